@@ -578,6 +578,7 @@ GSerializer::GSerializer(DSR::DSRGraph* G_, std::string save_file)
 
 GSerializer::~GSerializer()
 {
+    connections.clear();
     if (!out_file.empty()) save_file(out_file);
     //Manually deallocate buffers.
     for (auto [ptr, _] : ops) std::free(ptr);
@@ -586,7 +587,7 @@ GSerializer::~GSerializer()
 
 void GSerializer::initialize()
 {
-    QObject::connect(G, &DSR::DSRGraph::update_node_signal,  [this](auto node, auto type) {
+    connections.add(G->callbacks().update_node, [this](uint64_t node, const std::string &type, const DSR::SignalInfo &) {
 
         //TODO: los cambios en nodos pueden ir sin los arcos del nodo excepto en la primera ejecución.
         std::optional<DSR::Node> e = G->get_node(node);
@@ -612,7 +613,7 @@ void GSerializer::initialize()
         add_change(std::move(c));
 
     });
-    QObject::connect(G, &DSR::DSRGraph::update_edge_signal, [this](auto from, auto to, auto type) {
+    connections.add(G->callbacks().update_edge, [this](uint64_t from, uint64_t to, const std::string &type, const DSR::SignalInfo &) {
 
         std::optional<DSR::Edge> e = G->get_edge(from, to, type);
         uint32_t agent_id = 0;
@@ -638,10 +639,10 @@ void GSerializer::initialize()
 
     });
 
-    QObject::connect(G, &DSR::DSRGraph::del_edge_signal, [this](auto from, auto to, auto type) {
+    connections.add(G->callbacks().del_edge, [this](uint64_t from, uint64_t to, const std::string &type, const DSR::SignalInfo &info) {
         ChangeInfo c = {
                 .op = (ops.empty()) ? ChangeInfo::COMPLETE : ChangeInfo::EDGE_DEL,
-                .agent_id = 0, //We don't have a way to know who made this change.
+                .agent_id = info.agent_id,
                 .node_or_from_id= from,
                 .maybe_to_id=to,
                 .timestamp=get_unix_timestamp(),
@@ -650,10 +651,10 @@ void GSerializer::initialize()
 
         add_change(std::move(c));
     });
-    QObject::connect(G, &DSR::DSRGraph::del_node_signal, [this](auto node) {
+    connections.add(G->callbacks().del_node, [this](uint64_t node, const DSR::SignalInfo &info) {
         ChangeInfo c = {
                 .op = (ops.empty()) ? ChangeInfo::COMPLETE : ChangeInfo::NODE_DEL,
-                .agent_id = 0, //We don't have a way to know who made this change.
+                .agent_id = info.agent_id,
                 .node_or_from_id= node,
                 .maybe_to_id=0,
                 .timestamp=get_unix_timestamp(),
@@ -3,12 +3,16 @@
 //
 
 #include <dsr/api/dsr_api.h>
+#include <dsr/api/dsr_spatial_index_api.h>
+#include <dsr/api/dsr_kinematics_api.h>
 #include <dsr/core/types/crdt_types.h>
 #include <iostream>
 #include <unistd.h>
 #include <algorithm>
 #include <utility>
 #include <cmath>
+#include <condition_variable>
+#include <future>
 
 #include <fastdds/rtps/transport/UDPv4TransportDescriptor.hpp>
 #include <fastdds/rtps/RTPSDomain.hpp>
@@ -46,17 +50,12 @@ DSRGraph::DSRGraph(std::string name, uint32_t id, const std::string &dsr_input_f
                                                                 {
                                                                     if (status == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::DISCOVERED_PARTICIPANT)
                                                                     {
-                                                                        std::unique_lock<std::mutex> lck(participant_set_mutex);
-                                                                        std::cout << "Participant matched [" << info.participant_name.to_string() << "]" << std::endl;
-                                                                        graph->participant_set.emplace(info.participant_name.to_string(), false);
+                                                                        graph->participant_changed(info.participant_name.to_string(), true);
                                                                     }
                                                                     else if (status == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::REMOVED_PARTICIPANT ||
                                                                              status == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::DROPPED_PARTICIPANT)
                                                                     {
-                                                                        std::unique_lock<std::mutex> lck(participant_set_mutex);
-                                                                        graph->participant_set.erase(info.participant_name.to_string());
-                                                                        std::cout << "Participant unmatched [" << info.participant_name.to_string() << "]" << std::endl;
-                                                                        graph->delete_node(info.participant_name.to_string());
+                                                                        graph->participant_changed(info.participant_name.to_string(), false);
                                                                     }
                                                                 }));
 
@@ -78,7 +77,34 @@ DSRGraph::DSRGraph(std::string name, uint32_t id, const std::string &dsr_input_f
     dsrparticipant.add_publisher(dsrparticipant.getGraphRequestTopic()->get_name(), {pub5, writer5});
     dsrparticipant.add_publisher(dsrparticipant.getGraphTopic()->get_name(), {pub6, writer6});
 
-    // RTPS Initialize comms threads
+    start_comms(dsr_input_file);
+}
+
+DSRGraph::DSRGraph(std::string name, uint32_t id, const std::string &dsr_input_file, std::unique_ptr<Transport> transport_)
+        : agent_id(id),
+        agent_name(std::move(name)),
+        copy(false),
+        tp(5),
+        tp_delta_attr(1),
+        same_host(true),
+        generator(id),
+        transport(std::move(transport_))
+{
+    qDebug() << "Agent name: " << QString::fromStdString(agent_name);
+    utils =  std::make_unique<Utilities>(this);
+
+    transport->join(participant_name(), [this](const std::string &participant, bool joined) {
+        participant_changed(participant, joined);
+    });
+    for (auto *pub : {&dsrpub_node, &dsrpub_node_attrs, &dsrpub_edge, &dsrpub_edge_attrs, &dsrpub_graph_request, &dsrpub_request_answer})
+        pub->init(transport.get());
+
+    start_comms(dsr_input_file);
+}
+
+// RTPS Initialize comms threads
+void DSRGraph::start_comms(const std::string &dsr_input_file)
+{
     if (!dsr_input_file.empty())
     {
         try
@@ -101,7 +127,8 @@ DSRGraph::DSRGraph(std::string name, uint32_t id, const std::string &dsr_input_f
 
         if(!response)
         {
-            dsrparticipant.remove_participant_and_entities(); // Remove a Participant and all associated publishers and subscribers.
+            if (transport) transport->close();
+            else dsrparticipant.remove_participant_and_entities(); // Remove a Participant and all associated publishers and subscribers.
 
             if (repeated)
             {
@@ -115,10 +142,37 @@ DSRGraph::DSRGraph(std::string name, uint32_t id, const std::string &dsr_input_f
     qDebug() << __FUNCTION__ << "Constructor finished OK";
 }
 
+void DSRGraph::participant_changed(const std::string &participant, bool joined)
+{
+    if (joined)
+    {
+        std::unique_lock<std::mutex> lck(participant_set_mutex);
+        std::cout << "Participant matched [" << participant << "]" << std::endl;
+        participant_set.emplace(participant, false);
+    }
+    else
+    {
+        {
+            std::unique_lock<std::mutex> lck(participant_set_mutex);
+            participant_set.erase(participant);
+        }
+        std::cout << "Participant unmatched [" << participant << "]" << std::endl;
+        delete_node(participant);
+    }
+}
+
+std::string DSRGraph::participant_name() const
+{
+    return "Participant_" + std::to_string(agent_id) + " ( " + agent_name + " )";
+}
+
 DSRGraph::~DSRGraph()
 {
     qDebug() << "Removing DSRGraph";
-    dsrparticipant.remove_participant_and_entities();
+    // Pending waiters are resumed while the graph is still usable.
+    wait_api.reset();
+    if (transport) transport->close();
+    else dsrparticipant.remove_participant_and_entities();
     if (!copy) {
         qDebug() << "Removing rtps participant";
     }
@@ -173,10 +227,11 @@ std::optional<uint64_t> DSRGraph::insert_node(No &&node)
 {
     std::optional<IDL::MvregNode> delta;
     bool inserted = false;
+    // The generator is lock-free, the id is taken before locking G.
+    uint64_t new_node_id = generator.generate();
     {
         std::unique_lock<std::shared_mutex> lock(_mutex);
         std::shared_lock<std::shared_mutex> lck_cache(_mutex_cache_maps);
-        uint64_t new_node_id = generator.generate();
         node.id(new_node_id);
         if (node.name().empty() or name_map.contains(node.name()))
             node.name(node.type() + "_" + id_generator::hex_string(new_node_id));
@@ -190,10 +245,10 @@ std::optional<uint64_t> DSRGraph::insert_node(No &&node)
             if (delta.has_value())
             {
                 dsrpub_node.write(&delta.value());
-                emit update_node_signal(node.id(), node.type(), SignalInfo{agent_id});
+                notify_update_node(node.id(), node.type(), SignalInfo{agent_id});
                 for (const auto &[k, v]: node.fano())
                 {
-                    emit update_edge_signal(node.id(), k.first, k.second,  SignalInfo{agent_id});
+                    notify_update_edge(node.id(), k.first, k.second,  SignalInfo{agent_id});
                 }
             }
         }
@@ -205,6 +260,48 @@ std::optional<uint64_t> DSRGraph::insert_node(No &&node)
 template std::optional<uint64_t>  DSRGraph::insert_node<DSR::Node &&>(DSR::Node&&);
 template std::optional<uint64_t>  DSRGraph::insert_node<DSR::Node&>(DSR::Node&);
 
+std::vector<uint64_t> DSRGraph::insert_nodes(std::vector<DSR::Node> &new_nodes)
+{
+    std::vector<uint64_t> ids = generator.generate_n(new_nodes.size());
+    std::vector<IDL::MvregNode> deltas;
+    std::vector<uint64_t> inserted;
+    deltas.reserve(new_nodes.size());
+    inserted.reserve(new_nodes.size());
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        for (std::size_t i = 0; i < new_nodes.size(); i++)
+        {
+            auto &node = new_nodes[i];
+            node.id(ids[i]);
+            {
+                std::shared_lock<std::shared_mutex> lck_cache(_mutex_cache_maps);
+                if (node.name().empty() or name_map.contains(node.name()))
+                    node.name(node.type() + "_" + id_generator::hex_string(ids[i]));
+            }
+            auto [ok, delta] = insert_node_(user_node_to_crdt(node));
+            if (not ok) continue;
+            inserted.emplace_back(ids[i]);
+            if (delta.has_value()) deltas.emplace_back(std::move(delta.value()));
+        }
+    }
+    if (!copy)
+    {
+        for (auto &delta : deltas)
+            dsrpub_node.write(&delta);
+        // ids are increasing, so is inserted.
+        for (const auto &node : new_nodes)
+        {
+            if (not std::binary_search(inserted.begin(), inserted.end(), node.id())) continue;
+            notify_update_node(node.id(), node.type(), SignalInfo{agent_id});
+            for (const auto &[k, v]: node.fano())
+            {
+                notify_update_edge(node.id(), k.first, k.second,  SignalInfo{agent_id});
+            }
+        }
+    }
+    return inserted;
+}
+
 
 std::tuple<bool, std::optional<std::vector<IDL::MvregNodeAttr>>> DSRGraph::update_node_(CRDTNode &&node)
 {
@@ -244,6 +341,7 @@ std::tuple<bool, std::optional<std::vector<IDL::MvregNodeAttr>>> DSRGraph::updat
                     it_a++;
                 }
             }
+            if (not atts_deltas.empty()) update_attr_indices(node.id(), &nodes.at(node.id()).read_reg());
 
             return {true, std::move(atts_deltas)};
         }
@@ -258,6 +356,7 @@ requires (std::is_same_v<std::remove_cvref_t<No>, DSR::Node>)
 
     bool updated = false;
     std::optional<std::vector<IDL::MvregNodeAttr>> vec_node_attr;
+    AttrValues values;
 
     {
         std::unique_lock<std::shared_mutex> lock(_mutex);
@@ -274,19 +373,25 @@ requires (std::is_same_v<std::remove_cvref_t<No>, DSR::Node>)
         else if (nodes.contains(node.id())) {
             lck_cache.unlock();
             std::tie(updated, vec_node_attr) = update_node_(user_node_to_crdt(std::forward<No>(node)));
+            if (updated and vec_node_attr.has_value() and not graph_signals.update_node_attr_values.empty())
+            {
+                std::vector<std::string> names;
+                for (const auto &a : vec_node_attr.value()) names.emplace_back(a.attr_name());
+                values = node_attr_values_(node.id(), names);
+            }
         }
     }
     if (updated) {
         if (!copy) {
             if (vec_node_attr.has_value()) {
                 dsrpub_node_attrs.write(&vec_node_attr.value());
-                emit update_node_signal(node.id(), node.type(), SignalInfo{agent_id});
+                notify_update_node(node.id(), node.type(), SignalInfo{agent_id});
                 std::vector<std::string> atts_names(vec_node_attr->size());
                 std::transform(std::make_move_iterator(vec_node_attr->begin()),
                                std::make_move_iterator(vec_node_attr->end()),
                                atts_names.begin(),
                                [](auto &&x) { return x.attr_name(); });
-                emit update_node_attr_signal(node.id(), atts_names, SignalInfo{agent_id});
+                notify_update_node_attr(node.id(), atts_names, SignalInfo{agent_id}, std::move(values));
 
             }
         }
@@ -368,14 +473,14 @@ bool DSRGraph::delete_node(const std::string &name)
 
     if (result) {
         if (!copy) {
-            emit del_node_signal(id.value(), SignalInfo{agent_id});
+            notify_del_node(id.value(), SignalInfo{agent_id});
             dsrpub_node.write(&deleted_node.value());
 
             for (auto &a : delta_vec) {
                 dsrpub_edge.write(&a);
             }
             for (auto &[id0, id1, label] : deleted_edges)
-                    emit del_edge_signal(id0, id1, label, SignalInfo{ agent_id });
+                    notify_del_edge(id0, id1, label, SignalInfo{ agent_id });
         }
         return true;
     }
@@ -397,14 +502,14 @@ bool DSRGraph::delete_node(uint64_t id)
 
     if (result) {
         if (!copy) {
-            emit del_node_signal(id, SignalInfo{ agent_id });
+            notify_del_node(id, SignalInfo{ agent_id });
             dsrpub_node.write(&deleted_node.value());
 
             for (auto &a  : delta_vec) {
                 dsrpub_edge.write(&a);
             }
             for (auto &[id0, id1, label] : deleted_edges) {
-                    emit del_edge_signal(id0, id1, label, SignalInfo{ agent_id });
+                    notify_del_edge(id0, id1, label, SignalInfo{ agent_id });
             }
         }
         return true;
@@ -415,20 +520,17 @@ bool DSRGraph::delete_node(uint64_t id)
 
 
 std::vector<DSR::Node> DSRGraph::get_nodes_by_type(const std::string &type)
+{
+    return get_nodes_by_type_(name_id(type), type);
+}
+
+std::vector<DSR::Node> DSRGraph::get_nodes_by_type_(name_id_t id, std::string_view type)
 {
     std::shared_lock<std::shared_mutex> lock(_mutex);
     std::shared_lock<std::shared_mutex> lck(_mutex_cache_maps);
 
     std::vector<Node> nodes_;
-    if (nodeType.contains(type))
-    {
-        for (auto &id: nodeType.at(type))
-        {
-            std::optional<CRDTNode> n = get_(id);
-            if (n.has_value())
-                nodes_.emplace_back(std::move(n.value()));
-        }
-    }
+    append_nodes_of_type_(nodes_, id, type);
     return nodes_;
 }
 
@@ -439,20 +541,122 @@ std::vector<DSR::Node> DSRGraph::get_nodes_by_types(const std::vector<std::strin
 
     std::vector<Node> nodes_;
     for (auto &type : types)
+        append_nodes_of_type_(nodes_, name_id(type), type);
+    return nodes_;
+}
+
+void DSRGraph::append_nodes_of_type_(std::vector<Node> &out, name_id_t id, std::string_view type)
+{
+    auto t = nodeType.find(id);
+    if (t == nodeType.end()) return;
+    for (auto node_id : t->second)
     {
-        if (nodeType.contains(type))
-        {
-            for (auto &id: nodeType.at(type))
-            {
-                std::optional<CRDTNode> n = get_(id);
-                if (n.has_value())
-                    nodes_.emplace_back(std::move(n.value()));
-            }
-        }
+        auto it = nodes.find(node_id);
+        if (it != nodes.end() and not it->second.empty() and it->second.read_reg().type() == type)
+            out.emplace_back(it->second.read_reg());
+    }
+}
+
+std::vector<std::optional<DSR::Node>> DSRGraph::get_nodes(const std::vector<uint64_t> &ids)
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    std::vector<std::optional<Node>> nodes_;
+    nodes_.reserve(ids.size());
+    for (auto id : ids)
+    {
+        std::optional<CRDTNode> n = get_(id);
+        if (n.has_value()) nodes_.emplace_back(Node(std::move(n.value())));
+        else nodes_.emplace_back();
     }
     return nodes_;
 }
 
+std::vector<std::vector<std::optional<DSR::Attribute>>> DSRGraph::get_attribs(const std::vector<uint64_t> &ids, const std::vector<std::string> &names)
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    std::vector<std::vector<std::optional<Attribute>>> res(ids.size(), std::vector<std::optional<Attribute>>(names.size()));
+    for (std::size_t i = 0; i < ids.size(); i++)
+    {
+        auto it = nodes.find(ids[i]);
+        if (it == nodes.end() or it->second.empty()) continue;
+        const auto &attrs = it->second.read_reg().attrs();
+        for (std::size_t j = 0; j < names.size(); j++)
+            if (auto att = attrs.find(names[j]); att != attrs.end() and not att->second.empty())
+                res[i][j] = att->second.read_reg();
+    }
+    return res;
+}
+
+bool DSRGraph::create_attr_index(std::string_view att_name, IndexKind kind)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    std::string name(att_name);
+    if (attr_indices.contains(name)) return false;
+    AttributeIndex index(kind);
+    for (const auto &[id, reg] : nodes)
+    {
+        if (reg.empty()) continue;
+        const auto &attrs = reg.read_reg().attrs();
+        if (auto att = attrs.find(name); att != attrs.end() and not att->second.empty())
+            index.set(id, index_value(att->second.read_reg().value()));
+    }
+    attr_indices.emplace(std::move(name), std::move(index));
+    return true;
+}
+
+bool DSRGraph::drop_attr_index(std::string_view att_name)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    return attr_indices.erase(std::string(att_name)) > 0;
+}
+
+std::vector<uint64_t> DSRGraph::query_nodes(std::string_view att_name, const AttrPredicate &pred, const std::string &type)
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    std::shared_lock<std::shared_mutex> lck_cache(_mutex_cache_maps);
+    const std::string name(att_name);
+    const std::unordered_set<uint64_t> *of_type = nullptr;
+    if (not type.empty())
+    {
+        auto t = nodeType.find(name_id(type));
+        if (t == nodeType.end()) return {};
+        of_type = &t->second;
+    }
+
+    std::vector<uint64_t> ids;
+    if (auto it = attr_indices.find(name); it != attr_indices.end() and it->second.find(pred, ids))
+    {
+        if (of_type != nullptr)
+            std::erase_if(ids, [&](uint64_t id) {
+                auto n = nodes.find(id);
+                return not of_type->contains(id) or n == nodes.end() or n->second.empty() or n->second.read_reg().type() != type;
+            });
+        return ids;
+    }
+
+    // No index answers pred, the attributes are read in place.
+    auto matches = [&](const mvreg<CRDTNode> &reg) {
+        if (reg.empty()) return false;
+        const auto &attrs = reg.read_reg().attrs();
+        auto att = attrs.find(name);
+        if (att == attrs.end() or att->second.empty()) return false;
+        auto v = index_value(att->second.read_reg().value());
+        return v.has_value() and pred(v.value());
+    };
+    if (of_type != nullptr)
+    {
+        for (auto id : *of_type)
+            if (auto n = nodes.find(id); n != nodes.end() and matches(n->second) and n->second.read_reg().type() == type)
+                ids.emplace_back(id);
+    }
+    else
+    {
+        for (const auto &[id, reg] : nodes)
+            if (matches(reg)) ids.emplace_back(id);
+    }
+    return ids;
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // EDGE METHODS
 //////////////////////////////////////////////////////////////////////////////////
@@ -580,13 +784,21 @@ requires (std::is_same_v<std::remove_cvref_t<Ed>, DSR::Edge>)
     bool result = false;
     std::optional<IDL::MvregEdge> delta_edge;
     std::optional<std::vector<IDL::MvregEdgeAttr>> delta_attrs;
+    AttrValues values;
 
     {
         std::unique_lock<std::shared_mutex> lock(_mutex);
         uint64_t from = attrs.from();
         uint64_t to = attrs.to();
         if (nodes.contains(from) && nodes.contains(to)) {
+            const std::string type = attrs.type();
             std::tie(result, delta_edge, delta_attrs) = insert_or_assign_edge_(user_edge_to_crdt(std::forward<Ed>(attrs)), from, to);
+            if (result and delta_attrs.has_value() and not graph_signals.update_edge_attr_values.empty())
+            {
+                std::vector<std::string> names;
+                for (const auto &a : delta_attrs.value()) names.emplace_back(a.attr_name());
+                values = edge_attr_values_(from, to, type, names);
+            }
         } else {
             std::cout << __FUNCTION__ << ":" << __LINE__ << " Error. ID:" << from << " or " << to
                       << " not found. Cant update. " << std::endl;
@@ -595,7 +807,7 @@ requires (std::is_same_v<std::remove_cvref_t<Ed>, DSR::Edge>)
     }
     if (result) {
         if (!copy) {
-            emit update_edge_signal(attrs.from(), attrs.to(), attrs.type(), SignalInfo{ agent_id });
+            notify_update_edge(attrs.from(), attrs.to(), attrs.type(), SignalInfo{ agent_id });
 
             if (delta_edge.has_value()) { //Insert
                 dsrpub_edge.write(&delta_edge.value());
@@ -608,7 +820,7 @@ requires (std::is_same_v<std::remove_cvref_t<Ed>, DSR::Edge>)
                                atts_names.begin(),
                                [](auto &&x) { return x.attr_name(); });
 
-                emit update_edge_attr_signal(attrs.from(), attrs.to(), attrs.type(), atts_names, SignalInfo{ agent_id });
+                notify_update_edge_attr(attrs.from(), attrs.to(), attrs.type(), atts_names, SignalInfo{ agent_id }, std::move(values));
 
             }
         }
@@ -648,7 +860,7 @@ bool DSRGraph::delete_edge(uint64_t from, uint64_t to, const std::string &key)
     if (delta.has_value())
     {
         if (!copy) {
-            emit del_edge_signal(from, to, key, SignalInfo{ agent_id });
+            notify_del_edge(from, to, key, SignalInfo{ agent_id });
             dsrpub_edge.write(&delta.value());
         }
         return true;
@@ -674,7 +886,7 @@ bool DSRGraph::delete_edge(const std::string &from, const std::string &to, const
     if (delta.has_value())
     {
         if (!copy) {
-            emit del_edge_signal(id_from.value(), id_to.value(), key, SignalInfo{ agent_id });
+            notify_del_edge(id_from.value(), id_to.value(), key, SignalInfo{ agent_id });
             dsrpub_edge.write(&delta.value());
         }
         return true;
@@ -693,12 +905,18 @@ std::vector<DSR::Edge> DSRGraph::get_node_edges_by_type(const Node &node, const
 }
 
 std::vector<DSR::Edge> DSRGraph::get_edges_by_type(const std::string &type)
+{
+    return get_edges_by_type_(name_id(type), type);
+}
+
+std::vector<DSR::Edge> DSRGraph::get_edges_by_type_(name_id_t id, const std::string &type)
 {
     std::shared_lock<std::shared_mutex> lock(_mutex);
     std::shared_lock<std::shared_mutex> lock_cache(_mutex_cache_maps);
     std::vector<Edge> edges_;
-    if (edgeType.contains(type)) {
-        for (auto &[from, to] : edgeType.at(type)) {
+    if (auto t = edgeType.find(id); t != edgeType.end()) {
+        // get_edge_ looks the edge up by type, the ones of other types with the same id aren't found.
+        for (auto &[from, to] : t->second) {
             auto n = get_edge_(from, to, type);
             if (n.has_value())
                 edges_.emplace_back(Edge(std::move(n.value())));
@@ -749,6 +967,115 @@ std::map<uint64_t, DSR::Node> DSRGraph::getCopy() const
     return mymap;
 }
 
+std::unique_ptr<SpatialIndexAPI> DSRGraph::get_spatial_index_api()
+{
+    return std::make_unique<SpatialIndexAPI>(this);
+}
+
+std::unique_ptr<KinematicsAPI> DSRGraph::get_kinematics_api()
+{
+    return std::make_unique<KinematicsAPI>(this);
+}
+
+WaitAPI &DSRGraph::get_wait_api()
+{
+    std::call_once(wait_api_once, [this] { wait_api = std::make_unique<WaitAPI>(this); });
+    return *wait_api;
+}
+
+void DSRGraph::notify_update_node(uint64_t id, const std::string &type, SignalInfo info)
+{
+    graph_signals.update_node.publish(id, type, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit update_node_signal(id, type, info);
+#endif
+}
+
+void DSRGraph::notify_update_node_attr(uint64_t id, const std::vector<std::string> &att_names, SignalInfo info, AttrValues values)
+{
+    graph_signals.update_node_attr.publish(id, att_names, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit update_node_attr_signal(id, att_names, info);
+#endif
+    if (graph_signals.update_node_attr_values.empty()) return;
+    if (not values)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        values = node_attr_values_(id, att_names);
+    }
+    graph_signals.update_node_attr_values.publish(id, values, info);
+}
+
+void DSRGraph::notify_update_edge(uint64_t from, uint64_t to, const std::string &type, SignalInfo info)
+{
+    graph_signals.update_edge.publish(from, to, type, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit update_edge_signal(from, to, type, info);
+#endif
+}
+
+void DSRGraph::notify_update_edge_attr(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names, SignalInfo info, AttrValues values)
+{
+    graph_signals.update_edge_attr.publish(from, to, type, att_names, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit update_edge_attr_signal(from, to, type, att_names, info);
+#endif
+    if (graph_signals.update_edge_attr_values.empty()) return;
+    if (not values)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        values = edge_attr_values_(from, to, type, att_names);
+    }
+    graph_signals.update_edge_attr_values.publish(from, to, type, values, info);
+}
+
+void DSRGraph::notify_del_edge(uint64_t from, uint64_t to, const std::string &type, SignalInfo info)
+{
+    graph_signals.del_edge.publish(from, to, type, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit del_edge_signal(from, to, type, info);
+#endif
+}
+
+void DSRGraph::notify_del_node(uint64_t id, SignalInfo info)
+{
+    graph_signals.del_node.publish(id, info);
+#ifndef DSR_NO_QT_SIGNAL_EMIT
+    emit del_node_signal(id, info);
+#endif
+}
+
+static AttrValues attr_values(const std::map<std::string, mvreg<CRDTAttribute>> *attrs, const std::vector<std::string> &att_names)
+{
+    auto values = std::make_shared<std::vector<AttrChange>>();
+    values->reserve(att_names.size());
+    for (const auto &name : att_names)
+    {
+        auto &c = values->emplace_back(AttrChange{name, {}});
+        if (attrs == nullptr) continue;
+        if (auto it = attrs->find(name); it != attrs->end() and not it->second.empty())
+            c.value.emplace(it->second.read_reg());
+    }
+    return values;
+}
+
+AttrValues DSRGraph::node_attr_values_(uint64_t id, const std::vector<std::string> &att_names) const
+{
+    auto it = nodes.find(id);
+    if (it == nodes.end() or it->second.empty()) return attr_values(nullptr, att_names);
+    return attr_values(&it->second.read_reg().attrs(), att_names);
+}
+
+AttrValues DSRGraph::edge_attr_values_(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names) const
+{
+    auto it = nodes.find(from);
+    if (it == nodes.end() or it->second.empty()) return attr_values(nullptr, att_names);
+    const auto &fano = it->second.read_reg().fano();
+    auto edge = fano.find({to, type});
+    if (edge == fano.end() or edge->second.empty()) return attr_values(nullptr, att_names);
+    return attr_values(&edge->second.read_reg().attrs(), att_names);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /////  CORE
 //////////////////////////////////////////////////////////////////////////////
@@ -805,22 +1132,20 @@ inline void DSRGraph::update_maps_node_delete(uint64_t id, const std::optional<C
     }
     deleted.insert(id);
     to_edges.erase(id);
+    update_attr_indices(id, nullptr);
 
     if (n.has_value())
     {
-        if (nodeType.contains(n->type())) {
-            nodeType.at(n->type()).erase(id);
-            if (nodeType.at(n->type()).empty()) nodeType.erase(n->type());
+        if (auto t = nodeType.find(name_id(n->type())); t != nodeType.end()) {
+            t->second.erase(id);
+            if (t->second.empty()) nodeType.erase(t);
         }
         for (const auto &[k, v] : n->fano()) {
             if (auto tuple = std::pair{id, v.read_reg().to()}; edges.contains(tuple)) {
                 edges.at(tuple).erase(k.second);
                 if (edges.at(tuple).empty()) edges.erase(tuple);
             }
-            if (auto tuple = std::pair{id, k.first}; edgeType.contains(k.second)) {
-                edgeType.at(k.second).erase(tuple);
-                if (edgeType.at(k.second).empty())edgeType.erase(k.second);
-            }
+            erase_edge_type(id, k.first, k.second);
             if (auto tuple = std::pair{id, k.second}; to_edges.contains(k.first)) {
                 to_edges.at(k.first).erase(tuple);
                 if (to_edges.at(k.first).empty()) to_edges.erase(k.first);
@@ -835,16 +1160,35 @@ inline void DSRGraph::update_maps_node_insert(uint64_t id, const CRDTNode &n)
 
     name_map[n.name()] = id;
     id_map[id] = n.name();
-    nodeType[n.type()].emplace(id);
+    nodeType[name_id(n.type())].emplace(id);
     for (const auto &[k, v] : n.fano())
     {
         edges[{id, k.first}].insert(k.second);
-        edgeType[k.second].insert({id, k.first});
+        edgeType[name_id(k.second)].insert({id, k.first});
         to_edges[k.first].insert({id, k.second});
     }
+    update_attr_indices(id, &n);
 }
 
 
+inline void DSRGraph::update_attr_indices(uint64_t id, const CRDTNode *n)
+{
+    for (auto &[name, index] : attr_indices)
+    {
+        if (n == nullptr) index.erase(id);
+        else update_attr_index(id, name, *n);
+    }
+}
+
+inline void DSRGraph::update_attr_index(uint64_t id, const std::string &att_name, const CRDTNode &n)
+{
+    auto index = attr_indices.find(att_name);
+    if (index == attr_indices.end()) return;
+    auto att = n.attrs().find(att_name);
+    if (att == n.attrs().end() or att->second.empty()) index->second.erase(id);
+    else index->second.set(id, index_value(att->second.read_reg().value()));
+}
+
 inline void DSRGraph::update_maps_edge_delete(uint64_t from, uint64_t to, const std::string &key)
 {
 
@@ -853,11 +1197,10 @@ inline void DSRGraph::update_maps_edge_delete(uint64_t from, uint64_t to, const
     //if key is empty we delete all edges to the node from
     if (key.empty())
     {
-        edges.erase({from, to});
-
-        if (edgeType.contains(key)) {
-            edgeType.at(key).erase({from, to});
-            if (edgeType.at(key).empty()) edgeType.erase(key);
+        if (auto e = edges.find({from, to}); e != edges.end()) {
+            auto types = std::move(e->second);
+            edges.erase(e);
+            for (const auto &type : types) erase_edge_type(from, to, type);
         }
 
         if (to_edges.contains(to)) {
@@ -876,7 +1219,7 @@ inline void DSRGraph::update_maps_edge_delete(uint64_t from, uint64_t to, const
     {
         if (auto tuple = std::pair{from, to}; edges.contains(tuple)) {
             edges.at(tuple).erase(key);
-            edges.erase({from, to});
+            if (edges.at(tuple).empty()) edges.erase(tuple);
         }
 
         if (to_edges.contains(to)) {
@@ -884,21 +1227,31 @@ inline void DSRGraph::update_maps_edge_delete(uint64_t from, uint64_t to, const
             if (to_edges.at(to).empty()) to_edges.erase(to);
         }
 
-        if (edgeType.contains(key)) {
-            edgeType.at(key).erase({from, to});
-            if (edgeType.at(key).empty()) edgeType.erase(key);
-        }
+        erase_edge_type(from, to, key);
 
     }
 }
 
+inline void DSRGraph::erase_edge_type(uint64_t from, uint64_t to, const std::string &key)
+{
+    // Types with the same id share their set, the pair stays while from has an edge to `to` of one of them.
+    const name_id_t id = name_id(key);
+    auto t = edgeType.find(id);
+    if (t == edgeType.end()) return;
+    if (auto e = edges.find({from, to}); e != edges.end() and
+        std::any_of(e->second.begin(), e->second.end(), [&](const std::string &other) { return name_id(other) == id; }))
+        return;
+    t->second.erase({from, to});
+    if (t->second.empty()) edgeType.erase(t);
+}
+
 inline void DSRGraph::update_maps_edge_insert(uint64_t from, uint64_t to, const std::string &key)
 {
     std::unique_lock<std::shared_mutex> lck(_mutex_cache_maps);
 
     edges[{from, to}].insert(key);
     to_edges[to].insert({from, key});
-    edgeType[key].insert({from, to});
+    edgeType[name_id(key)].insert({from, to});
 
 }
 
@@ -924,6 +1277,13 @@ size_t DSRGraph::size() {
     return nodes.size();
 }
 
+DSRGraph::DeltaBacklog DSRGraph::delta_backlog() const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return { unprocessed_delta_node_att.size(), unprocessed_delta_edge_from.size(),
+             unprocessed_delta_edge_to.size(), unprocessed_delta_edge_att.size() };
+}
+
 
 bool DSRGraph::empty(const uint64_t &id)
 {
@@ -1052,30 +1412,30 @@ void DSRGraph::join_delta_node(IDL::MvregNode &&mvreg)
 
         if (joined) {
             if (signal) {
-                emit update_node_signal(id, nodes.at(id).read_reg().type(), SignalInfo{ mvreg.agent_id() });
+                notify_update_node(id, nodes.at(id).read_reg().type(), SignalInfo{ mvreg.agent_id() });
                 for (const auto &[k, v] : nodes.at(id).read_reg().fano()) {
                     //std::cout << "[JOIN NODE] add edge FROM: "<< id << ", " << k.first << ", " << k.second << std::endl;
-                    emit update_edge_signal(id, k.first, k.second, SignalInfo{ mvreg.agent_id() });
+                    notify_update_edge(id, k.first, k.second, SignalInfo{ mvreg.agent_id() });
                 }
 
                 for (const auto &[k, v]: map_new_to_edges)
                 {
                     //std::cout << "[JOIN NODE] add edge TO: "<< k << ", " << id << ", " << v << std::endl;
-                    emit update_edge_signal(k, id, v, SignalInfo{ mvreg.agent_id() });
+                    notify_update_edge(k, id, v, SignalInfo{ mvreg.agent_id() });
                 }
             } else {
-                emit del_node_signal(id, SignalInfo{ mvreg.agent_id() });
+                notify_del_node(id, SignalInfo{ mvreg.agent_id() });
                 if (maybe_deleted_node.has_value()) {
                     for (const auto &node: maybe_deleted_node->fano()) {
                         //std::cout << "[JOIN NODE] delete edge FROM: "<< node.second.read_reg().from() << ", " << node.second.read_reg().to() << ", " << node.second.read_reg().type() << std::endl;
-                        emit del_edge_signal(node.second.read_reg().from(), node.second.read_reg().to(),
+                        notify_del_edge(node.second.read_reg().from(), node.second.read_reg().to(),
                                              node.second.read_reg().type(), SignalInfo{ mvreg.agent_id() });
                     }
                 }
 
                 for (const auto &[from, type] : cache_map_to_edges.value()) {
                     //std::cout << "[JOIN NODE] delete edge TO: "<< from << ", " << id << ", " << type << std::endl;
-                    emit del_edge_signal(from, id, type, SignalInfo{ mvreg.agent_id() });
+                    notify_del_edge(from, id, type, SignalInfo{ mvreg.agent_id() });
                 }
 
             }
@@ -1216,10 +1576,10 @@ void DSRGraph::join_delta_edge(IDL::MvregEdge &&mvreg)
         if (joined) {
             if (signal) {
                 //std::cout << "[JOIN EDGE] add edge: "<< from << ", " << to << ", " << type << std::endl;
-                emit update_edge_signal(from, to, type, SignalInfo{ mvreg.agent_id() });
+                notify_update_edge(from, to, type, SignalInfo{ mvreg.agent_id() });
             } else {
                 //std::cout << "[JOIN EDGE] delete edge: "<< from << ", " << to << ", " << type << std::endl;
-                emit del_edge_signal(from, to, type, SignalInfo{ mvreg.agent_id() });
+                notify_del_edge(from, to, type, SignalInfo{ mvreg.agent_id() });
             }
         }
 
@@ -1239,6 +1599,7 @@ void DSRGraph::process_delta_node_attr(uint64_t id, const std::string& att_name,
     if (d_empty or not n.attrs().contains(att_name)) { //Remove
         n.attrs().erase(att_name);
     }
+    update_attr_index(id, att_name, n);
 }
 
 std::optional<std::string> DSRGraph::join_delta_node_attr(IDL::MvregNodeAttr &&mvreg)
@@ -1467,20 +1828,20 @@ void DSRGraph::join_full_graph(IDL::OrMap &&full_graph)
         if (signal) {
             //check what change is joined
             if (!nd.has_value() || nd->attrs() != nodes[id].read_reg().attrs()) {
-                emit update_node_signal(id, nodes[id].read_reg().type(), SignalInfo{ agent_id_ch });
+                notify_update_node(id, nodes[id].read_reg().type(), SignalInfo{ agent_id_ch });
             } else if (nd.value() != nodes[id].read_reg()) {
                 auto iter = nodes[id].read_reg().fano();
                 for (const auto &[k, v] : nd->fano()) {
                     if (!iter.contains(k))
-                            emit del_edge_signal(id, k.first, k.second, SignalInfo{ agent_id_ch });
+                            notify_del_edge(id, k.first, k.second, SignalInfo{ agent_id_ch });
                 }
                 for (const auto &[k, v] : iter) {
                     if (auto it = nd->fano().find(k); it == nd->fano().end() or it->second != v)
-                            emit update_edge_signal(id, k.first, k.second, SignalInfo{ agent_id_ch });
+                            notify_update_edge(id, k.first, k.second, SignalInfo{ agent_id_ch });
                 }
             }
         } else {
-            emit del_node_signal(id, SignalInfo{ agent_id_ch });
+            notify_del_node(id, SignalInfo{ agent_id_ch });
         }
 
 }
@@ -1519,145 +1880,113 @@ std::map<uint64_t , IDL::MvregNode> DSRGraph::Map()
     return m;
 }
 
+void DSRGraph::subscribe(DSRSubscriber &sub, TopicId topic, const NewMessageFunctor &f)
+{
+    if (transport)
+    {
+        sub.init(transport.get(), topic, f);
+        return;
+    }
+
+    eprosima::fastdds::dds::Topic *dds_topic = nullptr;
+    switch (topic)
+    {
+        case TopicId::NODE:          dds_topic = dsrparticipant.getNodeTopic(); break;
+        case TopicId::NODE_ATTRS:    dds_topic = dsrparticipant.getAttNodeTopic(); break;
+        case TopicId::EDGE:          dds_topic = dsrparticipant.getEdgeTopic(); break;
+        case TopicId::EDGE_ATTRS:    dds_topic = dsrparticipant.getAttEdgeTopic(); break;
+        case TopicId::GRAPH_REQUEST: dds_topic = dsrparticipant.getGraphRequestTopic(); break;
+        case TopicId::GRAPH_ANSWER:  dds_topic = dsrparticipant.getGraphTopic(); break;
+    }
+    auto [res, s, reader] = sub.init(dsrparticipant.getParticipant(), dds_topic, topic, f, mtx_entity_creation);
+    dsrparticipant.add_subscriber(dds_topic->get_name(), {s, reader});
+}
+
 void DSRGraph::node_subscription_thread(bool showReceived)
 {
     auto name = __FUNCTION__;
     auto lambda_general_topic = [&, name = name, showReceived = showReceived]
-    (eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    (DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        try {
-            while (true)
-            {
-                eprosima::fastdds::dds::SampleInfo m_info;
-                IDL::MvregNode sample;
-                if (reader->take_next_sample(&sample, &m_info) == 0) {
-                    if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    ) {
-                        if (sample.agent_id() != agent_id) {
-                            if (showReceived) {
-                                qDebug() << name << " Received:" << std::to_string(sample.id()).c_str() << " node from: "
-                                        << m_info.sample_identity.writer_guid().entityId.value;
-                            }
-                            tp.spawn_task(&DSRGraph::join_delta_node, this, std::move(sample));
-                        }
-                    }
-                } else {
-                    break;
-                }
+        auto &sample = std::get<IDL::MvregNode>(s);
+        if (sample.agent_id() != agent_id) {
+            if (showReceived) {
+                qDebug() << name << " Received:" << std::to_string(sample.id()).c_str() << " node from: "
+                        << sample.agent_id();
             }
+            tp.spawn_task(&DSRGraph::join_delta_node, this, std::move(sample));
         }
-        catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
     };
     dsrpub_call_node = NewMessageFunctor(this, lambda_general_topic);
-    auto [res, sub, reader] = dsrsub_node.init(dsrparticipant.getParticipant(), dsrparticipant.getNodeTopic(), dsrpub_call_node, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getNodeTopic()->get_name(), {sub, reader});
+    subscribe(dsrsub_node, TopicId::NODE, dsrpub_call_node);
 }
 
 void DSRGraph::edge_subscription_thread(bool showReceived)
 {
     auto name = __FUNCTION__;
     auto lambda_general_topic = [&, name = name, showReceived = showReceived]
-    (eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    (DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        try {
-            while (true)
-            {
-                eprosima::fastdds::dds::SampleInfo m_info;
-                IDL::MvregEdge sample;
-                if (reader->take_next_sample(&sample, &m_info) == 0) {
-                    if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    ) {
-                        if (sample.agent_id() != agent_id) {
-                            if (showReceived) {
-                                qDebug() << name << " Received:" << std::to_string(sample.id()).c_str() << " node from: "
-                                        << m_info.sample_identity.writer_guid().entityId.value;
-                            }
-                            tp.spawn_task(&DSRGraph::join_delta_edge, this, std::move(sample));
-                        }
-                    }
-                } else {
-                    break;
-                }
+        auto &sample = std::get<IDL::MvregEdge>(s);
+        if (sample.agent_id() != agent_id) {
+            if (showReceived) {
+                qDebug() << name << " Received:" << std::to_string(sample.id()).c_str() << " node from: "
+                        << sample.agent_id();
             }
+            tp.spawn_task(&DSRGraph::join_delta_edge, this, std::move(sample));
         }
-        catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
     };
     dsrpub_call_edge = NewMessageFunctor(this, lambda_general_topic);
-    auto [res, sub, reader]  = dsrsub_edge.init(dsrparticipant.getParticipant(), dsrparticipant.getEdgeTopic(), dsrpub_call_edge, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getEdgeTopic()->get_name(), {sub, reader});
-
+    subscribe(dsrsub_edge, TopicId::EDGE, dsrpub_call_edge);
 }
 
 void DSRGraph::edge_attrs_subscription_thread(bool showReceived)
 {
     auto name = __FUNCTION__;
     auto lambda_general_topic = [&, name = name, showReceived = showReceived]
-    (eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    (DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        try {
-            while (true)
-            {
-                eprosima::fastdds::dds::SampleInfo m_info;
-                IDL::MvregEdgeAttrVec samples;
-                if (reader->take_next_sample(&samples, &m_info) == 0) {
-                    if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    ) {
-                        if (showReceived) {
-                            qDebug() << name << " Received:" << samples.vec().size() << " edge attr from: "
-                                    << m_info.sample_identity.writer_guid().entityId.value;
-                        }
-                        if (!samples.vec().empty() and samples.vec().at(0).agent_id() != agent_id)
-                        {
-                            tp_delta_attr.spawn_task([this, samples = std::move(samples)]() mutable {
-                                if (samples.vec().empty()) return;
-
-                                auto from = samples.vec().at(0).from();
-                                auto to = samples.vec().at(0).to();
-                                auto type = samples.vec().at(0).type();
-
-                                std::vector<std::future<std::optional<std::string>>> futures;
-
-                                for (auto &&sample: samples.vec()) {
-                                    if (!ignored_attributes.contains(sample.attr_name().data())) {
-                                        futures.emplace_back(tp.spawn_task_waitable([this, sample = std::move(sample)]() mutable {
-                                                return join_delta_edge_attr(std::move(sample));
-                                        }));
-                                    }
-                                }
-
-                                std::vector<std::string> sig (futures.size());
-                                for (auto &f: futures)
-                                {
-                                    auto opt_str = f.get();
-                                    if (opt_str.has_value())
-                                        sig.emplace_back(std::move(opt_str.value()));
-                                }
-
-
-                                emit update_edge_attr_signal(from, to, type, sig, SignalInfo{samples.vec().at(0).agent_id()});
-                                emit update_edge_signal(from, to, type, SignalInfo{samples.vec().at(0).agent_id()});
-
-                            });
-                        }
+        auto &samples = std::get<IDL::MvregEdgeAttrVec>(s);
+        if (showReceived) {
+            qDebug() << name << " Received:" << samples.vec().size() << " edge attr";
+        }
+        if (!samples.vec().empty() and samples.vec().at(0).agent_id() != agent_id)
+        {
+            tp_delta_attr.spawn_task([this, samples = std::move(samples)]() mutable {
+                if (samples.vec().empty()) return;
+
+                auto from = samples.vec().at(0).from();
+                auto to = samples.vec().at(0).to();
+                auto type = samples.vec().at(0).type();
+
+                std::vector<std::future<std::optional<std::string>>> futures;
+
+                for (auto &&sample: samples.vec()) {
+                    if (!ignored_attributes.contains(sample.attr_name().data())) {
+                        futures.emplace_back(tp.spawn_task_waitable([this, sample = std::move(sample)]() mutable {
+                                return join_delta_edge_attr(std::move(sample));
+                        }));
                     }
-                } else {
-                    break;
                 }
-            }
-        }
-        catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
 
+                std::vector<std::string> sig;
+                sig.reserve(futures.size());
+                for (auto &f: futures)
+                {
+                    auto opt_str = f.get();
+                    if (opt_str.has_value())
+                        sig.emplace_back(std::move(opt_str.value()));
+                }
+
+
+                notify_update_edge_attr(from, to, type, sig, SignalInfo{samples.vec().at(0).agent_id()});
+                notify_update_edge(from, to, type, SignalInfo{samples.vec().at(0).agent_id()});
+
+            });
+        }
     };
     dsrpub_call_edge_attrs = NewMessageFunctor(this, lambda_general_topic);
-    auto [res, sub, reader] = dsrsub_edge_attrs.init(dsrparticipant.getParticipant(), dsrparticipant.getAttEdgeTopic(),
-                           dsrpub_call_edge_attrs, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getAttEdgeTopic()->get_name(), {sub, reader});
+    subscribe(dsrsub_edge_attrs, TopicId::EDGE_ATTRS, dsrpub_call_edge_attrs);
     //dsrsub_edge_attrs_stream.init(dsrparticipant.getParticipant(), "DSR_EDGE_ATTRS_STREAM", dsrparticipant.getEdgeAttrTopicName(),
     //                       dsrpub_call_edge_attrs, true);
 }
@@ -1666,198 +1995,161 @@ void DSRGraph::node_attrs_subscription_thread(bool showReceived)
 {
     auto name = __FUNCTION__;
     auto lambda_general_topic = [this, name = name, showReceived = showReceived]
-    (eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    (DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        try {
-            while (true)
-            {
-                eprosima::fastdds::dds::SampleInfo m_info;
-                IDL::MvregNodeAttrVec samples;
-                if (reader->take_next_sample(&samples, &m_info) == 0) {
-                    if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    ) {
-                        if (showReceived) {
-                            qDebug() << name << " Received:" << samples.vec().size() << " node attrs from: "
-                                    << m_info.sample_identity.writer_guid().entityId.value;
-                        }
-                        if (!samples.vec().empty() and samples.vec().at(0).agent_id() != agent_id) {
-                            tp_delta_attr.spawn_task([this, samples = std::move(samples)]() mutable {
-
-                                if (samples.vec().empty()) return;
-
-                                auto id = samples.vec().at(0).id();
-                                std::string type;
-                                {
-                                    std::shared_lock<std::shared_mutex> lock(_mutex);
-                                    if (auto itn = nodes.find(id); itn != nodes.end())  type = itn->second.read_reg().type() ;
-                                }
-                                std::vector<std::future<std::optional<std::string>>> futures;
-                                for (auto &&s: samples.vec()) {
-                                    if (ignored_attributes.find(s.attr_name().data()) == ignored_attributes.end()) {
-                                        futures.emplace_back(tp.spawn_task_waitable([this, samp{std::move(s)}]() mutable {
-                                            auto f = join_delta_node_attr(std::move(samp));
-                                            return f;
-                                        }));
-
-                                    }
-                                }
-
-                                std::vector<std::string> sig (futures.size());
-                                for (auto &f: futures)
-                                {
-                                    auto opt_str = f.get();
-                                    if (opt_str.has_value())
-                                        sig.emplace_back(std::move(opt_str.value()));
-                                }
-
-                                emit update_node_attr_signal(id, sig, SignalInfo{samples.vec().at(0).agent_id()});
-                                emit update_node_signal(id, type, SignalInfo{samples.vec().at(0).agent_id()});
-                            });
-                        }
+        auto &samples = std::get<IDL::MvregNodeAttrVec>(s);
+        if (showReceived) {
+            qDebug() << name << " Received:" << samples.vec().size() << " node attrs";
+        }
+        if (!samples.vec().empty() and samples.vec().at(0).agent_id() != agent_id) {
+            tp_delta_attr.spawn_task([this, samples = std::move(samples)]() mutable {
+
+                if (samples.vec().empty()) return;
+
+                auto id = samples.vec().at(0).id();
+                std::string type;
+                {
+                    std::shared_lock<std::shared_mutex> lock(_mutex);
+                    if (auto itn = nodes.find(id); itn != nodes.end())  type = itn->second.read_reg().type() ;
+                }
+                std::vector<std::future<std::optional<std::string>>> futures;
+                for (auto &&s: samples.vec()) {
+                    if (ignored_attributes.find(s.attr_name().data()) == ignored_attributes.end()) {
+                        futures.emplace_back(tp.spawn_task_waitable([this, samp{std::move(s)}]() mutable {
+                            auto f = join_delta_node_attr(std::move(samp));
+                            return f;
+                        }));
+
                     }
-                } else {
-                    break;
                 }
-            }
-        }
-        catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
 
+                std::vector<std::string> sig;
+                sig.reserve(futures.size());
+                for (auto &f: futures)
+                {
+                    auto opt_str = f.get();
+                    if (opt_str.has_value())
+                        sig.emplace_back(std::move(opt_str.value()));
+                }
+
+                notify_update_node_attr(id, sig, SignalInfo{samples.vec().at(0).agent_id()});
+                notify_update_node(id, type, SignalInfo{samples.vec().at(0).agent_id()});
+            });
+        }
     };
     dsrpub_call_node_attrs = NewMessageFunctor(this, lambda_general_topic);
-    auto [res, sub, reader] = dsrsub_node_attrs.init(dsrparticipant.getParticipant(), dsrparticipant.getAttNodeTopic(),
-                           dsrpub_call_node_attrs, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getAttNodeTopic()->get_name(), {sub, reader});
-
+    subscribe(dsrsub_node_attrs, TopicId::NODE_ATTRS, dsrpub_call_node_attrs);
 }
 
 void DSRGraph::fullgraph_server_thread()
 {
-    auto lambda_graph_request = [&](eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    auto lambda_graph_request = [&](DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        while (true)
+        auto &sample = std::get<IDL::GraphRequest>(s);
         {
-            eprosima::fastdds::dds::SampleInfo m_info;
-            IDL::GraphRequest sample;
-            if (reader->take_next_sample(&sample, &m_info) == 0) {
-
-                if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    ) 
-                {
-                    {
-                        std::unique_lock<std::mutex> lck(participant_set_mutex);
-                        if (auto [it, ok] = participant_set.emplace(sample.from(), true);
-                            it->second and !ok)
-                        {
-                            if (it->second) {
-                                lck.unlock();
-                                IDL::OrMap mp;
-                                mp.id(-1);
-                                mp.to_id(sample.id());
-                                dsrpub_request_answer.write(&mp);
-                                continue;
-                            } else {}
-                        } else {
-                            it->second = true;
-                            lck.unlock();
-                        }
-                    }
-                    if (static_cast<uint32_t>(sample.id()) != agent_id ) {
+            std::unique_lock<std::mutex> lck(participant_set_mutex);
+            if (auto [it, ok] = participant_set.emplace(sample.from(), true);
+                it->second and !ok)
+            {
+                if (it->second) {
+                    lck.unlock();
+                    IDL::OrMap mp;
+                    mp.id(-1);
+                    mp.to_id(sample.id());
+                    dsrpub_request_answer.write(&mp);
+                    return;
+                } else {}
+            } else {
+                it->second = true;
+                lck.unlock();
+            }
+        }
+        if (static_cast<uint32_t>(sample.id()) != agent_id ) {
 
-                        qDebug() << " Received Full Graph request: from "
-                                << m_info.sample_identity.writer_guid().entityId.value;
-                        IDL::OrMap mp;
-                        mp.id(graph->get_agent_id());
-                        mp.m(graph->Map());
-                        dsrpub_request_answer.write(&mp);
+            qDebug() << " Received Full Graph request: from " << sample.id();
+            IDL::OrMap mp;
+            mp.id(graph->get_agent_id());
+            mp.m(graph->Map());
+            dsrpub_request_answer.write(&mp);
 
-                        qDebug() << "Full graph written";
+            qDebug() << "Full graph written";
 
-                    }
-                }
-            } else {
-                break;
-            }
         }
     };
     dsrpub_graph_request_call = NewMessageFunctor(this, lambda_graph_request);
-    auto [res, sub, reader] = dsrsub_graph_request.init(dsrparticipant.getParticipant(), dsrparticipant.getGraphRequestTopic(),
-                              dsrpub_graph_request_call, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getGraphRequestTopic()->get_name(), {sub, reader});
-
+    subscribe(dsrsub_graph_request, TopicId::GRAPH_REQUEST, dsrpub_graph_request_call);
 }
 
 std::pair<bool, bool> DSRGraph::fullgraph_request_thread()
 {
     bool sync = false;
     bool repeated = false;
-    auto lambda_request_answer = [&](eprosima::fastdds::dds::DataReader *reader, DSR::DSRGraph *graph)
+    std::mutex sync_mutex;
+    std::condition_variable sync_cv;
+    std::future<void> joined;
+    auto lambda_request_answer = [&](DSR::TransportSample &&s, DSR::DSRGraph *graph)
     {
-        while (true)
+        auto &sample = std::get<IDL::OrMap>(s);
+        if (sample.id() == graph->get_agent_id()) return;
+
+        std::unique_lock<std::mutex> lck(sync_mutex);
+        if (sync) return;
+        if (sample.id() != static_cast<uint32_t>(-1)) {
+            qDebug() << " Received Full Graph from " << sample.id() << " whith "
+                    << sample.m().size() << " elements";
+            joined = tp.spawn_task_waitable([this, sample = std::move(sample)]() mutable {
+                join_full_graph(std::move(sample));
+            });
+            qDebug() << "Synchronized.";
+            sync = true;
+            sync_cv.notify_all();
+        }
+        else if (sample.to_id() == agent_id)
         {
-            eprosima::fastdds::dds::SampleInfo m_info;
-            IDL::OrMap sample;
-            if (reader->take_next_sample(&sample, &m_info) == 0) {
-                if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
-                        m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE && 
-                        m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE 
-                    )
-                {
-                    if (sample.id() != graph->get_agent_id()) {
-                        if (sample.id() != static_cast<uint32_t>(-1)) {
-                            qDebug() << " Received Full Graph from " << m_info.sample_identity.writer_guid().entityId.value
-                                    << " whith "
-                                    << sample.m().size() << " elements";
-                            tp.spawn_task(&DSRGraph::join_full_graph, this, std::move(sample));
-                            qDebug() << "Synchronized.";
-                            sync = true;
-                            break;
-                        }
-                        else if (!sync && sample.to_id() == agent_id)
-                        {
-                            repeated = true;
-                        }
-                    }
-                }
-            } else {
-                break;
-            }
+            repeated = true;
+            sync_cv.notify_all();
         }
     };
 
     dsrpub_request_answer_call = NewMessageFunctor(this, lambda_request_answer);
-    auto [res, sub, reader] = dsrsub_request_answer.init(dsrparticipant.getParticipant(), dsrparticipant.getGraphTopic(),
-                               dsrpub_request_answer_call, mtx_entity_creation);
-    dsrparticipant.add_subscriber(dsrparticipant.getGraphTopic()->get_name(), {sub, reader});
+    subscribe(dsrsub_request_answer, TopicId::GRAPH_ANSWER, dsrpub_request_answer_call);
 
-    std::this_thread::sleep_for(300ms);   // NEEDED ?
+    // DDS needs some time to match the endpoints, a transport is ready as soon as it subscribes.
+    if (!transport) std::this_thread::sleep_for(300ms);   // NEEDED ?
 
     qDebug() << " Requesting the complete graph ";
 
     IDL::GraphRequest gr;
-    gr.from( dsrparticipant.getParticipant()->get_qos().name().to_string());
+    gr.from(participant_name());
     gr.id(agent_id);
     dsrpub_graph_request.write(&gr);
 
 
     bool timeout = false;
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
-    while (!sync and !timeout and !repeated) {
-        std::this_thread::sleep_for(1000ms);
+    std::unique_lock<std::mutex> lck(sync_mutex);
+    while (!timeout) {
+        if (sync_cv.wait_for(lck, 1000ms, [&] { return sync or repeated; })) break;
         std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
         timeout = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() > TIMEOUT * 3;
         qInfo() << " Waiting for the graph ... seconds to timeout ["
                 << std::ceil(std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() / 10) / 100.0
                 << "/" << TIMEOUT / 1000 * 3 << "] ";
+        lck.unlock();
         dsrpub_graph_request.write(&gr);
+        lck.lock();
     }
+    lck.unlock();
 
-    dsrparticipant.delete_publisher(dsrparticipant.getGraphRequestTopic()->get_name());
-    dsrparticipant.delete_subscriber(dsrparticipant.getGraphTopic()->get_name());
+    if (transport) transport->unsubscribe(TopicId::GRAPH_ANSWER);
+    else
+    {
+        dsrparticipant.delete_publisher(dsrparticipant.getGraphRequestTopic()->get_name());
+        dsrparticipant.delete_subscriber(dsrparticipant.getGraphTopic()->get_name());
+    }
 
+    // The graph is complete when the constructor returns.
+    if (joined.valid()) joined.wait();
     return { sync, repeated };
 }
 
@@ -1878,6 +2170,7 @@ DSRGraph::DSRGraph(const DSRGraph &G) : agent_id(G.agent_id), copy(true), tp(1),
     edges = G.edges;
     edgeType = G.edgeType;
     nodeType = G.nodeType;
+    attr_indices = G.attr_indices;
     same_host = G.same_host;
 }
 
@@ -0,0 +1,130 @@
+#include <dsr/api/dsr_attr_index.h>
+#include <limits>
+
+using namespace DSR;
+
+namespace
+{
+    // Smallest value of the alternative of v, the ordered index keeps each alternative together.
+    IndexValue lowest_of(const IndexValue &v)
+    {
+        switch (v.index())
+        {
+            case 0: return false;
+            case 1: return -std::numeric_limits<double>::infinity();
+            case 2: return uint64_t{0};
+            default: return std::string();
+        }
+    }
+
+    // Any value of the alternative that follows alt.
+    IndexValue next_alternative(std::size_t alt)
+    {
+        switch (alt)
+        {
+            case 0: return 0.0;
+            case 1: return uint64_t{0};
+            default: return std::string();
+        }
+    }
+}
+
+
+std::optional<IndexValue> DSR::index_value(const ValType &v)
+{
+    switch (v.index())
+    {
+        case 0: return std::get<std::string>(v);
+        case 1: return static_cast<double>(std::get<int32_t>(v));
+        case 2:
+        {
+            const float f = std::get<float>(v);
+            if (std::isnan(f)) return {};
+            return static_cast<double>(f);
+        }
+        case 4: return std::get<bool>(v);
+        case 6: return static_cast<double>(std::get<uint32_t>(v));
+        case 7: return std::get<uint64_t>(v);
+        case 8:
+        {
+            const double d = std::get<double>(v);
+            if (std::isnan(d)) return {};
+            return d;
+        }
+        default: return {};
+    }
+}
+
+bool AttrPredicate::operator()(const IndexValue &v) const
+{
+    if (v.index() != a.index()) return false;
+    switch (op)
+    {
+        case Op::EQ: return v == a;
+        case Op::LT: return v < a;
+        case Op::LE: return v <= a;
+        case Op::GT: return v > a;
+        case Op::GE: return v >= a;
+        case Op::RANGE: return v >= a and v < b;
+    }
+    return false;
+}
+
+void AttributeIndex::set(uint64_t id, const std::optional<IndexValue> &v)
+{
+    auto it = values.find(id);
+    if (it != values.end())
+    {
+        if (v.has_value() and it->second == v.value()) return;
+        if (kind == IndexKind::HASH)
+        {
+            auto h = hashed.find(it->second);
+            h->second.erase(id);
+            if (h->second.empty()) hashed.erase(h);
+        }
+        else ordered.erase({it->second, id});
+        if (not v.has_value())
+        {
+            values.erase(it);
+            return;
+        }
+        it->second = v.value();
+    }
+    else if (not v.has_value()) return;
+    else values.emplace(id, v.value());
+
+    if (kind == IndexKind::HASH) hashed[v.value()].insert(id);
+    else ordered.emplace(v.value(), id);
+}
+
+bool AttributeIndex::find(const AttrPredicate &pred, std::vector<uint64_t> &out) const
+{
+    using Op = AttrPredicate::Op;
+    if (kind == IndexKind::HASH)
+    {
+        if (pred.op != Op::EQ) return false;
+        if (auto h = hashed.find(pred.a); h != hashed.end())
+            out.insert(out.end(), h->second.begin(), h->second.end());
+        return true;
+    }
+
+    if (pred.op == Op::RANGE and (pred.b.index() != pred.a.index() or not (pred.a < pred.b))) return true;
+    // The pairs of each alternative are contiguous, [group_begin, group_end) holds the ones of the bound.
+    const auto alt = pred.a.index();
+    auto group_begin = ordered.lower_bound({lowest_of(pred.a), 0});
+    auto group_end = alt + 1 < std::variant_size_v<IndexValue> ? ordered.lower_bound({lowest_of(next_alternative(alt)), 0}) : ordered.end();
+
+    constexpr uint64_t MAX_ID = std::numeric_limits<uint64_t>::max();
+    auto first = group_begin, last = group_end;
+    switch (pred.op)
+    {
+        case Op::EQ:    first = ordered.lower_bound({pred.a, 0}); last = ordered.upper_bound({pred.a, MAX_ID}); break;
+        case Op::LT:    last = ordered.lower_bound({pred.a, 0}); break;
+        case Op::LE:    last = ordered.upper_bound({pred.a, MAX_ID}); break;
+        case Op::GT:    first = ordered.upper_bound({pred.a, MAX_ID}); break;
+        case Op::GE:    first = ordered.lower_bound({pred.a, 0}); break;
+        case Op::RANGE: first = ordered.lower_bound({pred.a, 0}); last = ordered.lower_bound({pred.b, 0}); break;
+    }
+    for (auto it = first; it != last; ++it) out.emplace_back(it->second);
+    return true;
+}
@@ -129,27 +129,10 @@ std::optional<std::vector<uint8_t>> CameraAPI::get_rgb_image()
 
 std::optional<std::vector<float>> CameraAPI::get_depth_image()
 {
-    if( const auto n = G->get_node(id); n.has_value())
-    {
-        auto &attrs = n.value().attrs();
-        if (auto value = attrs.find("cam_depth"); value != attrs.end())
-        {
-            const std::size_t SIZE = value->second.byte_vec().size() / sizeof(float);
-            float *depth_array = (float *) value->second.byte_vec().data();
-            std::vector<float> res{depth_array, depth_array + SIZE};
-            return res;
-        } else
-        {
-            qWarning() << __FUNCTION__ << "No depth attribute found in node " << QString::fromStdString(n.value().name())
-                       << ". Returning empty";
-            return {};
-        }
-    }
-    else
-    {
-        qWarning() << __FUNCTION__ << "No camera node found in G. Returning empty";
-        return {};
-    }
+    auto view = get_depth_view();
+    if (not view.has_value()) return {};
+    const auto depth = view->pixels<float>();
+    return std::vector<float>{depth.begin(), depth.end()};
 }
 
 //std::optional<std::vector<float>> CameraAPI::get_existing_depth_image()
@@ -396,56 +379,76 @@ std::optional<std::vector<std::tuple<float,float,float>>>  CameraAPI::get_pointc
 //    }
 //}
 
+std::optional<ImageView> CameraAPI::get_rgb_view() const
+{
+    auto view = ImageView::rgb(G, id);
+    if (not view.has_value())
+        qWarning() << __FUNCTION__ << "No camera node or valid rgb attributes found in G. Returning empty";
+    return view;
+}
+
+std::optional<ImageView> CameraAPI::get_depth_view() const
+{
+    auto view = ImageView::depth(G, id);
+    if (not view.has_value())
+        qWarning() << __FUNCTION__ << "No camera node or valid depth attributes found in G. Returning empty";
+    return view;
+}
+
 std::optional<std::vector<uint8_t>> CameraAPI::get_depth_as_gray_image() const
 {
-    if( const auto n = G->get_node(id); n.has_value())
-    {
-        auto &attrs = n.value().attrs();
-        if (auto value = attrs.find("cam_depth"); value != attrs.end())
-        {
-            const std::vector<uint8_t> &tmp = value->second.byte_vec();
-            float *depth_array = (float *) value->second.byte_vec().data();
-            const auto STEP = sizeof(float);
-            std::vector<std::uint8_t> gray_image(tmp.size() / STEP);
-            for (std::size_t i = 0; i < tmp.size() / STEP; i++)
-                gray_image[i] = (int) (depth_array[i] * 15);  // ONLY VALID FOR SHORT RANGE, INDOOR SCENES
-            return gray_image;
-        } else
-        {
-            qWarning() << __FUNCTION__ << "No depth attribute found in node " << QString::fromStdString(n.value().name())
-                       << ". Returning empty";
-            return {};
-        };
-    }
-    else
-    {
-        qWarning() << __FUNCTION__ << "No camera node found in G. Returning empty";
-        return {};
-    }
+    auto view = get_depth_view();
+    if (not view.has_value()) return {};
+    const auto *depth = view->pixels<float>().data();
+    const int w = view->width(), h = view->height();
+    std::vector<uint8_t> gray(static_cast<std::size_t>(w) * h);
+    DSR::depth::depth_to_gray(depth, w, h, 1, DSR::depth::depth_range(depth, w, h), gray.data(), w);
+    return gray;
+}
+
+std::optional<std::vector<float>> CameraAPI::get_depth_decimated(int block) const
+{
+    auto view = get_depth_view();
+    if (not view.has_value()) return {};
+    const int w = view->width(), h = view->height();
+    block = std::clamp(block, 1, 16);
+    std::vector<float> res(static_cast<std::size_t>(w / block) * (h / block));
+    DSR::depth::decimate_median(view->pixels<float>().data(), w, h, block, res.data());
+    return res;
+}
+
+std::optional<DSR::depth::RoiStats> CameraAPI::get_roi_depth_stats(const Eigen::AlignedBox<float, 2> &roi) const
+{
+    auto view = get_depth_view();
+    if (not view.has_value()) return {};
+    return DSR::depth::roi_stats(view->pixels<float>().data(), view->width(), view->height(),
+                                 (int)roi.min().x(), (int)roi.min().y(), (int)roi.max().x(), (int)roi.max().y());
+}
+
+std::optional<std::vector<float>> CameraAPI::get_depth_normals() const
+{
+    auto view = get_depth_view();
+    if (not view.has_value()) return {};
+    const int w = view->width(), h = view->height();
+    std::vector<float> res(static_cast<std::size_t>(w) * h * 3);
+    DSR::depth::normals(view->pixels<float>().data(), w, h, focal_x, focal_y, w / 2.f, h / 2.f, res.data());
+    return res;
 }
 
 std::optional<std::tuple<float,float,float>> CameraAPI::get_roi_depth(const std::vector<float> &depth, const Eigen::AlignedBox<float, 2> &roi)
 {
     auto left = (int)roi.min().x(); auto bot = (int)roi.min().y();
     auto right = (int)roi.max().x(); auto top = (int)roi.max().y();  // botom has higher numeric value. rows start in 0 up
-    if(left<right and bot>top)
+    if(left<right and bot>top and depth.size() >= static_cast<std::size_t>(width) * height)
     {
-        
-        auto size = (right - left) * (bot - top);
-        std::vector<float> values(size);
-        std::size_t k = 0;
-        for (int i = top; i < bot; i++)
-            for (int j = left; j < right; j++)
-                values[k++] = depth[i * width + j];
-
-        //auto mv = std::ranges::min(values);
-        //std::nth_element(values.begin(), values.begin() + values.size()/2, values.end());
-        std::sort(values.begin(), values.end());
-        // const int px = (left + right) / 2;
-        // const int py = (top + bot) / 2;
-        // const auto mv = depth[py * width + px];
-        const auto mv = values[values.size()/2];  //median
-        const auto Y = mv * 1000;
+        // median of the valid pixels
+        const auto stats = DSR::depth::roi_stats(depth.data(), width, height, left, top, right, bot);
+        if (not stats.has_value())
+        {
+            qWarning() << __FUNCTION__ << "No valid depth values in the ROI. Returning empty";
+            return {};
+        }
+        const auto Y = stats->median * 1000;
         const float cols = left + (right - left) / 2;
         const float rows = top + (bot - top) / 2;
         float X = (cols - this->width/2) * Y / this->focal_x;
@@ -457,4 +460,4 @@ std::optional<std::tuple<float,float,float>> CameraAPI::get_roi_depth(const std:
         qWarning() << __FUNCTION__ << "Incorrect ROI dimensions l r t b: " << left << right << top << bot << ". Returning empty";
         return {};
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,229 @@
+//
+// Kernels over float depth images.
+//
+
+#include <dsr/api/dsr_depth_utils.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace DSR::depth;
+
+namespace
+{
+    // NaN compares false, inf is discarded by the upper bound.
+    inline bool is_valid(float d)
+    {
+        return d > 0.f and d < std::numeric_limits<float>::max();
+    }
+}
+
+
+DepthRange DSR::depth::depth_range(const float *depth, int width, int height, int step)
+{
+    step = std::max(step, 1);
+    float mn = std::numeric_limits<float>::max();
+    float mx = 0.f;
+    for (int y = 0; y < height; y += step)
+    {
+        const float *row = depth + static_cast<std::size_t>(y) * width;
+        for (int x = 0; x < width; x += step)
+        {
+            const float d = row[x];
+            const bool valid = is_valid(d);
+            mn = valid and d < mn ? d : mn;
+            mx = valid and d > mx ? d : mx;
+        }
+    }
+    if (mx == 0.f) return {};
+    return {mn, mx};
+}
+
+void DSR::depth::depth_to_gray(const float *depth, int width, int height, int step, DepthRange range,
+                               uint8_t *out, std::size_t out_stride)
+{
+    step = std::max(step, 1);
+    const int out_w = width / step;
+    const int out_h = height / step;
+    const float mn = range.min;
+    const float scale = range.valid() ? 255.f / (range.max - range.min) : 0.f;
+
+    for (int y = 0; y < out_h; y++)
+    {
+        const float *__restrict src = depth + static_cast<std::size_t>(y) * step * width;
+        uint8_t *__restrict dst = out + static_cast<std::size_t>(y) * out_stride;
+        if (step == 1)
+        {
+            for (int x = 0; x < out_w; x++)
+            {
+                const float d = src[x];
+                float v = (d - mn) * scale;
+                v = std::clamp(v, 0.f, 255.f);
+                dst[x] = is_valid(d) ? static_cast<uint8_t>(v) : 0;
+            }
+        }
+        else
+        {
+            for (int x = 0; x < out_w; x++)
+            {
+                const float d = src[x * step];
+                float v = (d - mn) * scale;
+                v = std::clamp(v, 0.f, 255.f);
+                dst[x] = is_valid(d) ? static_cast<uint8_t>(v) : 0;
+            }
+        }
+    }
+}
+
+void DSR::depth::decimate_median(const float *depth, int width, int height, int block, float *out)
+{
+    block = std::clamp(block, 1, 16);
+    const int out_w = width / block;
+    const int out_h = height / block;
+    std::array<float, 16 * 16> tile{};
+
+    if (block == 2)
+    {
+        // Sorting network over the 2x2 tile with the invalid values pushed to the end as +inf.
+        constexpr float INF = std::numeric_limits<float>::infinity();
+        for (int y = 0; y < out_h; y++)
+        {
+            const float *__restrict top = depth + static_cast<std::size_t>(2 * y) * width;
+            const float *__restrict bot = top + width;
+            float *__restrict dst = out + static_cast<std::size_t>(y) * out_w;
+            for (int x = 0; x < out_w; x++)
+            {
+                float v[4] = {top[2 * x], top[2 * x + 1], bot[2 * x], bot[2 * x + 1]};
+                int n = 0;
+                for (auto &d : v)
+                {
+                    n += is_valid(d);
+                    d = is_valid(d) ? d : INF;
+                }
+                auto cswap = [](float &a, float &b) { const float t = std::min(a, b); b = std::max(a, b); a = t; };
+                cswap(v[0], v[1]); cswap(v[2], v[3]); cswap(v[0], v[2]); cswap(v[1], v[3]); cswap(v[1], v[2]);
+                const float m = n >= 2 ? (n >= 4 ? v[2] : v[1]) : v[0];
+                dst[x] = n > 0 ? m : 0.f;
+            }
+        }
+        return;
+    }
+
+    for (int y = 0; y < out_h; y++)
+    {
+        float *__restrict dst = out + static_cast<std::size_t>(y) * out_w;
+        for (int x = 0; x < out_w; x++)
+        {
+            // Valid values are packed at the front of the tile without branching.
+            std::size_t n = 0;
+            for (int by = 0; by < block; by++)
+            {
+                const float *src = depth + static_cast<std::size_t>(y * block + by) * width + x * block;
+                for (int bx = 0; bx < block; bx++)
+                {
+                    const float d = src[bx];
+                    tile[n] = d;
+                    n += is_valid(d);
+                }
+            }
+            if (n == 0)
+            {
+                dst[x] = 0.f;
+                continue;
+            }
+            std::nth_element(tile.begin(), tile.begin() + n / 2, tile.begin() + n);
+            dst[x] = tile[n / 2];
+        }
+    }
+}
+
+std::optional<RoiStats> DSR::depth::roi_stats(const float *depth, int width, int height, int x0, int y0, int x1, int y1)
+{
+    x0 = std::clamp(x0, 0, width);  x1 = std::clamp(x1, 0, width);
+    y0 = std::clamp(y0, 0, height); y1 = std::clamp(y1, 0, height);
+    if (x0 >= x1 or y0 >= y1) return {};
+
+    // First pass without branches for the sum, min and count, second one packs the valid values for the median.
+    double sum = 0.0;
+    float mn = std::numeric_limits<float>::max();
+    std::size_t count = 0;
+    for (int y = y0; y < y1; y++)
+    {
+        const float *__restrict row = depth + static_cast<std::size_t>(y) * width;
+        float row_sum = 0.f;
+        for (int x = x0; x < x1; x++)
+        {
+            const float d = row[x];
+            const bool valid = is_valid(d);
+            row_sum += valid ? d : 0.f;
+            mn = valid and d < mn ? d : mn;
+            count += valid;
+        }
+        sum += row_sum;
+    }
+    if (count == 0) return {};
+
+    std::vector<float> values(count);
+    std::size_t k = 0;
+    for (int y = y0; y < y1; y++)
+    {
+        const float *row = depth + static_cast<std::size_t>(y) * width;
+        for (int x = x0; x < x1 and k < count; x++)
+        {
+            values[k] = row[x];
+            k += is_valid(row[x]);
+        }
+    }
+    std::nth_element(values.begin(), values.begin() + count / 2, values.end());
+    return RoiStats{static_cast<float>(sum / count), values[count / 2], mn, count};
+}
+
+void DSR::depth::normals(const float *depth, int width, int height, float focal_x, float focal_y,
+                         float centre_x, float centre_y, float *out)
+{
+    std::fill_n(out, static_cast<std::size_t>(width) * height * 3, 0.f);
+    if (width < 3 or height < 3 or focal_x == 0.f or focal_y == 0.f) return;
+    const float inv_fx = 1.f / focal_x;
+    const float inv_fy = 1.f / focal_y;
+
+    for (int y = 1; y < height - 1; y++)
+    {
+        const float *__restrict up = depth + static_cast<std::size_t>(y - 1) * width;
+        const float *__restrict row = depth + static_cast<std::size_t>(y) * width;
+        const float *__restrict down = depth + static_cast<std::size_t>(y + 1) * width;
+        float *__restrict dst = out + static_cast<std::size_t>(y) * width * 3;
+        // Image rows grow downwards and Z grows upwards.
+        const float z_up = (centre_y - (y - 1)) * inv_fy;
+        const float z_row = (centre_y - y) * inv_fy;
+        const float z_down = (centre_y - (y + 1)) * inv_fy;
+
+        for (int x = 1; x < width - 1; x++)
+        {
+            const bool valid = is_valid(row[x - 1]) and is_valid(row[x + 1]) and is_valid(up[x]) and is_valid(down[x]);
+            // Invalid neighbours are zeroed so NaN does not leak into the masked result.
+            const float dl = valid ? row[x - 1] : 0.f, dr = valid ? row[x + 1] : 0.f;
+            const float du = valid ? up[x] : 0.f, dd = valid ? down[x] : 0.f;
+            const float x_row = (x - centre_x) * inv_fx;
+
+            // Horizontal difference, left to right.
+            const float ax = (x_row + inv_fx) * dr - (x_row - inv_fx) * dl;
+            const float ay = dr - dl;
+            const float az = z_row * (dr - dl);
+            // Vertical difference, bottom to top.
+            const float bx = x_row * (du - dd);
+            const float by = du - dd;
+            const float bz = z_up * du - z_down * dd;
+
+            const float nx = ay * bz - az * by;
+            const float ny = az * bx - ax * bz;
+            const float nz = ax * by - ay * bx;
+            const float norm2 = nx * nx + ny * ny + nz * nz;
+            const float inv = norm2 > 0.f ? 1.f / std::sqrt(norm2) : 0.f;
+            dst[3 * x] = nx * inv;
+            dst[3 * x + 1] = ny * inv;
+            dst[3 * x + 2] = nz * inv;
+        }
+    }
+}
@@ -40,4 +40,8 @@ std::vector<std::tuple<float, float, float>> geometry_queries_api::get_geom_bbox
 std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>> geometry_queries_api::get_geom_vertices_and_indices(const std::string& geom)
 {
     return m_geom_info->getQtGeom(geom).value_or(std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short> >({}, {}));
-}
\ No newline at end of file
+}
+GeomInfo::MeshPtr geometry_queries_api::get_geom_mesh(const std::string& geom)
+{
+    return m_geom_info->getQtMesh(geom);
+}
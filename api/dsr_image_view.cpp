@@ -0,0 +1,87 @@
+#include <dsr/api/dsr_image_view.h>
+#include <dsr/api/dsr_api.h>
+
+using namespace DSR;
+
+namespace
+{
+    const CRDTAttribute *find_attr(const CRDTNode &node, std::string_view name)
+    {
+        auto it = node.attrs().find(std::string(name));
+        if (it == node.attrs().end() or it->second.empty()) return nullptr;
+        return &it->second.read_reg();
+    }
+
+    std::optional<int> find_int(const CRDTNode &node, std::string_view name)
+    {
+        auto att = find_attr(node, name);
+        if (att == nullptr) return {};
+        if (auto v = std::get_if<int32_t>(&att->value())) return *v;
+        return {};
+    }
+}
+
+
+std::optional<ImageView> ImageView::rgb(DSRGraph *G, uint64_t id)
+{
+    return read(G, id, false);
+}
+
+std::optional<ImageView> ImageView::depth(DSRGraph *G, uint64_t id)
+{
+    return read(G, id, true);
+}
+
+std::optional<ImageView> ImageView::read(DSRGraph *G, uint64_t id, bool depth)
+{
+    ImageView view;
+    view.lock = std::shared_lock<std::shared_mutex>(G->_mutex);
+    auto it = G->nodes.find(id);
+    if (it == G->nodes.end() or it->second.empty()) return {};
+    const CRDTNode &node = it->second.read_reg();
+
+    const auto *image = find_attr(node, depth ? cam_depth_str : cam_rgb_str);
+    const auto width = find_int(node, depth ? cam_depth_width_str : cam_rgb_width_str);
+    const auto height = find_int(node, depth ? cam_depth_height_str : cam_rgb_height_str);
+    if (image == nullptr or not width.has_value() or not height.has_value() or *width <= 0 or *height <= 0) return {};
+    const auto *bytes = std::get_if<std::vector<uint8_t>>(&image->value());
+    if (bytes == nullptr) return {};
+
+    if (depth) view.fmt = PixelFormat::DEPTH32F;
+    else
+    {
+        // cam_rgb_depth is the number of channels, 3 when it is not set
+        const auto channels = find_int(node, cam_rgb_depth_str).value_or(3);
+        if (channels != 1 and channels != 3) return {};
+        view.fmt = channels == 1 ? PixelFormat::GRAY8 : PixelFormat::RGB8;
+    }
+    view.w = *width;
+    view.h = *height;
+    view.row_bytes = static_cast<std::size_t>(view.w) * view.bytes_per_pixel();
+    const std::size_t size = view.row_bytes * view.h;
+    if (bytes->size() < size) return {};
+    view.data = std::span<const uint8_t>(bytes->data(), size);
+    view.ts = image->timestamp();
+    return view;
+}
+
+void ImageView::release()
+{
+    data = {};
+    owned.reset();
+    if (lock.owns_lock()) lock.unlock();
+}
+
+ImageView ImageView::copy() const
+{
+    ImageView view;
+    auto bytes = std::make_shared<const std::vector<uint8_t>>(data.begin(), data.end());
+    view.data = std::span<const uint8_t>(bytes->data(), bytes->size());
+    view.owned = std::move(bytes);
+    view.w = w;
+    view.h = h;
+    view.row_bytes = row_bytes;
+    view.fmt = fmt;
+    view.ts = ts;
+    return view;
+}
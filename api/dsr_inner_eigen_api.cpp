@@ -1,5 +1,6 @@
 #include <dsr/api/dsr_inner_eigen_api.h>
 #include <dsr/api/dsr_api.h>
+#include <limits>
 
 using namespace DSR;
 
@@ -9,9 +10,10 @@ InnerEigenAPI::InnerEigenAPI(DSR::DSRGraph *G_)
     G = G_;
     rt = G->get_rt_api();
     //update signals
-    connect(G, &DSR::DSRGraph::update_edge_signal, this, &InnerEigenAPI::add_or_assign_edge_slot, Qt::QueuedConnection);
-    connect(G, &DSR::DSRGraph::del_edge_signal, this, &InnerEigenAPI::del_edge_slot, Qt::QueuedConnection);
-    connect(G, &DSR::DSRGraph::del_node_signal, this, &InnerEigenAPI::del_node_slot, Qt::QueuedConnection);
+    auto &cb = G->callbacks();
+    connections.add(cb.update_edge, executor, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { add_or_assign_edge_slot(from, to, type); });
+    connections.add(cb.del_edge, executor, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { del_edge_slot(from, to, type); });
+    connections.add(cb.del_node, executor, [this](uint64_t id, const SignalInfo &) { del_node_slot(id); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -216,6 +218,153 @@ std::optional<Mat::Vector6d> InnerEigenAPI::transform_axis( const std::string &d
 	return transform_axis(dest, Mat::Vector6d::Zero(), orig, timestamp);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+////// BATCHED
+////////////////////////////////////////////////////////////////////////////////////////
+const InnerEigenAPI::Frame &InnerEigenAPI::get_frame_(uint64_t id, std::uint64_t timestamp, FrameMap &frames)
+{
+    if (auto it = frames.find(id); it != frames.end())
+        return it->second;
+
+    // Go up until a known frame or the top of the tree, then compose the poses on the way down.
+    std::vector<std::pair<uint64_t, uint64_t>> chain;   // (node, parent)
+    Frame base {Mat::RTMat::Identity(), id, true};
+    uint64_t current = id;
+    while (true)
+    {
+        auto node_it = G->nodes.find(current);
+        if (node_it == G->nodes.end() or chain.size() > G->nodes.size())
+        {
+            base = Frame{Mat::RTMat::Identity(), current, false};
+            frames.emplace(current, base);
+            break;
+        }
+        auto parent = G->get_crdt_attrib_by_name<parent_att>(node_it->second.read_reg());
+        if (not parent.has_value())
+        {
+            base = Frame{Mat::RTMat::Identity(), current, true};
+            frames.emplace(current, base);
+            break;
+        }
+        chain.emplace_back(current, parent.value());
+        if (auto it = frames.find(parent.value()); it != frames.end())
+        {
+            base = it->second;
+            break;
+        }
+        current = parent.value();
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    {
+        const auto [child, parent] = *it;
+        Frame f {Mat::RTMat::Identity(), base.top, false};
+        if (base.valid)
+        {
+            const auto &fano = G->nodes.at(parent).read_reg().fano();
+            if (auto edge = fano.find({child, "RT"}); edge != fano.end())
+            {
+                if (auto local = rt->get_edge_RT_as_rtmat(edge->second.read_reg(), timestamp); local.has_value())
+                    f = Frame{base.pose * local.value(), base.top, true};
+            }
+        }
+        base = frames.insert_or_assign(child, f).first->second;
+    }
+    return frames.at(id);
+}
+
+Mat::Vector6d InnerEigenAPI::to_pose_vector(const Mat::RTMat &m)
+{
+    Mat::Vector6d v;
+    v << m.translation(), m.rotation().eulerAngles(0,1,2);
+    return v;
+}
+
+std::optional<Mat::Matrix3Xd> InnerEigenAPI::transform(const std::string &dest, const Mat::Matrix3Xd &points, const std::string &orig, std::uint64_t timestamp)
+{
+    Mat::RTMat tm;
+    {
+        std::shared_lock<std::shared_mutex> lock(G->_mutex);
+        auto dest_id = G->get_id_from_name(dest);
+        auto orig_id = G->get_id_from_name(orig);
+        if (not dest_id.has_value() or not orig_id.has_value())
+        {
+            qWarning() << __FUNCTION__ << ":" << __LINE__ << " origen or dest nodes do not exist: " << QString::fromStdString(orig) << QString::fromStdString(dest);
+            return {};
+        }
+        FrameMap frames;
+        const Frame d = get_frame_(dest_id.value(), timestamp, frames);
+        const Frame &o = get_frame_(orig_id.value(), timestamp, frames);
+        if (not d.valid or not o.valid or d.top != o.top)
+        {
+            qWarning() << __FUNCTION__ << ":" << __LINE__ << " No RT path between " << QString::fromStdString(orig) << " and " << QString::fromStdString(dest);
+            return {};
+        }
+        tm = d.pose.inverse() * o.pose;
+    }
+    return tm * points;
+}
+
+std::optional<Mat::Matrix6Xd> InnerEigenAPI::get_poses(const std::string &dest, const std::vector<uint64_t> &nodes, std::uint64_t timestamp)
+{
+    std::shared_lock<std::shared_mutex> lock(G->_mutex);
+    auto dest_id = G->get_id_from_name(dest);
+    if (not dest_id.has_value())
+    {
+        qWarning() << __FUNCTION__ << ":" << __LINE__ << " dest node does not exist: " << QString::fromStdString(dest);
+        return {};
+    }
+    FrameMap frames;
+    frames.reserve(nodes.size() * 2);
+    const Frame d = get_frame_(dest_id.value(), timestamp, frames);
+    if (not d.valid)
+        return {};
+    const Mat::RTMat inv = d.pose.inverse();
+
+    Mat::Matrix6Xd ret(6, nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const Frame &f = get_frame_(nodes[i], timestamp, frames);
+        if (f.valid and f.top == d.top)
+            ret.col(i) = to_pose_vector(inv * f.pose);
+        else
+            ret.col(i).setConstant(std::numeric_limits<double>::quiet_NaN());
+    }
+    return ret;
+}
+
+std::pair<std::vector<uint64_t>, Mat::Matrix6Xd> InnerEigenAPI::get_world_poses(const std::string &type, std::uint64_t timestamp)
+{
+    std::shared_lock<std::shared_mutex> lock(G->_mutex);
+    auto root_id = G->get_id_from_name("root");
+    std::vector<uint64_t> candidates;
+    {
+        std::shared_lock<std::shared_mutex> lock_cache(G->_mutex_cache_maps);
+        if (auto it = G->nodeType.find(name_id(type)); it != G->nodeType.end())
+            for (auto id : it->second)
+                if (auto n = G->nodes.find(id); n != G->nodes.end() and not n->second.empty() and n->second.read_reg().type() == type)
+                    candidates.emplace_back(id);
+    }
+    if (not root_id.has_value() or candidates.empty())
+        return {};
+
+    FrameMap frames;
+    frames.reserve(candidates.size() * 2);
+    std::vector<uint64_t> ids;
+    ids.reserve(candidates.size());
+    Mat::Matrix6Xd poses(6, candidates.size());
+    for (auto id : candidates)
+    {
+        const Frame &f = get_frame_(id, timestamp, frames);
+        if (not f.valid or f.top != root_id.value())
+            continue;
+        poses.col(ids.size()) = to_pose_vector(f.pose);
+        ids.emplace_back(id);
+    }
+    poses.conservativeResize(Eigen::NoChange, ids.size());
+    return {std::move(ids), std::move(poses)};
+}
+
 ////////////////////////////////////////////////////////////////////////
 /// SLOTS ==> used to remove cached transforms when node/edge changes
 ///////////////////////////////////////////////////////////////////////
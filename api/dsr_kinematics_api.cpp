@@ -0,0 +1,275 @@
+#include <dsr/api/dsr_kinematics_api.h>
+#include <dsr/api/dsr_api.h>
+#include <algorithm>
+
+using namespace DSR;
+
+
+KinematicsAPI::KinematicsAPI(DSR::DSRGraph *G_)
+{
+    G = G_;
+    rt = G->get_rt_api();
+    rebuild();
+    // Direct connections, the slots only lock this object and read one edge from G.
+    auto &cb = G->callbacks();
+    connections.add(cb.update_node, [this](uint64_t id, const std::string &type, const SignalInfo &) { add_or_assign_node_slot(id, type); });
+    connections.add(cb.update_edge, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { add_or_assign_edge_slot(from, to, type); });
+    connections.add(cb.del_edge, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { del_edge_slot(from, to, type); });
+    connections.add(cb.del_node, [this](uint64_t id, const SignalInfo &) { del_node_slot(id); });
+}
+
+void KinematicsAPI::rebuild()
+{
+    std::vector<uint64_t> roots;
+    std::vector<std::tuple<uint64_t, uint64_t, Eigen::Isometry3d>> edges;
+    {
+        std::shared_lock<std::shared_mutex> lock(G->_mutex);
+        for (const auto &[id, reg] : G->nodes)
+        {
+            const auto &node = reg.read_reg();
+            if (node.type() == "root") roots.emplace_back(id);
+            for (const auto &[key, edge] : node.fano())
+            {
+                if (key.second != "RT") continue;
+                auto m = rt->get_edge_RT_as_rtmat(edge.read_reg());
+                edges.emplace_back(id, key.first, Eigen::Isometry3d(m.value_or(Mat::RTMat::Identity()).matrix()));
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    slot_of.clear(); ids.clear(); parents.clear(); children.clear();
+    local.clear(); world.clear(); dirty.clear(); valid.clear(); is_root.clear(); free_slots.clear();
+    for (auto id : roots)
+        get_or_create_slot(id, true);
+    for (const auto &[from, to, pose] : edges)
+    {
+        auto p = get_or_create_slot(from, false);
+        auto c = get_or_create_slot(to, false);
+        local[c] = pose;
+        set_parent(c, p);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////// QUERIES
+////////////////////////////////////////////////////////////////////////////////////////
+
+std::optional<Eigen::Isometry3d> KinematicsAPI::world_pose(uint64_t id)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = slot_of.find(id);
+        if (it == slot_of.end()) return {};
+        if (not dirty[it->second])
+            return valid[it->second] ? std::make_optional(world[it->second]) : std::nullopt;
+    }
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto it = slot_of.find(id);
+    if (it == slot_of.end()) return {};
+    refresh(it->second);
+    return valid[it->second] ? std::make_optional(world[it->second]) : std::nullopt;
+}
+
+std::optional<Eigen::Isometry3d> KinematicsAPI::local_pose(uint64_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto it = slot_of.find(id);
+    if (it == slot_of.end() or parents[it->second] == NONE) return {};
+    return local[it->second];
+}
+
+std::optional<Eigen::Isometry3d> KinematicsAPI::relative_pose(uint64_t dest, uint64_t orig)
+{
+    auto compose = [&](uint32_t d, uint32_t o) -> std::optional<Eigen::Isometry3d> {
+        if (not valid[d] or not valid[o]) return {};
+        return world[d].inverse() * world[o];
+    };
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto d = slot_of.find(dest), o = slot_of.find(orig);
+        if (d == slot_of.end() or o == slot_of.end()) return {};
+        if (not dirty[d->second] and not dirty[o->second])
+            return compose(d->second, o->second);
+    }
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto d = slot_of.find(dest), o = slot_of.find(orig);
+    if (d == slot_of.end() or o == slot_of.end()) return {};
+    refresh(d->second);
+    refresh(o->second);
+    return compose(d->second, o->second);
+}
+
+std::optional<uint64_t> KinematicsAPI::parent(uint64_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto it = slot_of.find(id);
+    if (it == slot_of.end() or parents[it->second] == NONE) return {};
+    return ids[parents[it->second]];
+}
+
+std::size_t KinematicsAPI::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return slot_of.size();
+}
+
+////////////////////////////////////////////////////////////////////////
+/// SLOTS
+///////////////////////////////////////////////////////////////////////
+
+void KinematicsAPI::add_or_assign_node_slot(uint64_t id, const std::string &type)
+{
+    if (type != "root") return;
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    get_or_create_slot(id, true);
+}
+
+void KinematicsAPI::add_or_assign_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type)
+{
+    if (edge_type != "RT") return;
+    auto edge = read_edge(from, to);
+    if (not edge.has_value()) return;
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto p = get_or_create_slot(from, edge->from_is_root);
+    auto c = get_or_create_slot(to, false);
+    local[c] = edge->local;
+    set_parent(c, p);
+    mark_dirty(c);
+}
+
+void KinematicsAPI::del_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type)
+{
+    if (edge_type != "RT") return;
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto p = slot_of.find(from), c = slot_of.find(to);
+    if (p == slot_of.end() or c == slot_of.end() or parents[c->second] != p->second) return;
+    set_parent(c->second, NONE);
+}
+
+void KinematicsAPI::del_node_slot(uint64_t id)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto it = slot_of.find(id);
+    if (it == slot_of.end()) return;
+    const uint32_t s = it->second;
+    set_parent(s, NONE);
+    for (auto c : std::vector<uint32_t>(children[s]))
+        set_parent(c, NONE);
+    slot_of.erase(it);
+    // A free slot is not connected and has nothing cached.
+    children[s].clear();
+    dirty[s] = 1; valid[s] = 0; is_root[s] = 0;
+    free_slots.emplace_back(s);
+}
+
+////////////////////////////////////////////////////////////////////////
+/// INTERNALS, called with mtx locked
+///////////////////////////////////////////////////////////////////////
+
+uint32_t KinematicsAPI::get_or_create_slot(uint64_t id, bool root)
+{
+    if (auto it = slot_of.find(id); it != slot_of.end())
+    {
+        if (root and not is_root[it->second])
+        {
+            is_root[it->second] = 1;
+            mark_dirty(it->second);
+        }
+        return it->second;
+    }
+    uint32_t s;
+    if (not free_slots.empty())
+    {
+        s = free_slots.back();
+        free_slots.pop_back();
+        ids[s] = id;
+        parents[s] = NONE;
+        children[s].clear();
+        local[s] = world[s] = Eigen::Isometry3d::Identity();
+        dirty[s] = 1; valid[s] = 0; is_root[s] = root;
+    }
+    else
+    {
+        s = static_cast<uint32_t>(ids.size());
+        ids.emplace_back(id);
+        parents.emplace_back(NONE);
+        children.emplace_back();
+        local.emplace_back(Eigen::Isometry3d::Identity());
+        world.emplace_back(Eigen::Isometry3d::Identity());
+        dirty.emplace_back(1); valid.emplace_back(0); is_root.emplace_back(root);
+    }
+    slot_of.emplace(id, s);
+    return s;
+}
+
+void KinematicsAPI::set_parent(uint32_t slot, uint32_t parent)
+{
+    const uint32_t old = parents[slot];
+    if (old == parent) return;
+    if (old != NONE)
+        std::erase(children[old], slot);
+    if (parent != NONE)
+        children[parent].emplace_back(slot);
+    parents[slot] = parent;
+    mark_dirty(slot);
+}
+
+void KinematicsAPI::mark_dirty(uint32_t slot)
+{
+    std::vector<uint32_t> stack{slot};
+    while (not stack.empty())
+    {
+        const uint32_t s = stack.back();
+        stack.pop_back();
+        if (dirty[s]) continue;     // its subtree is already dirty
+        dirty[s] = 1;
+        stack.insert(stack.end(), children[s].begin(), children[s].end());
+    }
+}
+
+void KinematicsAPI::refresh(uint32_t slot)
+{
+    if (not dirty[slot]) return;
+    // Dirty ancestors up to the first clean one, then the poses are composed on the way down.
+    std::vector<uint32_t> path;
+    for (uint32_t s = slot; s != NONE and dirty[s]; s = parents[s])
+    {
+        if (path.size() > ids.size())   // RT cycle
+        {
+            for (auto p : path) { valid[p] = 0; dirty[p] = 0; }
+            return;
+        }
+        path.emplace_back(s);
+    }
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        const uint32_t s = *it;
+        const uint32_t p = parents[s];
+        if (p == NONE)
+        {
+            world[s] = Eigen::Isometry3d::Identity();
+            valid[s] = is_root[s];
+        }
+        else
+        {
+            world[s] = world[p] * local[s];
+            valid[s] = valid[p];
+        }
+        dirty[s] = 0;
+    }
+}
+
+std::optional<KinematicsAPI::EdgeRead> KinematicsAPI::read_edge(uint64_t from, uint64_t to)
+{
+    std::shared_lock<std::shared_mutex> lock(G->_mutex);
+    auto node = G->nodes.find(from);
+    if (node == G->nodes.end()) return {};
+    const auto &n = node->second.read_reg();
+    auto edge = n.fano().find({to, "RT"});
+    if (edge == n.fano().end()) return {};
+    auto m = rt->get_edge_RT_as_rtmat(edge->second.read_reg());
+    if (not m.has_value()) return {};
+    return EdgeRead{Eigen::Isometry3d(m->matrix()), n.type() == "root"};
+}
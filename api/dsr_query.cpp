@@ -0,0 +1,261 @@
+#include <dsr/api/dsr_query.h>
+#include <dsr/api/dsr_api.h>
+#include <algorithm>
+#include <deque>
+#include <unordered_set>
+#include <utility>
+
+using namespace DSR;
+
+
+//////////////////////////////////////////////////////////////////////////
+/// Query
+//////////////////////////////////////////////////////////////////////////
+
+Query Query::node(uint64_t id)
+{
+    return {Start::ID, id, {}};
+}
+
+Query Query::name(const std::string &name)
+{
+    return {Start::NAME, 0, name};
+}
+
+Query Query::type(const std::string &type)
+{
+    return {Start::TYPE, 0, type};
+}
+
+Query &Query::out(const std::string &edge_type, uint32_t max_depth, uint32_t min_depth)
+{
+    steps.emplace_back(Step{Step::OUT, edge_type, min_depth, max_depth, {}});
+    return *this;
+}
+
+Query &Query::in(const std::string &edge_type, uint32_t max_depth, uint32_t min_depth)
+{
+    steps.emplace_back(Step{Step::IN, edge_type, min_depth, max_depth, {}});
+    return *this;
+}
+
+Query &Query::of_type(const std::string &type)
+{
+    steps.emplace_back(Step{Step::TYPE, type, 0, 0, {}});
+    return *this;
+}
+
+Query &Query::has(const std::string &att_name)
+{
+    steps.emplace_back(Step{Step::ATTR, att_name, 0, 0, {}});
+    return *this;
+}
+
+Query &Query::where(const std::string &att_name, std::function<bool(const Attribute &)> pred)
+{
+    steps.emplace_back(Step{Step::ATTR, att_name, 0, 0, std::move(pred)});
+    return *this;
+}
+
+QueryResult Query::run(DSRGraph *G) const
+{
+    return {G, *this};
+}
+
+bool Query::has_predicates() const
+{
+    return std::any_of(steps.begin(), steps.end(), [](const Step &s) { return static_cast<bool>(s.pred); });
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+/// QueryResult
+//////////////////////////////////////////////////////////////////////////
+
+// One step of the query. The first stage produces the start nodes, the rest pull the nodes of the stage
+// before them and filter or expand them. Called with G locked.
+struct QueryResult::Stage
+{
+    Stage(DSRGraph *G_, std::unique_ptr<Stage> prev_, Query::Step step_)
+        : G(G_), prev(std::move(prev_)), step(std::move(step_)) {}
+
+    DSRGraph *G;
+    std::unique_ptr<Stage> prev;    // null for the start nodes
+    Query::Step step;
+
+    // Start nodes: one node, the nodes of a type or all of them.
+    std::optional<uint64_t> single;
+    const std::unordered_set<uint64_t> *type_set = nullptr;   // shared by the types with the same id
+    std::unordered_set<uint64_t>::const_iterator type_it;
+    std::string type;
+    bool all = false;
+    Nodes::const_iterator all_it;
+
+    // Expansion of the current node of prev, breadth first so each node is reached at its minimum depth.
+    std::deque<std::pair<uint64_t, uint32_t>> frontier;
+    std::unordered_set<uint64_t> visited;   // from the current node of prev
+    std::unordered_set<uint64_t> emitted;
+
+    const CRDTNode *find(uint64_t id) const
+    {
+        auto it = G->nodes.find(id);
+        if (it == G->nodes.end() or it->second.empty()) return nullptr;
+        return &it->second.read_reg();
+    }
+
+    std::optional<uint64_t> next_start()
+    {
+        if (single.has_value()) return std::exchange(single, std::nullopt);
+        if (type_set != nullptr)
+        {
+            while (type_it != type_set->end())
+            {
+                const uint64_t id = *type_it++;
+                if (auto n = find(id); n != nullptr and n->type() == type) return id;
+            }
+        }
+        else if (all)
+        {
+            while (all_it != G->nodes.end())
+            {
+                const auto &[id, reg] = *all_it++;
+                if (not reg.empty()) return id;
+            }
+        }
+        return {};
+    }
+
+    bool accepts(const CRDTNode &node) const
+    {
+        if (step.kind == Query::Step::TYPE) return node.type() == step.label;
+        auto it = node.attrs().find(step.label);
+        if (it == node.attrs().end() or it->second.empty()) return false;
+        return not step.pred or step.pred(it->second.read_reg());
+    }
+
+    void expand(uint64_t id, uint32_t depth)
+    {
+        auto push = [&](uint64_t n, const std::string &type) {
+            if ((step.label.empty() or type == step.label) and visited.insert(n).second)
+                frontier.emplace_back(n, depth + 1);
+        };
+        if (step.kind == Query::Step::OUT)
+        {
+            if (const auto *node = find(id); node != nullptr)
+                for (const auto &[key, _] : node->fano()) push(key.first, key.second);
+        }
+        else if (auto it = G->to_edges.find(id); it != G->to_edges.end())
+        {
+            for (const auto &[from, type] : it->second) push(from, type);
+        }
+    }
+
+    std::optional<uint64_t> next()
+    {
+        if (prev == nullptr) return next_start();
+
+        if (step.kind == Query::Step::TYPE or step.kind == Query::Step::ATTR)
+        {
+            while (auto id = prev->next())
+                if (const auto *node = find(id.value()); node != nullptr and accepts(*node)) return id;
+            return {};
+        }
+
+        while (true)
+        {
+            if (frontier.empty())
+            {
+                auto root = prev->next();
+                if (not root.has_value()) return {};
+                visited.clear();
+                visited.insert(root.value());
+                frontier.emplace_back(root.value(), 0);
+            }
+            auto [id, depth] = frontier.front();
+            frontier.pop_front();
+            if (depth < step.max_depth) expand(id, depth);
+            if (depth >= step.min_depth and find(id) != nullptr and emitted.insert(id).second) return id;
+        }
+    }
+};
+
+
+QueryResult::QueryResult(DSRGraph *G_, const Query &q)
+    : G(G_), lock(G_->_mutex), lock_cache(G_->_mutex_cache_maps)
+{
+    last = std::make_unique<Stage>(G, nullptr, Query::Step{});
+    switch (q.start)
+    {
+        case Query::Start::ID:
+            last->single = q.start_id;
+            if (last->find(q.start_id) == nullptr) last->single.reset();
+            break;
+        case Query::Start::NAME:
+            if (auto it = G->name_map.find(q.start_label); it != G->name_map.end() and last->find(it->second) != nullptr)
+                last->single = it->second;
+            break;
+        case Query::Start::TYPE:
+            if (q.start_label.empty())
+            {
+                last->all = true;
+                last->all_it = G->nodes.cbegin();
+            }
+            else if (auto it = G->nodeType.find(name_id(q.start_label)); it != G->nodeType.end())
+            {
+                last->type_set = &it->second;
+                last->type_it = it->second.cbegin();
+                last->type = q.start_label;
+            }
+            break;
+    }
+    for (const auto &step : q.steps)
+        last = std::make_unique<Stage>(G, std::move(last), step);
+}
+
+QueryResult::QueryResult(QueryResult &&) noexcept = default;
+QueryResult &QueryResult::operator=(QueryResult &&) noexcept = default;
+QueryResult::~QueryResult() = default;
+
+std::optional<uint64_t> QueryResult::next()
+{
+    if (not locked()) return {};
+    return last->next();
+}
+
+std::vector<uint64_t> QueryResult::ids(std::size_t limit)
+{
+    std::vector<uint64_t> ret;
+    while (ret.size() < limit)
+    {
+        auto id = next();
+        if (not id.has_value()) break;
+        ret.emplace_back(id.value());
+    }
+    return ret;
+}
+
+std::vector<Node> QueryResult::nodes(std::size_t limit)
+{
+    std::vector<Node> ret;
+    while (ret.size() < limit)
+    {
+        auto id = next();
+        if (not id.has_value()) break;
+        ret.emplace_back(*last->find(id.value()));
+    }
+    return ret;
+}
+
+std::size_t QueryResult::count()
+{
+    std::size_t n = 0;
+    while (next().has_value()) n++;
+    return n;
+}
+
+void QueryResult::release()
+{
+    last.reset();
+    if (lock_cache.owns_lock()) lock_cache.unlock();
+    if (lock.owns_lock()) lock.unlock();
+}
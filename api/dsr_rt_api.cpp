@@ -1,5 +1,6 @@
 #include <dsr/api/dsr_rt_api.h>
 #include <dsr/api/dsr_api.h>
+#include <algorithm>
 
 using namespace DSR;
 
@@ -10,7 +11,7 @@ RT_API::RT_API(DSR::DSRGraph *G_)
 
 std::optional<Edge> RT_API::get_edge_RT(const Node &n, uint64_t to)
 {
-    auto edges_ = n.fano();
+    const auto &edges_ = n.fano();
     auto res = edges_.find({to, "RT"});
     if (res != edges_.end())
         return res->second;
@@ -20,130 +21,170 @@ std::optional<Edge> RT_API::get_edge_RT(const Node &n, uint64_t to)
 
 std::optional<Mat::RTMat> RT_API::get_RT_pose_from_parent(const Node &n)
 {
-    auto p = G->get_parent_node(n);
-    if (p.has_value())
+    // Read the edge stored in G instead of copying the parent node.
+    auto parent = G->get_attrib_by_name<parent_att>(n);
+    if (not parent.has_value()) return {};
+    std::shared_lock<std::shared_mutex> lock(G->_mutex);
+    auto p = G->nodes.find(parent.value());
+    if (p == G->nodes.end()) return {};
+    const auto &edges_ = p->second.read_reg().fano();
+    auto res = edges_.find({n.id(), "RT"});
+    if (res == edges_.end()) return {};
+    auto r = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(res->second.read_reg());
+    auto t = G->get_attrib_by_name<rt_translation_att>(res->second.read_reg());
+    if (r.has_value() && t.has_value() )
     {
-        auto edges_ = p->fano();
-        auto res = edges_.find({n.id(),"RT"});
-        if (res != edges_.end())
+        Mat::RTMat rt(Eigen::Translation3d(t->get()[0], t->get()[1], t->get()[2]) *
+                      Eigen::AngleAxisd(r->get()[0], Eigen::Vector3d::UnitX()) *
+                      Eigen::AngleAxisd(r->get()[1], Eigen::Vector3d::UnitY()) *
+                      Eigen::AngleAxisd(r->get()[2], Eigen::Vector3d::UnitZ()));
+        return rt;
+    }
+    return {};
+}
+
+namespace
+{
+    Eigen::Quaterniond euler_xyz_to_quaternion(double rx, double ry, double rz)
+    {
+        return Eigen::Quaterniond(Eigen::AngleAxisd(rx, Eigen::Vector3d::UnitX()) *
+                                  Eigen::AngleAxisd(ry, Eigen::Vector3d::UnitY()) *
+                                  Eigen::AngleAxisd(rz, Eigen::Vector3d::UnitZ()));
+    }
+
+    // Binary search of t in a ring buffer with count samples, the newest one in head. ts(slot) returns the
+    // timestamp of a slot. Returns the slots before and after t and the interpolation factor between them.
+    template <typename TsFn>
+    std::tuple<uint32_t, uint32_t, double> ring_lookup(uint32_t capacity, uint32_t head, uint32_t count, uint64_t t, TsFn &&ts)
+    {
+        auto slot = [&](uint32_t pos) { return (head + 1 + pos + capacity - count) % capacity; };
+        uint32_t lo = 0, hi = count;   // first position with a timestamp greater than t
+        while (lo < hi)
         {
-            auto r = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(res->second);
-            auto t = G->get_attrib_by_name<rt_translation_att>(res->second);
-            if (r.has_value() && t.has_value() )
-            {
-                Mat::RTMat rt(Eigen::Translation3d(t->get()[0], t->get()[1], t->get()[2]) *
-                              Eigen::AngleAxisd(r->get()[0], Eigen::Vector3d::UnitX()) *
-                              Eigen::AngleAxisd(r->get()[1], Eigen::Vector3d::UnitY()) *
-                              Eigen::AngleAxisd(r->get()[2], Eigen::Vector3d::UnitZ()));
-                return rt;
-            }
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (ts(slot(mid)) <= t) lo = mid + 1;
+            else hi = mid;
         }
+        if (lo == 0) return {slot(0), slot(0), 0.0};
+        if (lo == count) return {slot(count - 1), slot(count - 1), 0.0};
+        const uint32_t a = slot(lo - 1), b = slot(lo);
+        const uint64_t ta = ts(a), tb = ts(b);
+        return {a, b, tb > ta ? static_cast<double>(t - ta) / static_cast<double>(tb - ta) : 0.0};
     }
-    return {};
 }
 
-std::optional<Mat::RTMat>  RT_API::get_edge_RT_as_rtmat(const Edge &edge, std::uint64_t timestamp)
+std::string RT_API::history_slot_name(uint32_t slot)
 {
-    auto r_o = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(edge);
-    auto t_o =  G->get_attrib_by_name<rt_translation_att>(edge);
+    return "rt_pose_history_" + std::to_string(slot);
+}
+
+template <typename EdgeType>
+std::optional<RT_API::Pose> RT_API::get_edge_pose(const EdgeType &edge, std::uint64_t timestamp)
+{
+    const auto &attrs = edge.attrs();
     auto head_o = G->get_attrib_by_name<rt_head_index_att>(edge);
-    auto tstamps_o = G->get_attrib_by_name<rt_timestamps_att>(edge);
-    if (r_o.has_value() and t_o.has_value() and t_o.value().get().size() >= 3 and r_o.value().get().size() >= 3)
+    auto size_o = G->get_attrib_by_name<rt_history_size_att>(edge);
+
+    if (timestamp != 0 and head_o.has_value() and size_o.has_value() and size_o.value() > 0)
     {
-        const auto &t = t_o.value().get();
-        const auto &r = r_o.value().get();
-        if (timestamp == 0)  // return with the first 3 elements of the arrays
+        const auto capacity = static_cast<uint32_t>(size_o.value());
+        const auto head = static_cast<uint32_t>(head_o.value()) % capacity;
+        auto attribute = [&](const std::string &name) -> const Attribute* {
+            auto it = attrs.find(name);
+            if (it == attrs.end()) return nullptr;
+            if constexpr (std::is_same_v<EdgeType, CRDTEdge>) return &it->second.read_reg();
+            else return &it->second;
+        };
+        auto sample = [&](uint32_t slot) -> const Attribute* {
+            const Attribute *att = attribute(history_slot_name(slot));
+            return att != nullptr and att->value().index() == VEC6 ? att : nullptr;
+        };
+        // The slot, rt_head_index and the current pose of an append are separate deltas that other agents
+        // may join in any order. Until all of them have arrived the head slot isn't the sample written with
+        // rt_translation, or the slot after it is newer than the head, and the last pose is returned.
+        const Attribute *head_sample = sample(head);
+        const Attribute *next_sample = sample((head + 1) % capacity);
+        const Attribute *current = attribute("rt_translation");
+        const bool consistent = head_sample != nullptr and current != nullptr
+                                and head_sample->timestamp() == current->timestamp()
+                                and (next_sample == nullptr or capacity == 1 or next_sample->timestamp() < head_sample->timestamp());
+        if (consistent)
         {
-            if (head_o.has_value() and tstamps_o.has_value())
+            const uint32_t count = next_sample != nullptr ? capacity : head + 1;
+            auto [a, b, alpha] = ring_lookup(capacity, head, count, timestamp * 1000000,
+                                             [&](uint32_t slot) { auto s = sample(slot); return s ? s->timestamp() : 0; });
+            const auto *sa = sample(a);
+            const auto *sb = sample(b);
+            if (sa != nullptr and sb != nullptr)
             {
-                const auto &head = head_o.value();
-                //qInfo() << __FUNCTION__ << " ZERO " << static_cast<int64_t>(timestamp) << static_cast<int64_t>(tstamps_o.value().get()[(int)(head/BLOCK_SIZE)]);
-                return Mat::RTMat(Eigen::Translation3d(t[head], t[head+1], t[head+2]) *
-                                  Eigen::AngleAxisd(r[head], Eigen::Vector3d::UnitX()) *
-                                  Eigen::AngleAxisd(r[head+1], Eigen::Vector3d::UnitY()) *
-                                  Eigen::AngleAxisd(r[head+2], Eigen::Vector3d::UnitZ()));
+                const auto &pa = sa->vec6();
+                const auto &pb = sb->vec6();
+                Eigen::Vector3d ta(pa[0], pa[1], pa[2]), tb(pb[0], pb[1], pb[2]);
+                auto qa = euler_xyz_to_quaternion(pa[3], pa[4], pa[5]);
+                auto qb = euler_xyz_to_quaternion(pb[3], pb[4], pb[5]);
+                return Pose{ta + alpha * (tb - ta), qa.slerp(alpha, qb)};
             }
-            else
-                return Mat::RTMat(Eigen::Translation3d(t[0], t[1], t[2]) *
-                                  Eigen::AngleAxisd(r[0], Eigen::Vector3d::UnitX()) *
-                                  Eigen::AngleAxisd(r[1], Eigen::Vector3d::UnitY()) *
-                                  Eigen::AngleAxisd(r[2], Eigen::Vector3d::UnitZ()));
         }
-        else  // timestamp not 0
-        {
-            if (head_o.has_value() and tstamps_o.has_value())
-            {
-                const auto &tstamps = tstamps_o.value().get();
-                auto i = std::ranges::min_element(tstamps, [timestamp](std::uint64_t x, std::uint64_t y)
-                    {
-                        return abs(static_cast<int64_t>(x)-static_cast<int64_t>(timestamp)) < abs(static_cast<int64_t>(y)-static_cast<int64_t>(timestamp));
-                    });
-                auto bix = std::distance(begin(tstamps), i) * BLOCK_SIZE;
+    }
 
-                //qInfo() << __FUNCTION__ << " IN " << static_cast<int64_t>(timestamp)-static_cast<int64_t>(*i);
+    auto r_o = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(edge);
+    auto t_o = G->get_attrib_by_name<rt_translation_att>(edge);
+    if (not r_o.has_value() or not t_o.has_value() or t_o.value().get().size() < 3 or r_o.value().get().size() < 3)
+        return {};
+    const auto &t = t_o.value().get();
+    const auto &r = r_o.value().get();
 
-                return Mat::RTMat(Eigen::Translation3d(t[bix], t[bix + 1], t[bix + 2]) *
-                                  Eigen::AngleAxisd(r[bix], Eigen::Vector3d::UnitX()) *
-                                  Eigen::AngleAxisd(r[bix + 1], Eigen::Vector3d::UnitY()) *
-                                  Eigen::AngleAxisd(r[bix + 2], Eigen::Vector3d::UnitZ()));
-            }
-            else
+    // Edges written with the packed layout (all the history in rt_translation and rt_rotation_euler_xyz).
+    auto tstamps_o = G->get_attrib_by_name<rt_timestamps_att>(edge);
+    if (not size_o.has_value() and head_o.has_value() and tstamps_o.has_value())
+    {
+        const auto &tstamps = tstamps_o.value().get();
+        const auto capacity = static_cast<uint32_t>(std::min({tstamps.size(), t.size() / BLOCK_SIZE, r.size() / BLOCK_SIZE}));
+        if (capacity > 0)
+        {
+            const auto head = static_cast<uint32_t>(head_o.value() / BLOCK_SIZE) % capacity;
+            uint32_t a = head, b = head;
+            double alpha = 0.0;
+            if (timestamp != 0)
             {
-                //qWarning() << __FUNCTION__ << "Not head or no timestamps found in RT edge from node "  << edge.from() << " to: " << edge.to() << " Returning first element in array";
-                return Mat::RTMat(Eigen::Translation3d(t[0], t[1], t[2]) *
-                                  Eigen::AngleAxisd(r[0], Eigen::Vector3d::UnitX()) *
-                                  Eigen::AngleAxisd(r[1], Eigen::Vector3d::UnitY()) *
-                                  Eigen::AngleAxisd(r[2], Eigen::Vector3d::UnitZ()));
+                const uint32_t count = tstamps[(head + 1) % capacity] != 0 ? capacity : head + 1;
+                std::tie(a, b, alpha) = ring_lookup(capacity, head, count, timestamp, [&](uint32_t slot) { return tstamps[slot]; });
             }
+            const auto ia = a * BLOCK_SIZE, ib = b * BLOCK_SIZE;
+            Eigen::Vector3d ta(t[ia], t[ia + 1], t[ia + 2]), tb(t[ib], t[ib + 1], t[ib + 2]);
+            auto qa = euler_xyz_to_quaternion(r[ia], r[ia + 1], r[ia + 2]);
+            auto qb = euler_xyz_to_quaternion(r[ib], r[ib + 1], r[ib + 2]);
+            return Pose{ta + alpha * (tb - ta), qa.slerp(alpha, qb)};
         }
     }
-    else
-    {
-        qWarning() << __FUNCTION__ << "NO translation or rotation found in RT edge from node " << edge.from() << " to: " << edge.to();
-        return {};
-    }
+
+    return Pose{Eigen::Vector3d(t[0], t[1], t[2]), euler_xyz_to_quaternion(r[0], r[1], r[2])};
+}
+
+std::optional<Mat::RTMat>  RT_API::get_edge_RT_as_rtmat(const Edge &edge, std::uint64_t timestamp)
+{
+    if (auto pose = get_edge_pose(edge, timestamp); pose.has_value())
+        return Mat::RTMat(Eigen::Translation3d(pose->translation) * pose->rotation);
+    qWarning() << __FUNCTION__ << "NO translation or rotation found in RT edge from node " << edge.from() << " to: " << edge.to();
+    return {};
+}
+
+std::optional<Mat::RTMat>  RT_API::get_edge_RT_as_rtmat(const CRDTEdge &edge, std::uint64_t timestamp)
+{
+    if (auto pose = get_edge_pose(edge, timestamp); pose.has_value())
+        return Mat::RTMat(Eigen::Translation3d(pose->translation) * pose->rotation);
+    qWarning() << __FUNCTION__ << "NO translation or rotation found in RT edge from node " << edge.from() << " to: " << edge.to();
+    return {};
 }
 
 std::optional<Eigen::Vector3d> RT_API::get_translation(const Node &n, uint64_t to, std::uint64_t timestamp)
 {
     if( auto edge = get_edge_RT(n, to); edge.has_value())
     {
-        auto t_o = G->get_attrib_by_name<rt_translation_att>(edge.value());
-        auto head_o = G->get_attrib_by_name<rt_head_index_att>(edge.value());
-        auto tstamps_o = G->get_attrib_by_name<rt_timestamps_att>(edge.value());
-        if (t_o.has_value() and t_o.value().get().size() >= 3)
-        {
-            const auto &t = t_o.value().get();
-            if (timestamp == 0)
-            {
-                if (head_o.has_value() and tstamps_o.has_value())
-                    return Eigen::Vector3d(t[head_o.value()], t[head_o.value() + 1], t[head_o.value() + 2]);
-                else
-                    return Eigen::Vector3d(t[0], t[1], t[2]);
-            }
-            else  // timestamp not 0
-            {
-                if (head_o.has_value() and tstamps_o.has_value())
-                {
-                    // get first index of tstamps whose value is greater than timestamp
-                    const auto &tstamps = tstamps_o.value().get();
-                    auto i = std::ranges::min_element(tstamps, [timestamp](float x, float y)
-                    { return abs(static_cast<int64_t>(x)-static_cast<int64_t>(timestamp)) < abs(static_cast<int64_t>(y)-static_cast<int64_t>(timestamp));});
-                    auto bix = std::distance(begin(tstamps), i) * BLOCK_SIZE;
-                    return Eigen::Vector3d(t[bix], t[bix + 1], t[bix + 2]);
-                }
-                else
-                {
-                    qWarning() << __FUNCTION__ << " Not timestamp or not head found in RT edge from node "  << QString::fromStdString(n.name()) << " to: " << to << " Returning first element in array";
-                    return Eigen::Vector3d(t[0], t[1], t[2]);
-                }
-            }
-        }
-        else
-        {
-            qWarning() << __FUNCTION__ << " NO translation found in RT edge from node " << QString::fromStdString(n.name()) << " to: " << to ;
-            return {};
-        }
+        if (auto pose = get_edge_pose(edge.value(), timestamp); pose.has_value())
+            return pose->translation;
+        qWarning() << __FUNCTION__ << " NO translation found in RT edge from node " << QString::fromStdString(n.name()) << " to: " << to ;
+        return {};
     }
     else
     {
@@ -162,146 +203,7 @@ std::optional<Eigen::Vector3d> RT_API::get_translation(uint64_t node_id, uint64_
 
 void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, const std::vector<float> &trans, const std::vector<float> &rot_euler)
 {
-    bool r1 = false;
-    bool r2 = false;
-    bool no_send = true;
-
-    std::optional<IDL::MvregEdge> node1_insert;
-    std::optional<std::vector<IDL::MvregEdgeAttr>> node1_update;
-    std::optional<std::vector<IDL::MvregNodeAttr>> node2;
-    std::optional<CRDTNode> to_n;
-    {
-        std::unique_lock<std::shared_mutex> lock(G->_mutex);
-        if (G->nodes.contains(to))
-        {
-            CRDTEdge e;
-            if (HISTORY_SIZE <= 0)
-            {
-                e.to(to);  e.from(n.id()); e.type("RT"); e.agent_id(G->agent_id);
-                CRDTAttribute tr(trans, get_unix_timestamp(), 0);
-                CRDTAttribute rot(rot_euler, get_unix_timestamp(), 0);
-
-                auto [it, new_el] = e.attrs().emplace("rt_rotation_euler_xyz", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(rot));
-                auto [it2, new_el2] = e.attrs().emplace("rt_translation", mvreg<CRDTAttribute> ());
-                it2->second.write(std::move(tr));
-            } else {
-
-                e = G->get_edge_(n.id(), to, "RT").value_or(CRDTEdge());
-                e.to(to);  e.from(n.id()); e.type("RT"); e.agent_id(G->agent_id);
-                auto head_o = G->get_attrib_by_name<rt_head_index_att>(e);
-                std::optional<std::vector<uint64_t>> tstamps_o = G->get_attrib_by_name<rt_timestamps_att>(e);
-                std::optional<std::vector<float>> tr_pack_o = G->get_attrib_by_name<rt_translation_att>(e);
-                std::optional<std::vector<float>> rot_pack_o = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(e);
-                auto time_stamps = tstamps_o.value_or(std::vector<std::uint64_t>(HISTORY_SIZE, 0));
-                auto tr_pack = tr_pack_o.value_or(std::vector<float> (BLOCK_SIZE * HISTORY_SIZE, 0.f));
-                auto rot_pack = rot_pack_o.value_or(std::vector<float> (BLOCK_SIZE * HISTORY_SIZE, 0.f));
-
-                auto timestamp_index = (int)(head_o.value_or(0)/BLOCK_SIZE+1) % HISTORY_SIZE;
-                uint32_t index = timestamp_index * BLOCK_SIZE;
-
-                tr_pack[index] = trans[0];
-                tr_pack[index + 1] = trans[1];
-                tr_pack[index + 2] = trans[2];
-                rot_pack[index] = rot_euler[0];
-                rot_pack[index + 1] = rot_euler[1];
-                rot_pack[index + 2] = rot_euler[2];
-                time_stamps[timestamp_index] = static_cast<std::uint64_t>(
-                    std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::system_clock::now().time_since_epoch()).count());
-
-
-                CRDTAttribute tr(std::move(tr_pack), get_unix_timestamp(), 0);
-                CRDTAttribute rot(std::move(rot_pack), get_unix_timestamp(), 0);
-                CRDTAttribute head_index(index, get_unix_timestamp(), 0);
-                CRDTAttribute timestamps(std::move(time_stamps), get_unix_timestamp(), 0);
-
-                auto [it, new_el] = e.attrs().insert_or_assign("rt_rotation_euler_xyz", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(rot));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_translation", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(tr));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_head_index", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(head_index));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_timestamps", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(timestamps));
-            }
-
-            to_n = G->get_(to).value();
-            if (auto x = G->get_crdt_attrib_by_name<parent_att>(to_n.value()); x.has_value())
-            {
-                if ( x.value() != n.id())
-                {
-                    no_send = !G->modify_attrib_local<parent_att>(to_n.value(), n.id());
-                }
-            }
-            else
-            {
-                no_send = !G->add_attrib_local<parent_att>(to_n.value(), n.id());
-            }
-
-            if (auto x = G->get_crdt_attrib_by_name<level_att>(to_n.value()); x.has_value())
-            {
-                if (x.value() != G->get_node_level(n).value() + 1)
-                {
-                    no_send = !G->modify_attrib_local<level_att>(to_n.value(),  G->get_node_level(n).value() + 1 );
-                }
-            }
-            else
-            {
-                no_send = !G->add_attrib_local<level_att>(to_n.value(),  G->get_node_level(n).value() + 1 );
-            }
-
-            //Check if RT edge exist.
-            if (!n.fano().contains({to, "RT"}))
-            {
-                //Create -> from: IDL::MvregEdge, to: vector<IDL::MvregNodeAttr>
-                std::tie(r1, node1_insert, std::ignore) = G->insert_or_assign_edge_(std::move(e), n.id(), to);
-                if (!no_send) std::tie(r2, node2) = G->update_node_(std::move(to_n.value()));
-
-            }
-            else
-            {
-                //Update -> from: IDL::MvregEdgeAttr, to: vector<IDL::MvregNodeAttr>
-                std::tie(r1, std::ignore, node1_update) = G->insert_or_assign_edge_(std::move(e), n.id(), to);
-                if (!no_send) std::tie(r2, node2) = G->update_node_(std::move(to_n.value()));
-
-            }
-            if (!r1)
-            {
-                throw std::runtime_error(
-                        "Could not insert Node " + std::to_string(n.id()) + " in G in insert_or_assign_edge_RT() " +
-                        __FILE__ + " " + __FUNCTION__ + " " + std::to_string(__LINE__));
-            }
-            if (!r2 and !no_send)
-            {
-                throw std::runtime_error(
-                        "Could not insert Node " + std::to_string(to_n->id()) + " in G in insert_or_assign_edge_RT() " +
-                        __FILE__ + " " + __FUNCTION__ + " " + std::to_string(__LINE__));
-            }
-        } else
-            throw std::runtime_error(
-                    "Destination node " + std::to_string(to) + " not found in G in insert_or_assign_edge_RT() " +
-                    __FILE__ + " " + __FUNCTION__ + " " + std::to_string(__LINE__));
-    }
-    if (!G->copy)
-    {
-        if (node1_insert.has_value())
-        {
-            G->dsrpub_edge.write(&node1_insert.value());
-
-        }
-        if (node1_update.has_value()) G->dsrpub_edge_attrs.write(&node1_update.value());
-
-        if (!no_send and node2.has_value()) G->dsrpub_node_attrs.write(&node2.value());
-
-        emit G->update_edge_attr_signal(n.id(), to, "RT" ,{"rt_rotation_euler_xyz", "rt_translation"}, SignalInfo{ G->agent_id });
-        emit G->update_edge_signal(n.id(), to, "RT", SignalInfo{ G->agent_id });
-        if (!no_send)
-        {
-            emit G->update_node_signal(to_n->id(), to_n->type(), SignalInfo{ G->agent_id });
-            emit G->update_node_attr_signal(to_n->id(), {"level", "parent"}, SignalInfo{ G->agent_id });
-        }
-    }
+    insert_or_assign_edge_RT(n, to, std::vector<float>(trans), std::vector<float>(rot_euler));
 }
 
 void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &&trans, std::vector<float> &&rot_euler)
@@ -314,6 +216,7 @@ void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &
     std::optional<std::vector<IDL::MvregEdgeAttr>> node1_update;
     std::optional<std::vector<IDL::MvregNodeAttr>> node2;
     std::optional<CRDTNode> to_n;
+    std::vector<std::string> changed_attrs {"rt_rotation_euler_xyz", "rt_translation"};
     {
         std::unique_lock<std::shared_mutex> lock(G->_mutex);
         if (G->nodes.contains(to))
@@ -330,44 +233,58 @@ void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &
                 auto [it2, new_el2] = e.attrs().emplace("rt_translation", mvreg<CRDTAttribute> ());
                 it2->second.write(std::move(tr));
             } else {
+                CRDTEdge *stored = nullptr;
+                if (auto from_it = G->nodes.find(n.id()); from_it != G->nodes.end())
+                {
+                    auto &fano = from_it->second.read_reg().fano();
+                    if (auto edge_it = fano.find({to, "RT"}); edge_it != fano.end())
+                        stored = &edge_it->second.read_reg();
+                }
 
-                e = G->get_edge_(n.id(), to, "RT").value_or(CRDTEdge());
-                e.to(to);  e.from(n.id()); e.type("RT"); e.agent_id(G->agent_id);
-                auto head_o = G->get_attrib_by_name<rt_head_index_att>(e);
-                std::optional<std::vector<uint64_t>> tstamps_o = G->get_attrib_by_name<rt_timestamps_att>(e);
-                std::optional<std::vector<float>> tr_pack_o = G->get_attrib_by_name<rt_translation_att>(e);
-                std::optional<std::vector<float>> rot_pack_o = G->get_attrib_by_name<rt_rotation_euler_xyz_att>(e);
-                auto time_stamps = tstamps_o.value_or(std::vector<std::uint64_t>(HISTORY_SIZE, 0));
-                auto tr_pack = tr_pack_o.value_or(std::vector<float> (BLOCK_SIZE * HISTORY_SIZE, 0.f));
-                auto rot_pack = rot_pack_o.value_or(std::vector<float> (BLOCK_SIZE * HISTORY_SIZE, 0.f));
-
-                auto timestamp_index = (int)(head_o.value_or(0)/BLOCK_SIZE+1) % HISTORY_SIZE;
-                uint32_t index = timestamp_index * BLOCK_SIZE;
-
-                tr_pack[index] = trans[0];
-                tr_pack[index + 1] = trans[1];
-                tr_pack[index + 2] = trans[2];
-                rot_pack[index] = rot_euler[0];
-                rot_pack[index + 1] = rot_euler[1];
-                rot_pack[index + 2] = rot_euler[2];
-                time_stamps[timestamp_index] = static_cast<std::uint64_t>(
-                    std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::system_clock::now().time_since_epoch()).count());
-
-
-                CRDTAttribute tr(std::move(tr_pack), get_unix_timestamp(), 0);
-                CRDTAttribute rot(std::move(rot_pack), get_unix_timestamp(), 0);
-                CRDTAttribute head_index(index, get_unix_timestamp(), 0);
-                CRDTAttribute timestamps(std::move(time_stamps), get_unix_timestamp(), 0);
+                const uint64_t now = get_unix_timestamp();
+                std::array<float, 6> sample {trans[0], trans[1], trans[2], rot_euler[0], rot_euler[1], rot_euler[2]};
+                auto head_o = stored ? G->get_attrib_by_name<rt_head_index_att>(*stored) : std::nullopt;
+                auto size_o = stored ? G->get_attrib_by_name<rt_history_size_att>(*stored) : std::nullopt;
 
-                auto [it, new_el] = e.attrs().insert_or_assign("rt_rotation_euler_xyz", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(rot));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_translation", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(tr));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_head_index", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(head_index));
-                std::tie(it, new_el) = e.attrs().insert_or_assign("rt_timestamps", mvreg<CRDTAttribute> ());
-                it->second.write(std::move(timestamps));
+                if (stored != nullptr and head_o.has_value() and size_o.value_or(0) == static_cast<int>(HISTORY_SIZE))
+                {
+                    // Append to the stored edge. Four attribute deltas are replicated: the slot, rt_head_index and
+                    // the current pose. Other agents join them concurrently, get_edge_pose checks they all arrived.
+                    auto head = static_cast<int>((head_o.value() + 1) % HISTORY_SIZE);
+                    auto slot = history_slot_name(head);
+                    std::vector<IDL::MvregEdgeAttr> deltas;
+                    auto write = [&](const std::string &name, CRDTAttribute &&att) {
+                        auto delta = stored->attrs()[name].write(std::move(att));
+                        deltas.emplace_back(CRDTEdgeAttr_to_IDL(G->agent_id, n.id(), n.id(), to, "RT", name, delta));
+                    };
+                    write(slot, CRDTAttribute(sample, now, 0));
+                    write("rt_head_index", CRDTAttribute(head, now, 0));
+                    write("rt_translation", CRDTAttribute(std::move(trans), now, 0));
+                    write("rt_rotation_euler_xyz", CRDTAttribute(std::move(rot_euler), now, 0));
+                    node1_update = std::move(deltas);
+                    changed_attrs.emplace_back("rt_head_index");
+                    changed_attrs.emplace_back(std::move(slot));
+                    r1 = true;
+                }
+                else
+                {
+                    // New edge, or an edge without history or with another size. Start a new history.
+                    if (stored != nullptr) e = *stored;
+                    e.to(to);  e.from(n.id()); e.type("RT"); e.agent_id(G->agent_id);
+                    std::erase_if(e.attrs(), [](const auto &att) {
+                        return att.first == "rt_timestamps" or att.first.starts_with("rt_pose_history_");
+                    });
+                    auto set = [&](const std::string &name, CRDTAttribute &&att) {
+                        auto [it, new_el] = e.attrs().insert_or_assign(name, mvreg<CRDTAttribute> ());
+                        it->second.write(std::move(att));
+                    };
+                    set("rt_rotation_euler_xyz", CRDTAttribute(std::move(rot_euler), now, 0));
+                    set("rt_translation", CRDTAttribute(std::move(trans), now, 0));
+                    set("rt_history_size", CRDTAttribute(static_cast<int>(HISTORY_SIZE), now, 0));
+                    set("rt_head_index", CRDTAttribute(0, now, 0));
+                    set(history_slot_name(0), CRDTAttribute(sample, now, 0));
+                    changed_attrs.insert(changed_attrs.end(), {"rt_history_size", "rt_head_index", history_slot_name(0)});
+                }
             }
 
             to_n = G->get_(to).value();
@@ -395,21 +312,13 @@ void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &
                 no_send = !G->add_attrib_local<level_att>(to_n.value(),  G->get_node_level(n).value() + 1 );
             }
 
-            //Check if RT edge exist.
-            if (!n.fano().contains({to, "RT"}))
+            if (!r1)
             {
-                //Create -> from: IDL::MvregEdge, to: vector<IDL::MvregNodeAttr>
-                std::tie(r1, node1_insert, std::ignore) = G->insert_or_assign_edge_(std::move(e), n.id(), to);
-                if (!no_send) std::tie(r2, node2) = G->update_node_(std::move(to_n.value()));
-
+                //Create -> from: IDL::MvregEdge, Update -> from: IDL::MvregEdgeAttr
+                std::tie(r1, node1_insert, node1_update) = G->insert_or_assign_edge_(std::move(e), n.id(), to);
             }
-            else
-            {
-                //Update -> from: IDL::MvregEdgeAttr, to: vector<IDL::MvregNodeAttr>
-                std::tie(r1, std::ignore, node1_update) = G->insert_or_assign_edge_(std::move(e), n.id(), to);
-                if (!no_send) std::tie(r2, node2) = G->update_node_(std::move(to_n.value()));
+            if (!no_send) std::tie(r2, node2) = G->update_node_(std::move(to_n.value()));
 
-            }
             if (!r1)
             {
                 throw std::runtime_error(
@@ -437,12 +346,12 @@ void RT_API::insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &
 
         if (!no_send and node2.has_value()) G->dsrpub_node_attrs.write(&node2.value());
 
-        emit G->update_edge_attr_signal(n.id(), to, "RT",{"rt_rotation_euler_xyz", "rt_translation"}, SignalInfo{ G->agent_id });
-        emit G->update_edge_signal(n.id(), to, "RT", SignalInfo{ G->agent_id });
+        G->notify_update_edge_attr(n.id(), to, "RT", changed_attrs, SignalInfo{ G->agent_id });
+        G->notify_update_edge(n.id(), to, "RT", SignalInfo{ G->agent_id });
         if (!no_send)
         {
-            emit G->update_node_signal(to_n->id(), to_n->type(), SignalInfo{ G->agent_id });
-            emit G->update_node_attr_signal(to_n->id(), {"level", "parent"}, SignalInfo{ G->agent_id });
+            G->notify_update_node(to_n->id(), to_n->type(), SignalInfo{ G->agent_id });
+            G->notify_update_node_attr(to_n->id(), {"level", "parent"}, SignalInfo{ G->agent_id });
         }
     }
 }
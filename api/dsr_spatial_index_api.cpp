@@ -0,0 +1,342 @@
+#include <dsr/api/dsr_spatial_index_api.h>
+#include <dsr/api/dsr_api.h>
+#include <algorithm>
+
+using namespace DSR;
+namespace bg = boost::geometry;
+namespace bgi = boost::geometry::index;
+
+
+SpatialIndexAPI::SpatialIndexAPI(DSR::DSRGraph *G_)
+{
+    G = G_;
+    rt = G->get_rt_api();
+    rebuild();
+    //update signals
+    auto &cb = G->callbacks();
+    connections.add(cb.update_node, executor, [this](uint64_t id, const std::string &type, const SignalInfo &) { add_or_assign_node_slot(id, type); });
+    connections.add(cb.update_edge, executor, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { add_or_assign_edge_slot(from, to, type); });
+    connections.add(cb.del_edge, executor, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { del_edge_slot(from, to, type); });
+    connections.add(cb.del_node, executor, [this](uint64_t id, const SignalInfo &) { del_node_slot(id); });
+}
+
+void SpatialIndexAPI::rebuild()
+{
+    const auto nodes = G->getCopy();
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    entries.clear();
+    trees.clear();
+    root_id = 0;
+
+    for (const auto &[id, node] : nodes)
+    {
+        auto &e = entries[id];
+        e.type = node.type();
+        if (node.type() == "root") root_id = id;
+        auto w = G->get_attrib_by_name<obj_width_att>(node);
+        auto h = G->get_attrib_by_name<obj_height_att>(node);
+        auto d = G->get_attrib_by_name<obj_depth_att>(node);
+        if (w.has_value() and h.has_value() and d.has_value())
+            e.half_extents = Mat::Vector3d(w.value(), h.value(), d.value()) / 2.0;
+    }
+    for (const auto &[id, node] : nodes)
+        for (const auto &[key, edge] : node.fano())
+        {
+            if (key.second != "RT" or not entries.contains(key.first)) continue;
+            auto &child = entries[key.first];
+            child.parent = id;
+            child.local = rt->get_edge_RT_as_rtmat(edge).value_or(Mat::RTMat::Identity());
+            entries[id].children.emplace_back(key.first);
+        }
+    if (root_id == 0) return;
+
+    // Compute every world pose top-down and bulk load the trees (packing algorithm).
+    std::unordered_map<std::string, std::vector<value>> values;
+    std::vector<uint64_t> stack{root_id};
+    while (not stack.empty())
+    {
+        const uint64_t id = stack.back();
+        stack.pop_back();
+        auto &e = entries.at(id);
+        if (e.parent != 0) e.world = entries.at(e.parent).world * e.local;
+        e.bounds = world_bounds(e);
+        e.indexed = true;
+        values[e.type].emplace_back(e.bounds, id);
+        stack.insert(stack.end(), e.children.begin(), e.children.end());
+    }
+    for (auto &[type, v] : values)
+        trees.emplace(type, rtree(v.begin(), v.end()));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////// QUERIES
+////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Predicate>
+void SpatialIndexAPI::query(const std::string &type, const Predicate &pred, std::vector<value> &out) const
+{
+    if (type.empty())
+    {
+        for (const auto &[t, tree] : trees)
+            tree.query(pred, std::back_inserter(out));
+    }
+    else if (auto it = trees.find(type); it != trees.end())
+        it->second.query(pred, std::back_inserter(out));
+}
+
+SpatialIndexAPI::Item SpatialIndexAPI::make_item(const value &v, const point &p) const
+{
+    const auto &t = entries.at(v.second).world.translation();
+    return Item{v.second, t, bg::distance(p, v.first)};
+}
+
+std::vector<SpatialIndexAPI::Item> SpatialIndexAPI::nearest(const Mat::Vector3d &p, std::size_t k, const std::string &type) const
+{
+    const point qp(p.x(), p.y(), p.z());
+    std::vector<value> found;
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    // With several trees each one gives its k best, the merge below keeps the global k best.
+    query(type, bgi::nearest(qp, static_cast<unsigned>(k)), found);
+
+    std::vector<Item> ret;
+    ret.reserve(found.size());
+    for (const auto &v : found) ret.emplace_back(make_item(v, qp));
+    lock.unlock();
+
+    std::sort(ret.begin(), ret.end(), [](const auto &a, const auto &b) { return a.distance < b.distance; });
+    if (ret.size() > k) ret.resize(k);
+    return ret;
+}
+
+std::vector<SpatialIndexAPI::Item> SpatialIndexAPI::radius(const Mat::Vector3d &p, double r, const std::string &type) const
+{
+    const point qp(p.x(), p.y(), p.z());
+    const box qb(point(p.x() - r, p.y() - r, p.z() - r), point(p.x() + r, p.y() + r, p.z() + r));
+    std::vector<value> found;
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    query(type, bgi::intersects(qb) and bgi::satisfies([&](const value &v) { return bg::distance(qp, v.first) <= r; }), found);
+
+    std::vector<Item> ret;
+    ret.reserve(found.size());
+    for (const auto &v : found) ret.emplace_back(make_item(v, qp));
+    lock.unlock();
+
+    std::sort(ret.begin(), ret.end(), [](const auto &a, const auto &b) { return a.distance < b.distance; });
+    return ret;
+}
+
+std::vector<SpatialIndexAPI::Item> SpatialIndexAPI::box_query(const Mat::Vector3d &min, const Mat::Vector3d &max, const std::string &type) const
+{
+    const box qb(point(min.x(), min.y(), min.z()), point(max.x(), max.y(), max.z()));
+    std::vector<value> found;
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    query(type, bgi::intersects(qb), found);
+
+    std::vector<Item> ret;
+    ret.reserve(found.size());
+    for (const auto &v : found)
+        ret.emplace_back(Item{v.second, entries.at(v.second).world.translation(), 0.0});
+    return ret;
+}
+
+std::optional<Mat::RTMat> SpatialIndexAPI::get_world_pose(uint64_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    if (auto it = entries.find(id); it != entries.end() and it->second.indexed)
+        return it->second.world;
+    return {};
+}
+
+std::optional<Mat::Vector3d> SpatialIndexAPI::get_world_position(uint64_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    if (auto it = entries.find(id); it != entries.end() and it->second.indexed)
+        return it->second.world.translation();
+    return {};
+}
+
+std::optional<SpatialIndexAPI::box> SpatialIndexAPI::get_bounds(uint64_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    if (auto it = entries.find(id); it != entries.end() and it->second.indexed)
+        return it->second.bounds;
+    return {};
+}
+
+std::size_t SpatialIndexAPI::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::size_t n = 0;
+    for (const auto &[t, tree] : trees) n += tree.size();
+    return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////// INCREMENTAL UPDATES
+////////////////////////////////////////////////////////////////////////////////////////
+
+std::optional<Mat::Vector3d> SpatialIndexAPI::read_half_extents(uint64_t id)
+{
+    std::optional<Mat::Vector3d> ret;
+    G->read_attribs_by_name<obj_width_att, obj_height_att, obj_depth_att>(id, [&](int w, int h, int d)
+    {
+        ret = Mat::Vector3d(w, h, d) / 2.0;
+    });
+    return ret;
+}
+
+SpatialIndexAPI::Entry &SpatialIndexAPI::get_or_load_entry(uint64_t id)
+{
+    auto [it, inserted] = entries.try_emplace(id);
+    if (inserted)
+    {
+        if (auto n = G->get_node(id); n.has_value())
+        {
+            it->second.type = n->type();
+            if (n->type() == "root") root_id = id;
+        }
+        it->second.half_extents = read_half_extents(id).value_or(Mat::Vector3d::Zero());
+    }
+    return it->second;
+}
+
+SpatialIndexAPI::box SpatialIndexAPI::world_bounds(const Entry &e) const
+{
+    // Axis aligned box of the rotated object box.
+    const Mat::Vector3d c = e.world.translation();
+    const Mat::Vector3d h = e.world.linear().cwiseAbs() * e.half_extents;
+    return box(point(c.x() - h.x(), c.y() - h.y(), c.z() - h.z()), point(c.x() + h.x(), c.y() + h.y(), c.z() + h.z()));
+}
+
+void SpatialIndexAPI::unindex(Entry &e, uint64_t id)
+{
+    if (not e.indexed) return;
+    if (auto it = trees.find(e.type); it != trees.end())
+        it->second.remove(value(e.bounds, id));
+    e.indexed = false;
+}
+
+void SpatialIndexAPI::index(Entry &e, uint64_t id)
+{
+    unindex(e, id);
+    e.bounds = world_bounds(e);
+    trees[e.type].insert(value(e.bounds, id));
+    e.indexed = true;
+}
+
+void SpatialIndexAPI::update_subtree(uint64_t id)
+{
+    std::vector<uint64_t> stack{id};
+    while (not stack.empty())
+    {
+        const uint64_t current = stack.back();
+        stack.pop_back();
+        auto &e = entries.at(current);
+        if (current == root_id)
+            e.world = Mat::RTMat::Identity();
+        else if (auto p = entries.find(e.parent); e.parent != 0 and p != entries.end() and p->second.indexed)
+            e.world = p->second.world * e.local;
+        else
+        {
+            unindex_subtree(current);
+            continue;
+        }
+        index(e, current);
+        stack.insert(stack.end(), e.children.begin(), e.children.end());
+    }
+}
+
+void SpatialIndexAPI::unindex_subtree(uint64_t id)
+{
+    std::vector<uint64_t> stack{id};
+    while (not stack.empty())
+    {
+        const uint64_t current = stack.back();
+        stack.pop_back();
+        if (auto it = entries.find(current); it != entries.end())
+        {
+            unindex(it->second, current);
+            stack.insert(stack.end(), it->second.children.begin(), it->second.children.end());
+        }
+    }
+}
+
+void SpatialIndexAPI::detach(uint64_t id)
+{
+    auto &e = entries.at(id);
+    if (e.parent == 0) return;
+    if (auto p = entries.find(e.parent); p != entries.end())
+        std::erase(p->second.children, id);
+    e.parent = 0;
+}
+
+void SpatialIndexAPI::add_or_assign_node_slot(uint64_t id, const std::string &type)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto it = entries.find(id);
+    if (it == entries.end())
+    {
+        get_or_load_entry(id);
+        if (id == root_id) update_subtree(id);
+        return;
+    }
+
+    // Only the type and the object size affect the index.
+    auto &e = it->second;
+    auto extents = read_half_extents(id).value_or(Mat::Vector3d::Zero());
+    if (e.type != type or e.half_extents != extents)
+    {
+        const bool was_indexed = e.indexed;
+        unindex(e, id);
+        e.type = type;
+        e.half_extents = extents;
+        if (type == "root") root_id = id;
+        if (was_indexed or id == root_id) index(e, id);
+    }
+}
+
+void SpatialIndexAPI::add_or_assign_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type)
+{
+    if (edge_type != "RT") return;
+    auto edge = G->get_edge(from, to, "RT");
+    if (not edge.has_value()) return;
+    auto local = rt->get_edge_RT_as_rtmat(edge.value());
+    if (not local.has_value()) return;
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    get_or_load_entry(from);
+    auto &e = get_or_load_entry(to);
+    if (e.parent != from)
+    {
+        detach(to);
+        e.parent = from;
+        entries.at(from).children.emplace_back(to);
+    }
+    e.local = local.value();
+    update_subtree(to);
+}
+
+void SpatialIndexAPI::del_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type)
+{
+    if (edge_type != "RT") return;
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    if (auto it = entries.find(to); it != entries.end() and it->second.parent == from)
+    {
+        detach(to);
+        unindex_subtree(to);
+    }
+}
+
+void SpatialIndexAPI::del_node_slot(uint64_t id)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto it = entries.find(id);
+    if (it == entries.end()) return;
+    unindex_subtree(id);
+    detach(id);
+    for (auto child : entries.at(id).children)
+        if (auto c = entries.find(child); c != entries.end()) c->second.parent = 0;
+    entries.erase(id);
+    if (id == root_id) root_id = 0;
+}
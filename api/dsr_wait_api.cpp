@@ -0,0 +1,149 @@
+#include <dsr/api/dsr_wait_api.h>
+#include <dsr/api/dsr_api.h>
+#include <algorithm>
+
+using namespace DSR;
+
+
+WaitAPI::WaitAPI(DSR::DSRGraph *G_)
+{
+    G = G_;
+    // Direct connections, the slots are called by the join paths right after a change is applied.
+    auto &cb = G->callbacks();
+    connections.add(cb.update_node, [this](uint64_t id, const std::string &type, const SignalInfo &) { update_node_slot(id, type); });
+    connections.add(cb.update_node_attr, [this](uint64_t id, const std::vector<std::string> &att_names, const SignalInfo &) { update_node_attr_slot(id, att_names); });
+    connections.add(cb.update_edge, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &) { update_edge_slot(from, to, type); });
+}
+
+WaitAPI::~WaitAPI()
+{
+    connections.clear();
+    std::vector<std::shared_ptr<WaiterBase>> cancelled;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (int k = 0; k < 3; k++)
+        {
+            for (auto &[_, w] : waiters[k])
+                if (w->cancel()) cancelled.emplace_back(std::move(w));
+            waiters[k].clear();
+            counts[k].store(0, std::memory_order_relaxed);
+        }
+    }
+    for (auto &w : cancelled) w->resume();
+}
+
+WaitAPI::Condition<Node> WaitAPI::node_type_condition(const std::string &type)
+{
+    return {[this, type]() -> std::optional<Node> {
+                auto v = G->get_nodes_by_type(type);
+                if (v.empty()) return {};
+                return std::move(v.front());
+            },
+            [this](const Event &ev) { return G->get_node(ev.from); }};
+}
+
+WaitAPI::Condition<Edge> WaitAPI::edge_condition(uint64_t from, uint64_t to, const std::string &type)
+{
+    return {[this, from, to, type]() { return G->get_edge(from, to, type); },
+            [this, type](const Event &ev) { return G->get_edge(ev.from, ev.to, type); }};
+}
+
+WaitAPI::Awaiter<Node> WaitAPI::wait_for_node(const std::string &type)
+{
+    auto c = node_type_condition(type);
+    return wait<Node>(Kind::NODE_TYPE, type, std::move(c.initial), std::move(c.on_event));
+}
+
+WaitAPI::Awaiter<Node> WaitAPI::wait_for_node(uint64_t id)
+{
+    return wait<Node>(Kind::NODE_ID, node_key(id),
+                      [this, id]() { return G->get_node(id); },
+                      [this](const Event &ev) { return G->get_node(ev.from); });
+}
+
+WaitAPI::Awaiter<Edge> WaitAPI::wait_for_edge(uint64_t from, uint64_t to, const std::string &type)
+{
+    auto c = edge_condition(from, to, type);
+    return wait<Edge>(Kind::EDGE, edge_key(from, to, type), std::move(c.initial), std::move(c.on_event));
+}
+
+void WaitAPI::on_node(const std::string &type, std::function<void(std::optional<Node>)> cb)
+{
+    auto c = node_type_condition(type);
+    on<Node>(Kind::NODE_TYPE, type, std::move(c.initial), std::move(c.on_event), std::move(cb));
+}
+
+void WaitAPI::on_edge(uint64_t from, uint64_t to, const std::string &type, std::function<void(std::optional<Edge>)> cb)
+{
+    auto c = edge_condition(from, to, type);
+    on<Edge>(Kind::EDGE, edge_key(from, to, type), std::move(c.initial), std::move(c.on_event), std::move(cb));
+}
+
+std::size_t WaitAPI::pending() const
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    return waiters[0].size() + waiters[1].size() + waiters[2].size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////// SLOTS
+////////////////////////////////////////////////////////////////////////////////////////
+
+void WaitAPI::update_node_slot(uint64_t id, const std::string &type)
+{
+    if (counts[static_cast<int>(Kind::NODE_TYPE)].load(std::memory_order_acquire) > 0)
+        dispatch(Kind::NODE_TYPE, type, Event{id});
+    if (counts[static_cast<int>(Kind::NODE_ID)].load(std::memory_order_acquire) > 0)
+        dispatch(Kind::NODE_ID, node_key(id), Event{id});
+}
+
+void WaitAPI::update_node_attr_slot(uint64_t id, const std::vector<std::string> &att_names)
+{
+    if (counts[static_cast<int>(Kind::NODE_ID)].load(std::memory_order_acquire) > 0)
+        dispatch(Kind::NODE_ID, node_key(id), Event{id, 0, &att_names});
+}
+
+void WaitAPI::update_edge_slot(uint64_t from, uint64_t to, const std::string &type)
+{
+    if (counts[static_cast<int>(Kind::EDGE)].load(std::memory_order_acquire) > 0)
+        dispatch(Kind::EDGE, edge_key(from, to, type), Event{from, to});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////// WAITERS
+////////////////////////////////////////////////////////////////////////////////////////
+
+void WaitAPI::add(Kind kind, const std::string &key, std::shared_ptr<WaiterBase> w)
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    waiters[static_cast<int>(kind)].emplace(key, std::move(w));
+    counts[static_cast<int>(kind)].fetch_add(1, std::memory_order_release);
+}
+
+void WaitAPI::remove(Kind kind, const std::string &key, const WaiterBase *w)
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    auto &list = waiters[static_cast<int>(kind)];
+    auto [begin, end] = list.equal_range(key);
+    auto it = std::find_if(begin, end, [w](const auto &p) { return p.second.get() == w; });
+    if (it == end) return;
+    list.erase(it);
+    counts[static_cast<int>(kind)].fetch_sub(1, std::memory_order_release);
+}
+
+void WaitAPI::dispatch(Kind kind, const std::string &key, const Event &ev)
+{
+    std::vector<std::shared_ptr<WaiterBase>> candidates;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        auto [begin, end] = waiters[static_cast<int>(kind)].equal_range(key);
+        for (auto it = begin; it != end; ++it) candidates.emplace_back(it->second);
+    }
+    // The conditions read G, so they are checked without the lock.
+    for (auto &w : candidates)
+    {
+        if (not w->fire(ev)) continue;
+        remove(kind, key, w.get());
+        w->resume();
+    }
+}
@@ -81,6 +81,7 @@ class GSerializer {
     size_t total_size;
     size_t used_size;
     std::string out_file;
+    DSR::Connections connections;
 
 
     void add_change(ChangeInfo && c);
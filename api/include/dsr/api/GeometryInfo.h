@@ -7,6 +7,9 @@
 
 
 #include <vector>
+#include <span>
+#include <memory>
+#include <optional>
 #include <mutex>
 #include <shared_mutex>
 #include <iostream>
@@ -57,54 +60,76 @@ public:
     typedef boost::geometry::model::box<point> box;
     typedef boost::geometry::model::linestring<point> points;
     typedef std::pair<box, unsigned> value;
+    typedef boost::geometry::index::rtree<value, boost::geometry::index::rstar<16, 4>> rtree_t;
+
+    // Mesh buffers are immutable once registered, they can be shared and read without copies.
+    struct Mesh
+    {
+        std::vector<std::tuple<float, float, float>> positions;
+        std::vector<unsigned short> indices;
+
+        [[nodiscard]] std::span<const std::tuple<float, float, float>> vertices() const { return positions; }
+        [[nodiscard]] std::span<const unsigned short> triangle_indices() const { return indices; }
+    };
+    typedef std::shared_ptr<const Mesh> MeshPtr;
 
     void addQtGeom(Qt3DCore::QEntity* eptr, std::vector<std::tuple<float, float, float>> && positions, std::vector<unsigned short> && indices)
     {
-        poly p;
-        for (auto [x, y, z] : positions)
-        {
-            p.outer().push_back(point(x, y, z));
-        }
+        box b = envelope(positions);
+        std::string name = eptr->objectName().toStdString();
+        auto mesh = std::make_shared<const Mesh>(Mesh{std::move(positions), std::move(indices)});
 
-        box b = boost::geometry::return_envelope<box>(p);
+        // The envelope and the mesh are built before locking, readers only wait for the insertion.
         std::unique_lock<std::shared_mutex> lock(mtx);
         rtree.insert(std::make_pair(b, idx_geom));
-        rtree_.emplace(idx_geom, b);
-        std::string name = eptr->objectName().toStdString();
-        rtree_name_idx.emplace(name, idx_geom);
-        rtree_idx.emplace(idx_geom++, name);
-        geometries.emplace(eptr, std::pair(std::move(positions), std::move(indices)));
-        e_name_map.emplace(name, eptr);
+        insert_maps(eptr, name, b, std::move(mesh));
         lock.unlock();
         emit geometry_added(eptr);
     }
 
-    std::optional<std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>>> getQtGeom(Qt3DCore::QEntity* eptr)
+    std::optional<std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>>> getQtGeom(Qt3DCore::QEntity* eptr) const
+    {
+        if (auto mesh = getQtMesh(eptr); mesh)
+            return std::pair(mesh->positions, mesh->indices);
+        return {};
+    }
+
+    std::optional<std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>>> getQtGeom(const std::string& name) const
+    {
+        if (auto mesh = getQtMesh(name); mesh)
+            return std::pair(mesh->positions, mesh->indices);
+        return {};
+    }
+
+    // Shared, read-only access to the mesh buffers. Use Mesh::vertices() and Mesh::triangle_indices() to avoid copies.
+    MeshPtr getQtMesh(Qt3DCore::QEntity* eptr) const
     {
         std::shared_lock<std::shared_mutex> lock(mtx);
         if (auto it = geometries.find(eptr); it != geometries.end())
             return it->second;
-        else return {};
+        return nullptr;
     }
 
-
-    std::optional<std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>>> getQtGeom(const std::string& name)
+    MeshPtr getQtMesh(const std::string& name) const
     {
         std::shared_lock<std::shared_mutex> lock(mtx);
         if (auto it1 = e_name_map.find(name); it1 != e_name_map.end() )
             if (auto it = geometries.find(it1->second); it != geometries.end())
                 return it->second;
+        return nullptr;
+    }
 
-        return {};
+    std::vector<std::tuple<float, float, float>> getGeomBbox(Qt3DCore::QEntity* eptr) const
+    {
+        return getGeomBbox(eptr->objectName().toStdString());
     }
 
-    std::vector<std::tuple<float, float, float>> getGeomBbox(Qt3DCore::QEntity* eptr)
+    std::vector<std::tuple<float, float, float>> getGeomBbox(const std::string& name) const
     {
-        std::shared_lock<std::shared_mutex> lock(mtx);
-        auto box = rtree_[rtree_name_idx[eptr->objectName().toStdString()]];
-        lock.unlock();
-        auto max = box.max_corner();
-        auto min = box.min_corner();
+        auto geom = get_geom(name);
+        if (not geom.has_value()) return {};
+        auto max = geom->max_corner();
+        auto min = geom->min_corner();
         auto v1 = std::tuple<float, float, float>(min.get<0>(), min.get<1>(), max.get<2>());
         auto v2 = std::tuple<float, float, float>(max.get<0>(), min.get<1>(), min.get<2>());
         auto v3 = std::tuple<float, float, float>(min.get<0>(), max.get<1>(), min.get<2>());
@@ -117,28 +142,19 @@ public:
 
     }
 
-    std::vector<std::tuple<float, float, float>> getGeomBbox(const std::string& name)
+    std::optional<box> get_geom(const std::string& name) const
     {
         std::shared_lock<std::shared_mutex> lock(mtx);
-        auto box = rtree_[rtree_name_idx[name]];
-        lock.unlock();
-        auto max = box.max_corner();
-        auto min = box.min_corner();
-        auto v1 = std::tuple<float, float, float>(min.get<0>(), min.get<1>(), max.get<2>());
-        auto v2 = std::tuple<float, float, float>(max.get<0>(), min.get<1>(), min.get<2>());
-        auto v3 = std::tuple<float, float, float>(min.get<0>(), max.get<1>(), min.get<2>());
-        auto v4 = std::tuple<float, float, float>(max.get<0>(), max.get<1>(), min.get<2>());
-        auto v5 = std::tuple<float, float, float>(min.get<0>(), max.get<1>(), max.get<2>());
-        auto v6 = std::tuple<float, float, float>(max.get<0>(), min.get<1>(), max.get<2>());
-        return std::vector{ std::tuple<float, float, float>(min.get<0>(), min.get<1>(), min.get<2>()),
-                            std::tuple<float, float, float>(max.get<0>(), max.get<1>(), max.get<2>()),
-                            v1, v2, v3, v4, v5, v6};
-
+        if (auto it = rtree_name_idx.find(name); it != rtree_name_idx.end())
+            if (auto it2 = rtree_.find(it->second); it2 != rtree_.end())
+                return it2->second;
+        return {};
     }
-    box get_geom(const std::string& name)
+
+    size_t size() const
     {
         std::shared_lock<std::shared_mutex> lock(mtx);
-        return rtree_[rtree_name_idx[name]];
+        return rtree.size();
     }
 
 
@@ -236,7 +252,7 @@ public:
     }
 
     template<typename Predicate, typename Geometry>
-    std::vector<std::pair<std::string, float>> query(Predicate pred, const Geometry& geom)
+    std::vector<std::pair<std::string, float>> query(Predicate pred, const Geometry& geom) const
     {
 
         std::vector<value> result_n;
@@ -258,10 +274,31 @@ public:
     void geometry_added(Qt3DCore::QEntity* eptr);
 
 private:
-    std::shared_mutex mtx;
+    static box envelope(const std::vector<std::tuple<float, float, float>> &positions)
+    {
+        poly p;
+        p.outer().reserve(positions.size());
+        for (auto [x, y, z] : positions)
+        {
+            p.outer().push_back(point(x, y, z));
+        }
+        return boost::geometry::return_envelope<box>(p);
+    }
+
+    // Called with mtx locked.
+    void insert_maps(Qt3DCore::QEntity* eptr, const std::string &name, const box &b, MeshPtr &&mesh)
+    {
+        rtree_.emplace(idx_geom, b);
+        rtree_name_idx.emplace(name, idx_geom);
+        rtree_idx.emplace(idx_geom++, name);
+        geometries.emplace(eptr, std::move(mesh));
+        e_name_map.emplace(name, eptr);
+    }
+
+    mutable std::shared_mutex mtx;
 
-    std::unordered_map<Qt3DCore::QEntity*, std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>>> geometries;
-    boost::geometry::index::rtree<value, boost::geometry::index::rstar<16, 4>> rtree;
+    std::unordered_map<Qt3DCore::QEntity*, MeshPtr> geometries;
+    rtree_t rtree;
     std::unordered_map<size_t, box> rtree_;
     std::unordered_map<size_t, std::string> rtree_idx;
     std::unordered_map<std::string, size_t> rtree_name_idx;
@@ -5,6 +5,7 @@
 #ifndef DSR_GRAPH
 #define DSR_GRAPH
 
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
@@ -15,10 +16,12 @@
 #include <typeinfo>
 #include <optional>
 #include <type_traits>
+#include <utility>
 #include "dsr/core/crdt/delta_crdt.h"
 #include "dsr/core/rtps/dsrparticipant.h"
 #include "dsr/core/rtps/dsrpublisher.h"
 #include "dsr/core/rtps/dsrsubscriber.h"
+#include "dsr/core/rtps/dsrtransport.h"
 #include "dsr/core/types/crdt_types.h"
 #include "dsr/core/types/user_types.h"
 #include "dsr/core/types/translator.h"
@@ -29,6 +32,9 @@
 #include "dsr/api/dsr_rt_api.h"
 #include "dsr/api/dsr_utils.h"
 #include "dsr/api/dsr_signal_info.h"
+#include "dsr/api/dsr_signal_bus.h"
+#include "dsr/api/dsr_wait_api.h"
+#include "dsr/api/dsr_attr_index.h"
 #include "dsr/core/types/type_checking/dsr_attr_name.h"
 #include "dsr/core/utils.h"
 #include "dsr/core/id_generator.h"
@@ -42,6 +48,10 @@ namespace DSR
 {
     using Nodes = std::unordered_map<uint64_t , mvreg<CRDTNode>>;
     using IDType = uint64_t;
+    class SpatialIndexAPI;
+    class KinematicsAPI;
+    class ImageView;
+    class QueryResult;
 
     /////////////////////////////////////////////////////////////////
     /// CRDT API
@@ -49,6 +59,10 @@ namespace DSR
     class DSRGraph : public QObject
     {
         friend RT_API;
+        friend InnerEigenAPI;
+        friend KinematicsAPI;
+        friend ImageView;
+        friend QueryResult;
 
         public:
         size_t size();
@@ -56,6 +70,9 @@ namespace DSR
         [[deprecated("root parameter is not used anymore")]] DSRGraph(uint64_t root, std::string name, int id, const std::string& dsr_input_file = std::string(), bool all_same_host = true)
                                 : DSRGraph(name, id, dsr_input_file, all_same_host)
         {}
+        // Agent that talks to the others through transport instead of Fast DDS, e.g. a LoopbackTransport
+        // to run several agents in one process.
+        DSRGraph(std::string name, uint32_t id, const std::string& dsr_input_file, std::unique_ptr<Transport> transport_);
 
         ~DSRGraph() override;
 
@@ -71,6 +88,22 @@ namespace DSR
         std::unique_ptr<InnerEigenAPI> get_inner_eigen_api() { return std::make_unique<InnerEigenAPI>(this); };
         std::unique_ptr<RT_API> get_rt_api() { return std::make_unique<RT_API>(this); };
         std::unique_ptr<CameraAPI> get_camera_api(const DSR::Node &camera_node) { return std::make_unique<CameraAPI>(this, camera_node); };
+        // Include dsr/api/dsr_spatial_index_api.h to use it.
+        std::unique_ptr<SpatialIndexAPI> get_spatial_index_api();
+        // Include dsr/api/dsr_kinematics_api.h to use it.
+        std::unique_ptr<KinematicsAPI> get_kinematics_api();
+        // WaitAPI shared by the awaitables of this graph, created on first use and destroyed with it.
+        WaitAPI &get_wait_api();
+
+        // Awaitables, co_await G.wait_for_node("person"). See dsr/api/dsr_wait_api.h.
+        WaitAPI::Awaiter<Node> wait_for_node(const std::string &type) { return get_wait_api().wait_for_node(type); }
+        WaitAPI::Awaiter<Edge> wait_for_edge(uint64_t from, uint64_t to, const std::string &type) { return get_wait_api().wait_for_edge(from, to, type); }
+        template <typename name, typename Pred>
+        auto wait_for_attr(uint64_t id, Pred pred) requires(is_attr_name<name>) { return get_wait_api().wait_for_attr<name>(id, std::move(pred)); }
+
+        // The graph signals as plain callbacks, published before the Qt signals. With DSR_QT_SIGNAL_EMIT=OFF
+        // the Qt signals are never emitted and these are the only notifications. See dsr/api/dsr_signal_bus.h.
+        GraphSignals &callbacks() { return graph_signals; }
 
 
         //////////////////////////////////////////////////////
@@ -82,6 +115,9 @@ namespace DSR
         std::optional<Node> get_node(uint64_t id);
         template<typename No>
         std::optional<uint64_t> insert_node(No &&node) requires (std::is_same_v<std::remove_reference_t<No>, DSR::Node>);
+        // Inserts all the nodes under one lock, with ids reserved in one go. The nodes get their id and name
+        // as in insert_node. Returns the ids of the inserted nodes.
+        std::vector<uint64_t> insert_nodes(std::vector<DSR::Node> &nodes);
         template<typename No>
         bool update_node(No &&node) requires (std::is_same_v<std::remove_cvref_t<No>, DSR::Node>);
         bool delete_node(const DSR::Node& node);
@@ -106,7 +142,24 @@ namespace DSR
         // Nodes
         std::optional<Node> get_node_root() { return get_node("root"); };
         std::vector<Node> get_nodes_by_type(const std::string &type);
+        // Same as get_nodes_by_type with the id of the type computed at compile time.
+        template <typename node_type>
+        std::vector<Node> get_nodes_by_type() requires(node_type::node_type)
+        {
+            return get_nodes_by_type_(node_type::type_id, node_type::attr_name);
+        }
         std::vector<Node> get_nodes_by_types(const std::vector<std::string> &types);
+        // Batched reads that lock G once. Missing nodes or attributes are empty.
+        std::vector<std::optional<Node>> get_nodes(const std::vector<uint64_t> &ids);
+        // ids.size() x names.size() copies of the attributes, without copying the rest of each node.
+        std::vector<std::vector<std::optional<Attribute>>> get_attribs(const std::vector<uint64_t> &ids, const std::vector<std::string> &names);
+        // Opt-in secondary indices on a node attribute, see dsr/api/dsr_attr_index.h. They are kept up to date
+        // by local changes and by the join paths. False if the index already exists.
+        bool create_attr_index(std::string_view att_name, IndexKind kind = IndexKind::HASH);
+        bool drop_attr_index(std::string_view att_name);
+        // Ids of the nodes (of the given type if it is not empty) whose attribute matches pred. Uses the index of
+        // the attribute when it can answer pred and scans the attributes in place otherwise. Nodes are not copied.
+        std::vector<uint64_t> query_nodes(std::string_view att_name, const AttrPredicate &pred, const std::string &type = {});
         std::optional<std::string> get_name_from_id(uint64_t id);
         std::optional<uint64_t> get_id_from_name(const std::string &name);
         std::optional<std::int32_t> get_node_level(const Node &n);
@@ -116,6 +169,11 @@ namespace DSR
 
         // Edges
         std::vector<Edge> get_edges_by_type(const std::string &type);
+        template <typename edge_type>
+        std::vector<Edge> get_edges_by_type() requires(edge_type::edge_type)
+        {
+            return get_edges_by_type_(edge_type::type_id, std::string(edge_type::attr_name));
+        }
         static std::vector<Edge> get_node_edges_by_type(const Node &node, const std::string &type);
         std::vector<Edge> get_edges_to_id(uint64_t id);
         std::optional<std::map<std::pair<uint64_t, std::string>, Edge>> get_edges(uint64_t id);
@@ -262,6 +320,32 @@ namespace DSR
             return ret_type( return_nullopt(static_cast<name*>(nullptr)) ...);
         }
 
+        /**
+         * Calls fn with a const reference to the value of every attribute in name while the graph read lock is held.
+         * Unlike get_node or get_attrib_by_name(id) the node is not copied, which matters for big attributes like images.
+         * fn is only called if the node has all the attributes. References must not escape fn and fn must not modify G.
+         * Returns true if fn was called.
+         */
+        template <typename ... name, typename Fn>
+        inline bool read_attribs_by_name(uint64_t id, Fn &&fn)
+        requires(( ... && is_attr_name<name>))
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = nodes.find(id);
+            if (it == nodes.end() or it->second.empty()) return false;
+            const CRDTNode &node = it->second.read_reg();
+
+            auto values = std::make_tuple(get_attrib_by_name<name>(node) ...);
+            if (not std::apply([](const auto &... v) { return (... && v.has_value()); }, values)) return false;
+
+            auto unwrap = []<typename T>(const std::optional<T> &v) -> decltype(auto) {
+                if constexpr(is_reference_wrapper<T>::value) return v.value().get();
+                else return v.value();
+            };
+            std::apply([&](const auto &... v) { fn(unwrap(v) ...); }, values);
+            return true;
+        }
+
         /**
          * LOCAL ATTRIBUTES MODIFICATION METHODS (for nodes and edges)
          **/
@@ -452,7 +536,8 @@ namespace DSR
 
         void reset()
         {
-            dsrparticipant.remove_participant_and_entities();
+            if (transport) transport->close();
+            else dsrparticipant.remove_participant_and_entities();
 
             nodes.clear();
             deleted.clear();
@@ -519,6 +604,16 @@ namespace DSR
         bool is_copy() const;
 
 
+        // Deltas received before the node or edge they belong to, they are applied when it arrives.
+        struct DeltaBacklog
+        {
+            std::size_t node_attrs = 0;
+            std::size_t edges_from = 0;
+            std::size_t edges_to = 0;
+            std::size_t edge_attrs = 0;
+        };
+        DeltaBacklog delta_backlog() const;
+
         //////////////////////////////////////////////////
         ///// Agents info
         /////////////////////////////////////////////////
@@ -550,6 +645,9 @@ namespace DSR
         ThreadPool tp, tp_delta_attr;
         bool same_host;
         id_generator generator;
+        GraphSignals graph_signals;  // before the members that connect to it.
+        std::unique_ptr<WaitAPI> wait_api;
+        std::once_flag wait_api_once;
 
         //////////////////////////////////////////////////////////////////////////
         // Cache maps
@@ -560,13 +658,39 @@ namespace DSR
         std::unordered_map<uint64_t, std::string> id_map;       // mapping between id and name of nodes.
         std::unordered_map<std::pair<uint64_t, uint64_t>, std::unordered_set<std::string>, hash_tuple> edges;      // collection with all graph edges. ((from, to), key)
         std::unordered_map<uint64_t , std::unordered_set<std::pair<uint64_t, std::string>,hash_tuple>> to_edges;      // collection with all graph edges. (to, (from, key))
-        std::unordered_map<std::string, std::unordered_set<std::pair<uint64_t, uint64_t>, hash_tuple>> edgeType;  // collection with all edge types.
-        std::unordered_map<std::string, std::unordered_set<uint64_t>> nodeType;  // collection with all node types.
+        std::unordered_map<name_id_t, std::unordered_set<std::pair<uint64_t, uint64_t>, hash_tuple>> edgeType;  // collection with all edge types, by name_id.
+        std::unordered_map<name_id_t, std::unordered_set<uint64_t>> nodeType;  // collection with all node types, by name_id.
+        std::unordered_map<std::string, AttributeIndex> attr_indices;     // opt-in indices on node attributes, guarded by _mutex.
 
         void update_maps_node_delete(uint64_t id, const std::optional<CRDTNode>& n);
         void update_maps_node_insert(uint64_t id, const CRDTNode &n);
         void update_maps_edge_delete(uint64_t from, uint64_t to, const std::string &key = "");
         void update_maps_edge_insert(uint64_t from, uint64_t to, const std::string &key);
+        // Removes (from, to) from the edgeType set of key, called after key is removed from edges.
+        void erase_edge_type(uint64_t from, uint64_t to, const std::string &key);
+        void update_attr_indices(uint64_t id, const CRDTNode *n);
+        void update_attr_index(uint64_t id, const std::string &att_name, const CRDTNode &n);
+
+        //////////////////////////////////////////////////////////////////////////
+        // Notifications, to graph_signals and the Qt signals. Called without the locks.
+        //////////////////////////////////////////////////////////////////////////
+        void notify_update_node(uint64_t id, const std::string &type, SignalInfo info);
+        // values are read from the graph if they are needed and not given.
+        void notify_update_node_attr(uint64_t id, const std::vector<std::string> &att_names, SignalInfo info, AttrValues values = {});
+        void notify_update_edge(uint64_t from, uint64_t to, const std::string &type, SignalInfo info);
+        void notify_update_edge_attr(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names, SignalInfo info, AttrValues values = {});
+        void notify_del_edge(uint64_t from, uint64_t to, const std::string &type, SignalInfo info);
+        void notify_del_node(uint64_t id, SignalInfo info);
+        // Called with _mutex held. Copies of the attributes for the *_attr_values callbacks.
+        AttrValues node_attr_values_(uint64_t id, const std::vector<std::string> &att_names) const;
+        AttrValues edge_attr_values_(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names) const;
+
+        // get_*_by_type with the id of the type. Types with the same id share their set in nodeType and
+        // edgeType, so the type of each node is compared too.
+        std::vector<Node> get_nodes_by_type_(name_id_t id, std::string_view type);
+        std::vector<Edge> get_edges_by_type_(name_id_t id, const std::string &type);
+        // Called with _mutex and _mutex_cache_maps held.
+        void append_nodes_of_type_(std::vector<Node> &out, name_id_t id, std::string_view type);
 
 
         //////////////////////////////////////////////////////////////////////////
@@ -608,15 +732,15 @@ namespace DSR
         class NewMessageFunctor {
         public:
             DSRGraph *graph{};
-            std::function<void(eprosima::fastdds::dds::DataReader* reader, DSR::DSRGraph *graph)> f;
+            std::function<void(DSR::TransportSample &&sample, DSR::DSRGraph *graph)> f;
 
             NewMessageFunctor(DSRGraph *graph_,
-                              std::function<void(eprosima::fastdds::dds::DataReader* reader,  DSR::DSRGraph *graph)> f_)
+                              std::function<void(DSR::TransportSample &&sample,  DSR::DSRGraph *graph)> f_)
                     : graph(graph_), f(std::move(f_)) {}
 
             NewMessageFunctor() = default;
 
-            void operator()(eprosima::fastdds::dds::DataReader* reader) const { f(reader, graph); };
+            void operator()(DSR::TransportSample &&sample) const { f(std::move(sample), graph); };
         };
 
         //Custom function for each rtps topic
@@ -641,6 +765,10 @@ namespace DSR
 
 
         //Threads handlers
+        void start_comms(const std::string &dsr_input_file);
+        void subscribe(DSRSubscriber &sub, TopicId topic, const NewMessageFunctor &f);
+        void participant_changed(const std::string &participant, bool joined);
+        [[nodiscard]] std::string participant_name() const;
         std::pair<bool, bool> start_fullgraph_request_thread();
         void start_fullgraph_server_thread();
         void start_subscription_threads(bool showReceived);
@@ -655,6 +783,7 @@ namespace DSR
         // RTSP participant
         //TODO: Move this to a class?
         DSRParticipant dsrparticipant;
+        std::unique_ptr<Transport> transport;    // replaces dsrparticipant when set
         std::unordered_map<std::string, bool> participant_set;
 
         mutable std::mutex participant_set_mutex;
@@ -695,6 +824,24 @@ namespace DSR
         void del_node_signal(uint64_t id, DSR::SignalInfo info = {}) ;
 
     };
+
+    template <typename name, typename Pred>
+    WaitAPI::Awaiter<std::remove_cvref_t<unwrap_reference_wrapper_t<decltype(name::type)>>> WaitAPI::wait_for_attr(uint64_t id, Pred pred)
+    {
+        using T = std::remove_cvref_t<unwrap_reference_wrapper_t<decltype(name::type)>>;
+        auto check = [this, id, pred = std::move(pred)]() -> std::optional<T> {
+            auto v = G->get_attrib_by_name<name>(id);
+            if (v.has_value() and pred(std::as_const(v.value()))) return v;
+            return {};
+        };
+        return wait<T>(Kind::NODE_ID, node_key(id), check,
+                       [check](const Event &ev) -> std::optional<T> {
+                           // update_node_attr_signal says which attributes changed, skip the others.
+                           if (ev.attrs != nullptr and std::find(ev.attrs->begin(), ev.attrs->end(), name::attr_name) == ev.attrs->end())
+                               return {};
+                           return check();
+                       });
+    }
 } // namespace CRDT
 
 #endif
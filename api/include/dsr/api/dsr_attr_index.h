@@ -0,0 +1,92 @@
+//
+// Secondary indices on node attribute values.
+//
+// An index maps the value of one attribute to the ids of the nodes that have it. HASH indices answer
+// equality, ORDERED indices answer equality and ranges. Only scalar attributes are indexed, numbers are
+// compared as double except uint64_t (ids) that keep their exact value. DSRGraph owns the indices and
+// keeps them up to date under its lock, this class is not thread safe.
+//
+
+#ifndef DSR_ATTR_INDEX_H
+#define DSR_ATTR_INDEX_H
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "dsr/core/types/common_types.h"
+
+namespace DSR
+{
+    enum class IndexKind : uint8_t
+    {
+        HASH,
+        ORDERED
+    };
+
+    using IndexValue = std::variant<bool, double, uint64_t, std::string>;
+
+    template <typename T>
+    IndexValue make_index_value(const T &v)
+    {
+        if constexpr (std::is_same_v<T, bool>) return v;
+        else if constexpr (std::is_same_v<T, uint64_t> or std::is_same_v<T, unsigned long long>) return static_cast<uint64_t>(v);
+        else if constexpr (std::is_arithmetic_v<T>) return static_cast<double>(v);
+        else return std::string(std::string_view(v));
+    }
+
+    // Value of an attribute as it is indexed. Empty for vectors and NaN.
+    std::optional<IndexValue> index_value(const ValType &v);
+
+    struct AttrPredicate
+    {
+        enum class Op : uint8_t { EQ, LT, LE, GT, GE, RANGE };
+
+        Op op = Op::EQ;
+        IndexValue a;
+        IndexValue b;   // upper bound of RANGE
+
+        template <typename T> static AttrPredicate eq(const T &v) { return {Op::EQ, make_index_value(v), {}}; }
+        template <typename T> static AttrPredicate lt(const T &v) { return {Op::LT, make_index_value(v), {}}; }
+        template <typename T> static AttrPredicate le(const T &v) { return {Op::LE, make_index_value(v), {}}; }
+        template <typename T> static AttrPredicate gt(const T &v) { return {Op::GT, make_index_value(v), {}}; }
+        template <typename T> static AttrPredicate ge(const T &v) { return {Op::GE, make_index_value(v), {}}; }
+        // lo <= value < hi
+        template <typename T> static AttrPredicate range(const T &lo, const T &hi) { return {Op::RANGE, make_index_value(lo), make_index_value(hi)}; }
+
+        // Values of other types (a string against a number) never match.
+        [[nodiscard]] bool operator()(const IndexValue &v) const;
+    };
+
+    class AttributeIndex
+    {
+        public:
+            explicit AttributeIndex(IndexKind kind_) : kind(kind_) {}
+
+            // Sets the value of node id, an empty value removes it.
+            void set(uint64_t id, const std::optional<IndexValue> &v);
+            void erase(uint64_t id) { set(id, std::nullopt); }
+
+            // Appends to out the ids that match. False if the index can not answer the predicate.
+            bool find(const AttrPredicate &pred, std::vector<uint64_t> &out) const;
+
+            [[nodiscard]] IndexKind index_kind() const { return kind; }
+            [[nodiscard]] std::size_t size() const { return values.size(); }
+
+        private:
+            IndexKind kind;
+            std::unordered_map<uint64_t, IndexValue> values;
+            std::unordered_map<IndexValue, std::unordered_set<uint64_t>> hashed;
+            std::set<std::pair<IndexValue, uint64_t>> ordered;
+    };
+}
+
+#endif //DSR_ATTR_INDEX_H
@@ -3,6 +3,8 @@
 
 #include <dsr/core/topics/IDLGraphPubSubTypes.hpp>
 #include <dsr/core/types/user_types.h>
+#include <dsr/api/dsr_depth_utils.h>
+#include <dsr/api/dsr_image_view.h>
 #include <Eigen/Dense>
 #include <optional>
 
@@ -24,9 +26,19 @@ namespace DSR
             std::optional<std::vector<float>> get_depth_image(); //returns a copy
             //std::optional<std::reference_wrapper<const std::vector<uint8_t>>> get_depth_image() const;
             std::optional<std::vector<std::tuple<float,float,float>>>  get_pointcloud(const std::string& target_frame_node = "", unsigned short subsampling=1);
-            std::optional<std::vector<uint8_t>> get_depth_as_gray_image() const;
 
-            /// methods that DO NOT ask for a copy of the camera node
+            /// methods that DO NOT ask for a copy of the camera node. The depth kernels read cam_depth in place under the graph lock
+            // Zero copy views of cam_rgb and cam_depth. G stays locked for reading while the view is alive.
+            std::optional<ImageView> get_rgb_view() const;
+            std::optional<ImageView> get_depth_view() const;
+            // Gray image scaled to the range of the valid depth values. Invalid pixels are 0.
+            std::optional<std::vector<uint8_t>> get_depth_as_gray_image() const;
+            // Median of each block x block tile, the image has (width / block) x (height / block) pixels.
+            std::optional<std::vector<float>> get_depth_decimated(int block) const;
+            // Depth statistics of the valid pixels inside roi. min() is the top left corner in pixels.
+            std::optional<DSR::depth::RoiStats> get_roi_depth_stats(const Eigen::AlignedBox<float, 2> &roi) const;
+            // Unit normals in the camera frame, xyz per pixel.
+            std::optional<std::vector<float>> get_depth_normals() const;
             std::optional<std::tuple<float,float,float>> get_roi_depth(const std::vector<float> &depth, const Eigen::AlignedBox<float, 2> &roi);
 
             bool reload_camera(const DSR::Node &n);
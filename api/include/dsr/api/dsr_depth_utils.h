@@ -0,0 +1,58 @@
+//
+// Kernels over float depth images (metres, row major, width x height).
+//
+// They work on the buffer stored in the cam_depth attribute without copying it, CameraAPI calls them
+// under the graph lock. Depth values that are not finite or are <= 0 are invalid and never contribute
+// to a result. The loops are written without branches or aliasing so the compiler vectorizes them
+// (the api library is built with -O3), nothing is allocated per pixel.
+//
+
+#ifndef DSR_DEPTH_UTILS_H
+#define DSR_DEPTH_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace DSR::depth
+{
+    struct DepthRange
+    {
+        float min = 0.f;
+        float max = 0.f;
+
+        [[nodiscard]] bool valid() const { return max > min; }
+    };
+
+    struct RoiStats
+    {
+        float mean = 0.f;
+        float median = 0.f;
+        float min = 0.f;
+        std::size_t valid = 0;      // number of valid pixels in the roi
+    };
+
+    // Min and max of the valid depth values reading one pixel out of step in each dimension.
+    DepthRange depth_range(const float *depth, int width, int height, int step = 4);
+
+    // Maps depth in [range.min, range.max] to [0, 255] keeping one pixel out of step in each dimension.
+    // Invalid values are written as 0. The output has (width / step) x (height / step) pixels.
+    void depth_to_gray(const float *depth, int width, int height, int step, DepthRange range,
+                       uint8_t *out, std::size_t out_stride);
+
+    // Median of the valid values in each block x block tile, 0 if the tile has none.
+    // The output has (width / block) x (height / block) pixels. block must be in [1, 16].
+    void decimate_median(const float *depth, int width, int height, int block, float *out);
+
+    // Mean, median and min of the valid values in the pixels [x0, x1) x [y0, y1). The roi is clipped
+    // to the image. Empty if it has no valid pixel.
+    std::optional<RoiStats> roi_stats(const float *depth, int width, int height, int x0, int y0, int x1, int y1);
+
+    // Unit normals in the camera frame (X right, Y outwards, Z up) from central differences of the
+    // back projected pixels. out has 3 x width x height floats, xyz per pixel. Pixels in the border
+    // or with an invalid neighbour get a zero normal. Normals point towards the camera.
+    void normals(const float *depth, int width, int height, float focal_x, float focal_y,
+                 float centre_x, float centre_y, float *out);
+}
+
+#endif //DSR_DEPTH_UTILS_H
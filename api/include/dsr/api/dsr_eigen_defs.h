@@ -13,6 +13,8 @@ namespace Mat
     using Vector2d = Eigen::Matrix<double, 2, 1>;
     using Vector3d = Eigen::Matrix<double, 3, 1>;
     using Vector6d = Eigen::Matrix<double, 6, 1>;
+    using Matrix3Xd = Eigen::Matrix<double, 3, Eigen::Dynamic>;
+    using Matrix6Xd = Eigen::Matrix<double, 6, Eigen::Dynamic>;
     using RTMat = Eigen::Transform<double, 3, Eigen::Affine>;
     using Rot3D = Eigen::Matrix3d;
     using Mat22d = Eigen::Matrix<float, 4, 4>;
@@ -29,7 +29,9 @@ class geometry_queries_api {
     template<typename T> inline std::vector<State> p_status(T input, const std::string& geom)
     {
         std::vector<State> state;
-        GeomInfo::box bbox = m_geom_info->get_geom(geom);
+        auto geom_box = m_geom_info->get_geom(geom);
+        if (not geom_box.has_value()) return state;
+        const GeomInfo::box &bbox = *geom_box;
         if (GeomInfo::within(input, bbox)) state.emplace_back(State::within);
         if (GeomInfo::covered_by(input, bbox)) state.emplace_back(State::covered_by);
         //if (GeomInfo::overlaps(input, bbox)) state.emplace_back(State::overlaps);
@@ -58,6 +60,8 @@ public:
 
     std::vector<std::tuple<float, float, float>> get_geom_bbox_vertices(const std::string& geom);
     std::pair<std::vector<std::tuple<float, float, float>>, std::vector<unsigned short>> get_geom_vertices_and_indices(const std::string& geom);
+    // Same buffers as get_geom_vertices_and_indices without copying them. nullptr if the geometry does not exist.
+    GeomInfo::MeshPtr get_geom_mesh(const std::string& geom);
 
 private:
 
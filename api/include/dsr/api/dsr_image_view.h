@@ -0,0 +1,84 @@
+//
+// Read only view of the image stored in a camera node.
+//
+// The view reads the size attributes once, checks them against the stored buffer and gives typed access
+// to the bytes of cam_rgb or cam_depth without copying them. It holds a shared lock on the graph while it
+// is alive, so the buffer can not change under it. Release it before writing to G from the same thread.
+// copy() gives a view that owns its bytes and does not lock, for holders with an unbounded lifetime such
+// as Python objects.
+//
+
+#ifndef DSR_IMAGE_VIEW_H
+#define DSR_IMAGE_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace DSR
+{
+    class DSRGraph;
+
+    enum class PixelFormat : uint8_t
+    {
+        GRAY8,
+        RGB8,
+        DEPTH32F    // metres
+    };
+
+    class ImageView
+    {
+        public:
+            // Views of the cam_rgb and cam_depth attributes of node id. Empty if the node does not exist, an
+            // attribute is missing or the buffer is smaller than the size attributes say.
+            static std::optional<ImageView> rgb(DSRGraph *G, uint64_t id);
+            static std::optional<ImageView> depth(DSRGraph *G, uint64_t id);
+
+            [[nodiscard]] int width() const { return w; }
+            [[nodiscard]] int height() const { return h; }
+            [[nodiscard]] std::size_t stride() const { return row_bytes; }     // bytes between rows
+            [[nodiscard]] PixelFormat format() const { return fmt; }
+            [[nodiscard]] int channels() const { return fmt == PixelFormat::RGB8 ? 3 : 1; }
+            [[nodiscard]] std::size_t bytes_per_pixel() const { return fmt == PixelFormat::DEPTH32F ? sizeof(float) : channels(); }
+            [[nodiscard]] uint64_t timestamp() const { return ts; }            // timestamp of the image attribute
+            [[nodiscard]] bool locked() const { return lock.owns_lock(); }
+
+            // Bytes of the image, height() * stride().
+            [[nodiscard]] std::span<const uint8_t> bytes() const { return data; }
+
+            // Typed access, float for DEPTH32F and uint8_t for the rest. Empty if T does not match the format.
+            template <typename T>
+            [[nodiscard]] std::span<const T> pixels() const
+            {
+                static_assert(std::is_same_v<T, float> or std::is_same_v<T, uint8_t>);
+                if ((fmt == PixelFormat::DEPTH32F) != std::is_same_v<T, float>) return {};
+                return {reinterpret_cast<const T *>(data.data()), data.size() / sizeof(T)};
+            }
+
+            // Unlocks the graph. The spans must not be used afterwards.
+            void release();
+
+            // View over a copy of the bytes. It is not locked and its spans stay valid while it is alive.
+            [[nodiscard]] ImageView copy() const;
+
+        private:
+            ImageView() = default;
+            static std::optional<ImageView> read(DSRGraph *G, uint64_t id, bool depth);
+
+            std::shared_lock<std::shared_mutex> lock;
+            std::span<const uint8_t> data;
+            std::shared_ptr<const std::vector<uint8_t>> owned;  // storage of data in a copy
+            int w = 0;
+            int h = 0;
+            std::size_t row_bytes = 0;
+            PixelFormat fmt = PixelFormat::RGB8;
+            uint64_t ts = 0;
+    };
+}
+
+#endif //DSR_IMAGE_VIEW_H
@@ -5,10 +5,13 @@
 #include <dsr/core/topics/IDLGraphPubSubTypes.hpp>
 #include <dsr/api/dsr_eigen_defs.h>
 #include <dsr/api/dsr_rt_api.h>
+#include <dsr/api/dsr_signal_bus_qt.h>
 #include <optional>
 #include <cstdint>
 #include <tuple>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace DSR
 {
@@ -41,6 +44,17 @@ namespace DSR
             std::optional<Mat::Vector3d> get_translation_vector(const std::string &dest, const std::string &orig, std::uint64_t timestamp = 0);
             std::optional<Mat::Vector3d> get_euler_xyz_angles(const std::string &dest, const std::string &orig, std::uint64_t timestamp = 0);
 
+            ////////////////////////////////////////////////
+            /// Batched methods. G is locked once for the whole batch and the RT path of
+            /// each node is composed only once, no matter how many nodes share it.
+            ////////////////////////////////////////////////
+            // Points (one per column) given in orig, returned in dest.
+            std::optional<Mat::Matrix3Xd> transform(const std::string &dest, const Mat::Matrix3Xd &points, const std::string &orig, std::uint64_t timestamp = 0);
+            // Column i is {x, y, z, rx, ry, rz} of nodes[i] in dest. NaN if the node is not connected to dest through RT edges.
+            std::optional<Mat::Matrix6Xd> get_poses(const std::string &dest, const std::vector<uint64_t> &nodes, std::uint64_t timestamp = 0);
+            // {x, y, z, rx, ry, rz} in the root frame of every node of the type. ids[i] is the node of column i.
+            std::pair<std::vector<uint64_t>, Mat::Matrix6Xd> get_world_poses(const std::string &type, std::uint64_t timestamp = 0);
+
         public slots:
             void add_or_assign_edge_slot(uint64_t from, uint64_t to, const std::string& edge_type);
             void del_node_slot(uint64_t id);
@@ -52,6 +66,20 @@ namespace DSR
             TransformCache cache;
             NodeReference node_map;
             void remove_cache_entry(const uint64_t id);
+
+            struct Frame
+            {
+                Mat::RTMat pose;    // in the frame of top
+                uint64_t top;       // first ancestor without parent
+                bool valid;
+            };
+            using FrameMap = std::unordered_map<uint64_t, Frame>;
+            // Called with G locked. Memoizes the frames of id and its ancestors.
+            const Frame &get_frame_(uint64_t id, std::uint64_t timestamp, FrameMap &frames);
+            static Mat::Vector6d to_pose_vector(const Mat::RTMat &m);
+
+            QtExecutor executor{this};  // the slots run in the thread of this object, like the cache users
+            Connections connections;
     };
 }
 
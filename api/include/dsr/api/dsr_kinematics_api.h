@@ -0,0 +1,91 @@
+//
+// Forward kinematics cache of the RT tree.
+//
+// Every node reached by an RT edge gets a slot in flat arrays with its parent slot, its pose in the
+// parent frame and its world pose. A change in an RT edge only updates the local pose of the child and
+// marks its subtree as dirty, world poses are recomputed when they are read. Reading a clean pose is
+// O(1) and never copies nodes from G.
+//
+// The slots are connected directly to the graph callbacks, so the cache is up to date as soon as
+// insert_or_assign_edge_RT returns. All the methods are thread safe.
+//
+
+#ifndef DSR_KINEMATICS_API_H
+#define DSR_KINEMATICS_API_H
+
+#include <QObject>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dsr/api/dsr_eigen_defs.h>
+#include <dsr/api/dsr_rt_api.h>
+#include <dsr/api/dsr_signal_bus.h>
+
+namespace DSR
+{
+    class DSRGraph;
+
+    class KinematicsAPI : public QObject
+    {
+        Q_OBJECT
+        public:
+            explicit KinematicsAPI(DSRGraph *G_);
+
+            // Reads all the RT edges of G again.
+            void rebuild();
+
+            // Pose of id in the root frame. Empty if the node is not connected to the root through RT edges.
+            std::optional<Eigen::Isometry3d> world_pose(uint64_t id);
+            // Pose of id in the frame of its RT parent.
+            std::optional<Eigen::Isometry3d> local_pose(uint64_t id) const;
+            // Pose of orig in the frame of dest.
+            std::optional<Eigen::Isometry3d> relative_pose(uint64_t dest, uint64_t orig);
+            std::optional<uint64_t> parent(uint64_t id) const;
+            [[nodiscard]] std::size_t size() const;
+
+        public slots:
+            void add_or_assign_node_slot(uint64_t id, const std::string &type);
+            void add_or_assign_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type);
+            void del_node_slot(uint64_t id);
+            void del_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type);
+
+        private:
+            static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+            DSR::DSRGraph *G;
+            std::unique_ptr<DSR::RT_API> rt;
+            mutable std::shared_mutex mtx;
+
+            std::unordered_map<uint64_t, uint32_t> slot_of;    // node id -> index in the arrays below
+            std::vector<uint64_t> ids;
+            std::vector<uint32_t> parents;
+            std::vector<std::vector<uint32_t>> children;
+            std::vector<Eigen::Isometry3d> local;
+            std::vector<Eigen::Isometry3d> world;
+            std::vector<uint8_t> dirty;     // a dirty node only has dirty descendants
+            std::vector<uint8_t> valid;     // connected to the root
+            std::vector<uint8_t> is_root;
+            std::vector<uint32_t> free_slots;
+
+            uint32_t get_or_create_slot(uint64_t id, bool root);
+            void set_parent(uint32_t slot, uint32_t parent);
+            void mark_dirty(uint32_t slot);
+            void refresh(uint32_t slot);
+            struct EdgeRead
+            {
+                Eigen::Isometry3d local;
+                bool from_is_root;
+            };
+            // Pose of the RT edge from -> to stored in G. Locks G.
+            std::optional<EdgeRead> read_edge(uint64_t from, uint64_t to);
+
+            Connections connections;
+    };
+}
+
+#endif //DSR_KINEMATICS_API_H
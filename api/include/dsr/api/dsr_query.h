@@ -0,0 +1,126 @@
+//
+// Traversal and pattern queries over the graph.
+//
+// A Query starts from some nodes and applies steps in order: follow outgoing or incoming edges of a
+// type up to a depth, or keep the nodes of a type or with an attribute that satisfies a predicate.
+//
+//   // RT descendants of the world node of type plant, up to 8 levels down.
+//   auto plants = Query::name("world").out("RT", 8).of_type("plant").run(&G).ids();
+//   // Objects in the same room as the robot.
+//   auto objects = Query::type("robot").out("in").in("in").of_type("object").run(&G).ids();
+//
+// run() takes a shared lock on G and returns a QueryResult that walks the graph as its results are
+// read, so first() or a limit stop the traversal early. Nodes are read in place, only the results of
+// nodes() are copied. The lock is held until the result is released or destroyed, so release it before
+// writing to G from the same thread. Every step returns each node at most once.
+//
+
+#ifndef DSR_QUERY_H
+#define DSR_QUERY_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "dsr/core/traits.h"
+#include "dsr/core/types/user_types.h"
+
+namespace DSR
+{
+    class DSRGraph;
+    class QueryResult;
+
+    class Query
+    {
+        public:
+            // Start nodes. An empty type matches every node.
+            static Query node(uint64_t id);
+            static Query name(const std::string &name);
+            static Query type(const std::string &type);
+            static Query all() { return type({}); }
+
+            // Nodes reached from the current ones through edges of edge_type, at depth min_depth to max_depth.
+            // An empty edge_type follows every edge. out() follows the edges from the nodes, in() the edges
+            // to them.
+            Query &out(const std::string &edge_type = {}, uint32_t max_depth = 1, uint32_t min_depth = 1);
+            Query &in(const std::string &edge_type = {}, uint32_t max_depth = 1, uint32_t min_depth = 1);
+
+            // Filters.
+            Query &of_type(const std::string &type);
+            Query &has(const std::string &att_name);
+            Query &where(const std::string &att_name, std::function<bool(const Attribute &)> pred);
+            template <typename name, typename Pred>
+            Query &where(Pred pred) requires(is_attr_name<name>)
+            {
+                using T = std::remove_cvref_t<unwrap_reference_wrapper_t<decltype(name::type)>>;
+                return where(std::string(name::attr_name), [pred = std::move(pred)](const Attribute &att) {
+                    const auto *v = std::get_if<T>(&att.value());
+                    return v != nullptr and pred(*v);
+                });
+            }
+
+            [[nodiscard]] QueryResult run(DSRGraph *G) const;
+            // True if a step calls a predicate given to where().
+            [[nodiscard]] bool has_predicates() const;
+
+        private:
+            friend class QueryResult;
+
+            enum class Start : uint8_t { ID, NAME, TYPE };
+            struct Step
+            {
+                enum Kind : uint8_t { OUT, IN, TYPE, ATTR } kind;
+                std::string label;      // edge type, node type or attribute name
+                uint32_t min_depth = 0;
+                uint32_t max_depth = 0;
+                std::function<bool(const Attribute &)> pred;    // empty for has()
+            };
+
+            Query(Start start_, uint64_t id_, std::string label_) : start(start_), start_id(id_), start_label(std::move(label_)) {}
+
+            Start start;
+            uint64_t start_id;
+            std::string start_label;
+            std::vector<Step> steps;
+    };
+
+    class QueryResult
+    {
+        public:
+            QueryResult(QueryResult &&) noexcept;
+            QueryResult &operator=(QueryResult &&) noexcept;
+            ~QueryResult();
+
+            // Next result, empty at the end or after release().
+            std::optional<uint64_t> next();
+            // The next results, at most limit of them.
+            std::vector<uint64_t> ids(std::size_t limit = std::numeric_limits<std::size_t>::max());
+            std::vector<Node> nodes(std::size_t limit = std::numeric_limits<std::size_t>::max());
+            std::optional<uint64_t> first() { return next(); }
+            // Number of results left. Walks them all.
+            std::size_t count();
+
+            [[nodiscard]] bool locked() const { return lock.owns_lock(); }
+            // Unlocks the graph and ends the query.
+            void release();
+
+        private:
+            friend class Query;
+            struct Stage;
+            QueryResult(DSRGraph *G_, const Query &q);
+
+            DSRGraph *G;
+            std::shared_lock<std::shared_mutex> lock;
+            std::shared_lock<std::shared_mutex> lock_cache;
+            std::unique_ptr<Stage> last;    // stages are chained, each one pulls from the one before
+    };
+}
+
+#endif //DSR_QUERY_H
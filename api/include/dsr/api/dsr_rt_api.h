@@ -8,6 +8,7 @@
 #include <dsr/core/types/type_checking/dsr_attr_name.h>
 #include <dsr/api/dsr_eigen_defs.h>
 #include <optional>
+#include <string>
 
 namespace DSR
 {
@@ -21,12 +22,23 @@ namespace DSR
             const int32_t BLOCK_SIZE = 3;   // size of 3-vector for translation and euler xyz angles
             uint32_t HISTORY_SIZE = 0; // Number of blocks in the history.
 
+            // With HISTORY_SIZE > 0 the edge keeps a ring buffer of poses. Each slot is its own attribute
+            // (rt_pose_history_<slot>, {tx, ty, tz, rx, ry, rz}, sampled at the attribute timestamp), so an update
+            // replicates four attributes: the written slot, rt_head_index and the current pose in rt_translation and
+            // rt_rotation_euler_xyz, that are kept as with HISTORY_SIZE = 0. They are written with the same
+            // timestamp, and while a remote agent has only joined some of them the history isn't used.
+            static std::string history_slot_name(uint32_t slot);
+
             void insert_or_assign_edge_RT(Node &n, uint64_t to, const std::vector<float> &trans, const std::vector<float> &rot_euler);
             void insert_or_assign_edge_RT(Node &n, uint64_t to, std::vector<float> &&trans, std::vector<float> &&rot_euler);
 
             static std::optional<Edge> get_edge_RT(const Node &n, uint64_t to);
             std::optional<Mat::RTMat> get_RT_pose_from_parent(const Node &n);
+            // timestamp in ms. 0 returns the last pose, otherwise the pose is interpolated between the two closest
+            // samples of the history (linear for the translation, slerp for the rotation).
             std::optional<Mat::RTMat> get_edge_RT_as_rtmat(const Edge &edge, std::uint64_t timestamp = 0);
+            // Same for the edges stored in the graph, used by the APIs that read G while holding its lock.
+            std::optional<Mat::RTMat> get_edge_RT_as_rtmat(const CRDTEdge &edge, std::uint64_t timestamp = 0);
             std::optional<Eigen::Vector3d> get_translation(const Node &n, uint64_t to, std::uint64_t timestamp = 0);
             std::optional<Eigen::Vector3d> get_translation(uint64_t node_id, uint64_t to, std::uint64_t timestamp = 0);
             // std::optional<Mat::RTMat> get_edge_RT_as_rtmat(const Node &n, uint32_t to);
@@ -39,6 +51,14 @@ namespace DSR
 //            void del_edge_slot(const std::int32_t from, const std::int32_t to, const std::string &edge_type);
         private:
             DSR::DSRGraph *G;
+
+            struct Pose
+            {
+                Eigen::Vector3d translation;
+                Eigen::Quaterniond rotation;
+            };
+            template <typename EdgeType>
+            std::optional<Pose> get_edge_pose(const EdgeType &edge, std::uint64_t timestamp);
     };
 }
 
@@ -0,0 +1,295 @@
+//
+// Typed callbacks for the graph signals, without Qt.
+//
+// DSRGraph publishes every change to its GraphSignals (DSRGraph::callbacks()) before emitting the Qt
+// signals. A callback is connected in one of two modes:
+//  - direct: called in the thread that applies the change, like a Qt::DirectConnection.
+//  - queued: the arguments are copied into a task for an Executor, which runs it in its own thread.
+//    QueuedExecutor leaves the tasks for the owner to run with run_pending(), for agents without an
+//    event loop. dsr_signal_bus_qt.h has the executor for the Qt event loop of a QObject.
+//
+// Publishing doesn't lock: the callbacks are an immutable list swapped on connect and disconnect.
+// A replaced list is freed by the first connect or disconnect after the publishers that could have
+// read it are done, which is right away unless a publish is in progress. Publishers register in one of
+// two epochs and the writer only moves the epoch forward when the older one has no publishers, so a list
+// is freed two epochs after it was replaced. A callback that blocks holds back the lists replaced while
+// it runs, not the ones after.
+// disconnect() waits for the calls of the callback in progress in other threads.
+//
+
+#ifndef DSR_SIGNAL_BUS_H
+#define DSR_SIGNAL_BUS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dsr/api/dsr_signal_info.h>
+#include <dsr/core/mpsc_queue.h>
+#include <dsr/core/types/common_types.h>
+
+namespace DSR
+{
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+        // Called from the publishing threads.
+        virtual void post(std::function<void()> &&task) = 0;
+    };
+
+    // Tasks wait until the owner calls run_pending().
+    class QueuedExecutor final : public Executor
+    {
+    public:
+        void post(std::function<void()> &&task) override
+        {
+            queue.push(std::move(task));
+            pending.fetch_add(1, std::memory_order_release);
+        }
+
+        // Runs the tasks posted so far, in order. Only one thread may call it at a time.
+        std::size_t run_pending()
+        {
+            std::size_t n = 0;
+            while (auto task = queue.pop())
+            {
+                (*task)();
+                n++;
+            }
+            pending.fetch_sub(n, std::memory_order_relaxed);
+            return n;
+        }
+
+        [[nodiscard]] std::size_t size() const { return pending.load(std::memory_order_acquire); }
+
+    private:
+        MPSCQueue<std::function<void()>> queue;
+        std::atomic<std::size_t> pending{0};
+    };
+
+    using CallbackId = uint64_t;
+
+    template <typename... Args>
+    class Signal
+    {
+    public:
+        using Callback = std::function<void(const Args &...)>;
+
+        Signal() : current(new Slots()) {}
+        Signal(const Signal &) = delete;
+        Signal &operator=(const Signal &) = delete;
+        ~Signal() { delete current.load(); }
+
+        CallbackId connect(Callback cb) { return add(std::move(cb), nullptr); }
+        // executor must outlive the connection and the tasks it has been given.
+        CallbackId connect(Executor &executor, Callback cb) { return add(std::move(cb), &executor); }
+
+        // When it returns the callback isn't running and won't be called again, except when it is
+        // called from the callback itself.
+        bool disconnect(CallbackId id)
+        {
+            std::shared_ptr<State> state;
+            {
+                std::unique_lock lck(write_mtx);
+                auto next = std::make_unique<Slots>(*current.load());
+                auto it = std::find_if(next->begin(), next->end(), [id](const Slot &s) { return s.id == id; });
+                if (it == next->end()) return false;
+                state = it->state;
+                next->erase(it);
+                replace(std::move(next));
+            }
+            state->alive.store(false);
+            const int self = calling == state.get() ? 1 : 0;
+            while (state->running.load() > self) std::this_thread::yield();
+            return true;
+        }
+
+        void publish(const Args &... args) const
+        {
+            const ReadGuard guard(*this);
+            const Slots &slots_ = *current.load();
+            for (const auto &s : slots_)
+            {
+                if (s.executor == nullptr)
+                    invoke(*s.state, args...);
+                else
+                    s.executor->post([state = s.state, values = std::tuple<Args...>(args...)]() {
+                        std::apply([&](const Args &... a) { invoke(*state, a...); }, values);
+                    });
+            }
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            const ReadGuard guard(*this);
+            return current.load()->empty();
+        }
+
+        // Replaced lists not freed yet because a publisher may still be reading them.
+        [[nodiscard]] std::size_t retired_lists() const
+        {
+            std::unique_lock lck(write_mtx);
+            return retired.size();
+        }
+
+    private:
+        struct State
+        {
+            explicit State(Callback &&cb_) : cb(std::move(cb_)) {}
+            const Callback cb;
+            std::atomic<bool> alive{true};
+            std::atomic<int> running{0};  // calls in progress, disconnect waits for them.
+        };
+        struct Slot
+        {
+            CallbackId id;
+            std::shared_ptr<State> state;
+            Executor *executor;
+        };
+        using Slots = std::vector<Slot>;
+
+        // Registers a reader of current in the epoch it started in.
+        class ReadGuard
+        {
+        public:
+            explicit ReadGuard(const Signal &signal_) : signal(signal_)
+            {
+                while (true)
+                {
+                    epoch = signal.epoch.load();
+                    signal.readers[epoch & 1].fetch_add(1);
+                    if (signal.epoch.load() == epoch) break;
+                    signal.readers[epoch & 1].fetch_sub(1);
+                }
+            }
+            ~ReadGuard() { signal.readers[epoch & 1].fetch_sub(1); }
+            ReadGuard(const ReadGuard &) = delete;
+            ReadGuard &operator=(const ReadGuard &) = delete;
+
+        private:
+            const Signal &signal;
+            uint64_t epoch;
+        };
+
+        static void invoke(State &state, const Args &... args)
+        {
+            state.running.fetch_add(1);
+            if (state.alive.load())
+            {
+                const State *outer = std::exchange(calling, &state);
+                try { state.cb(args...); }
+                catch (...) { calling = outer; state.running.fetch_sub(1); throw; }
+                calling = outer;
+            }
+            state.running.fetch_sub(1);
+        }
+
+        CallbackId add(Callback &&cb, Executor *executor)
+        {
+            std::unique_lock lck(write_mtx);
+            auto next = std::make_unique<Slots>(*current.load());
+            const CallbackId id = next_id++;
+            next->push_back(Slot{id, std::make_shared<State>(std::move(cb)), executor});
+            replace(std::move(next));
+            return id;
+        }
+
+        // Called with write_mtx held, only the writer moves the epoch forward.
+        void replace(std::unique_ptr<Slots> &&next)
+        {
+            retired.emplace_back(std::unique_ptr<const Slots>(current.exchange(next.release())), epoch.load());
+            // The readers of the epoch before the current one are done when their count is zero, the
+            // ones registered from now on can only read the new list.
+            for (int i = 0; i < 2; i++)
+            {
+                const uint64_t e = epoch.load();
+                if (readers[(e + 1) & 1].load() != 0) break;
+                epoch.store(e + 1);
+            }
+            const uint64_t e = epoch.load();
+            retired.erase(std::remove_if(retired.begin(), retired.end(), [e](const auto &r) { return r.second + 2 <= e; }),
+                          retired.end());
+        }
+
+        std::atomic<const Slots *> current;
+        std::atomic<uint64_t> epoch{0};
+        mutable std::array<std::atomic<std::size_t>, 2> readers{};  // publishers by parity of their epoch.
+        std::vector<std::pair<std::unique_ptr<const Slots>, uint64_t>> retired;  // list and epoch it was replaced in.
+        mutable std::mutex write_mtx;
+        CallbackId next_id = 1;
+        static inline thread_local const State *calling = nullptr;  // callback running in this thread.
+    };
+
+    // Callbacks connected to several signals, disconnected together by clear() or the destructor.
+    // Declare it after the members the callbacks use.
+    class Connections
+    {
+    public:
+        Connections() = default;
+        Connections(const Connections &) = delete;
+        Connections &operator=(const Connections &) = delete;
+        ~Connections() { clear(); }
+
+        template <typename... Args, typename F>
+        void add(Signal<Args...> &signal, F &&cb)
+        {
+            const CallbackId id = signal.connect(std::forward<F>(cb));
+            undo.emplace_back([&signal, id] { signal.disconnect(id); });
+        }
+
+        template <typename... Args, typename F>
+        void add(Signal<Args...> &signal, Executor &executor, F &&cb)
+        {
+            const CallbackId id = signal.connect(executor, std::forward<F>(cb));
+            undo.emplace_back([&signal, id] { signal.disconnect(id); });
+        }
+
+        void clear()
+        {
+            for (auto &f : undo) f();
+            undo.clear();
+        }
+
+    private:
+        std::vector<std::function<void()>> undo;
+    };
+
+    // Attributes changed by an update, value is empty for the removed ones.
+    struct AttrChange
+    {
+        std::string name;
+        std::optional<Attribute> value;
+    };
+    // Built once per update and shared by every callback, the values can't be modified.
+    using AttrValues = std::shared_ptr<const std::vector<AttrChange>>;
+
+    // The six graph signals, with the arguments of the Qt signals of DSRGraph.
+    struct GraphSignals
+    {
+        Signal<uint64_t, std::string, SignalInfo> update_node;
+        Signal<uint64_t, std::vector<std::string>, SignalInfo> update_node_attr;
+        Signal<uint64_t, uint64_t, std::string, SignalInfo> update_edge;
+        Signal<uint64_t, uint64_t, std::string, std::vector<std::string>, SignalInfo> update_edge_attr;
+        Signal<uint64_t, uint64_t, std::string, SignalInfo> del_edge;
+        Signal<uint64_t, SignalInfo> del_node;
+
+        // Same as update_node_attr and update_edge_attr with the values of the attributes, published
+        // right after them. The values are copied out of the graph only while these have callbacks,
+        // so connect to them when the names alone would be followed by a get_node or get_edge.
+        Signal<uint64_t, AttrValues, SignalInfo> update_node_attr_values;
+        Signal<uint64_t, uint64_t, std::string, AttrValues, SignalInfo> update_edge_attr_values;
+    };
+}
+
+#endif //DSR_SIGNAL_BUS_H
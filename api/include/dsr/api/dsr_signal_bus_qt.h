@@ -0,0 +1,32 @@
+//
+// Executor for the callbacks of dsr_signal_bus.h that runs them in the thread of a QObject, like a
+// Qt::QueuedConnection to it. Disconnect the callbacks before the object is destroyed, the tasks
+// already posted are then discarded with its pending events.
+//
+
+#ifndef DSR_SIGNAL_BUS_QT_H
+#define DSR_SIGNAL_BUS_QT_H
+
+#include <QMetaObject>
+#include <QObject>
+
+#include <dsr/api/dsr_signal_bus.h>
+
+namespace DSR
+{
+    class QtExecutor final : public Executor
+    {
+    public:
+        explicit QtExecutor(QObject *context_) : context(context_) {}
+
+        void post(std::function<void()> &&task) override
+        {
+            QMetaObject::invokeMethod(context, std::move(task), Qt::QueuedConnection);
+        }
+
+    private:
+        QObject *context;
+    };
+}
+
+#endif //DSR_SIGNAL_BUS_QT_H
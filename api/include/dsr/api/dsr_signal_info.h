@@ -6,7 +6,9 @@
 #define DSR_DSR_SIGNAL_INFO_H
 
 #include <cstdint>
+#ifdef QT_CORE_LIB
 #include <QtCore>
+#endif
 
 namespace DSR{
     struct SignalInfo
@@ -17,6 +19,8 @@ namespace DSR{
     };
 }
 
+#ifdef QT_CORE_LIB
 Q_DECLARE_METATYPE(DSR::SignalInfo)
+#endif
 
 #endif //DSR_DSR_SIGNAL_INFO_H
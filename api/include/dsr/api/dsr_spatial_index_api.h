@@ -0,0 +1,111 @@
+//
+// Spatial index over the world poses of the nodes in the RT tree.
+//
+// Keeps one boost R-tree per node type with the world frame bounding box of every node hanging
+// from the root through RT edges. World poses are cached and only the subtree below a changed RT
+// edge is recomputed, so queries never walk the kinematic chain like InnerEigenAPI::transform does.
+// Nodes with obj_width, obj_height and obj_depth attributes are indexed with their box, the rest
+// as points.
+//
+
+#ifndef DSR_SPATIAL_INDEX_API_H
+#define DSR_SPATIAL_INDEX_API_H
+
+#include <QObject>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include <dsr/api/dsr_eigen_defs.h>
+#include <dsr/api/dsr_rt_api.h>
+#include <dsr/api/dsr_signal_bus_qt.h>
+
+namespace DSR
+{
+    class DSRGraph;
+
+    class SpatialIndexAPI : public QObject
+    {
+        Q_OBJECT
+        public:
+            using point = boost::geometry::model::point<double, 3, boost::geometry::cs::cartesian>;
+            using box = boost::geometry::model::box<point>;
+            using value = std::pair<box, uint64_t>;
+            using rtree = boost::geometry::index::rtree<value, boost::geometry::index::rstar<16, 4>>;
+
+            struct Item
+            {
+                uint64_t id;
+                Mat::Vector3d position;     // world position of the node
+                double distance;            // distance from the query point to the node box. 0 for box queries.
+            };
+
+            explicit SpatialIndexAPI(DSRGraph *G_);
+
+            // Reads the whole graph again and bulk loads the trees.
+            void rebuild();
+
+            /////////////////////////////////////////////////
+            /// Queries. An empty type matches every node type.
+            /////////////////////////////////////////////////
+            std::vector<Item> nearest(const Mat::Vector3d &p, std::size_t k, const std::string &type = {}) const;
+            std::vector<Item> radius(const Mat::Vector3d &p, double r, const std::string &type = {}) const;
+            std::vector<Item> box_query(const Mat::Vector3d &min, const Mat::Vector3d &max, const std::string &type = {}) const;
+
+            std::optional<Mat::RTMat> get_world_pose(uint64_t id) const;
+            std::optional<Mat::Vector3d> get_world_position(uint64_t id) const;
+            std::optional<box> get_bounds(uint64_t id) const;
+            [[nodiscard]] std::size_t size() const;
+
+        public slots:
+            void add_or_assign_node_slot(uint64_t id, const std::string &type);
+            void add_or_assign_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type);
+            void del_node_slot(uint64_t id);
+            void del_edge_slot(uint64_t from, uint64_t to, const std::string &edge_type);
+
+        private:
+            struct Entry
+            {
+                uint64_t parent = 0;                        // 0 when the node has no RT parent
+                std::vector<uint64_t> children;
+                Mat::RTMat local = Mat::RTMat::Identity();  // pose in the parent frame
+                Mat::RTMat world = Mat::RTMat::Identity();
+                Mat::Vector3d half_extents = Mat::Vector3d::Zero();
+                std::string type;
+                box bounds;
+                bool indexed = false;
+            };
+
+            DSR::DSRGraph *G;
+            std::unique_ptr<DSR::RT_API> rt;
+            mutable std::shared_mutex mtx;
+            uint64_t root_id = 0;
+            std::unordered_map<uint64_t, Entry> entries;
+            std::unordered_map<std::string, rtree> trees;
+
+            Entry &get_or_load_entry(uint64_t id);
+            std::optional<Mat::Vector3d> read_half_extents(uint64_t id);
+            box world_bounds(const Entry &e) const;
+            void detach(uint64_t id);
+            void unindex(Entry &e, uint64_t id);
+            void index(Entry &e, uint64_t id);
+            // Recomputes the world pose of id and its descendants and updates the trees.
+            void update_subtree(uint64_t id);
+            void unindex_subtree(uint64_t id);
+
+            template <typename Predicate>
+            void query(const std::string &type, const Predicate &pred, std::vector<value> &out) const;
+            [[nodiscard]] Item make_item(const value &v, const point &p) const;
+
+            QtExecutor executor{this};  // the slots run in the thread of this object
+            Connections connections;
+    };
+}
+
+#endif //DSR_SPATIAL_INDEX_API_H
@@ -0,0 +1,238 @@
+//
+// Awaitable conditions on the graph.
+//
+// co_await on the objects returned by wait_for_* suspends the coroutine until the condition holds and
+// resumes it with the value that satisfied it. The condition is checked once when the coroutine is
+// suspended and then only when G emits a signal for the awaited node or edge. The slots are connected
+// directly to the graph callbacks, which are published by the join paths as soon as a local change or a
+// remote delta is applied, so there is no polling and the coroutine is resumed on the thread that
+// applied the change (the DDS reader or the thread that called G). Move heavy continuations to your own
+// executor. Pending waiters are resumed with an empty value when the WaitAPI is destroyed.
+//
+
+#ifndef DSR_WAIT_API_H
+#define DSR_WAIT_API_H
+
+#include <QObject>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dsr/api/dsr_signal_bus.h"
+#include "dsr/core/traits.h"
+#include "dsr/core/types/user_types.h"
+
+namespace DSR
+{
+    class DSRGraph;
+
+    // Fire and forget coroutine. It starts running when it is called and frees itself when it ends.
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    class WaitAPI : public QObject
+    {
+        Q_OBJECT
+        public:
+            enum class Kind : uint8_t
+            {
+                NODE_TYPE,  // key is the node type
+                NODE_ID,    // key is the node id
+                EDGE        // key is from, to and edge type
+            };
+
+            // Signal that woke a waiter. attrs is null for update_node_signal.
+            struct Event
+            {
+                uint64_t from = 0;
+                uint64_t to = 0;
+                const std::vector<std::string> *attrs = nullptr;
+            };
+
+        private:
+            struct WaiterBase
+            {
+                virtual ~WaiterBase() = default;
+                // Sets the value and wins the waiter if the condition holds.
+                virtual bool fire(const Event &ev) = 0;
+                // Wins the waiter with an empty value.
+                bool cancel() { return not fired.exchange(true, std::memory_order_acq_rel); }
+
+                std::atomic<bool> fired{false};
+                std::function<void()> resume;
+            };
+
+            template <typename T>
+            struct Waiter : WaiterBase
+            {
+                bool fire(const Event &ev) override
+                {
+                    if (fired.load(std::memory_order_acquire)) return false;
+                    auto v = on_event(ev);
+                    if (not v.has_value() or fired.exchange(true, std::memory_order_acq_rel)) return false;
+                    value = std::move(v);
+                    return true;
+                }
+                bool try_now()
+                {
+                    auto v = initial();
+                    if (not v.has_value() or fired.exchange(true, std::memory_order_acq_rel)) return false;
+                    value = std::move(v);
+                    return true;
+                }
+
+                std::function<std::optional<T>()> initial;
+                std::function<std::optional<T>(const Event &)> on_event;
+                std::optional<T> value;
+            };
+
+        public:
+            template <typename T>
+            class Awaiter
+            {
+                public:
+                    bool await_ready()
+                    {
+                        return state->try_now();
+                    }
+
+                    bool await_suspend(std::coroutine_handle<> h)
+                    {
+                        // The coroutine may be resumed by another thread as soon as the waiter is registered,
+                        // so nothing from this object is used after add().
+                        auto w = state;
+                        auto *a = api;
+                        const auto k = kind;
+                        auto key_copy = key;
+                        w->resume = [h] { h.resume(); };
+                        a->add(k, key_copy, w);
+                        // The condition may have become true between await_ready and add.
+                        if (w->try_now())
+                        {
+                            a->remove(k, key_copy, w.get());
+                            return false;
+                        }
+                        return true;
+                    }
+
+                    // Empty if the WaitAPI was destroyed before the condition held.
+                    std::optional<T> await_resume() { return std::move(state->value); }
+
+                private:
+                    friend WaitAPI;
+                    Awaiter(WaitAPI *api_, Kind kind_, std::string key_, std::shared_ptr<Waiter<T>> state_)
+                        : api(api_), kind(kind_), key(std::move(key_)), state(std::move(state_)) {}
+
+                    WaitAPI *api;
+                    Kind kind;
+                    std::string key;
+                    std::shared_ptr<Waiter<T>> state;
+            };
+
+            explicit WaitAPI(DSRGraph *G_);
+            ~WaitAPI() override;
+
+            Awaiter<Node> wait_for_node(const std::string &type);
+            Awaiter<Node> wait_for_node(uint64_t id);
+            Awaiter<Edge> wait_for_edge(uint64_t from, uint64_t to, const std::string &type);
+
+            // Callback versions of the conditions above, see on().
+            void on_node(const std::string &type, std::function<void(std::optional<Node>)> cb);
+            void on_edge(uint64_t from, uint64_t to, const std::string &type, std::function<void(std::optional<Edge>)> cb);
+
+            // Waits until pred(value) is true for attribute name of node id and returns that value.
+            // Defined in dsr_api.h.
+            template <typename name, typename Pred>
+            Awaiter<std::remove_cvref_t<unwrap_reference_wrapper_t<decltype(name::type)>>> wait_for_attr(uint64_t id, Pred pred);
+
+            // Generic condition. initial is checked when the coroutine is suspended and on_event every time
+            // G signals a change for the key. Both return the value that resumes the coroutine, or nothing.
+            template <typename T>
+            Awaiter<T> wait(Kind kind, std::string key, std::function<std::optional<T>()> initial,
+                            std::function<std::optional<T>(const Event &)> on_event)
+            {
+                auto w = std::make_shared<Waiter<T>>();
+                w->initial = std::move(initial);
+                w->on_event = std::move(on_event);
+                return Awaiter<T>(this, kind, std::move(key), std::move(w));
+            }
+
+            // Same conditions without a coroutine. cb gets the value, or nothing when the WaitAPI is destroyed,
+            // from the thread that applied the change. It is called at most once.
+            template <typename T>
+            void on(Kind kind, const std::string &key, std::function<std::optional<T>()> initial,
+                    std::function<std::optional<T>(const Event &)> on_event, std::function<void(std::optional<T>)> cb)
+            {
+                auto w = std::make_shared<Waiter<T>>();
+                w->initial = std::move(initial);
+                w->on_event = std::move(on_event);
+                std::weak_ptr<Waiter<T>> weak = w;
+                w->resume = [weak, cb = std::move(cb)] { if (auto s = weak.lock()) cb(std::move(s->value)); };
+                if (w->try_now())
+                {
+                    w->resume();
+                    return;
+                }
+                add(kind, key, w);
+                if (w->try_now())
+                {
+                    remove(kind, key, w.get());
+                    w->resume();
+                }
+            }
+
+            static std::string node_key(uint64_t id) { return std::to_string(id); }
+            static std::string edge_key(uint64_t from, uint64_t to, const std::string &type)
+            {
+                return std::to_string(from) + ':' + std::to_string(to) + ':' + type;
+            }
+
+            [[nodiscard]] std::size_t pending() const;
+
+        public slots:
+            void update_node_slot(uint64_t id, const std::string &type);
+            void update_node_attr_slot(uint64_t id, const std::vector<std::string> &att_names);
+            void update_edge_slot(uint64_t from, uint64_t to, const std::string &type);
+
+        private:
+            template <typename T>
+            struct Condition
+            {
+                std::function<std::optional<T>()> initial;
+                std::function<std::optional<T>(const Event &)> on_event;
+            };
+            Condition<Node> node_type_condition(const std::string &type);
+            Condition<Edge> edge_condition(uint64_t from, uint64_t to, const std::string &type);
+
+            using WaiterList = std::unordered_multimap<std::string, std::shared_ptr<WaiterBase>>;
+
+            DSRGraph *G;
+            mutable std::mutex mtx;
+            WaiterList waiters[3];
+            std::atomic<std::size_t> counts[3] = {0, 0, 0};     // read by the slots without the lock
+            Connections connections;
+
+            void add(Kind kind, const std::string &key, std::shared_ptr<WaiterBase> w);
+            void remove(Kind kind, const std::string &key, const WaiterBase *w);
+            void dispatch(Kind kind, const std::string &key, const Event &ev);
+    };
+}
+
+#endif //DSR_WAIT_API_H
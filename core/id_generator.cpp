@@ -3,57 +3,72 @@
 //
 
 #include <dsr/core/id_generator.h>
+#include <algorithm>
 #include <thread>
 #include <iostream>
 #include <iomanip>
 
-inline std::chrono::system_clock::time_point id_generator::get_time_point()
+inline uint64_t id_generator::current_period() const
 {
-    auto now = std::chrono::system_clock::now();
-    std::chrono::time_point pt_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(now);
-    if (pt_ns < last_point)
-    {
-        return last_point;
-    }
-    last_point = pt_ns;
-    return pt_ns;
+    auto now = std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now());
+    return now.time_since_epoch().count() / time_unit - start_time / time_unit;
 }
 
-uint64_t id_generator::generate()
+uint64_t id_generator::reserve(uint64_t n)
 {
-    constexpr uint16_t mask_counter = (1 << counter_size) - 1;
-    std::unique_lock<id_generator::mtx_type> lock(mtx);
-    uint64_t current = get_time_point().time_since_epoch().count() / time_unit - start_time / time_unit;
-    if (elapsed_time < current)
+    uint64_t prev = last.load(std::memory_order_relaxed);
+    while (true)
     {
-        elapsed_time = current;
-        counter = 0;
-    }
-    else
-    {
-        counter = (counter + 1) & mask_counter;
-        if (counter == 0)
+        const uint64_t current = current_period();
+        // A new period starts its counter at 0, otherwise the counter goes on and carries into the time.
+        const uint64_t first = (prev >> counter_size) < current ? current << counter_size : prev + 1;
+        const uint64_t end = first + n - 1;
+
+        if ((end >> counter_size) >= (static_cast<uint64_t>(1) << time_size))
+        {
+            throw std::logic_error("time is over the limit, restart the agent");
+        }
+
+        if ((end >> counter_size) > current + max_lead)
+        {
+            // The last id would be too far ahead of the clock. Nothing is held while waiting.
+            std::this_thread::sleep_for(std::chrono::milliseconds(((end >> counter_size) - current - max_lead) * 10));
+            prev = last.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (last.compare_exchange_weak(prev, end, std::memory_order_relaxed))
         {
-            elapsed_time += 1;
-            auto overtime = elapsed_time - current;
-            auto tp = std::chrono::system_clock::time_point{
-                    std::chrono::milliseconds{overtime * 10}} -
-                      std::chrono::system_clock::time_point {std::chrono::nanoseconds{std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()).time_since_epoch().count() % (int64_t)time_unit}};
-
-            /*std::cout << "BLOCK  " << tp.count()
-                      << std::endl;*/
-            std::this_thread::sleep_for(tp);
+            return first;
         }
     }
+}
+
+inline uint64_t id_generator::make_id(uint64_t time_counter) const
+{
+    return (time_counter << agent_id_size) | static_cast<uint64_t>(agent_id);
+}
+
+uint64_t id_generator::generate()
+{
+    return make_id(reserve(1));
+}
 
-    if (elapsed_time >= (static_cast<uint64_t>(1) << time_size))
+std::vector<uint64_t> id_generator::generate_n(std::size_t n)
+{
+    std::vector<uint64_t> ids;
+    if (n == 0) return ids;
+    ids.reserve(n);
+    while (ids.size() < n)
     {
-        throw std::logic_error("time is over the limit, restart the agent");
+        const uint64_t count = std::min<uint64_t>(n - ids.size(), max_batch);
+        const uint64_t first = reserve(count);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            ids.emplace_back(make_id(first + i));
+        }
     }
-
-    return (static_cast<uint64_t>(elapsed_time) << (agent_id_size + counter_size)) |
-           (static_cast<uint64_t>(counter) << agent_id_size) |
-           static_cast<uint64_t>(agent_id);
+    return ids;
 }
 
 std::tuple<uint64_t, uint16_t, uint16_t> id_generator::parse(uint64_t id)
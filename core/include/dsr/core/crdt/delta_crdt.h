@@ -412,7 +412,7 @@ public:
         return dk.ds.begin()->second;
     }
 
-    bool empty() {
+    bool empty() const {
         return dk.ds.empty();
     }
 
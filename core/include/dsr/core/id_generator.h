@@ -19,9 +19,13 @@
 #ifndef ID_GENERATOR_H
 #define ID_GENERATOR_H
 
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <stdexcept>
+#include <tuple>
+#include <vector>
 
 //Bits for each field.
 static constexpr auto time_size = 40;    // lower bits of the timestamps.
@@ -32,22 +36,34 @@ static constexpr auto agent_id_size = 12;
 static constexpr auto time_unit = 1e7;
 
 
+/*
+ * Generation is lock-free. The last (timestamp, counter) pair is packed in one atomic word that is
+ * advanced with a CAS. When the counter of a timestamp is exhausted it carries into the timestamp, so
+ * a burst borrows ids from the next periods instead of sleeping. The borrowed time is bounded by
+ * max_lead, for the last id of a reservation too: past it the generator waits for the clock.
+ * The lead is not persisted. An agent restarted with the same agent_id less than max_lead periods
+ * (one second) after its last id was generated can hand out ids of its previous run again, so wait
+ * at least that long before restarting it.
+ */
 class id_generator
 {
-    using mtx_type = std::mutex;
+    static constexpr uint64_t max_lead = 100;   // periods, one second.
+    static constexpr uint64_t max_batch = max_lead << counter_size;  // ids reserved at once, so a batch fits in max_lead.
 
     uint64_t start_time;    //Timestamp of start.
-    uint64_t elapsed_time;  //Difference between last point and start_time, used to create the time segment in the id.
-    uint16_t agent_id;      //identifier of the agent. This value must be unique for each generator. The "agent_id" of the agent should be used here.
-    uint16_t counter;       //Counter to generate ids in an equal timestamp.
-    mtx_type mtx;           //Lock for thread safe generation.
-    std::chrono::system_clock::time_point last_point; //We use this to check that time_point doesn't go backwards. TODO: we should use a monotonic clock.
+    //identifier of the agent. This value must be unique for each generator. The "agent_id" of the agent should be used here.
+    uint16_t agent_id;
+    //Last (elapsed_time << counter_size | counter) handed out. It never goes backwards, even if the clock does.
+    std::atomic<uint64_t> last{0};
 
     [[nodiscard]] static inline bool check_agent_id(uint16_t agent_id) {
         return agent_id < (1<<agent_id_size);
     }
 
-    inline std::chrono::system_clock::time_point get_time_point();
+    [[nodiscard]] inline uint64_t current_period() const;
+    // Reserves n consecutive (time, counter) values and returns the first one.
+    [[nodiscard]] uint64_t reserve(uint64_t n);
+    [[nodiscard]] inline uint64_t make_id(uint64_t time_counter) const;
 public:
 
     explicit id_generator(uint16_t agent_id_)
@@ -58,13 +74,13 @@ public:
         }
 
         start_time = 1609459200000000000; // epoch of 2021-01-01 00:00:00 GMT in nanoseconds
-        elapsed_time = 0;
         agent_id = agent_id_;
-        counter  = 0;
-        last_point = std::chrono::system_clock::time_point { std::chrono::system_clock::duration {0}};
     }
 
     [[nodiscard]] uint64_t generate();
+    // n ids for batch inserts, reserved with one atomic operation per max_batch ids. They are sorted, a batch
+    // larger than what max_lead allows waits for the clock like generate() does.
+    [[nodiscard]] std::vector<uint64_t> generate_n(std::size_t n);
     [[nodiscard]] static std::tuple<uint64_t, uint16_t, uint16_t> parse(uint64_t id);
     [[nodiscard]] static std::string hex_string(uint64_t id);
 
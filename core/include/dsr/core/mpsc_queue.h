@@ -0,0 +1,54 @@
+#ifndef _MPSC_QUEUE_H_
+#define _MPSC_QUEUE_H_
+
+#include <atomic>
+#include <optional>
+
+namespace DSR
+{
+    //
+    // Unbounded multi-producer single-consumer queue. Producers never block, pop returns nothing while
+    // the queue is empty.
+    //
+    template <typename T>
+    class MPSCQueue
+    {
+    public:
+        MPSCQueue() : head(new Cell), tail(head.load()) {}
+        ~MPSCQueue()
+        {
+            while (pop()) {}
+            delete tail;
+        }
+        MPSCQueue(const MPSCQueue &) = delete;
+        MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+        void push(T &&value)
+        {
+            auto *cell = new Cell;
+            cell->value.emplace(std::move(value));
+            head.exchange(cell, std::memory_order_acq_rel)->next.store(cell, std::memory_order_release);
+        }
+
+        std::optional<T> pop()
+        {
+            Cell *next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) return {};
+            std::optional<T> value(std::move(next->value));
+            delete tail;
+            tail = next;
+            return value;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<Cell *> next{nullptr};
+            std::optional<T> value;
+        };
+        std::atomic<Cell *> head;
+        Cell *tail;
+    };
+}
+
+#endif // _MPSC_QUEUE_H_
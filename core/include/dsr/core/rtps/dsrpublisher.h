@@ -10,6 +10,7 @@
 #include <fastdds/dds/publisher/DataWriterListener.hpp>
 
 #include <dsr/core/topics/IDLGraphPubSubTypes.hpp>
+#include <dsr/core/rtps/dsrtransport.h>
 
 class DSRPublisher
 {
@@ -17,6 +18,8 @@ public:
     DSRPublisher();
     virtual ~DSRPublisher();
     [[nodiscard]] std::tuple<bool, eprosima::fastdds::dds::Publisher*, eprosima::fastdds::dds::DataWriter*> init(eprosima::fastdds::dds::DomainParticipant *mp_participant_, eprosima::fastdds::dds::Topic *topic,  bool isStreamData = false);
+    // Writes through the transport instead of Fast DDS.
+    void init(DSR::Transport *transport_);
     [[nodiscard]] eprosima::fastdds::rtps::GUID_t getParticipantID() const;
     bool write(IDL::GraphRequest *object);
     bool write(IDL::MvregNode *object);
@@ -26,6 +29,7 @@ public:
     bool write(std::vector<IDL::MvregNodeAttr> *object);
 
 private:
+    DSR::Transport *transport;
     eprosima::fastdds::dds::DomainParticipant *mp_participant;
     eprosima::fastdds::dds::Publisher *mp_publisher;
     eprosima::fastdds::dds::DataWriter *mp_writer;
@@ -7,6 +7,8 @@
 
 #include <functional>
 
+#include <dsr/core/rtps/dsrtransport.h>
+
 
 class DSRSubscriber
 {
@@ -16,9 +18,12 @@ public:
     [[nodiscard]] std::tuple<bool, eprosima::fastdds::dds::Subscriber*, eprosima::fastdds::dds::DataReader*>
 	          init(eprosima::fastdds::dds::DomainParticipant *mp_participant_,
                    eprosima::fastdds::dds::Topic *topic,
-				   const std::function<void(eprosima::fastdds::dds::DataReader*)>&  f_,
+                   DSR::TopicId topic_id,
+				   const DSR::Transport::SampleHandler&  f_,
 				   std::mutex& mtx,
 				   bool isStreamData = false);
+    // Receives from the transport instead of Fast DDS.
+    void init(DSR::Transport *transport, DSR::TopicId topic_id, const DSR::Transport::SampleHandler& f_);
 
     eprosima::fastdds::dds::Subscriber *getSubscriber();
     eprosima::fastdds::dds::DataReader *getDataReader();
@@ -38,7 +43,8 @@ private:
         void on_data_available(
                 eprosima::fastdds::dds::DataReader* reader) override;
 
-		std::function<void(eprosima::fastdds::dds::DataReader* sub)>  f;
+		DSR::TopicId topic_id{};
+		DSR::Transport::SampleHandler  f;
 
 	} m_listener;
 
@@ -0,0 +1,61 @@
+#ifndef _TRANSPORT_H_
+#define _TRANSPORT_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <variant>
+
+#include <dsr/core/topics/IDLGraph.hpp>
+
+namespace DSR
+{
+    // Topics shared by the agents. The value is the index of the sample type in TransportSample.
+    enum class TopicId : uint8_t
+    {
+        NODE,
+        NODE_ATTRS,
+        EDGE,
+        EDGE_ATTRS,
+        GRAPH_REQUEST,
+        GRAPH_ANSWER
+    };
+
+    inline constexpr std::size_t TOPIC_COUNT = 6;
+
+    using TransportSample = std::variant<IDL::MvregNode, IDL::MvregNodeAttrVec, IDL::MvregEdge,
+                                         IDL::MvregEdgeAttrVec, IDL::GraphRequest, IDL::OrMap>;
+
+    //
+    // Exchanges samples between the agents of a graph. DSRPublisher and DSRSubscriber use it when they
+    // are initialized with one, otherwise they talk to Fast DDS directly.
+    //
+    class Transport
+    {
+    public:
+        using SampleHandler = std::function<void(TransportSample &&)>;
+        // Called with joined == false when the agent leaves.
+        using ParticipantHandler = std::function<void(const std::string &participant, bool joined)>;
+
+        virtual ~Transport() = default;
+
+        // Connects the agent under the participant name, the one it sends in GraphRequest::from.
+        virtual void join(const std::string &participant, ParticipantHandler on_participant) = 0;
+        // Disconnects the agent. Writes fail and handlers are not called afterwards.
+        virtual void close() = 0;
+
+        // Sends the sample to the other agents subscribed to its topic.
+        virtual bool write(TransportSample &&sample) = 0;
+
+        // Handlers of a topic are called one at a time. unsubscribe waits for a running handler.
+        virtual void subscribe(TopicId topic, SampleHandler handler) = 0;
+        virtual void unsubscribe(TopicId topic) = 0;
+    };
+
+    constexpr TopicId topic_of(const TransportSample &sample)
+    {
+        return static_cast<TopicId>(sample.index());
+    }
+}
+
+#endif // _TRANSPORT_H_
@@ -0,0 +1,90 @@
+#ifndef _LOOPBACK_TRANSPORT_H_
+#define _LOOPBACK_TRANSPORT_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dsr/core/mpsc_queue.h>
+#include <dsr/core/rtps/dsrtransport.h>
+
+namespace DSR
+{
+    class LoopbackTransport;
+
+    //
+    // Agents of the same process connected without Fast DDS, the in-process counterpart of a DDS domain.
+    // Each agent gets a LoopbackTransport with connect().
+    //
+    class LoopbackDomain : public std::enable_shared_from_this<LoopbackDomain>
+    {
+    public:
+        [[nodiscard]] static std::shared_ptr<LoopbackDomain> create() { return std::shared_ptr<LoopbackDomain>(new LoopbackDomain); }
+        [[nodiscard]] std::unique_ptr<LoopbackTransport> connect();
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        friend class LoopbackTransport;
+        LoopbackDomain() = default;
+
+        void add(LoopbackTransport *t);
+        void remove(LoopbackTransport *t);
+        bool deliver(const LoopbackTransport *from, TransportSample &&sample);
+
+        mutable std::shared_mutex mtx;
+        std::vector<LoopbackTransport *> endpoints;
+    };
+
+    //
+    // Transport of one agent in a LoopbackDomain. Samples are copied into the lock-free queue of each
+    // receiver and delivered in order by its own thread, as a DDS listener would.
+    //
+    class LoopbackTransport final : public Transport
+    {
+    public:
+        explicit LoopbackTransport(std::shared_ptr<LoopbackDomain> domain_);
+        ~LoopbackTransport() override;
+
+        void join(const std::string &participant, ParticipantHandler on_participant) override;
+        void close() override;
+        bool write(TransportSample &&sample) override;
+        void subscribe(TopicId topic, SampleHandler handler) override;
+        void unsubscribe(TopicId topic) override;
+
+    private:
+        friend class LoopbackDomain;
+
+        struct ParticipantEvent
+        {
+            std::string participant;
+            bool joined;
+        };
+        using Message = std::variant<TransportSample, ParticipantEvent>;
+
+        void push(Message &&m);
+        void run();
+
+        std::shared_ptr<LoopbackDomain> domain;
+        std::string name;
+        std::atomic<bool> joined{false};
+
+        MPSCQueue<Message> queue;
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<bool> stop{false};
+
+        std::mutex handlers_mtx;
+        std::array<SampleHandler, TOPIC_COUNT> handlers;
+        std::array<std::atomic<bool>, TOPIC_COUNT> subscribed{};
+        ParticipantHandler participant_handler;
+
+        std::thread worker;
+    };
+}
+
+#endif // _LOOPBACK_TRANSPORT_H_
@@ -28,6 +28,7 @@ template<const std::string_view& n, AttributeType Tn>
 struct Attr {
     static constexpr bool attr_type = std::bool_constant<allowed_types<unwrap_reference_wrapper_t<Tn>>>();
     static constexpr std::string_view attr_name = std::string_view(n);
+    static constexpr name_id_t attr_id = name_id(n);
     static Tn type;
 };
 
@@ -73,7 +74,9 @@ static constexpr auto reg_fn = []() -> auto
 #define COMMA_TEMPLATE() ,
 
 
-inline std::unordered_map<std::string_view, std::function<bool(const std::any&)>> attribute_types::map_fn_;
+inline std::unordered_map<name_id_t, attribute_types::Entry> attribute_types::types_;
+inline std::unordered_map<name_id_t, attribute_types::Entry> attribute_types::runtime_types_;
+inline std::shared_mutex attribute_types::mtx_;
 
 /*
  * Generic
@@ -111,6 +114,7 @@ REGISTER_TYPE(rt_rotation_euler_xyz_velocity, std::reference_wrapper<const std::
 REGISTER_TYPE(rt_timestamps, std::reference_wrapper<const std::vector<uint64_t>> , false)
 REGISTER_TYPE(rt_se2_covariance, std::reference_wrapper<const std::vector<float>>, true)
 REGISTER_TYPE(rt_head_index, int, false)
+REGISTER_TYPE(rt_history_size, int, false) /* Number of slots of the pose history (rt_pose_history_<slot> attributes) */
 
 
 /*
@@ -17,6 +17,7 @@ template<const std::string_view& n>
 struct EdgeType {
     static constexpr bool edge_type = true;
     static constexpr std::string_view attr_name = std::string_view(n);
+    static constexpr name_id_t type_id = name_id(n);
 };
 
 
@@ -27,7 +28,7 @@ struct EdgeType {
                                 \
 
 
-inline std::unordered_set<std::string_view> edge_types::set_type_;
+inline std::unordered_map<name_id_t, std::string_view> edge_types::set_type_;
 
 REGISTER_EDGE_TYPE(RT)
 REGISTER_EDGE_TYPE(reachable)
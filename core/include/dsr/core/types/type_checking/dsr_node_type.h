@@ -15,6 +15,7 @@ template<const std::string_view& n>
 struct NodeType {
     static constexpr bool node_type = true;
     static constexpr std::string_view attr_name = std::string_view(n);
+    static constexpr name_id_t type_id = name_id(n);
 };
 
 
@@ -24,7 +25,7 @@ struct NodeType {
                                 using x##_node_type = NodeType< x##_type_str >;                      \
                                 \
 
-inline std::unordered_set<std::string_view> node_types::set_type_;
+inline std::unordered_map<name_id_t, std::string_view> node_types::set_type_;
 
 
 REGISTER_NODE_TYPE(root)
@@ -5,43 +5,115 @@
 #ifndef TYPE_CHECKER_H
 #define TYPE_CHECKER_H
 
+#include<cstdint>
 #include<unordered_map>
 #include<unordered_set>
+#include<string>
 #include<string_view>
-#include<functional>
+#include<shared_mutex>
+#include<mutex>
+#include<optional>
+#include<stdexcept>
 #include<any>
 #include<typeindex>
 
 
+/*
+ * Attribute names, node types and edge types are identified by the 32 bits FNV-1a hash of the name.
+ * The id of a registered name is computed at compile time (Attr::attr_id, NodeType::type_id,
+ * EdgeType::type_id) and is the same in every agent and build, so a name defined at runtime maps to
+ * the same id everywhere without exchanging tables. Two names with the same id are rejected when
+ * the second one is registered.
+ */
+using name_id_t = uint32_t;
+
+constexpr name_id_t name_id(std::string_view s)
+{
+    uint32_t h = 2166136261u;
+    for (char c : s)
+    {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
 
 class attribute_types
 {
+    struct Entry
+    {
+        std::string name;
+        std::type_index type;
+    };
+
+    // Attributes declared with REGISTER_TYPE, filled during static initialization and only read after it,
+    // so it is searched without locking.
+    static std::unordered_map<name_id_t, Entry> types_;
+    // Attributes seen for the first time at runtime.
+    static std::unordered_map<name_id_t, Entry> runtime_types_;
+    static std::shared_mutex mtx_;
+
+    static bool check_type_(std::string_view s, std::type_index t)
+    {
+        const name_id_t id = name_id(s);
+        // s may be any string, the name is compared because it can have the id of a registered one.
+        if (auto it = types_.find(id); it != types_.end())
+            return it->second.type == t and it->second.name == s;
+        {
+            std::shared_lock lck(mtx_);
+            if (auto it = runtime_types_.find(id); it != runtime_types_.end())
+                return it->second.type == t and it->second.name == s;
+        }
+        std::unique_lock lck(mtx_);
+        auto [it, inserted] = runtime_types_.try_emplace(id, Entry{std::string(s), t});
+        // Like REGISTER_TYPE, a name with the id of another one is rejected. It is never registered, so
+        // every value written with it fails the check.
+        if (not inserted and it->second.name != s) return false;
+        return it->second.type == t;
+    }
+
 public:
-    static std::unordered_map<std::string_view, std::function<bool(const std::any&)>> map_fn_;
 
+    // Called by REGISTER_TYPE during static initialization.
     static bool register_type(std::string_view s, const std::any& type , bool stream_type = false)
     {
-        map_fn_.emplace(std::make_pair(s, [t = std::type_index(type.type()) ](const std::any &el) -> bool {
-            return t == std::type_index(el.type());
-        }));
+        auto [it, inserted] = types_.try_emplace(name_id(s), Entry{std::string(s), std::type_index(type.type())});
+        if (not inserted and it->second.name != s)
+        {
+            throw std::logic_error("attribute " + std::string(s) + " has the same id as " + it->second.name);
+        }
         return true;
     }
 
+    // Checks the type of a value without copying it into a std::any.
+    template<typename T>
+    static bool check_type(std::string_view s, const T& val)
+    {
+        return check_type_(s, std::type_index(typeid(T)));
+    }
+
     static bool check_type(std::string_view s, const std::any& val)
     {
-        if (map_fn_.find(s) != map_fn_.end()) {
-            return map_fn_.at(s)(val);
-        } else  {
-            register_type(s, val);
-            return map_fn_.at(s)(val);
-        }
+        return check_type_(s, std::type_index(val.type()));
+    }
+
+    static std::optional<std::string> name_of(name_id_t id)
+    {
+        if (auto it = types_.find(id); it != types_.end()) return it->second.name;
+        std::shared_lock lck(mtx_);
+        if (auto it = runtime_types_.find(id); it != runtime_types_.end()) return it->second.name;
+        return {};
     }
 
     static std::unordered_set<std::string_view> get_all()
     {
         std::unordered_set<std::string_view> types;
-        for(auto const& type_t: map_fn_)
-            types.emplace(type_t.first);
+        for(auto const& type_t: types_)
+            types.emplace(type_t.second.name);
+        std::shared_lock lck(mtx_);
+        for(auto const& type_t: runtime_types_)
+            types.emplace(type_t.second.name);
         return types;
     }
 
@@ -49,47 +121,61 @@ public:
 
 class node_types
 {
-    static std::unordered_set<std::string_view> set_type_;
+    static std::unordered_map<name_id_t, std::string_view> set_type_;
 
 public:
 
     static bool register_type(std::string_view s)
     {
-        set_type_.emplace(s);
+        if (auto [it, inserted] = set_type_.try_emplace(name_id(s), s); not inserted and it->second != s)
+        {
+            throw std::logic_error("node type " + std::string(s) + " has the same id as " + std::string(it->second));
+        }
         return true;
     }
 
     static bool check_type(std::string_view v)
     {
-        return set_type_.find(v) != set_type_.end();
+        auto it = set_type_.find(name_id(v));
+        return it != set_type_.end() and it->second == v;
     }
 
     static std::unordered_set<std::string_view> get_all()
     {
-        return set_type_;
+        std::unordered_set<std::string_view> types;
+        for (auto const &[id, name] : set_type_)
+            types.emplace(name);
+        return types;
     }
 };
 
 class edge_types
 {
-    static std::unordered_set<std::string_view> set_type_;
+    static std::unordered_map<name_id_t, std::string_view> set_type_;
 
 public:
 
     static bool register_type(std::string_view s)
     {
-        set_type_.emplace(s);
+        if (auto [it, inserted] = set_type_.try_emplace(name_id(s), s); not inserted and it->second != s)
+        {
+            throw std::logic_error("edge type " + std::string(s) + " has the same id as " + std::string(it->second));
+        }
         return true;
     }
 
     static bool check_type(std::string_view v)
     {
-        return set_type_.find(v) != set_type_.end();
+        auto it = set_type_.find(name_id(v));
+        return it != set_type_.end() and it->second == v;
     }
 
     static std::unordered_set<std::string_view> get_all()
     {
-        return set_type_;
+        std::unordered_set<std::string_view> types;
+        for (auto const &[id, name] : set_type_)
+            types.emplace(name);
+        return types;
     }
 };
 
@@ -15,7 +15,7 @@ using namespace eprosima::fastdds;
 using namespace eprosima::fastdds::rtps;
 using namespace eprosima::fastdds::dds;
 
-DSRPublisher::DSRPublisher() : mp_participant(nullptr), mp_publisher(nullptr), mp_writer(nullptr)
+DSRPublisher::DSRPublisher() : transport(nullptr), mp_participant(nullptr), mp_publisher(nullptr), mp_writer(nullptr)
 {}
 
 DSRPublisher::~DSRPublisher()
@@ -95,6 +95,11 @@ std::tuple<bool, eprosima::fastdds::dds::Publisher*, eprosima::fastdds::dds::Dat
 
 }
 
+void DSRPublisher::init(DSR::Transport *transport_)
+{
+    transport = transport_;
+}
+
 GUID_t DSRPublisher::getParticipantID() const
 {
     return mp_participant->guid();
@@ -103,6 +108,7 @@ GUID_t DSRPublisher::getParticipantID() const
 
 bool DSRPublisher::write(IDL::MvregNode *object)
 {
+    if (transport != nullptr) return transport->write(DSR::TransportSample(std::in_place_type<IDL::MvregNode>, *object));
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
@@ -116,6 +122,7 @@ bool DSRPublisher::write(IDL::MvregNode *object)
 
 bool DSRPublisher::write(IDL::MvregEdge *object)
 {
+    if (transport != nullptr) return transport->write(DSR::TransportSample(std::in_place_type<IDL::MvregEdge>, *object));
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
@@ -129,6 +136,7 @@ bool DSRPublisher::write(IDL::MvregEdge *object)
 
 bool DSRPublisher::write(IDL::OrMap *object)
 {
+    if (transport != nullptr) return transport->write(DSR::TransportSample(std::in_place_type<IDL::OrMap>, *object));
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
@@ -141,6 +149,7 @@ bool DSRPublisher::write(IDL::OrMap *object)
 
 bool DSRPublisher::write(IDL::GraphRequest *object)
 {
+    if (transport != nullptr) return transport->write(DSR::TransportSample(std::in_place_type<IDL::GraphRequest>, *object));
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
@@ -153,6 +162,12 @@ bool DSRPublisher::write(IDL::GraphRequest *object)
 
 bool DSRPublisher::write(std::vector<IDL::MvregEdgeAttr> *object)
 {
+    if (transport != nullptr)
+    {
+        IDL::MvregEdgeAttrVec sample;
+        sample.vec(*object);
+        return transport->write(std::move(sample));
+    }
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
@@ -163,7 +178,14 @@ bool DSRPublisher::write(std::vector<IDL::MvregEdgeAttr> *object)
     return false;
 }
 
-bool DSRPublisher::write(std::vector<IDL::MvregNodeAttr> *object) {
+bool DSRPublisher::write(std::vector<IDL::MvregNodeAttr> *object)
+{
+    if (transport != nullptr)
+    {
+        IDL::MvregNodeAttrVec sample;
+        sample.vec(*object);
+        return transport->write(std::move(sample));
+    }
     ReturnCode_t rt;
     int retry = 0;
     while (retry < 5) {
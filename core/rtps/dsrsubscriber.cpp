@@ -2,6 +2,7 @@
 #include <fastdds/dds/subscriber/DataReader.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 #include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
 #include <fastdds/rtps/transport/shared_mem/SharedMemTransportDescriptor.hpp>
 #include <fastdds/rtps/common/MatchingInfo.hpp>
 #include <fastdds/utils/IPFinder.hpp>
@@ -9,6 +10,7 @@
 #include <dsr/core/rtps/dsrsubscriber.h>
 
 #include <QDebug>
+#include <iostream>
 
 using namespace eprosima;
 using namespace eprosima::fastdds;
@@ -22,7 +24,8 @@ DSRSubscriber::~DSRSubscriber()
 std::tuple<bool, eprosima::fastdds::dds::Subscriber*, eprosima::fastdds::dds::DataReader*>
         DSRSubscriber::init(eprosima::fastdds::dds::DomainParticipant *mp_participant_,
                          eprosima::fastdds::dds::Topic *topic,
-                        const std::function<void(eprosima::fastdds::dds::DataReader*)>&  f_,
+                         DSR::TopicId topic_id,
+                        const DSR::Transport::SampleHandler&  f_,
                         std::mutex& mtx,
                         bool isStreamData)
 {
@@ -30,6 +33,7 @@ std::tuple<bool, eprosima::fastdds::dds::Subscriber*, eprosima::fastdds::dds::Da
 
 
     //m_listener.participant_ID = mp_participant->guid();
+    m_listener.topic_id = topic_id;
     m_listener.f = f_;
 
 
@@ -92,6 +96,11 @@ std::tuple<bool, eprosima::fastdds::dds::Subscriber*, eprosima::fastdds::dds::Da
 }
 
 
+void DSRSubscriber::init(DSR::Transport *transport, DSR::TopicId topic_id, const DSR::Transport::SampleHandler& f_)
+{
+    transport->subscribe(topic_id, f_);
+}
+
 eprosima::fastdds::dds::Subscriber * DSRSubscriber::getSubscriber(){
     return mp_subscriber;
 }
@@ -117,8 +126,40 @@ void DSRSubscriber::SubListener::on_subscription_matched(eprosima::fastdds::dds:
     }
 }
 
+namespace
+{
+    // Takes the new samples of the reader and hands them to f one by one.
+    template <typename T>
+    void take_samples(eprosima::fastdds::dds::DataReader* reader, const DSR::Transport::SampleHandler& f)
+    {
+        while (true)
+        {
+            eprosima::fastdds::dds::SampleInfo m_info;
+            T sample;
+            if (reader->take_next_sample(&sample, &m_info) != eprosima::fastdds::dds::RETCODE_OK) break;
+            if (m_info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
+                m_info.sample_state == eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE &&
+                m_info.view_state != eprosima::fastdds::dds::NOT_NEW_VIEW_STATE)
+            {
+                f(DSR::TransportSample(std::in_place_type<T>, std::move(sample)));
+            }
+        }
+    }
+}
+
 void DSRSubscriber::SubListener::on_data_available(eprosima::fastdds::dds::DataReader* sub)
 {
-    f(sub);
+    try {
+        switch (topic_id)
+        {
+            case DSR::TopicId::NODE:          take_samples<IDL::MvregNode>(sub, f); break;
+            case DSR::TopicId::NODE_ATTRS:    take_samples<IDL::MvregNodeAttrVec>(sub, f); break;
+            case DSR::TopicId::EDGE:          take_samples<IDL::MvregEdge>(sub, f); break;
+            case DSR::TopicId::EDGE_ATTRS:    take_samples<IDL::MvregEdgeAttrVec>(sub, f); break;
+            case DSR::TopicId::GRAPH_REQUEST: take_samples<IDL::GraphRequest>(sub, f); break;
+            case DSR::TopicId::GRAPH_ANSWER:  take_samples<IDL::OrMap>(sub, f); break;
+        }
+    }
+    catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
 }
 
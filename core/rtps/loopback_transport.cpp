@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iostream>
+
+#include <dsr/core/rtps/loopback_transport.h>
+
+using namespace DSR;
+
+
+std::unique_ptr<LoopbackTransport> LoopbackDomain::connect()
+{
+    return std::make_unique<LoopbackTransport>(shared_from_this());
+}
+
+std::size_t LoopbackDomain::size() const
+{
+    std::shared_lock lck(mtx);
+    return endpoints.size();
+}
+
+void LoopbackDomain::add(LoopbackTransport *t)
+{
+    std::unique_lock lck(mtx);
+    // Both sides discover each other, like DDS participants do.
+    for (auto *other : endpoints)
+    {
+        other->push(LoopbackTransport::ParticipantEvent{t->name, true});
+        t->push(LoopbackTransport::ParticipantEvent{other->name, true});
+    }
+    endpoints.emplace_back(t);
+}
+
+void LoopbackDomain::remove(LoopbackTransport *t)
+{
+    std::unique_lock lck(mtx);
+    std::erase(endpoints, t);
+    for (auto *other : endpoints)
+        other->push(LoopbackTransport::ParticipantEvent{t->name, false});
+}
+
+bool LoopbackDomain::deliver(const LoopbackTransport *from, TransportSample &&sample)
+{
+    const auto topic = static_cast<std::size_t>(topic_of(sample));
+    // Endpoints stay alive while the lock is held, they leave the domain before they are destroyed.
+    std::shared_lock lck(mtx);
+    LoopbackTransport *last = nullptr;
+    for (auto *to : endpoints)
+    {
+        if (to == from or not to->subscribed[topic].load(std::memory_order_acquire)) continue;
+        if (last != nullptr) last->push(TransportSample(sample));
+        last = to;
+    }
+    if (last != nullptr) last->push(std::move(sample));
+    return true;
+}
+
+
+LoopbackTransport::LoopbackTransport(std::shared_ptr<LoopbackDomain> domain_)
+    : domain(std::move(domain_))
+{
+    worker = std::thread(&LoopbackTransport::run, this);
+}
+
+LoopbackTransport::~LoopbackTransport()
+{
+    close();
+    stop.store(true, std::memory_order_release);
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void LoopbackTransport::join(const std::string &participant, ParticipantHandler on_participant)
+{
+    if (joined) return;
+    {
+        std::unique_lock lck(handlers_mtx);
+        participant_handler = std::move(on_participant);
+    }
+    name = participant;
+    joined.store(true);
+    domain->add(this);
+}
+
+void LoopbackTransport::close()
+{
+    if (joined.exchange(false)) domain->remove(this);
+    std::unique_lock lck(handlers_mtx);
+    for (std::size_t i = 0; i < TOPIC_COUNT; i++)
+    {
+        subscribed[i].store(false, std::memory_order_release);
+        handlers[i] = nullptr;
+    }
+    participant_handler = nullptr;
+}
+
+bool LoopbackTransport::write(TransportSample &&sample)
+{
+    if (not joined) return false;
+    return domain->deliver(this, std::move(sample));
+}
+
+void LoopbackTransport::subscribe(TopicId topic, SampleHandler handler)
+{
+    const auto i = static_cast<std::size_t>(topic);
+    std::unique_lock lck(handlers_mtx);
+    handlers[i] = std::move(handler);
+    subscribed[i].store(true, std::memory_order_release);
+}
+
+void LoopbackTransport::unsubscribe(TopicId topic)
+{
+    const auto i = static_cast<std::size_t>(topic);
+    std::unique_lock lck(handlers_mtx);
+    subscribed[i].store(false, std::memory_order_release);
+    handlers[i] = nullptr;
+}
+
+void LoopbackTransport::push(Message &&m)
+{
+    queue.push(std::move(m));
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+}
+
+void LoopbackTransport::run()
+{
+    while (true)
+    {
+        // A push after this load changes the counter, so the wait below does not miss it.
+        const auto seen = pushed.load(std::memory_order_acquire);
+        while (auto m = queue.pop())
+        {
+            std::unique_lock lck(handlers_mtx);
+            try {
+                if (auto *sample = std::get_if<TransportSample>(&m.value()))
+                {
+                    if (auto &f = handlers[sample->index()]; f) f(std::move(*sample));
+                }
+                else if (participant_handler)
+                {
+                    auto &ev = std::get<ParticipantEvent>(m.value());
+                    participant_handler(ev.participant, ev.joined);
+                }
+            }
+            catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; }
+        }
+        if (stop.load(std::memory_order_acquire)) break;
+        pushed.wait(seen, std::memory_order_acquire);
+    }
+}
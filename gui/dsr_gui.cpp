@@ -178,9 +178,9 @@ DSRViewer::DSRViewer(QMainWindow *widget, std::shared_ptr<DSR::DSRGraph> G_, int
     timer->start(1000);
     init();  //intialize processor number
     connect(timer, SIGNAL(timeout()), this, SLOT(compute()));
-    connect(G.get(), &DSR::DSRGraph::update_node_signal, this, &DSRViewer::add_or_assign_node_SLOT,
-            Qt::QueuedConnection);
-    connect(G.get(), &DSR::DSRGraph::del_node_signal, this, &DSRViewer::del_node_SLOT, Qt::QueuedConnection);
+    dispatcher = GraphUpdateDispatcher::get(G);
+    connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this, &DSRViewer::add_or_assign_node_SLOT);
+    connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_node_signal, this, &DSRViewer::del_node_SLOT);
 
 
 }
@@ -313,6 +313,16 @@ void DSRViewer::initialize_views(int options, view central)
         {
             qobject_cast<GraphViewer *>(widgets_by_type[view::graph]->widget)->toggle_animation(state);
         });
+
+        QAction *threaded_action = new QAction("Threaded layout", this);
+        threaded_action->setStatusTip(tr("Compute the force layout in a worker thread"));
+        threaded_action->setCheckable(true);
+        threaded_action->setChecked(false);
+        forcesMenu->addAction(threaded_action);
+        connect(threaded_action, &QAction::triggered, this, [this](bool state)
+        {
+            qobject_cast<GraphViewer *>(widgets_by_type[view::graph]->widget)->set_threaded_layout(state);
+        });
     }
 
 //	Tabification of current docks
@@ -543,6 +553,12 @@ void DSRViewer::compute()
     {
         status += " HZ: " + std::to_string(external_hz);
     }
+    if (dispatcher)
+    {
+        auto st = dispatcher->stats();
+        status += " Events: " + std::to_string(st.received) + " recv " + std::to_string(st.delivered) + " sent "
+                + std::to_string(st.merged) + " merged " + std::to_string(st.dropped) + " dropped";
+    }
     m_stMessage->setText(QString::fromStdString(status));
 }
 
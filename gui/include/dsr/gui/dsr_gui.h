@@ -31,6 +31,7 @@
 #include <dsr/gui/viewers/qscene_2d_viewer/qscene_2d_viewer.h>
 #include <dsr/gui/viewers/graph_viewer/graph_viewer.h>
 #include <dsr/gui/viewers/tree_viewer/tree_viewer.h>
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
 
 #include <QFileDialog>
 
@@ -97,6 +98,7 @@ private:
     QTimer *timer;
     QElapsedTimer alive_timer;
     std::shared_ptr<DSR::DSRGraph> G;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     QMainWindow *window;
     QMenu *viewMenu;
     QMenu *fileMenu;
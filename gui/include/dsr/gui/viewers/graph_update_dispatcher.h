@@ -0,0 +1,161 @@
+//
+// Frame-rate bounded delivery of graph signals to the GUI viewers.
+//
+// DSRGraph emits one signal per change and every viewer used to receive them through its own
+// Qt::QueuedConnection. With high rate nodes (cameras, lasers) the GUI event queue grows without
+// bound and every queued event ends up copying the node again. The dispatcher receives the graph
+// signals directly in the emitting thread, keeps the set of dirty nodes and edges (deduplicated,
+// in arrival order) and re-emits them once per frame from the GUI thread.
+//
+// All the viewers of the same graph share one dispatcher, use GraphUpdateDispatcher::get(G).
+//
+
+#ifndef DSR_GRAPH_UPDATE_DISPATCHER_H
+#define DSR_GRAPH_UPDATE_DISPATCHER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <dsr/api/dsr_api.h>
+#include <dsr/core/utils.h>
+
+namespace DSR
+{
+    class GraphUpdateDispatcher : public QObject
+    {
+        Q_OBJECT
+        public:
+            struct Stats
+            {
+                uint64_t received = 0;      // signals received from the graph.
+                uint64_t delivered = 0;     // signals emitted to the viewers.
+                uint64_t merged = 0;        // signals folded into an update that was already pending.
+                uint64_t dropped = 0;       // pending updates discarded because the node or edge was deleted.
+                uint64_t frames = 0;        // number of flushes that emitted something.
+            };
+
+            static constexpr int DEFAULT_RATE = 60;
+
+            // Returns the dispatcher shared by all the viewers of G, creating it if needed. GUI thread only.
+            static std::shared_ptr<GraphUpdateDispatcher> get(const std::shared_ptr<DSR::DSRGraph> &G);
+
+            explicit GraphUpdateDispatcher(DSR::DSRGraph *G, int hz = DEFAULT_RATE);
+            ~GraphUpdateDispatcher() override;
+
+            void set_rate(int hz);
+            [[nodiscard]] int rate() const;
+            [[nodiscard]] Stats stats() const;
+            [[nodiscard]] std::size_t pending() const;
+
+        public slots:
+            // Emits every pending update. Called by the frame timer, can be forced from the GUI thread.
+            void flush();
+
+        signals:
+            // Same signatures as the DSRGraph signals so the viewers slots connect unchanged.
+            void update_node_signal(uint64_t, const std::string &type, DSR::SignalInfo info = {});
+            void update_node_attr_signal(uint64_t id ,const std::vector<std::string>& att_names, DSR::SignalInfo info = {});
+            void update_edge_signal(uint64_t from, uint64_t to, const std::string &type, DSR::SignalInfo info = {});
+            void update_edge_attr_signal(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string>& att_name, DSR::SignalInfo info = {});
+            void del_edge_signal(uint64_t from, uint64_t to, const std::string &edge_tag, DSR::SignalInfo info = {});
+            void del_node_signal(uint64_t id, DSR::SignalInfo info = {});
+
+        private:
+            using EdgeKey = std::tuple<uint64_t, uint64_t, std::string>;
+
+            // Insertion ordered set of pending updates. Erased entries are left as holes until the next flush.
+            template <typename K, typename V, typename Hash = std::hash<K>>
+            struct Pending
+            {
+                std::vector<std::tuple<K, V, bool>> items;
+                std::unordered_map<K, std::size_t, Hash> index;
+
+                // Returns true if the key was already pending.
+                template <typename F>
+                bool upsert(const K &key, F &&update)
+                {
+                    if (auto it = index.find(key); it != index.end())
+                    {
+                        update(std::get<1>(items[it->second]), false);
+                        return true;
+                    }
+                    index.emplace(key, items.size());
+                    auto &[k, v, valid] = items.emplace_back(key, V{}, true);
+                    update(v, true);
+                    return false;
+                }
+
+                bool erase(const K &key)
+                {
+                    if (auto it = index.find(key); it != index.end())
+                    {
+                        std::get<2>(items[it->second]) = false;
+                        index.erase(it);
+                        return true;
+                    }
+                    return false;
+                }
+
+                template <typename P>
+                std::size_t erase_if(P &&pred)
+                {
+                    std::size_t n = 0;
+                    for (auto &[k, v, valid] : items)
+                        if (valid and pred(k)) { valid = false; index.erase(k); n++; }
+                    return n;
+                }
+
+                [[nodiscard]] std::size_t size() const { return index.size(); }
+                [[nodiscard]] bool empty() const { return index.empty(); }
+                void clear() { items.clear(); index.clear(); }
+            };
+
+            struct Frame
+            {
+                Pending<uint64_t, std::pair<std::string, SignalInfo>> nodes;
+                Pending<uint64_t, std::pair<std::vector<std::string>, SignalInfo>> node_attrs;
+                Pending<EdgeKey, SignalInfo, hash_tuple> edges;
+                Pending<EdgeKey, std::pair<std::vector<std::string>, SignalInfo>, hash_tuple> edge_attrs;
+                Pending<EdgeKey, SignalInfo, hash_tuple> deleted_edges;
+                Pending<uint64_t, SignalInfo> deleted_nodes;
+
+                [[nodiscard]] bool empty() const;
+                [[nodiscard]] std::size_t size() const;
+                void clear();
+            };
+
+            void on_update_node(uint64_t id, const std::string &type, DSR::SignalInfo info);
+            void on_update_node_attr(uint64_t id, const std::vector<std::string> &att_names, DSR::SignalInfo info);
+            void on_update_edge(uint64_t from, uint64_t to, const std::string &type, DSR::SignalInfo info);
+            void on_update_edge_attr(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names, DSR::SignalInfo info);
+            void on_del_edge(uint64_t from, uint64_t to, const std::string &type, DSR::SignalInfo info);
+            void on_del_node(uint64_t id, DSR::SignalInfo info);
+
+            // Asks the GUI thread to flush at the next frame boundary. Called with mtx held.
+            void schedule();
+
+            DSR::DSRGraph *G;
+            mutable std::mutex mtx;
+            Frame frame;
+            Frame out;                          // only used by flush, keeps the allocations between frames.
+            bool scheduled = false;
+            QTimer timer;
+            QElapsedTimer since_flush;
+            std::atomic_int period_ms;
+
+            std::atomic_uint64_t received{0}, delivered{0}, merged{0}, dropped{0}, frames{0};
+
+            DSR::Connections connections;
+    };
+}
+
+#endif //DSR_GRAPH_UPDATE_DISPATCHER_H
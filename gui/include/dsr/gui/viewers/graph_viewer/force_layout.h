@@ -0,0 +1,107 @@
+//
+// Barnes-Hut force directed layout used by the GraphViewer.
+//
+// The engine works on flat position arrays (x0, y0, x1, y1, ...) so it does not touch
+// QGraphicsItems at all. Repulsion between nodes is approximated with a quadtree
+// (O(n log n) per step instead of the O(n^2) pairwise loop in GraphNode::calculateForces),
+// edge attraction and the pull towards the scene centre follow the same rules used by GraphNode.
+//
+
+#ifndef DSR_FORCE_LAYOUT_H
+#define DSR_FORCE_LAYOUT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace DSR
+{
+    struct ForceLayoutParams
+    {
+        float theta = 0.8f;                 // Barnes-Hut opening angle. 0 degenerates into the exact O(n^2) sum.
+        float repulsion = 150.f;            // Same meaning as force_velocity_factor in graph_node.h
+        float edge_pull = 10.f;             // Same meaning as GraphNode::EDGE_PULL_FACTOR
+        float sludge = 0.1f;                // Velocities under this threshold are discarded.
+        float left = -1e6f, top = -1e6f;    // Scene rect used to clamp the new positions.
+        float right = 1e6f, bottom = 1e6f;
+        float margin = 10.f;
+    };
+
+    // Input and output of a layout step. Positions are stored as x,y pairs indexed by node.
+    struct ForceLayoutState
+    {
+        std::vector<float> positions;
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        std::vector<uint8_t> pinned;        // pinned nodes (ex. grabbed by the mouse) do not move.
+        ForceLayoutParams params;
+        uint64_t generation = 0;            // Opaque value set by the caller to match results with the current scene.
+
+        [[nodiscard]] std::size_t size() const { return positions.size() / 2; }
+    };
+
+    class ForceLayout
+    {
+        public:
+            ForceLayout() = default;
+
+            // Computes one iteration over the state. Returns true if any node moved.
+            bool step(ForceLayoutState &state);
+
+        private:
+            struct Cell
+            {
+                float cx = 0.f, cy = 0.f;       // centre of mass
+                float mass = 0.f;
+                float x0 = 0.f, y0 = 0.f;       // cell bounds
+                float size = 0.f;
+                int32_t child[4] = {-1, -1, -1, -1};
+                int32_t body = -1;              // index of the node when the cell is a leaf with one body.
+            };
+
+            std::vector<Cell> cells;
+            std::vector<float> velocity;
+            std::vector<uint32_t> degree;
+
+            void build_tree(const std::vector<float> &pos);
+            void insert(int32_t cell, uint32_t body, const std::vector<float> &pos, int depth);
+            int32_t new_cell(float x0, float y0, float size);
+            void repulsion(uint32_t body, const std::vector<float> &pos, float theta2, float k, float &fx, float &fy) const;
+    };
+
+    // Runs the layout on a worker thread. The GUI thread submits snapshots of the scene and picks up
+    // the last computed result without ever waiting for the computation.
+    class ForceLayoutWorker
+    {
+        public:
+            ForceLayoutWorker();
+            ~ForceLayoutWorker();
+
+            ForceLayoutWorker(const ForceLayoutWorker&) = delete;
+            ForceLayoutWorker& operator=(const ForceLayoutWorker&) = delete;
+
+            // Replaces any pending snapshot that has not been processed yet.
+            void submit(ForceLayoutState &&state);
+            // Returns the result of the last finished step, if there is a new one.
+            std::optional<std::pair<ForceLayoutState, bool>> take_result();
+            [[nodiscard]] bool busy() const { return working.load(std::memory_order_acquire); }
+
+        private:
+            void run();
+
+            ForceLayout layout;
+            std::thread worker;
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::optional<ForceLayoutState> pending;
+            std::optional<std::pair<ForceLayoutState, bool>> result;
+            std::atomic_bool working{false};
+            bool stop = false;
+    };
+}
+
+#endif //DSR_FORCE_LAYOUT_H
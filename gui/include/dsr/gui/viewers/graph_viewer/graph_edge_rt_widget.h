@@ -21,7 +21,8 @@ public:
         qRegisterMetaType<std::string>("std::string");
         qRegisterMetaType<std::map<std::string, DSR::Attribute>>("Attribs");
 
-        connect(graph.get(), &DSR::DSRGraph::update_edge_signal, this, &GraphEdgeRTWidget::add_or_assign_edge_slot, Qt::QueuedConnection);
+        dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+        connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_edge_signal, this, &GraphEdgeRTWidget::add_or_assign_edge_slot);
         //Inner Api
         inner_eigen = graph->get_inner_eigen_api();
 
@@ -118,6 +119,7 @@ public:
     {
         //graph.reset();
         disconnect(graph.get(), 0, this, 0);
+        disconnect(dispatcher.get(), 0, this, 0);
     };
 public slots:
             void update_combo(const QString& combo_text)
@@ -198,6 +200,7 @@ public slots:
 
 private:
     std::shared_ptr<DSR::DSRGraph> graph;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     std::shared_ptr<DSR::InnerEigenAPI> inner_eigen;
     uint64_t from, to;
     std::string edge_type;
@@ -45,7 +45,8 @@ public:
             //TODO: comprobar QObject::connect(graph.get(), &DSR::DSRGraph::update_attrs_signal, this, &GraphEdgeWidget::drawSLOT);
             //QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphEdgeWidget::update_node_slot);
             //QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphEdgeWidget::update_node_slot);
-            QObject::connect(graph.get(), &DSR::DSRGraph::update_edge_attr_signal, this, &GraphEdgeWidget::update_edge_attr_slot, Qt::QueuedConnection);
+            dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+            QObject::connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_edge_attr_signal, this, &GraphEdgeWidget::update_edge_attr_slot);
             //QObject::connect(graph.get(), &DSR::DSRGraph::update_edge_signal, this, &GraphEdgeWidget::add_or_assign_edge_slot);
             show();
         }
@@ -85,9 +86,11 @@ public slots:
     void closeEvent (QCloseEvent *event)
     {
         disconnect(graph.get(), 0, this, 0);
+        disconnect(dispatcher.get(), 0, this, 0);
     };
 private:
     std::shared_ptr<DSR::DSRGraph> graph;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     std::uint64_t node_id;
     uint64_t from, to;
     std::string edge_type;
@@ -28,10 +28,10 @@
 #include <QHeaderView>
 #include <QLabel>
 #include <utility>
-#include <cppitertools/zip.hpp>
 
 #include <dsr/api/dsr_api.h>
 #include "graph_edge.h"
+#include <dsr/gui/viewers/laser_item.h>
 #include <dsr/gui/dsr_gui.h>
 
 
@@ -49,9 +49,16 @@ class GraphNodeLaserWidget : public QGraphicsView
       setRenderHint(QPainter::Antialiasing);
       fitInView(scene.sceneRect(), Qt::KeepAspectRatio );
       scale(1, -1);
+      QPolygonF robot;
+      robot << QPointF(-200, 200) << QPointF(-200, -200) << QPointF(200, -200) << QPointF(200, 200) << QPointF(0, 260);
+      scene.addPolygon(robot, QPen(QColor("DarkGreen"), 8), QBrush(QColor("DarkGreen")))->setZValue(1);
+      laser = new DSR::LaserItem(QPointF(0, 150));
+      laser->set_polygon_style(QPen(QColor("LightPink"), 8), QBrush(QColor("LightPink")));
+      scene.addItem(laser);
       //drawLaserSLOT(node_id_, );
       //QObject::connect(graph.get(), &DSR::DSRGraph::update_attrs_signal, this, &GraphNodeLaserWidget::drawLaserSLOT);
-      QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphNodeLaserWidget::drawLaserSLOT, Qt::QueuedConnection);
+      dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+      QObject::connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this, &GraphNodeLaserWidget::drawLaserSLOT);
       show();
     };
 
@@ -59,6 +66,7 @@ class GraphNodeLaserWidget : public QGraphicsView
     void closeEvent (QCloseEvent *event) override 
     {
       disconnect(graph.get(), nullptr, this, nullptr);
+      disconnect(dispatcher.get(), nullptr, this, nullptr);
       //graph.reset();
     };
 
@@ -77,19 +85,7 @@ class GraphNodeLaserWidget : public QGraphicsView
             const auto lDists = graph->get_attrib_by_name<laser_dists_att>(n.value());
             if (lAngles.has_value() and lDists.has_value()) 
             {
-                QPolygonF polig;
-                polig << QPointF(0,150);
-                for (const auto &[dist, angle] : iter::zip(lDists.value().get(), lAngles.value().get()))
-                {
-                    //std::cout << dist << "," << angle << std::endl;
-                    polig << QPointF(dist * sin(angle), dist * cos(angle));
-                }
-                polig << QPointF(0,150);
-                scene.clear();
-                QPolygonF robot;
-                robot << QPointF(-200, 200) << QPointF(-200, -200) << QPointF(200, -200) << QPointF(200, 200) << QPointF(0, 260);
-                scene.addPolygon(polig, QPen(QColor("LightPink"), 8), QBrush(QColor("LightPink")));
-                scene.addPolygon(robot, QPen(QColor("DarkGreen"), 8), QBrush(QColor("DarkGreen")));
+                laser->set_scan(lAngles.value().get(), lDists.value().get());
             }
         }
       }
@@ -97,7 +93,9 @@ class GraphNodeLaserWidget : public QGraphicsView
     };
   private:
     QGraphicsScene scene;
+    DSR::LaserItem *laser;
     std::shared_ptr<DSR::DSRGraph> graph;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     std::uint64_t node_id;
 };
 
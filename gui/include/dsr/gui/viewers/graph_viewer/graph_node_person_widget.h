@@ -51,7 +51,8 @@ class GraphNodePersonWidget : public QGraphicsView
       scale(1, -1);
       //drawLaserSLOT(node_id_, );
       //QObject::connect(graph.get(), &DSR::DSRGraph::update_attrs_signal, this, &GraphNodePersonWidget::drawPersonSLOT);
-      QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphNodePersonWidget::drawPersonSLOT, Qt::QueuedConnection);
+      dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+      QObject::connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this, &GraphNodePersonWidget::drawPersonSLOT);
       show();
     };
 
@@ -59,6 +60,7 @@ class GraphNodePersonWidget : public QGraphicsView
     void closeEvent (QCloseEvent *event) override 
     {
       disconnect(graph.get(), nullptr, this, nullptr);
+      disconnect(dispatcher.get(), nullptr, this, nullptr);
       //graph.reset();
     };
 
@@ -98,6 +100,7 @@ class GraphNodePersonWidget : public QGraphicsView
   private:
     QGraphicsScene scene;
     std::shared_ptr<DSR::DSRGraph> graph;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     std::uint64_t node_id;
 };
 
@@ -17,22 +17,65 @@
 #ifndef GRAPHNODERGBDWIDGET_H
 #define GRAPHNODERGBDWIDGET_H
 
+#include <QImage>
+#include <QPainter>
+#include <dsr/gui/viewers/graph_viewer/rgbd_image_utils.h>
+
+// Paints a QImage owned by the widget. Unlike QLabel::setPixmap no QPixmap is created on every frame.
+class RGBDImageView : public QWidget
+{
+  public:
+    explicit RGBDImageView(QWidget *parent = nullptr) : QWidget(parent) {}
+
+    QImage &image() { return img; }
+
+    // Reallocates the image only when the size changes. Returns true in that case.
+    bool reshape(int width, int height, QImage::Format format)
+    {
+        if (img.width() == width and img.height() == height and img.format() == format) return false;
+        img = QImage(width, height, format);
+        setFixedSize(width, height);
+        return true;
+    }
+
+    void clear()
+    {
+        img = QImage();
+        update();
+    }
+
+  protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        if (img.isNull()) return;
+        QPainter painter(this);
+        painter.drawImage(0, 0, img);
+    }
+
+  private:
+    QImage img;
+};
+
 class GraphNodeRGBDWidget : public QWidget
 {
   Q_OBJECT
-  QLabel rgbd_label, depth_label;
+  RGBDImageView rgbd_label, depth_label;
   QMenuBar *mainMenu;
   QAction *show_rgb;
   QAction *show_depth;
-  std::chrono::system_clock::time_point last_update_rgb, last_update_d ;
 
   public:
+    // Images wider than this are downsampled by an integer factor before display.
+    static constexpr int MAX_DISPLAY_WIDTH = 640;
+    // The depth range used to scale the gray image is recomputed every RANGE_REFRESH_FRAMES frames.
+    static constexpr int RANGE_REFRESH_FRAMES = 15;
+
     GraphNodeRGBDWidget(std::shared_ptr<DSR::DSRGraph> graph_, DSR::IDType node_id_) : graph(std::move(graph_)), node_id(node_id_)
     {
-      //cam = graph->get_camera_api(graph->get_nodes_by_type("rgbd").at(0));
       setWindowTitle(QString::fromStdString(graph->get_agent_name()) + "-RGBD");
       //QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphNodeRGBDWidget::drawRGBDSLOT);
-      QObject::connect(graph.get(), &DSR::DSRGraph::update_node_attr_signal, this, &GraphNodeRGBDWidget::drawRGBDSLOT, Qt::QueuedConnection);
+      dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+      QObject::connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_attr_signal, this, &GraphNodeRGBDWidget::drawRGBDSLOT);
       QHBoxLayout *layout = new QHBoxLayout();
       layout->addWidget(&rgbd_label);
       layout->addWidget(&depth_label);
@@ -50,14 +93,16 @@ class GraphNodeRGBDWidget : public QWidget
       show_depth->setCheckable(true);
       show_depth->setChecked(true);
       viewMenu->addAction(show_depth);
+      connect(show_rgb, &QAction::toggled, this, [this](bool checked){ if (not checked) rgbd_label.clear(); });
+      connect(show_depth, &QAction::toggled, this, [this](bool checked){ if (not checked) depth_label.clear(); });
       show();
     };
 
     void closeEvent (QCloseEvent *event) override
     {
         disconnect(graph.get(), nullptr, this, nullptr);
+        disconnect(dispatcher.get(), nullptr, this, nullptr);
         //graph.reset();
-        //cam.reset();
     };
 
   public slots:
@@ -67,97 +112,53 @@ class GraphNodeRGBDWidget : public QWidget
       bool rgb = std::any_of(type.begin(), type.end(), [](auto& e){ return e == cam_rgb_att::attr_name;});
       bool d = std::any_of(type.begin(), type.end(), [](auto& e){ return e == cam_depth_att::attr_name;});
 
-      auto now = std::chrono::system_clock::now();
-      bool update_rgb = std::chrono::duration_cast<std::chrono::microseconds>(now - last_update_rgb)  > std::chrono::milliseconds(20);
-      bool update_d = d = std::chrono::duration_cast<std::chrono::microseconds>(now - last_update_d)  > std::chrono::milliseconds(20);
-
-
-      if ( (rgb and update_rgb) or (d and update_d) )
+      bool resized = false;
+      // The image buffers are read in place while the graph read lock is held, the node is never copied.
+      if (rgb and show_rgb->isChecked())
+      {
+          graph->read_attribs_by_name<cam_rgb_att, cam_rgb_width_att, cam_rgb_height_att>(id,
+              [&](const std::vector<uint8_t> &img, int width, int height)
+              {
+                  if (width <= 0 or height <= 0 or img.size() < static_cast<std::size_t>(width) * height * 3) return;
+                  const int step = DSR::image::downsample_step(width, MAX_DISPLAY_WIDTH);
+                  resized |= rgbd_label.reshape(width / step, height / step, QImage::Format_RGB888);
+                  auto &out = rgbd_label.image();
+                  DSR::image::downsample_rgb(img.data(), width, height, step, out.bits(), out.bytesPerLine());
+              });
+          rgbd_label.update();
+      }
+      if (d and show_depth->isChecked())
       {
-          std::optional<Node> n = (show_rgb->isChecked() or show_depth->isChecked()) ?  graph->get_node(id) :  std::nullopt;
-          if (n.has_value()) {
-              Node node = n.value();
-              //auto t = get_unix_timestamp();
-              //std::cout << "[DRAW IMG] " << timestamp << ", " << t << ": " << static_cast<double>(t - timestamp) / 1000000 << std::endl;
-              //rgb
-              if (rgb and update_rgb) {
-                  if (show_rgb->isChecked()) {
-                      const auto rgb_data = graph->get_attrib_by_name<cam_rgb_att>(node);//cam->get_rgb_image();
-                      const auto rgb_width = graph->get_attrib_by_name<cam_rgb_width_att>(node);
-                      const auto rgb_height = graph->get_attrib_by_name<cam_rgb_height_att>(node);
-
-                      if (rgb_data.has_value() and rgb_width.has_value() and rgb_height.has_value()) {
-                          const std::vector<uint8_t> &img = rgb_data.value();//.get();
-                          auto pix = QPixmap::fromImage(
-                                  QImage(&img[0], rgb_width.value(), rgb_height.value(), QImage::Format_RGB888));
-                          rgbd_label.setPixmap(pix);
-                          last_update_rgb = now;
-                      }
-                  } else
-                      rgbd_label.clear();
-              }
-              //depth
-              if (d and update_d) {
-                  if (show_depth->isChecked()) {
-                      if (cam == nullptr) {
-                          std::vector<std::string_view> att_names;
-                          std::for_each(node.attrs().begin(), node.attrs().end(),
-                                        [&](auto &p){ att_names.emplace_back(p.first); });
-
-                          std::vector<std::string_view> required_atts = {
-                                  cam_rgb_focalx_att::attr_name,
-                                  cam_rgb_focaly_att::attr_name,
-                                  cam_rgb_width_att::attr_name,
-                                  cam_rgb_height_att::attr_name,
-                                  cam_rgb_depth_att::attr_name,
-                                  cam_rgb_cameraID_att::attr_name
-                          };
-
-                          std::sort(att_names.begin(), att_names.end());
-                          std::sort(required_atts.begin(), required_atts.end());
-
-                          std::vector<std::string_view> diff;
-                          std::set_difference(required_atts.begin(), required_atts.end(),
-                                              att_names.begin(), att_names.end(),
-                                              std::inserter(diff, diff.begin()));
-
-                          if (diff.empty())
-                              cam = graph->get_camera_api(node);
-                          else {
-                              std::cout << "Camera API constructor expects the attributes 'cam_rgb_focalx_att', "
-                                           "'cam_rgb_focaly_att', 'cam_rgb_width_att', 'cam_rgb_height_att' and "
-                                           "'cam_rgb_cameraID_att' to exist in the camera node. Can't show depth image.\n";
-                          }
-                      }
-                      if (cam) {
-                          const auto depth_width = graph->get_attrib_by_name<cam_depth_width_att>(n.value());
-                          const auto depth_height = graph->get_attrib_by_name<cam_depth_height_att>(n.value());
-                          const std::optional <std::vector<std::uint8_t>> gray_scale = cam->get_depth_as_gray_image();
-                          if (gray_scale.has_value() and depth_width.has_value() and depth_height.has_value()) {
-                              depth_label.setPixmap(QPixmap::fromImage(
-                                      QImage(&gray_scale.value()[0], depth_width.value(), depth_height.value(),
-                                             QImage::Format_Indexed8)));
-                              last_update_d = now;
-                          }
-                      }
-                  } else {
-                      depth_label.clear();
+          graph->read_attribs_by_name<cam_depth_att, cam_depth_width_att, cam_depth_height_att>(id,
+              [&](const std::vector<uint8_t> &img, int width, int height)
+              {
+                  if (width <= 0 or height <= 0 or img.size() < static_cast<std::size_t>(width) * height * sizeof(float)) return;
+                  const auto *depth = reinterpret_cast<const float *>(img.data());
+                  const int step = DSR::image::downsample_step(width, MAX_DISPLAY_WIDTH);
+                  if (depth_label.reshape(width / step, height / step, QImage::Format_Grayscale8))
+                  {
+                      resized = true;
+                      range_frames = 0;
+                  }
+                  if (range_frames-- <= 0 or not depth_range.valid())
+                  {
+                      depth_range = DSR::image::depth_range(depth, width, height);
+                      range_frames = RANGE_REFRESH_FRAMES;
                   }
-              }
-              this->adjustSize();
-              show();
-          } else {
-              rgbd_label.clear();
-              depth_label.clear();
-          }
+                  auto &out = depth_label.image();
+                  DSR::image::depth_to_gray(depth, width, height, step, depth_range, out.bits(), out.bytesPerLine());
+              });
+          depth_label.update();
       }
+      if (resized) this->adjustSize();
     };
 
   private:
-    QLabel label;
     std::shared_ptr<DSR::DSRGraph> graph;
-    std::unique_ptr<CameraAPI> cam;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     DSR::IDType node_id;
-};      
+    DSR::image::DepthRange depth_range;
+    int range_frames = 0;
+};
 
 #endif // GRAPHNODERGBDWIDGET_H
@@ -51,7 +51,8 @@ class GraphNodeWidget : public  QTableWidget
           //TODO: comprobar QObject::connect(graph.get(), &DSR::DSRGraph::update_attrs_signal, this, &GraphNodeWidget::drawSLOT);
           //QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphNodeWidget::update_node_slot);
           //QObject::connect(graph.get(), &DSR::DSRGraph::update_node_signal, this, &GraphNodeWidget::update_node_slot);
-          QObject::connect(graph.get(), &DSR::DSRGraph::update_node_attr_signal, this, &GraphNodeWidget::update_node_attr_slot, Qt::QueuedConnection);
+          dispatcher = DSR::GraphUpdateDispatcher::get(graph);
+          QObject::connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_attr_signal, this, &GraphNodeWidget::update_node_attr_slot);
           show();
       }
     };
@@ -110,10 +111,12 @@ class GraphNodeWidget : public  QTableWidget
     void closeEvent (QCloseEvent *event) override
     {
         disconnect(graph.get(), nullptr, this, nullptr);
+        disconnect(dispatcher.get(), nullptr, this, nullptr);
         //graph.reset();
     };
   private:
     std::shared_ptr<DSR::DSRGraph> graph;
+    std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
     std::uint64_t node_id;
     std::map<std::string, QWidget*> widget_map;
     void resize_widget()
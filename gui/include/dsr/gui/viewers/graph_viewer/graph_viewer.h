@@ -18,7 +18,9 @@
 #define DSR_TO_GRAPH_VIEWER_H
 
 #include <dsr/api/dsr_api.h>
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
 #include <dsr/gui/viewers/_abstract_graphic_view.h>
+#include <dsr/gui/viewers/graph_viewer/force_layout.h>
 
 #include <chrono>
 #include <QWidget>
@@ -41,7 +43,8 @@ namespace DSR
             GraphViewer(std::shared_ptr<DSR::DSRGraph> G_, QWidget *parent=0);
 			~GraphViewer();
             std::shared_ptr<DSR::DSRGraph> getGraph()  			  	{return G;};
-			std::map<std::uint64_t , GraphNode*> getGMap() const 			{return gmap;};
+            std::shared_ptr<DSR::GraphUpdateDispatcher> getDispatcher()	{return dispatcher;};
+			const std::map<std::uint64_t , GraphNode*>& getGMap() const 	{return gmap;};
             QGraphicsEllipseItem* getCentralPoint() const 				{return central_point;};
 
 
@@ -54,11 +57,13 @@ namespace DSR
 			void hide_show_node_SLOT(uint64_t id, bool visible);
 			// Others
 			void toggle_animation(bool state);
+			void set_threaded_layout(bool threaded);
 			void reload(QWidget * widget);
             void remove_node_SLOT(uint64_t id);  // remove node from DSR
 
         protected:
             std::shared_ptr<DSR::DSRGraph> G;
+            std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
             GraphNode* new_visual_node(uint64_t id, const std::string &type, const std::string &name, bool debug = false);
             GraphEdge* new_visual_edge(GraphNode *sourceNode, GraphNode *destNode, const QString &edge_name);
             GraphEdge* new_visual_edge(std::uint64_t from, std::uint64_t to, const std::string &edge_tag);
@@ -73,6 +78,17 @@ namespace DSR
 			int timerId = 0;
             void showContextMenu(QMouseEvent *event);
 
+			// Force layout
+			ForceLayout layout;
+			std::unique_ptr<ForceLayoutWorker> layout_worker;
+			std::vector<GraphNode*> layout_nodes;
+			std::vector<std::pair<uint32_t, uint32_t>> layout_edges;
+			uint64_t layout_generation = 0;
+			bool layout_dirty = true;
+			void invalidate_layout();  // called whenever nodes or edges are added or deleted
+			ForceLayoutState make_layout_state();
+			void apply_layout(const ForceLayoutState &state);
+
 
     	protected:
             void createGraph();
@@ -0,0 +1,34 @@
+//
+// Image conversion kernels used by GraphNodeRGBDWidget.
+//
+// The loops are written without branches or aliasing so the compiler vectorizes them (the gui
+// library is built with -O3). They write into caller owned buffers, nothing is allocated per frame.
+//
+
+#ifndef DSR_RGBD_IMAGE_UTILS_H
+#define DSR_RGBD_IMAGE_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <dsr/api/dsr_depth_utils.h>
+
+namespace DSR::image
+{
+    // The depth kernels are shared with CameraAPI.
+    using DSR::depth::DepthRange;
+    using DSR::depth::depth_range;
+    using DSR::depth::depth_to_gray;
+
+    // Nearest neighbour downsampling of a packed RGB888 image.
+    void downsample_rgb(const uint8_t *rgb, int width, int height, int step,
+                        uint8_t *out, std::size_t out_stride);
+
+    // Smallest integer step that makes width fit in max_width.
+    inline int downsample_step(int width, int max_width)
+    {
+        if (max_width <= 0 or width <= max_width) return 1;
+        return (width + max_width - 1) / max_width;
+    }
+}
+
+#endif //DSR_RGBD_IMAGE_UTILS_H
@@ -0,0 +1,55 @@
+//
+// Laser scan overlay drawn by a single scene item.
+//
+// The viewers used to add one QGraphicsEllipseItem per beam and a new polygon on every laser update,
+// and to delete the previous ones, so a 1080 beam laser at 20 Hz created and destroyed about 20k scene
+// items per second in the GUI thread. LaserItem keeps the scan in a buffer that is rewritten in place
+// and paints the polygon and all the points in one paint() call.
+//
+
+#ifndef DSR_LASER_ITEM_H
+#define DSR_LASER_ITEM_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPen>
+#include <QBrush>
+#include <QPolygonF>
+#include <span>
+
+namespace DSR
+{
+    class LaserItem : public QGraphicsItem
+    {
+        public:
+            // origin: first and last vertex of the polygon, in the coordinates of the laser.
+            explicit LaserItem(QPointF origin = {}, QGraphicsItem *parent = nullptr);
+
+            // Beam i ends at (dist * sin(angle), dist * cos(angle)). The buffer only grows, so updates with
+            // the same number of beams do not allocate.
+            void set_scan(std::span<const float> angles, std::span<const float> dists);
+            void clear_scan();
+
+            void set_polygon_style(const QPen &pen, const QBrush &brush);
+            // Points are drawn as round dots of the given diameter, 0 draws only the polygon.
+            void set_point_style(const QColor &color, qreal diameter);
+
+            [[nodiscard]] QRectF boundingRect() const override;
+            void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+        private:
+            void update_bounds(const QRectF &scan_bounds);
+
+            QPointF origin;
+            // origin, one vertex per beam, origin.
+            QPolygonF polygon;
+            qsizetype beams = 0;
+            QRectF bounds;
+
+            QPen polygon_pen;
+            QBrush polygon_brush;
+            QPen point_pen;
+    };
+}
+
+#endif // DSR_LASER_ITEM_H
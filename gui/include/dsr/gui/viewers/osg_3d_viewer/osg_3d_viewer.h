@@ -40,6 +40,7 @@
 #include <QOpenGLWidget>
 #include <QResizeEvent>
 #include <dsr/api/dsr_api.h>
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
 
 using namespace std::chrono_literals;
 
@@ -67,6 +68,7 @@ namespace DSR
 
         private:
             std::shared_ptr<DSR::DSRGraph> G;
+            std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
             std::unique_ptr<RT_API> rt;
             osgGA::EventQueue* getEventQueue() const ;
             osg::ref_ptr<osgViewer::GraphicsWindowEmbedded> _mGraphicsWindow;
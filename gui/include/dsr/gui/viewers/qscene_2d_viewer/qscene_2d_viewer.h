@@ -19,6 +19,7 @@
 
 #include "dsr/api/dsr_api.h"
 #include "dsr/gui/viewers/_abstract_graphic_view.h"
+#include "dsr/gui/viewers/laser_item.h"
 #include <math.h>
 #include <filesystem>
 
@@ -39,7 +40,7 @@ namespace DSR
     Q_OBJECT
     private:
         QGraphicsItem *robot = nullptr;
-        QGraphicsItem *laser_polygon = nullptr;
+        LaserItem *laser_item = nullptr;
         bool delete_axis = false;
         QGraphicsRectItem *axis_center = nullptr, *axis_x = nullptr, *axis_y = nullptr;
         QMenu *contextMenu, *showMenu;
@@ -0,0 +1,80 @@
+//
+// Background stage of the mesh loading of the Qt3D viewer.
+//
+// Resolving the mesh file of a node (rewriting .ive/.3ds to .obj, canonical path, reading the file)
+// used to happen in the GUI thread for every plane and mesh of the world before the first frame.
+// MeshLoader does it in a worker thread: the viewer requests the nodes and takes the resolved ones
+// once per frame. Files are identified by their contents, nodes that get the same content key can
+// share one geometry. The loader does not depend on Qt3D, so it can be benchmarked headless.
+//
+
+#ifndef DSR_MESH_LOADER_H
+#define DSR_MESH_LOADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace DSR
+{
+    struct MeshSource
+    {
+        uint64_t node_id = 0;
+        std::string requested;          // path as given to request().
+        std::string path;               // canonical path of the .obj file. Empty if the node has no usable mesh.
+        uint64_t content_key = 0;       // same value for files with the same contents. 0 if path is empty.
+    };
+
+    class MeshLoader
+    {
+        public:
+            struct Stats
+            {
+                uint64_t requested = 0;     // nodes requested.
+                uint64_t files_read = 0;    // distinct files read from disk.
+                uint64_t shared = 0;        // nodes resolved to a content key that was already known.
+            };
+
+            MeshLoader();
+            ~MeshLoader();
+
+            MeshLoader(const MeshLoader&) = delete;
+            MeshLoader& operator=(const MeshLoader&) = delete;
+
+            // path is the value of path_att.
+            void request(uint64_t node_id, std::string path);
+            // Resolved nodes, at most max of them, in request order. Never waits for the worker.
+            std::vector<MeshSource> take_ready(std::size_t max = std::numeric_limits<std::size_t>::max());
+            // True when every requested node has been taken.
+            [[nodiscard]] bool idle() const;
+            [[nodiscard]] Stats stats() const;
+
+            // The viewer only loads .obj files, .ive and .3ds models are expected to have an .obj next to them.
+            static std::string obj_path(std::string path);
+
+        private:
+            void run();
+            MeshSource resolve(uint64_t node_id, std::string &&requested);
+
+            std::thread worker;
+            mutable std::mutex mtx;
+            std::condition_variable cv;
+            std::deque<std::pair<uint64_t, std::string>> requests;
+            std::deque<MeshSource> ready;
+            std::size_t in_flight = 0;
+            Stats counters;
+            bool stop = false;
+
+            // Worker thread only. A file is read once per session, later changes on disk are not seen.
+            std::unordered_map<std::string, uint64_t> path_keys;
+            std::unordered_map<uint64_t, uint64_t> key_uses;
+    };
+}
+
+#endif //DSR_MESH_LOADER_H
@@ -18,6 +18,7 @@
 #define DSR_QT3D_VIEWER_H
 
 #include <chrono>
+#include <deque>
 
 
 #include <Qt3DCore/QEntity>
@@ -30,9 +31,12 @@
 #include <QObject>
 #include <QWidget>
 #include <QMatrix4x4>
+#include <QTimer>
 
 #include <cstdint>
 #include <dsr/api/dsr_api.h>
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
+#include <dsr/gui/viewers/qt3d_viewer/mesh_loader.h>
 #include <qwidget.h>
 
 using namespace std::chrono_literals;
@@ -66,27 +70,50 @@ namespace DSR
         void update_node(uint64_t id, const std::string& type);
         //void update_node_attr(uint64_t id, const std::vector<std::string> &att_names);
 
+        // Creates the entities of the initial scene a batch per event loop iteration, and attaches
+        // the meshes resolved by the loader.
+        void populate();
+        void create_entity(const Node& node, const Mat::RTMat &mat);
+        void attach_mesh(const MeshSource &source);
+
 
         //Convenience methods
 
-        Qt3DRender::QMaterial *color_material(QColor color)
-        {
-            auto *mat = new Qt3DExtras::QDiffuseSpecularMaterial(); 
-            mat->setAmbient(color);
-            mat->setSpecular(QColor(0, 0, 0));
-            qInfo() << "Color: " << color;
-            return mat;
-        };
+        // Materials and geometries are shared by all the entities that use them.
+        Qt3DRender::QMaterial *color_material(QColor color);
+        Qt3DRender::QGeometryRenderer *cuboid_mesh();
+
+        static Qt3DCore::QTransform *transform_of(Qt3DCore::QEntity *entity);
+        static void set_pose(Qt3DCore::QTransform *transform, const Mat::RTMat &mat);
+
+        static constexpr std::size_t POPULATE_BATCH = 64;
 
         bool only_one_widget;
         Qt3DExtras::Qt3DWindow *view; //We don't manage this pointer object. A widget will take it's ownership.
         QWidget * widget;
         std::shared_ptr<DSR::DSRGraph> g; //We don't own this pointer.
+        std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
         std::unique_ptr<DSR::InnerEigenAPI> inner;
         Qt3DCore::QEntity *rootEntity;
         Qt3DRender::QLayer* globalLayer;
         std::unordered_map<uint64_t, Qt3DCore::QEntity*> entities;
 
+        // Nodes of the initial scene that still have no entity.
+        std::deque<uint64_t> pending_nodes;
+        QTimer populate_timer;
+
+        struct PendingMesh
+        {
+            std::string path;                       // value of path_att when the mesh was requested.
+            QVector3D scale;                        // of the mesh.
+            std::optional<QVector3D> extents;       // of the cuboid drawn if the mesh can't be loaded.
+        };
+        MeshLoader mesh_loader;
+        std::unordered_map<uint64_t, PendingMesh> pending_meshes;
+        std::unordered_map<uint64_t, Qt3DRender::QMesh*> meshes;       // by content key.
+        std::unordered_map<QRgb, Qt3DRender::QMaterial*> materials;
+        Qt3DRender::QGeometryRenderer *unit_cuboid = nullptr;
+
     };
 };
 #endif
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include <QSpinBox>
 #include <QHBoxLayout>
 #include <dsr/api/dsr_api.h>
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
 #include <dsr/core/types/user_types.h>
 class GraphNode;
 class GraphEdge;
@@ -52,6 +53,7 @@ namespace DSR
 
         private:
             std::shared_ptr<DSR::DSRGraph> G;
+            std::shared_ptr<DSR::GraphUpdateDispatcher> dispatcher;
             std::map<std::string, QTreeWidgetItem*> types_map;
 			std::map<uint64_t, QTreeWidgetItem*> tree_map;
 			std::map<uint64_t, std::map<std::string, QTreeWidgetItem*>> attributes_map;
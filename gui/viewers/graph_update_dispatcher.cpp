@@ -0,0 +1,214 @@
+//
+// Frame-rate bounded delivery of graph signals to the GUI viewers.
+//
+
+#include <dsr/gui/viewers/graph_update_dispatcher.h>
+#include <algorithm>
+#include <map>
+
+using namespace DSR;
+
+
+std::shared_ptr<GraphUpdateDispatcher> GraphUpdateDispatcher::get(const std::shared_ptr<DSR::DSRGraph> &G)
+{
+    static std::map<const DSR::DSRGraph*, std::weak_ptr<GraphUpdateDispatcher>> dispatchers;
+
+    std::erase_if(dispatchers, [](const auto &item) { return item.second.expired(); });
+    if (auto it = dispatchers.find(G.get()); it != dispatchers.end())
+        if (auto d = it->second.lock()) return d;
+
+    // deleteLater: the last owner can be a widget destroyed from a slot connected to this dispatcher.
+    std::shared_ptr<GraphUpdateDispatcher> d(new GraphUpdateDispatcher(G.get()), [](GraphUpdateDispatcher *p) { p->deleteLater(); });
+    dispatchers[G.get()] = d;
+    return d;
+}
+
+GraphUpdateDispatcher::GraphUpdateDispatcher(DSR::DSRGraph *G_, int hz) : G(G_), period_ms(1000 / std::max(hz, 1))
+{
+    qRegisterMetaType<uint64_t>("uint64_t");
+    qRegisterMetaType<std::string>("std::string");
+    qRegisterMetaType<std::vector<std::string>>("std::vector<std::string>");
+
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &GraphUpdateDispatcher::flush);
+    since_flush.start();
+
+    // Direct callbacks: these run in the thread that applies the change (usually the DDS reader threads).
+    auto &cb = G->callbacks();
+    connections.add(cb.update_node, [this](uint64_t id, const std::string &type, const SignalInfo &info) { on_update_node(id, type, info); });
+    connections.add(cb.update_node_attr, [this](uint64_t id, const std::vector<std::string> &names, const SignalInfo &info) { on_update_node_attr(id, names, info); });
+    connections.add(cb.update_edge, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &info) { on_update_edge(from, to, type, info); });
+    connections.add(cb.update_edge_attr, [this](uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &names, const SignalInfo &info) {
+        on_update_edge_attr(from, to, type, names, info);
+    });
+    connections.add(cb.del_edge, [this](uint64_t from, uint64_t to, const std::string &type, const SignalInfo &info) { on_del_edge(from, to, type, info); });
+    connections.add(cb.del_node, [this](uint64_t id, const SignalInfo &info) { on_del_node(id, info); });
+}
+
+GraphUpdateDispatcher::~GraphUpdateDispatcher()
+{
+    connections.clear();
+}
+
+void GraphUpdateDispatcher::set_rate(int hz)
+{
+    period_ms.store(1000 / std::max(hz, 1));
+}
+
+int GraphUpdateDispatcher::rate() const
+{
+    return 1000 / period_ms.load();
+}
+
+GraphUpdateDispatcher::Stats GraphUpdateDispatcher::stats() const
+{
+    return Stats{received.load(std::memory_order_relaxed), delivered.load(std::memory_order_relaxed),
+                 merged.load(std::memory_order_relaxed), dropped.load(std::memory_order_relaxed),
+                 frames.load(std::memory_order_relaxed)};
+}
+
+std::size_t GraphUpdateDispatcher::pending() const
+{
+    std::unique_lock<std::mutex> lck(mtx);
+    return frame.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Graph signals
+////////////////////////////////////////////////////////////////////////////
+
+static void merge_names(std::vector<std::string> &dst, const std::vector<std::string> &src)
+{
+    for (const auto &name : src)
+        if (std::find(dst.begin(), dst.end(), name) == dst.end())
+            dst.emplace_back(name);
+}
+
+void GraphUpdateDispatcher::on_update_node(uint64_t id, const std::string &type, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lck(mtx);
+    frame.deleted_nodes.erase(id);
+    if (frame.nodes.upsert(id, [&](auto &v, bool) { v = {type, info}; }))
+        merged.fetch_add(1, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::on_update_node_attr(uint64_t id, const std::vector<std::string> &att_names, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lck(mtx);
+    if (frame.node_attrs.upsert(id, [&](auto &v, bool) { merge_names(v.first, att_names); v.second = info; }))
+        merged.fetch_add(1, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::on_update_edge(uint64_t from, uint64_t to, const std::string &type, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    EdgeKey key{from, to, type};
+    std::unique_lock<std::mutex> lck(mtx);
+    frame.deleted_edges.erase(key);
+    if (frame.edges.upsert(key, [&](auto &v, bool) { v = info; }))
+        merged.fetch_add(1, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::on_update_edge_attr(uint64_t from, uint64_t to, const std::string &type, const std::vector<std::string> &att_names, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    EdgeKey key{from, to, type};
+    std::unique_lock<std::mutex> lck(mtx);
+    if (frame.edge_attrs.upsert(key, [&](auto &v, bool) { merge_names(v.first, att_names); v.second = info; }))
+        merged.fetch_add(1, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::on_del_edge(uint64_t from, uint64_t to, const std::string &type, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    EdgeKey key{from, to, type};
+    std::unique_lock<std::mutex> lck(mtx);
+    uint64_t n = frame.edges.erase(key) + frame.edge_attrs.erase(key);
+    if (frame.deleted_edges.upsert(key, [&](auto &v, bool) { v = info; }))
+        n++;
+    dropped.fetch_add(n, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::on_del_node(uint64_t id, DSR::SignalInfo info)
+{
+    received.fetch_add(1, std::memory_order_relaxed);
+    auto touches = [id](const EdgeKey &k) { return std::get<0>(k) == id or std::get<1>(k) == id; };
+    std::unique_lock<std::mutex> lck(mtx);
+    uint64_t n = frame.nodes.erase(id) + frame.node_attrs.erase(id);
+    n += frame.edges.erase_if(touches) + frame.edge_attrs.erase_if(touches);
+    if (frame.deleted_nodes.upsert(id, [&](auto &v, bool) { v = info; }))
+        n++;
+    dropped.fetch_add(n, std::memory_order_relaxed);
+    schedule();
+}
+
+void GraphUpdateDispatcher::schedule()
+{
+    if (scheduled) return;
+    scheduled = true;
+    // The timer belongs to the GUI thread, start it from there.
+    QMetaObject::invokeMethod(this, [this]()
+    {
+        const auto remaining = period_ms.load() - since_flush.elapsed();
+        timer.start(static_cast<int>(std::max<qint64>(remaining, 0)));
+    }, Qt::QueuedConnection);
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Delivery
+////////////////////////////////////////////////////////////////////////////
+
+bool GraphUpdateDispatcher::Frame::empty() const
+{
+    return nodes.empty() and node_attrs.empty() and edges.empty() and edge_attrs.empty()
+           and deleted_edges.empty() and deleted_nodes.empty();
+}
+
+std::size_t GraphUpdateDispatcher::Frame::size() const
+{
+    return nodes.size() + node_attrs.size() + edges.size() + edge_attrs.size()
+           + deleted_edges.size() + deleted_nodes.size();
+}
+
+void GraphUpdateDispatcher::Frame::clear()
+{
+    nodes.clear(); node_attrs.clear(); edges.clear(); edge_attrs.clear();
+    deleted_edges.clear(); deleted_nodes.clear();
+}
+
+void GraphUpdateDispatcher::flush()
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        std::swap(frame, out);
+        scheduled = false;
+    }
+    since_flush.restart();
+    if (out.empty()) return;
+
+    // New nodes before the edges that reference them, deletions at the end.
+    uint64_t n = 0;
+    for (const auto &[id, v, valid] : out.nodes.items)
+        if (valid) { emit update_node_signal(id, v.first, v.second); n++; }
+    for (const auto &[id, v, valid] : out.node_attrs.items)
+        if (valid) { emit update_node_attr_signal(id, v.first, v.second); n++; }
+    for (const auto &[k, info, valid] : out.edges.items)
+        if (valid) { emit update_edge_signal(std::get<0>(k), std::get<1>(k), std::get<2>(k), info); n++; }
+    for (const auto &[k, v, valid] : out.edge_attrs.items)
+        if (valid) { emit update_edge_attr_signal(std::get<0>(k), std::get<1>(k), std::get<2>(k), v.first, v.second); n++; }
+    for (const auto &[k, info, valid] : out.deleted_edges.items)
+        if (valid) { emit del_edge_signal(std::get<0>(k), std::get<1>(k), std::get<2>(k), info); n++; }
+    for (const auto &[id, info, valid] : out.deleted_nodes.items)
+        if (valid) { emit del_node_signal(id, info); n++; }
+
+    delivered.fetch_add(n, std::memory_order_relaxed);
+    frames.fetch_add(1, std::memory_order_relaxed);
+    out.clear();
+}
@@ -0,0 +1,250 @@
+//
+// Barnes-Hut force directed layout used by the GraphViewer.
+//
+
+#include <dsr/gui/viewers/graph_viewer/force_layout.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace DSR;
+
+static constexpr int MAX_TREE_DEPTH = 32;
+
+int32_t ForceLayout::new_cell(float x0, float y0, float size)
+{
+    Cell c;
+    c.x0 = x0; c.y0 = y0; c.size = size;
+    cells.emplace_back(c);
+    return static_cast<int32_t>(cells.size() - 1);
+}
+
+void ForceLayout::build_tree(const std::vector<float> &pos)
+{
+    cells.clear();
+    const std::size_t n = pos.size() / 2;
+    if (n == 0) return;
+
+    float minx = std::numeric_limits<float>::max(), miny = std::numeric_limits<float>::max();
+    float maxx = std::numeric_limits<float>::lowest(), maxy = std::numeric_limits<float>::lowest();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        minx = std::min(minx, pos[2*i]);   maxx = std::max(maxx, pos[2*i]);
+        miny = std::min(miny, pos[2*i+1]); maxy = std::max(maxy, pos[2*i+1]);
+    }
+    const float size = std::max({maxx - minx, maxy - miny, 1.f}) * 1.0001f;
+
+    cells.reserve(2 * n + 1);
+    new_cell(minx, miny, size);
+    for (uint32_t i = 0; i < n; i++)
+        insert(0, i, pos, 0);
+}
+
+void ForceLayout::insert(int32_t cell, uint32_t body, const std::vector<float> &pos, int depth)
+{
+    const float x = pos[2*body], y = pos[2*body+1];
+    while (true)
+    {
+        // cells may be reallocated by new_cell, never keep references across calls.
+        if (cells[cell].mass == 0.f)
+        {
+            auto &c = cells[cell];
+            c.body = static_cast<int32_t>(body);
+            c.cx = x; c.cy = y; c.mass = 1.f;
+            return;
+        }
+
+        const bool leaf = cells[cell].body >= 0;
+        if (leaf and depth >= MAX_TREE_DEPTH)
+        {
+            // Too many coincident points, aggregate them in the same leaf.
+            auto &c = cells[cell];
+            c.cx = (c.cx * c.mass + x) / (c.mass + 1.f);
+            c.cy = (c.cy * c.mass + y) / (c.mass + 1.f);
+            c.mass += 1.f;
+            return;
+        }
+
+        auto quadrant = [&](int32_t parent, float px, float py) -> int32_t
+        {
+            const float half = cells[parent].size * 0.5f;
+            const int q = (px >= cells[parent].x0 + half ? 1 : 0) + (py >= cells[parent].y0 + half ? 2 : 0);
+            if (cells[parent].child[q] < 0)
+            {
+                const float cx0 = cells[parent].x0 + ((q & 1) ? half : 0.f);
+                const float cy0 = cells[parent].y0 + ((q & 2) ? half : 0.f);
+                const int32_t child = new_cell(cx0, cy0, half);
+                cells[parent].child[q] = child;
+            }
+            return cells[parent].child[q];
+        };
+
+        if (leaf)
+        {
+            // Push the body stored in this leaf one level down.
+            const auto old = static_cast<uint32_t>(cells[cell].body);
+            cells[cell].body = -1;
+            const int32_t child = quadrant(cell, pos[2*old], pos[2*old+1]);
+            auto &c = cells[child];
+            c.body = static_cast<int32_t>(old);
+            c.cx = pos[2*old]; c.cy = pos[2*old+1]; c.mass = 1.f;
+        }
+
+        auto &c = cells[cell];
+        c.cx = (c.cx * c.mass + x) / (c.mass + 1.f);
+        c.cy = (c.cy * c.mass + y) / (c.mass + 1.f);
+        c.mass += 1.f;
+
+        cell = quadrant(cell, x, y);
+        depth++;
+    }
+}
+
+void ForceLayout::repulsion(uint32_t body, const std::vector<float> &pos, float theta2, float k, float &fx, float &fy) const
+{
+    const float x = pos[2*body], y = pos[2*body+1];
+    int32_t stack[4 * MAX_TREE_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const Cell &c = cells[stack[--top]];
+        if (c.mass == 0.f or c.body == static_cast<int32_t>(body)) continue;
+
+        const float dx = x - c.cx;
+        const float dy = y - c.cy;
+        const float d2 = dx * dx + dy * dy;
+        if (c.body >= 0 or c.size * c.size < theta2 * d2)
+        {
+            // Same expression as GraphNode::calculateForces, weighted by the number of bodies in the cell.
+            if (d2 > 0.f)
+            {
+                const float l = 2.f * d2;
+                fx += c.mass * dx * k / l;
+                fy += c.mass * dy * k / l;
+            }
+        }
+        else
+        {
+            for (int32_t ch : c.child)
+                if (ch >= 0) stack[top++] = ch;
+        }
+    }
+}
+
+bool ForceLayout::step(ForceLayoutState &state)
+{
+    auto &pos = state.positions;
+    const auto &p = state.params;
+    const std::size_t n = state.size();
+    if (n == 0) return false;
+
+    build_tree(pos);
+
+    velocity.assign(2 * n, 0.f);
+    degree.assign(n, 0);
+    for (const auto &[a, b] : state.edges)
+    {
+        if (a >= n or b >= n) continue;
+        degree[a]++; degree[b]++;
+    }
+
+    const float theta2 = p.theta * p.theta;
+    for (uint32_t i = 0; i < n; i++)
+        repulsion(i, pos, theta2, p.repulsion, velocity[2*i], velocity[2*i+1]);
+
+    // Edges pull both ends together, scaled by the degree of each node.
+    for (const auto &[a, b] : state.edges)
+    {
+        if (a >= n or b >= n) continue;
+        const float dx = pos[2*a] - pos[2*b];
+        const float dy = pos[2*a+1] - pos[2*b+1];
+        const float wa = (degree[a] + 1) * p.edge_pull;
+        const float wb = (degree[b] + 1) * p.edge_pull;
+        velocity[2*a] -= dx / wa;  velocity[2*a+1] -= dy / wa;
+        velocity[2*b] += dx / wb;  velocity[2*b+1] += dy / wb;
+    }
+
+    bool moved = false;
+    const bool has_pinned = state.pinned.size() == n;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (has_pinned and state.pinned[i]) continue;
+
+        // Pull towards the central point (0, 0) of the scene.
+        const float weight = (degree[i] + 1) * p.edge_pull;
+        float vx = velocity[2*i] - pos[2*i] / (weight / 2.f);
+        float vy = velocity[2*i+1] - pos[2*i+1] / (weight / 2.f);
+
+        if (std::abs(vx) < p.sludge and std::abs(vy) < p.sludge)
+            continue;
+
+        const float nx = std::min(std::max(pos[2*i] + vx, p.left + p.margin), p.right - p.margin);
+        const float ny = std::min(std::max(pos[2*i+1] + vy, p.top + p.margin), p.bottom - p.margin);
+        if (nx != pos[2*i] or ny != pos[2*i+1])
+        {
+            pos[2*i] = nx;
+            pos[2*i+1] = ny;
+            moved = true;
+        }
+    }
+    return moved;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Worker thread
+////////////////////////////////////////////////////////////////////////////
+
+ForceLayoutWorker::ForceLayoutWorker()
+{
+    worker = std::thread(&ForceLayoutWorker::run, this);
+}
+
+ForceLayoutWorker::~ForceLayoutWorker()
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        stop = true;
+    }
+    cv.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void ForceLayoutWorker::submit(ForceLayoutState &&state)
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        pending = std::move(state);
+    }
+    cv.notify_one();
+}
+
+std::optional<std::pair<ForceLayoutState, bool>> ForceLayoutWorker::take_result()
+{
+    std::unique_lock<std::mutex> lck(mtx);
+    auto ret = std::move(result);
+    result.reset();
+    return ret;
+}
+
+void ForceLayoutWorker::run()
+{
+    while (true)
+    {
+        ForceLayoutState state;
+        {
+            std::unique_lock<std::mutex> lck(mtx);
+            cv.wait(lck, [this] { return stop or pending.has_value(); });
+            if (stop) return;
+            state = std::move(pending.value());
+            pending.reset();
+            working.store(true, std::memory_order_release);
+        }
+        bool moved = layout.step(state);
+        {
+            std::unique_lock<std::mutex> lck(mtx);
+            result = std::make_pair(std::move(state), moved);
+            working.store(false, std::memory_order_release);
+        }
+    }
+}
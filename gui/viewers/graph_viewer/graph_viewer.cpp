@@ -30,10 +30,11 @@ GraphViewer::GraphViewer(std::shared_ptr<DSR::DSRGraph> G_, QWidget *parent) :
 	central_point = new QGraphicsEllipseItem(0,0,0,0);
 	scene.addItem(central_point);
 
-	connect(G.get(), &DSR::DSRGraph::update_node_signal, this, &GraphViewer::add_or_assign_node_SLOT, Qt::QueuedConnection);
-	connect(G.get(), &DSR::DSRGraph::update_edge_signal, this, &GraphViewer::add_or_assign_edge_SLOT, Qt::QueuedConnection);
-	connect(G.get(), &DSR::DSRGraph::del_edge_signal, this, &GraphViewer::del_edge_SLOT, Qt::QueuedConnection);
-	connect(G.get(), &DSR::DSRGraph::del_node_signal, this, &GraphViewer::del_node_SLOT, Qt::QueuedConnection);
+	dispatcher = GraphUpdateDispatcher::get(G);
+	connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this, &GraphViewer::add_or_assign_node_SLOT);
+	connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_edge_signal, this, &GraphViewer::add_or_assign_edge_SLOT);
+	connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_edge_signal, this, &GraphViewer::del_edge_SLOT);
+	connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_node_signal, this, &GraphViewer::del_node_SLOT);
 }
 
 
@@ -61,6 +62,7 @@ void GraphViewer::createGraph()
 {
 	gmap.clear();
 	gmap_edges.clear();
+	invalidate_layout();
     type_id_map.clear();
 	this->scene.clear();
 	qDebug() << __FUNCTION__ << "Reading graph in Graph Viewer";
@@ -112,20 +114,106 @@ void GraphViewer::toggle_animation(bool animate)
 	}
 }
 
-void GraphViewer::timerEvent(QTimerEvent *event)
+void GraphViewer::set_threaded_layout(bool threaded)
+{
+	if (threaded and !layout_worker)
+		layout_worker = std::make_unique<ForceLayoutWorker>();
+	else if (!threaded)
+		layout_worker.reset();
+}
+
+void GraphViewer::invalidate_layout()
+{
+	// layout_nodes may hold deleted nodes, the results of the worker for them are discarded by apply_layout.
+	layout_dirty = true;
+	layout_nodes.clear();
+	layout_edges.clear();
+	layout_generation++;
+}
+
+ForceLayoutState GraphViewer::make_layout_state()
 {
-	// Q_UNUSED(event)
+	// Node indices and edges are only rebuilt when the visual graph changes.
+	if (layout_dirty)
+	{
+		std::unordered_map<GraphNode*, uint32_t> index;
+		layout_nodes.reserve(gmap.size());
+		for (auto &[_, node] : gmap)
+		{
+			index.emplace(node, layout_nodes.size());
+			layout_nodes.emplace_back(node);
+		}
+		for (auto &[_, edge] : gmap_edges)
+		{
+			if (edge == nullptr or edge->sourceNode() == edge->destNode()) continue;
+			auto src = index.find(edge->sourceNode());
+			auto dst = index.find(edge->destNode());
+			if (src != index.end() and dst != index.end())
+				layout_edges.emplace_back(src->second, dst->second);
+		}
+		layout_generation++;
+		layout_dirty = false;
+	}
+
+	ForceLayoutState state;
+	state.generation = layout_generation;
+	state.edges = layout_edges;
+	state.positions.resize(2 * layout_nodes.size());
+	state.pinned.resize(layout_nodes.size(), 0);
+	auto grabber = scene.mouseGrabberItem();
+	for (std::size_t i = 0; i < layout_nodes.size(); i++)
+	{
+		const QPointF p = layout_nodes[i]->pos();
+		state.positions[2*i] = static_cast<float>(p.x());
+		state.positions[2*i+1] = static_cast<float>(p.y());
+		state.pinned[i] = (layout_nodes[i] == grabber);
+	}
+	const QRectF rect = scene.sceneRect();
+	state.params.left = rect.left();   state.params.right = rect.right();
+	state.params.top = rect.top();     state.params.bottom = rect.bottom();
+	state.params.repulsion = force_velocity_factor;
+	state.params.edge_pull = GraphNode::EDGE_PULL_FACTOR;
+	state.params.margin = GraphNode::SCENE_MARGIN;
+	return state;
+}
 
-	for( auto &[_,node] : gmap)
+void GraphViewer::apply_layout(const ForceLayoutState &state)
+{
+	// Results computed for an older version of the scene are discarded.
+	if (layout_dirty or state.generation != layout_generation or state.size() != layout_nodes.size()) return;
+	auto grabber = scene.mouseGrabberItem();
+	for (std::size_t i = 0; i < layout_nodes.size(); i++)
 	{
-		node->calculateForces();
+		if (layout_nodes[i] == grabber) continue;
+		const QPointF p(state.positions[2*i], state.positions[2*i+1]);
+		if (p != layout_nodes[i]->pos())
+			layout_nodes[i]->setPos(p);
 	}
-	bool itemsMoved = false;
+}
+
+void GraphViewer::timerEvent(QTimerEvent *event)
+{
+	Q_UNUSED(event)
 
-	for( auto &[_,node] : gmap)
+	bool itemsMoved = true;
+	if (layout_worker)
 	{
-		itemsMoved = node->advancePosition() or itemsMoved;
+		// Apply the last step computed in the worker thread and hand it a fresh snapshot of the scene.
+		if (auto res = layout_worker->take_result(); res.has_value())
+		{
+			apply_layout(res->first);
+			itemsMoved = res->second or res->first.generation != layout_generation;
+		}
+		if (!layout_worker->busy())
+			layout_worker->submit(make_layout_state());
 	}
+	else
+	{
+		auto state = make_layout_state();
+		itemsMoved = layout.step(state);
+		apply_layout(state);
+	}
+
 	if (!itemsMoved)
 	{
 		killTimer(timerId);
@@ -152,6 +240,7 @@ void GraphViewer::add_or_assign_node_SLOT(uint64_t id, const std::string &type)
             qDebug()<<__FUNCTION__<<"##### New node";
             gnode = this->new_visual_node(id, type, name, false);
             gmap.insert(std::pair(id, gnode));
+            invalidate_layout();
 
             std::string color("coral");
             color = G->get_attrib_by_name<color_att>(n.value()).value_or(color);
@@ -215,6 +304,7 @@ void GraphViewer::add_or_assign_edge_SLOT(std::uint64_t from, std::uint64_t to,
             {
                 auto item = this->new_visual_edge(from, to, edge_tag);
                 gmap_edges.insert(std::make_pair(key, item));
+                invalidate_layout();
             }
             if (gmap_edges[key]) gmap_edges[key]->change_detected();
         }
@@ -258,6 +348,7 @@ void GraphViewer::del_edge_SLOT(std::uint64_t from, std::uint64_t to, const std:
 		std::tuple<std::uint64_t, std::uint64_t, std::string> key = std::make_tuple(from, to, edge_tag);
 		while (gmap_edges.count(key) > 0) {
             GraphEdge *edge = gmap_edges.extract(key).mapped();
+            invalidate_layout();
             if (gmap.find(from) != gmap.end())
                 gmap.at(from)->deleteEdge(edge);
             if (gmap.find(to) != gmap.end())
@@ -282,6 +373,7 @@ void GraphViewer::del_node_SLOT(uint64_t id)
             scene.removeItem(item);
             delete item;
             gmap.erase(id);
+            invalidate_layout();
         }
     } catch(const std::exception &e) { std::cout << e.what() <<" Error  "<<__FUNCTION__<<":"<<__LINE__<< std::endl;}
 
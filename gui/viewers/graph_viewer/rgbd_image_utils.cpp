@@ -0,0 +1,38 @@
+//
+// Image conversion kernels used by GraphNodeRGBDWidget.
+//
+
+#include <dsr/gui/viewers/graph_viewer/rgbd_image_utils.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace DSR::image;
+
+
+void DSR::image::downsample_rgb(const uint8_t *rgb, int width, int height, int step,
+                                uint8_t *out, std::size_t out_stride)
+{
+    step = std::max(step, 1);
+    const int out_w = width / step;
+    const int out_h = height / step;
+    const std::size_t in_stride = static_cast<std::size_t>(width) * 3;
+
+    for (int y = 0; y < out_h; y++)
+    {
+        const uint8_t *__restrict src = rgb + static_cast<std::size_t>(y) * step * in_stride;
+        uint8_t *__restrict dst = out + static_cast<std::size_t>(y) * out_stride;
+        if (step == 1)
+        {
+            std::memcpy(dst, src, static_cast<std::size_t>(out_w) * 3);
+        }
+        else
+        {
+            for (int x = 0; x < out_w; x++)
+            {
+                dst[3*x]   = src[3*x*step];
+                dst[3*x+1] = src[3*x*step+1];
+                dst[3*x+2] = src[3*x*step+2];
+            }
+        }
+    }
+}
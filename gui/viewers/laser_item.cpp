@@ -0,0 +1,92 @@
+//
+// Laser scan overlay drawn by a single scene item.
+//
+
+#include <dsr/gui/viewers/laser_item.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace DSR;
+
+
+LaserItem::LaserItem(QPointF origin_, QGraphicsItem *parent) : QGraphicsItem(parent), origin(origin_)
+{
+    polygon << origin << origin;
+    point_pen.setCapStyle(Qt::RoundCap);
+    point_pen.setWidthF(0);
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void LaserItem::set_scan(std::span<const float> angles, std::span<const float> dists)
+{
+    beams = static_cast<qsizetype>(std::min(angles.size(), dists.size()));
+    polygon.resize(beams + 2);
+
+    auto *p = polygon.data();
+    qreal min_x = origin.x(), max_x = origin.x(), min_y = origin.y(), max_y = origin.y();
+    p[0] = origin;
+    for (qsizetype i = 0; i < beams; i++)
+    {
+        const qreal x = dists[i] * std::sin(angles[i]);
+        const qreal y = dists[i] * std::cos(angles[i]);
+        p[i + 1] = QPointF(x, y);
+        min_x = std::min(min_x, x); max_x = std::max(max_x, x);
+        min_y = std::min(min_y, y); max_y = std::max(max_y, y);
+    }
+    p[beams + 1] = origin;
+
+    update_bounds(QRectF(QPointF(min_x, min_y), QPointF(max_x, max_y)));
+}
+
+void LaserItem::clear_scan()
+{
+    beams = 0;
+    polygon.resize(2);
+    update_bounds(QRectF(origin, origin));
+}
+
+void LaserItem::set_polygon_style(const QPen &pen, const QBrush &brush)
+{
+    polygon_pen = pen;
+    polygon_brush = brush;
+    update_bounds(bounds);
+}
+
+void LaserItem::set_point_style(const QColor &color, qreal diameter)
+{
+    point_pen.setColor(color);
+    point_pen.setWidthF(diameter);
+    update_bounds(bounds);
+}
+
+void LaserItem::update_bounds(const QRectF &scan_bounds)
+{
+    // Half of the widest pen sticks out of the scan.
+    const qreal margin = std::max(polygon_pen.widthF(), point_pen.widthF()) / 2 + 1;
+    const auto new_bounds = scan_bounds.adjusted(-margin, -margin, margin, margin);
+    // Most updates of a static robot keep the bounds, the scene index is only touched when they change.
+    if (new_bounds != bounds)
+    {
+        prepareGeometryChange();
+        bounds = new_bounds;
+    }
+    update();
+}
+
+QRectF LaserItem::boundingRect() const
+{
+    return bounds;
+}
+
+void LaserItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
+{
+    if (beams == 0) return;
+    painter->setPen(polygon_pen);
+    painter->setBrush(polygon_brush);
+    painter->drawPolygon(polygon);
+    if (point_pen.widthF() > 0)
+    {
+        painter->setPen(point_pen);
+        painter->drawPoints(polygon.constData() + 1, static_cast<int>(beams));
+    }
+}
@@ -533,7 +533,7 @@ void QScene2dViewer::mousePressEvent(QMouseEvent *event){
             {
                 auto it = std::find_if(scene_map.begin(), scene_map.end(),
                     [&item](const std::pair<int, QGraphicsItem*> &p) { return p.second == item;});
-                if (it != scene_map.end() and it->second != laser_polygon) {
+                if (it != scene_map.end() and it->second != laser_item) {
                     std::optional<Node> node = G->get_node(it->first);
                     if(node.has_value())
                     {
@@ -580,22 +580,11 @@ void QScene2dViewer::set_draw_people_spaces(bool draw)
 }
 void QScene2dViewer::draw_laser()
 {
-    static std::vector<QGraphicsEllipseItem*> points;
-    if (laser_polygon != nullptr){
-        scene.removeItem(laser_polygon);
-        delete laser_polygon;
-    }
-    for(auto p : points){
-        scene.removeItem(p);
-        delete p;
-    }
-    points.clear();
-
-    if(not this->drawlaser)
-        return;
-    
-    if(robot == nullptr) //robot is required to draw laser
+    if(not this->drawlaser or robot == nullptr) //robot is required to draw laser
+    {
+        if (laser_item != nullptr) laser_item->hide();
         return;
+    }
 
     auto laser_node = G->get_node("laser");
     if(laser_node.has_value())
@@ -604,25 +593,20 @@ void QScene2dViewer::draw_laser()
         const auto lDists = G->get_attrib_by_name<laser_dists_att>(laser_node.value());
         if (lAngles.has_value() and lDists.has_value()) 
         {
-            QPolygonF poly;
-            poly << robot->mapToScene(QPointF(0, 0));
-            QPen pen(QColor("DarkGreen")); QBrush brush(QColor("DarkGreen"));
-            auto angs = lAngles.value().get();
-            auto dists = lDists.value().get();
-            points.reserve(dists.size());
-            for( auto &&[angle, dist] : iter::zip(angs, dists))
+            if (laser_item == nullptr)
             {
-                QPointF p = robot->mapToScene(QPointF(dist * sin(angle), dist * cos(angle)));
-                poly << p;
-                auto e = scene.addEllipse(QRectF(0,0,50,50), pen, brush);
-                e->setPos(p); e->setZValue(3000);
-                points.push_back(e);
+                QColor color("LightGreen");
+                color.setAlpha(60);
+                laser_item = new LaserItem();
+                laser_item->set_polygon_style(QPen(color), QBrush(color));
+                laser_item->set_point_style(QColor("DarkGreen"), 50);
+                laser_item->setZValue(3);
+                scene.addItem(laser_item);
             }
-            poly << robot->mapToScene(QPointF(0, 0));
-            QColor color("LightGreen");
-            color.setAlpha(60);
-            laser_polygon = scene.addPolygon(poly, QPen(color), QBrush(color));
-            laser_polygon->setZValue(3);
+            // The scan stays in laser coordinates, the item follows the robot.
+            laser_item->setTransform(robot->sceneTransform());
+            laser_item->set_scan(lAngles.value().get(), lDists.value().get());
+            laser_item->show();
         }
     }
 }
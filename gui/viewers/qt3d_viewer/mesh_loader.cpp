@@ -0,0 +1,130 @@
+//
+// Background stage of the mesh loading of the Qt3D viewer.
+//
+
+#include <dsr/gui/viewers/qt3d_viewer/mesh_loader.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string_view>
+
+using namespace DSR;
+
+
+MeshLoader::MeshLoader()
+{
+    worker = std::thread(&MeshLoader::run, this);
+}
+
+MeshLoader::~MeshLoader()
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        stop = true;
+    }
+    cv.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void MeshLoader::request(uint64_t node_id, std::string path)
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        requests.emplace_back(node_id, std::move(path));
+        in_flight++;
+        counters.requested++;
+    }
+    cv.notify_one();
+}
+
+std::vector<MeshSource> MeshLoader::take_ready(std::size_t max)
+{
+    std::unique_lock<std::mutex> lck(mtx);
+    std::vector<MeshSource> ret;
+    ret.reserve(std::min(max, ready.size()));
+    while (not ready.empty() and ret.size() < max)
+    {
+        ret.emplace_back(std::move(ready.front()));
+        ready.pop_front();
+    }
+    in_flight -= ret.size();
+    return ret;
+}
+
+bool MeshLoader::idle() const
+{
+    std::unique_lock<std::mutex> lck(mtx);
+    return in_flight == 0;
+}
+
+MeshLoader::Stats MeshLoader::stats() const
+{
+    std::unique_lock<std::mutex> lck(mtx);
+    return counters;
+}
+
+std::string MeshLoader::obj_path(std::string path)
+{
+    for (std::string_view ext : {".ive", ".3ds"})
+        if (auto pos = path.find(ext); pos != std::string::npos)
+            path.replace(pos, ext.size(), ".obj");
+    return path;
+}
+
+MeshSource MeshLoader::resolve(uint64_t node_id, std::string &&requested)
+{
+    MeshSource source{node_id, std::move(requested), {}, 0};
+
+    std::error_code ec;
+    auto canonical = std::filesystem::canonical(obj_path(source.requested), ec);
+    if (ec or canonical.extension() != ".obj" or not std::filesystem::is_regular_file(canonical, ec))
+        return source;
+    source.path = canonical.string();
+
+    if (auto it = path_keys.find(source.path); it != path_keys.end())
+        source.content_key = it->second;
+    else
+    {
+        std::ifstream file(source.path, std::ios::binary);
+        std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        if (file.bad())
+        {
+            source.path.clear();
+            return source;
+        }
+        // 0 means no mesh.
+        source.content_key = std::hash<std::string_view>{}(contents) | 1;
+        path_keys.emplace(source.path, source.content_key);
+        std::unique_lock<std::mutex> lck(mtx);
+        counters.files_read++;
+    }
+
+    if (key_uses[source.content_key]++ > 0)
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        counters.shared++;
+    }
+    return source;
+}
+
+void MeshLoader::run()
+{
+    while (true)
+    {
+        std::pair<uint64_t, std::string> req;
+        {
+            std::unique_lock<std::mutex> lck(mtx);
+            cv.wait(lck, [this] { return stop or not requests.empty(); });
+            if (stop) return;
+            req = std::move(requests.front());
+            requests.pop_front();
+        }
+        auto source = resolve(req.first, std::move(req.second));
+        {
+            std::unique_lock<std::mutex> lck(mtx);
+            ready.emplace_back(std::move(source));
+        }
+    }
+}
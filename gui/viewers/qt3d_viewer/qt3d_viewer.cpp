@@ -17,19 +17,24 @@ namespace DSR {
         widget = create_widget();
         //widget->setMinimumSize(QSize(500, 400));
 
-        connect(g.get(), &DSR::DSRGraph::update_node_signal, this, &QT3DViewer::update_node, Qt::QueuedConnection);
-        connect(g.get(), &DSR::DSRGraph::update_edge_signal, this, &QT3DViewer::update_edge, Qt::QueuedConnection);
-        connect(g.get(), &DSR::DSRGraph::del_edge_signal, this, &QT3DViewer::delete_edge, Qt::QueuedConnection);
-        connect(g.get(), &DSR::DSRGraph::del_node_signal, this, &QT3DViewer::delete_node, Qt::QueuedConnection);
+        dispatcher = GraphUpdateDispatcher::get(g);
+        connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this, &QT3DViewer::update_node);
+        connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_edge_signal, this, &QT3DViewer::update_edge);
+        connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_edge_signal, this, &QT3DViewer::delete_edge);
+        connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_node_signal, this, &QT3DViewer::delete_node);
         //connect(g.get(), &DSR::DSRGraph::update_node_attr_signal, this, &QT3DViewer::update_node_attr, Qt::QueuedConnection);
         //connect(g.get(), &DSR::DSRGraph::update_edge_attr_signal, this, &QT3DViewer::update_edge_attr, Qt::QueuedConnection);
         
 
+        populate_timer.setInterval(0);
+        connect(&populate_timer, &QTimer::timeout, this, &QT3DViewer::populate);
+
         initialize();
     }
     
     QT3DViewer::~QT3DViewer()
     {
+        populate_timer.stop();
         if (!only_one_widget) {
             delete view;
         }
@@ -106,145 +111,218 @@ namespace DSR {
         rootEntity->addComponent(globalLayer);
 
         //TODO: More types?
+        // The scene is shown right away and filled in by populate(), meshes are resolved in the background.
         for (const auto& node : g->get_nodes_by_types({"plane", "mesh"}))
-        {
-            update_qt3d_entity(node);
-        }
-        
+            pending_nodes.emplace_back(node.id());
+        populate_timer.start();
+
         view->setRootEntity(rootEntity);
     }
 
-    void QT3DViewer::update_qt3d_entity(const Node& node)
+    void QT3DViewer::populate()
     {
+        std::vector<uint64_t> batch;
+        batch.reserve(POPULATE_BATCH);
+        while (not pending_nodes.empty() and batch.size() < POPULATE_BATCH)
+        {
+            if (not entities.contains(pending_nodes.front()))
+                batch.emplace_back(pending_nodes.front());
+            pending_nodes.pop_front();
+        }
 
-        if (auto it = entities.find(node.id()); it == entities.end()) 
+        if (not batch.empty())
         {
-            auto y = g->get_attrib_by_name<height_att>(node);
-            auto x = g->get_attrib_by_name<width_att>(node);
-            auto z = g->get_attrib_by_name<depth_att>(node);
-            auto path = g->get_attrib_by_name<path_att>(node);
-            auto texture = g->get_attrib_by_name<texture_att>(node);
-
-
-            auto mat = inner->get_transformation_matrix("root", node.name());
-
-            if (((x.has_value() && y.has_value() && z.has_value()) || path.has_value()) && mat.has_value()) {
-
-                auto *Entity = new Qt3DCore::QEntity(rootEntity);
-                entities.emplace(node.id(), Entity);
-                
-                Entity->setObjectName(QString(node.name().data()));
-                QVector3D scale (1, 1, 1);
-                Qt3DRender::QMaterial *material = nullptr;
-                
-                if (texture.has_value()) {
-                    std::string_view str((*texture).get());
-                    if  (!str.empty()){
-                        if (str[0] == '#')
-                        {
-                            material = color_material(QColor(QString(str.data())));
-                        } else 
-                        {
-                            qInfo() << "[NOT SUPPORTED] Other material. should load texture.";
-                        }
-                    } else {
-                        material = color_material(QColor("gray"));
-                    }
-                } else {
-                    material = color_material(QColor("gray"));
+            // One pass over the RT tree for the whole batch.
+            if (auto poses = inner->get_poses("root", batch); poses.has_value())
+            {
+                for (std::size_t i = 0; i < batch.size(); i++)
+                {
+                    const auto pose = poses->col(static_cast<Eigen::Index>(i));
+                    if (pose.hasNaN()) continue;
+                    auto node = g->get_node(batch[i]);
+                    if (not node.has_value()) continue;
+                    Mat::RTMat mat = Eigen::Translation3d(pose.head<3>())
+                                   * (Eigen::AngleAxisd(pose(3), Eigen::Vector3d::UnitX())
+                                      * Eigen::AngleAxisd(pose(4), Eigen::Vector3d::UnitY())
+                                      * Eigen::AngleAxisd(pose(5), Eigen::Vector3d::UnitZ()));
+                    create_entity(node.value(), mat);
                 }
-                
-                auto plane_mesh = [&](auto& x, auto& y, auto& z) {
-
-                    auto *planeGeom = new Qt3DExtras::QCuboidGeometry;//QCuboidGeom;
-                    auto *planeMesh = new Qt3DRender::QGeometryRenderer(Entity);
+            }
+        }
 
-                    auto n_x = (*x / 10.f != 0) ?  *x / 10.f : 0.00001;
-                    auto n_y = (*y / 10.f != 0) ?  *y / 10.f : 0.00001;
-                    auto n_z = (*z / 10.f != 0) ?  *z / 10.f : 0.00001;
+        for (const auto &source : mesh_loader.take_ready(POPULATE_BATCH))
+            attach_mesh(source);
 
-                    qInfo() << "Create mesh "<< QString::fromStdString(node.name()) <<" " << n_x << " " << n_y << " " << n_z;
+        if (pending_nodes.empty() and mesh_loader.idle())
+        {
+            populate_timer.stop();
+            auto stats = mesh_loader.stats();
+            qInfo() << "QT3DViewer: scene populated." << entities.size() << "entities," << meshes.size()
+                    << "distinct meshes for" << stats.requested << "mesh nodes";
+        }
+    }
 
-                    planeGeom->setXExtent(n_x);
-                    planeGeom->setYExtent(n_y);
-                    planeGeom->setZExtent(n_z);
-                    planeGeom->setXYMeshResolution(QSize(2, 2));
-                    planeGeom->setXZMeshResolution(QSize(2, 2));
-                    planeGeom->setYZMeshResolution(QSize(2, 2));
-                    
-                    planeMesh->setGeometry(planeGeom);
-                    Entity->addComponent(planeMesh);
-                    Entity->addComponent(globalLayer);
+    void QT3DViewer::update_qt3d_entity(const Node& node)
+    {
+        auto mat = inner->get_transformation_matrix("root", node.name());
+        if (not mat.has_value())
+            return;
 
-                };
+        if (auto it = entities.find(node.id()); it == entities.end())
+        {
+            create_entity(node, mat.value());
+            if (not populate_timer.isActive() and not pending_meshes.empty())
+                populate_timer.start();
+        }
+        else if (auto transform = transform_of(it->second); transform != nullptr)
+            set_pose(transform, mat.value());
+    }
 
-                if (auto [path, scalex, scaley, scalez] = g->get_attribs_by_name<DSR::Node, path_att, scalex_att, scaley_att, scalez_att>(node); path.has_value())
+    void QT3DViewer::create_entity(const Node& node, const Mat::RTMat &mat)
+    {
+        auto y = g->get_attrib_by_name<height_att>(node);
+        auto x = g->get_attrib_by_name<width_att>(node);
+        auto z = g->get_attrib_by_name<depth_att>(node);
+        auto [path, scalex, scaley, scalez] = g->get_attribs_by_name<DSR::Node, path_att, scalex_att, scaley_att, scalez_att>(node);
+        auto texture = g->get_attrib_by_name<texture_att>(node);
+
+        const bool has_extents = x.has_value() && y.has_value() && z.has_value();
+        if (not has_extents and not path.has_value())
+            return;
+
+        auto *Entity = new Qt3DCore::QEntity(rootEntity);
+        entities.emplace(node.id(), Entity);
+        Entity->setObjectName(QString(node.name().data()));
+
+        Qt3DRender::QMaterial *material = nullptr;
+        if (texture.has_value()) {
+            std::string_view str((*texture).get());
+            if  (!str.empty()){
+                if (str[0] == '#')
                 {
-
-                    
-                    auto *mesh = new Qt3DRender::QMesh(Entity);
-
-                    QUrl meshpath;
-                    QString pathqstr (path->data());
-                    //TODO: support .ive y .3ds
-                    pathqstr.replace(".ive", ".obj");
-                    pathqstr.replace(".3ds", ".obj");
-                    QFileInfo check_file(pathqstr);
-                    pathqstr = check_file.canonicalFilePath();
-                    meshpath.setScheme("file");
-                    meshpath.setPath(pathqstr);
-                    mesh->setSource(meshpath);
-
-                    std::cout << pathqstr.toStdString() << ", children nodes=" << mesh->childNodes().count() << " file exist?: "<< std::boolalpha<< (check_file.exists() && check_file.isFile())  << std::endl;
-
-                    if (!pathqstr.endsWith(".obj") )
-                    {
-                        qInfo() << "no obj file: "<< QString::fromStdString(node.name()) <<" " << *x << " " << *y << " " << *z;
-                        plane_mesh(x, y, z);
-                    }
-                    else {
-                        std::cout << "Set mesh. scale  " <<scalex.value_or(1.0)<< " " << scaley.value_or(1.0)<< " " << scalez.value_or(1.0) << std::endl;
-                        Entity->addComponent(mesh);
-                        Entity->addComponent(globalLayer);
-
-                        scale = QVector3D(scalex.value_or(1.0)/10, scaley.value_or(1.0)/10, scalez.value_or(1.0)/10);
-                        scale = QVector3D(scalex.value_or(1.0)/10, scaley.value_or(1.0)/10, scalez.value_or(1.0)/10);
-                    }
-
-                } else {
-                    qInfo() << "no path in object "<< QString::fromStdString(node.name()) <<" " << *x << " " << *y << " " << *z;
-                    plane_mesh(x, y, z);
+                    material = color_material(QColor(QString(str.data())));
+                } else
+                {
+                    qInfo() << "[NOT SUPPORTED] Other material. should load texture.";
                 }
-
-                Qt3DCore::QTransform *planeTransform = new Qt3DCore::QTransform;
-                planeTransform->setScale3D(scale);
-                auto tr = mat->translation();
-                Eigen::Matrix<float, 3, 3> mcopy = mat->rotation().cast<float>();
-                QMatrix3x3 rot(mcopy.data());
-                planeTransform->setTranslation(QVector3D(tr.x() / 10, tr.y() / 10, tr.z() / 10));
-                planeTransform->setRotation(QQuaternion::fromRotationMatrix(rot));
-                
-                Entity->addComponent(material);
-                Entity->addComponent(planeTransform);                        
+            } else {
+                material = color_material(QColor("gray"));
             }
         } else {
+            material = color_material(QColor("gray"));
+        }
 
-            auto Entity = it->second;
-            auto mat = inner->get_transformation_matrix("root", node.name());
-
-            auto componentList = Entity->components();
-            auto c = std::find_if(componentList.begin(), componentList.end(),
-                                    [](auto &p) {
-                                        return qobject_cast<Qt3DCore::QTransform *>(p);
-                                    });
-            auto transform = qobject_cast<Qt3DCore::QTransform *>(*c);
-
-            auto tr = mat->translation();
-            Eigen::Matrix<float, 3, 3> mcopy = mat->rotation().cast<float>();
-            QMatrix3x3 rot(mcopy.data());
-            transform->setTranslation(QVector3D(tr.x() / 10, tr.y() / 10, tr.z() / 10));
-            transform->setRotation(QQuaternion::fromRotationMatrix(rot));
+        std::optional<QVector3D> extents;
+        if (has_extents)
+        {
+            auto n_x = (*x / 10.f != 0) ?  *x / 10.f : 0.00001;
+            auto n_y = (*y / 10.f != 0) ?  *y / 10.f : 0.00001;
+            auto n_z = (*z / 10.f != 0) ?  *z / 10.f : 0.00001;
+            extents = QVector3D(n_x, n_y, n_z);
         }
+
+        auto *planeTransform = new Qt3DCore::QTransform;
+        set_pose(planeTransform, mat);
+        if (material != nullptr)
+            Entity->addComponent(material);
+        Entity->addComponent(planeTransform);
+
+        if (path.has_value())
+        {
+            // The geometry is attached when the loader has resolved the file.
+            pending_meshes[node.id()] = PendingMesh{path.value(),
+                                                    QVector3D(scalex.value_or(1.0)/10, scaley.value_or(1.0)/10, scalez.value_or(1.0)/10),
+                                                    extents};
+            mesh_loader.request(node.id(), path.value());
+        }
+        else
+        {
+            // All the cuboids share one unit geometry scaled by the transform.
+            planeTransform->setScale3D(extents.value());
+            Entity->addComponent(cuboid_mesh());
+            Entity->addComponent(globalLayer);
+        }
+    }
+
+    void QT3DViewer::attach_mesh(const MeshSource &source)
+    {
+        auto pending = pending_meshes.find(source.node_id);
+        auto entity = entities.find(source.node_id);
+        // The node was deleted, or recreated with another mesh that is still in the loader.
+        if (pending == pending_meshes.end() or entity == entities.end() or pending->second.path != source.requested)
+            return;
+        auto transform = transform_of(entity->second);
+
+        if (source.content_key != 0)
+        {
+            auto &mesh = meshes[source.content_key];
+            if (mesh == nullptr)
+            {
+                mesh = new Qt3DRender::QMesh(rootEntity);
+                QUrl meshpath;
+                meshpath.setScheme("file");
+                meshpath.setPath(QString::fromStdString(source.path));
+                mesh->setSource(meshpath);
+            }
+            transform->setScale3D(pending->second.scale);
+            entity->second->addComponent(mesh);
+            entity->second->addComponent(globalLayer);
+        }
+        else if (pending->second.extents.has_value())
+        {
+            qInfo() << "no obj file: " << entity->second->objectName() << " " << QString::fromStdString(source.requested);
+            transform->setScale3D(pending->second.extents.value());
+            entity->second->addComponent(cuboid_mesh());
+            entity->second->addComponent(globalLayer);
+        }
+        else
+            qInfo() << "no obj file and no size in object " << entity->second->objectName();
+        pending_meshes.erase(pending);
+    }
+
+    Qt3DRender::QMaterial *QT3DViewer::color_material(QColor color)
+    {
+        auto &mat = materials[color.rgba()];
+        if (mat == nullptr)
+        {
+            auto *diffuse = new Qt3DExtras::QDiffuseSpecularMaterial(rootEntity);
+            diffuse->setAmbient(color);
+            diffuse->setSpecular(QColor(0, 0, 0));
+            qInfo() << "Color: " << color;
+            mat = diffuse;
+        }
+        return mat;
+    }
+
+    Qt3DRender::QGeometryRenderer *QT3DViewer::cuboid_mesh()
+    {
+        if (unit_cuboid == nullptr)
+        {
+            auto *geom = new Qt3DExtras::QCuboidGeometry;
+            geom->setXYMeshResolution(QSize(2, 2));
+            geom->setXZMeshResolution(QSize(2, 2));
+            geom->setYZMeshResolution(QSize(2, 2));
+            unit_cuboid = new Qt3DRender::QGeometryRenderer(rootEntity);
+            unit_cuboid->setGeometry(geom);
+        }
+        return unit_cuboid;
+    }
+
+    Qt3DCore::QTransform *QT3DViewer::transform_of(Qt3DCore::QEntity *entity)
+    {
+        for (auto *c : entity->components())
+            if (auto *transform = qobject_cast<Qt3DCore::QTransform *>(c))
+                return transform;
+        return nullptr;
+    }
+
+    void QT3DViewer::set_pose(Qt3DCore::QTransform *transform, const Mat::RTMat &mat)
+    {
+        auto tr = mat.translation();
+        Eigen::Matrix<float, 3, 3> mcopy = mat.rotation().cast<float>();
+        QMatrix3x3 rot(mcopy.data());
+        transform->setTranslation(QVector3D(tr.x() / 10, tr.y() / 10, tr.z() / 10));
+        transform->setRotation(QQuaternion::fromRotationMatrix(rot));
     }
 
 
@@ -267,6 +345,7 @@ namespace DSR {
 
     void QT3DViewer::delete_node(uint64_t id)
     {
+        pending_meshes.erase(id);
         auto node = entities.extract(id);
         if (!node.empty()){
             auto entity = node.mapped();
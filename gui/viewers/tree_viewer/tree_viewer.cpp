@@ -22,8 +22,9 @@ TreeViewer::TreeViewer(std::shared_ptr<DSR::DSRGraph> G_, QWidget *parent) :  QT
 //	setHeaderHidden(true);
     createGraph();
 
-    connect(G.get(), &DSR::DSRGraph::update_node_signal, this,
-			[=, this]( std::uint64_t id, const std::string& type ) {TreeViewer::add_or_assign_node_SLOT(id, type);}, Qt::QueuedConnection);
+    dispatcher = GraphUpdateDispatcher::get(G);
+    connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::update_node_signal, this,
+			[=, this]( std::uint64_t id, const std::string& type ) {TreeViewer::add_or_assign_node_SLOT(id, type);});
     setColumnCount(2);
 	QStringList horzHeaders;
 	horzHeaders <<"Attribute"<< "Value";
@@ -32,7 +33,7 @@ TreeViewer::TreeViewer(std::shared_ptr<DSR::DSRGraph> G_, QWidget *parent) :  QT
 	this->header()->setDefaultSectionSize(250);
 	//connect(G.get(), &DSR::DSRGraph::update_edge_signal, this, &GraphViewer::addEdgeSLOT, Qt::QueuedConnection);
 //	connect(G.get(), &DSR::DSRGraph::del_edge_signal, this, &TreeViewer::);
-	connect(G.get(), &DSR::DSRGraph::del_node_signal, this, &TreeViewer::del_node_SLOT, Qt::QueuedConnection);
+	connect(dispatcher.get(), &DSR::GraphUpdateDispatcher::del_node_signal, this, &TreeViewer::del_node_SLOT);
 }
 
 void TreeViewer::createGraph()
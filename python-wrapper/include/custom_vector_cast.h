@@ -13,9 +13,11 @@
 #include <pybind11/iostream.h>
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 #pragma pop_macro("slots")
 
+#include <cstring>
 #include <iostream>
 
 
@@ -25,7 +27,16 @@ namespace pybind11::detail {
         using value_conv = make_caster<float>;
 
         bool load(handle src, bool convert) {
-            if (!isinstance<sequence>(src) || isinstance<str>(src) || npy_api::get().PyArrayDescr_Check_(src.ptr())) {
+            auto &npy = npy_api::get();
+            // float32 numpy arrays are copied with a single memcpy instead of element by element.
+            if (npy.PyArray_Check_(src.ptr()) && npy.PyArray_EquivTypes_(array_proxy(src.ptr())->descr, dtype::of<float>().ptr())) {
+                auto a = array_t<float, array::c_style | array::forcecast>::ensure(src);
+                if (!a || a.ndim() != 1) return false;
+                value.resize(a.size());
+                if (!value.empty()) std::memcpy(value.data(), a.data(), value.size() * sizeof(float));
+                return true;
+            }
+            if (!isinstance<sequence>(src) || isinstance<str>(src) || npy.PyArrayDescr_Check_(src.ptr())) {
                 return false;
             }
             //std::cout <<" Casting std::vector from type "<< src.ptr()->ob_type->tp_name << " " << py::repr(src.ptr()) << std::boolalpha << convert <<  std::endl;
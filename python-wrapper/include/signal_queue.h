@@ -0,0 +1,246 @@
+//
+// Queued delivery of graph signals to Python.
+//
+// The slots connected to the graph only push events into a bounded lock-free queue, they never take the
+// GIL or wait for Python. Python drains the queue from its own loop, blocking in wait() with the GIL
+// released or from asyncio through fileno(). When the queue is full new events are dropped. An update
+// equal to one that is still pending (same node or edge and same attribute names) is coalesced with it,
+// Python reads the graph when it handles the event so it sees the last value anyway.
+//
+
+#ifndef PYTHON_WRAPPER_SIGNAL_QUEUE_H
+#define PYTHON_WRAPPER_SIGNAL_QUEUE_H
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace DSR::python
+{
+    // Same order as the signal_type enum of the signals module.
+    enum class EventType : uint8_t
+    {
+        UPDATE_NODE,
+        UPDATE_NODE_ATTR,
+        UPDATE_EDGE,
+        UPDATE_EDGE_ATTR,
+        DELETE_EDGE,
+        DELETE_NODE
+    };
+
+    struct SignalEvent
+    {
+        EventType type = EventType::UPDATE_NODE;
+        uint64_t from = 0;                  // node id for the node signals
+        uint64_t to = 0;
+        std::string name;                   // node or edge type
+        std::vector<std::string> attrs;
+        uint64_t key = 0;                   // coalescing key, 0 for events that are never coalesced
+    };
+
+    // Bounded multi producer multi consumer queue (D. Vyukov). The capacity is rounded up to a power of two.
+    template <typename T>
+    class BoundedQueue
+    {
+        public:
+            explicit BoundedQueue(std::size_t capacity)
+                : mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), cells(new Cell[mask + 1])
+            {
+                for (std::size_t i = 0; i <= mask; i++)
+                    cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+
+            bool try_push(T &&v)
+            {
+                std::size_t pos = tail.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    Cell &c = cells[pos & mask];
+                    const std::size_t seq = c.seq.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                    if (diff == 0)
+                    {
+                        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            c.data = std::move(v);
+                            c.seq.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) return false;    // full
+                    else pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            bool try_pop(T &out)
+            {
+                std::size_t pos = head.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    Cell &c = cells[pos & mask];
+                    const std::size_t seq = c.seq.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                    if (diff == 0)
+                    {
+                        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            out = std::move(c.data);
+                            c.seq.store(pos + mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) return false;    // empty
+                    else pos = head.load(std::memory_order_relaxed);
+                }
+            }
+
+            [[nodiscard]] std::size_t capacity() const { return mask + 1; }
+            [[nodiscard]] std::size_t size() const
+            {
+                const auto t = tail.load(std::memory_order_relaxed), h = head.load(std::memory_order_relaxed);
+                return t > h ? t - h : 0;
+            }
+
+        private:
+            struct Cell
+            {
+                std::atomic<std::size_t> seq;
+                T data;
+            };
+            const std::size_t mask;
+            std::unique_ptr<Cell[]> cells;
+            alignas(64) std::atomic<std::size_t> head{0};
+            alignas(64) std::atomic<std::size_t> tail{0};
+    };
+
+    class SignalQueue
+    {
+        public:
+            explicit SignalQueue(std::size_t capacity, bool coalesce = true)
+                : queue(capacity), coalescing(coalesce), fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+            {
+                for (auto &p : pending) p.store(0, std::memory_order_relaxed);
+            }
+            ~SignalQueue() { if (fd >= 0) close(fd); }
+            SignalQueue(const SignalQueue &) = delete;
+            SignalQueue &operator=(const SignalQueue &) = delete;
+
+            // Called from the graph threads. Never blocks.
+            void push(SignalEvent &&ev)
+            {
+                if (not coalescing) ev.key = 0;
+                const uint64_t key = ev.key;
+                auto &slot = pending[key & (PENDING - 1)];
+                if (key != 0 and slot.exchange(key, std::memory_order_acq_rel) == key)
+                {
+                    coalesced_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (not queue.try_push(std::move(ev)))
+                {
+                    if (key != 0)
+                    {
+                        auto expected = key;
+                        slot.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+                    }
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                pushed_.fetch_add(1, std::memory_order_relaxed);
+                notify();
+            }
+
+            // Pops up to max_events (all of them if 0) and resets the notification.
+            std::vector<SignalEvent> drain(std::size_t max_events = 0)
+            {
+                armed.store(false, std::memory_order_seq_cst);
+                if (fd >= 0)
+                {
+                    uint64_t v;
+                    [[maybe_unused]] auto r = read(fd, &v, sizeof(v));
+                }
+                std::vector<SignalEvent> out;
+                SignalEvent ev;
+                while ((max_events == 0 or out.size() < max_events) and queue.try_pop(ev))
+                {
+                    // Cleared before the event is handled so later updates are queued again.
+                    if (ev.key != 0)
+                    {
+                        auto expected = ev.key;
+                        pending[ev.key & (PENDING - 1)].compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+                    }
+                    out.emplace_back(std::move(ev));
+                }
+                // Events left behind by max_events must wake the reader again.
+                if (queue.size() > 0) notify();
+                return out;
+            }
+
+            // Waits until there are events or timeout_ms passes (-1 waits forever). Call it without the GIL.
+            bool wait(int timeout_ms)
+            {
+                if (queue.size() > 0) return true;
+                if (fd < 0) return false;
+                pollfd p{fd, POLLIN, 0};
+                return poll(&p, 1, timeout_ms) > 0 or queue.size() > 0;
+            }
+
+            [[nodiscard]] int fileno() const { return fd; }
+            [[nodiscard]] std::size_t size() const { return queue.size(); }
+            [[nodiscard]] std::size_t capacity() const { return queue.capacity(); }
+            [[nodiscard]] uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+            [[nodiscard]] uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+            [[nodiscard]] uint64_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+            // Coalescing key of an update, 0 for deletions.
+            static uint64_t make_key(const SignalEvent &ev)
+            {
+                if (ev.type == EventType::DELETE_EDGE or ev.type == EventType::DELETE_NODE) return 0;
+                uint64_t h = mix(static_cast<uint64_t>(ev.type) + 1);
+                h = mix(h ^ ev.from);
+                h = mix(h ^ ev.to);
+                h = mix(h ^ std::hash<std::string>{}(ev.name));
+                for (const auto &a : ev.attrs) h = mix(h ^ std::hash<std::string>{}(a));
+                return h == 0 ? 1 : h;
+            }
+
+        private:
+            static constexpr std::size_t PENDING = 4096;
+
+            static uint64_t mix(uint64_t x)
+            {
+                x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+                x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+                x ^= x >> 33;
+                return x;
+            }
+
+            void notify()
+            {
+                if (fd >= 0 and not armed.exchange(true, std::memory_order_seq_cst))
+                {
+                    const uint64_t one = 1;
+                    [[maybe_unused]] auto r = write(fd, &one, sizeof(one));
+                }
+            }
+
+            BoundedQueue<SignalEvent> queue;
+            const bool coalescing;
+            const int fd;
+            std::atomic<bool> armed{false};
+            // Key of the pending update in each bucket. Two keys in the same bucket only lose the coalescing.
+            std::atomic<uint64_t> pending[PENDING];
+            std::atomic<uint64_t> pushed_{0};
+            std::atomic<uint64_t> dropped_{0};
+            std::atomic<uint64_t> coalesced_{0};
+    };
+}
+
+#endif //PYTHON_WRAPPER_SIGNAL_QUEUE_H
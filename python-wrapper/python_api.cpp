@@ -3,6 +3,7 @@
 //
 
 #include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_query.h"
 
 using namespace DSR;
 
@@ -12,6 +13,7 @@ using namespace DSR;
 #include "include/custom_bool_cast.h"
 #include "include/custom_vector_cast.h"
 #include "include/GHistory.h"
+#include "include/signal_queue.h"
 
 #pragma push_macro("slots")
 #undef slots
@@ -25,6 +27,9 @@ using namespace DSR;
 
 #pragma pop_macro("slots")
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <utility>
 
 #include <memory>
@@ -86,6 +91,26 @@ using attribute_type = std::variant<std::string,
 
 
 
+// Copies a numpy array into a vector with a single memcpy. Arrays that are not C contiguous are made contiguous first.
+template <typename T>
+std::vector<T> array_to_vector(const py::array_t<T> &a)
+{
+    auto c = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(a);
+    if (not c) throw pybind11::type_error("Cannot convert the array to a contiguous array");
+    std::vector<T> v(c.size());
+    if (not v.empty()) std::memcpy(v.data(), c.data(), v.size() * sizeof(T));
+    return v;
+}
+
+// Read only numpy array over data. owner is the capsule that keeps the storage alive while the array exists.
+template <typename T>
+py::array_t<T> readonly_array(const T *data, std::size_t size, const py::capsule &owner)
+{
+    py::array_t<T> a({static_cast<py::ssize_t>(size)}, {static_cast<py::ssize_t>(sizeof(T))}, data, owner);
+    py::detail::array_proxy(a.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return a;
+}
+
 template<std::size_t idx, typename T>
 ValType convert_variant_fn(const attribute_type & e)
 {
@@ -93,23 +118,13 @@ ValType convert_variant_fn(const attribute_type & e)
     ValType vout;
     if constexpr (std::is_same_v<T, py::array_t<uint8_t>>)
     {
-        auto tmp = std::get<py::array_t<uint8_t>>(e);
-        const auto size = tmp.size();
-        py::buffer_info x = tmp.request();
-        vout.emplace<idx>(std::vector<uint8_t>{static_cast<uint8_t *>(x.ptr), static_cast<uint8_t *>(x.ptr) + size});
+        vout.emplace<idx>(array_to_vector(std::get<py::array_t<uint8_t>>(e)));
     } else if constexpr (std::is_same_v<T, py::array_t<float>>)
     {
-        auto tmp = std::get<py::array_t<float>>(e);
-        //std::cout << tmp.dtype() << " " << tmp.size() << py::array_t<float>::ensure(tmp) << std::endl;
-        const auto size = tmp.size();
-        py::buffer_info x = tmp.request();
-        vout.emplace<idx>(std::vector<float>{static_cast<float *>(x.ptr), static_cast<float *>(x.ptr) + size});
+        vout.emplace<idx>(array_to_vector(std::get<py::array_t<float>>(e)));
     } else if constexpr (std::is_same_v<T, py::array_t<uint64_t>>)
     {
-        auto tmp = std::get<py::array_t<uint64_t>>(e);
-        const auto size = tmp.size();
-        py::buffer_info x = tmp.request();
-        vout.emplace<idx>(std::vector<uint64_t>{static_cast<uint64_t *>(x.ptr), static_cast<uint64_t *>(x.ptr) + size});
+        vout.emplace<idx>(array_to_vector(std::get<py::array_t<uint64_t>>(e)));
     } else if constexpr (std::is_same_v<T, no_int_cast_bool>)
     {
         auto tmp = std::get<no_int_cast_bool>(e)();
@@ -152,6 +167,105 @@ ValType convert_variant(const attribute_type & e)
     return cast[idx](e);
 }
 
+// Queue connected to the callbacks of a graph. The callbacks hold the queue so it outlives any call in flight.
+struct SignalQueueConnection
+{
+    std::shared_ptr<DSR::python::SignalQueue> queue;
+    DSR::Connections connections;
+
+    SignalQueueConnection(DSRGraph *G, std::size_t capacity, bool coalesce, const std::vector<DSR::python::EventType> &types)
+        : queue(std::make_shared<DSR::python::SignalQueue>(capacity, coalesce))
+    {
+        using DSR::python::EventType;
+        using DSR::python::SignalEvent;
+        auto q = queue;
+        auto push = [q](SignalEvent &&ev) {
+            ev.key = DSR::python::SignalQueue::make_key(ev);
+            q->push(std::move(ev));
+        };
+        auto &cb = G->callbacks();
+        for (auto type : types)
+        {
+            switch (type)
+            {
+                case EventType::UPDATE_NODE:
+                    connections.add(cb.update_node, [push](uint64_t id, const std::string &t, const SignalInfo &) {
+                        push(SignalEvent{EventType::UPDATE_NODE, id, 0, t, {}});
+                    });
+                    break;
+                case EventType::UPDATE_NODE_ATTR:
+                    connections.add(cb.update_node_attr, [push](uint64_t id, const std::vector<std::string> &attrs, const SignalInfo &) {
+                        push(SignalEvent{EventType::UPDATE_NODE_ATTR, id, 0, {}, attrs});
+                    });
+                    break;
+                case EventType::UPDATE_EDGE:
+                    connections.add(cb.update_edge, [push](uint64_t from, uint64_t to, const std::string &t, const SignalInfo &) {
+                        push(SignalEvent{EventType::UPDATE_EDGE, from, to, t, {}});
+                    });
+                    break;
+                case EventType::UPDATE_EDGE_ATTR:
+                    connections.add(cb.update_edge_attr, [push](uint64_t from, uint64_t to, const std::string &t, const std::vector<std::string> &attrs, const SignalInfo &) {
+                        push(SignalEvent{EventType::UPDATE_EDGE_ATTR, from, to, t, attrs});
+                    });
+                    break;
+                case EventType::DELETE_EDGE:
+                    connections.add(cb.del_edge, [push](uint64_t from, uint64_t to, const std::string &t, const SignalInfo &) {
+                        push(SignalEvent{EventType::DELETE_EDGE, from, to, t, {}});
+                    });
+                    break;
+                case EventType::DELETE_NODE:
+                    connections.add(cb.del_node, [push](uint64_t id, const SignalInfo &) {
+                        push(SignalEvent{EventType::DELETE_NODE, id, 0, {}, {}});
+                    });
+                    break;
+            }
+        }
+    }
+
+    void disconnect()
+    {
+        connections.clear();
+    }
+
+    ~SignalQueueConnection() { disconnect(); }
+};
+
+// Python object kept by a graph thread. It is released with the GIL held.
+struct GilObject
+{
+    py::object obj;
+    explicit GilObject(py::object o) : obj(std::move(o)) {}
+    ~GilObject()
+    {
+        py::gil_scoped_acquire gil;
+        obj = py::object();
+    }
+};
+
+// asyncio future of the running loop completed by a WaitAPI condition. register_fn registers the
+// condition with the callback, it is called without the GIL because the first check reads the graph.
+template <typename T>
+py::object async_wait(const std::function<void(std::function<void(std::optional<T>)>)> &register_fn)
+{
+    auto loop = py::module_::import("asyncio").attr("get_running_loop")();
+    auto future = loop.attr("create_future")();
+    auto state = std::make_shared<std::pair<GilObject, GilObject>>(GilObject(loop), GilObject(future));
+    auto cb = [state](std::optional<T> v) {
+        py::gil_scoped_acquire gil;
+        auto fut = state->second.obj;
+        py::object value = v.has_value() ? py::cast(std::move(v.value())) : py::none();
+        // The future may have been cancelled (asyncio.wait_for) or the loop closed in the meantime.
+        auto set = py::cpp_function([fut, value]() { if (not fut.attr("done")().cast<bool>()) fut.attr("set_result")(value); });
+        try { state->first.obj.attr("call_soon_threadsafe")(set); }
+        catch (py::error_already_set &e) { e.discard_as_unraisable(__func__); }
+    };
+    {
+        py::gil_scoped_release release;
+        register_fn(std::move(cb));
+    }
+    return future;
+}
+
 PYBIND11_MAKE_OPAQUE(std::map<std::pair<uint64_t, std::string>, Edge>)
 PYBIND11_MAKE_OPAQUE(std::map<std::string, Attribute>)
 
@@ -219,13 +333,15 @@ PYBIND11_MODULE(pydsr, m) {
             .export_values();
 
 
+    // The callbacks are direct, they run in the graph threads and take the GIL. They stay connected while G lives.
     sig.def("connect", [](DSRGraph *G, signal_type type, callback_types fn_callback) {
 
+        auto &cb = G->callbacks();
         switch (type) {
             case UPDATE_NODE:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::update_node_signal,
-                                     std::get<std::function<void(std::uint64_t, const std::string &)>>(fn_callback));
+                    cb.update_node.connect([f = std::get<std::function<void(std::uint64_t, const std::string &)>>(fn_callback)]
+                                           (uint64_t id, const std::string &t, const SignalInfo &) { f(id, t); });
 
                 } catch (std::exception &e) {
                     std::cout << "Update Node Callback must be (int, str)\n "  << std::endl;
@@ -234,9 +350,8 @@ PYBIND11_MODULE(pydsr, m) {
                 break;
             case UPDATE_NODE_ATTR:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::update_node_attr_signal,
-                                     std::get<std::function<void(std::uint64_t, const std::vector<std::string> &)>>(
-                                                 fn_callback));
+                    cb.update_node_attr.connect([f = std::get<std::function<void(std::uint64_t, const std::vector<std::string> &)>>(fn_callback)]
+                                                (uint64_t id, const std::vector<std::string> &attrs, const SignalInfo &) { f(id, attrs); });
 
                 } catch (std::exception &e) {
                     std::cout << "Update Node Attribute Callback must be (int, [str])\n "  << std::endl;
@@ -245,9 +360,8 @@ PYBIND11_MODULE(pydsr, m) {
                 break;
             case UPDATE_EDGE:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::update_edge_signal,
-                                     std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string &)>>(
-                                             fn_callback));
+                    cb.update_edge.connect([f = std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string &)>>(fn_callback)]
+                                           (uint64_t from, uint64_t to, const std::string &t, const SignalInfo &) { f(from, to, t); });
                 } catch (std::exception &e) {
                     std::cout << "Update Edge Callback must be (int, int, str)\n "  << std::endl;
                     throw e;
@@ -255,9 +369,10 @@ PYBIND11_MODULE(pydsr, m) {
                 break;
             case UPDATE_EDGE_ATTR:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::update_edge_attr_signal,
-                                     std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string&,
-                                                                 const std::vector<std::string> &)>>(fn_callback));
+                    cb.update_edge_attr.connect([f = std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string&,
+                                                                                 const std::vector<std::string> &)>>(fn_callback)]
+                                                (uint64_t from, uint64_t to, const std::string &t, const std::vector<std::string> &attrs,
+                                                 const SignalInfo &) { f(from, to, t, attrs); });
                 } catch (std::exception &e) {
                     std::cout << "Update Edge Attribute Callback must be (int, int, str, [str])\n " << std::endl;
                     throw e;
@@ -265,9 +380,8 @@ PYBIND11_MODULE(pydsr, m) {
                 break;
             case DELETE_EDGE:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::del_edge_signal,
-                                     std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string &)>>(
-                                             fn_callback));
+                    cb.del_edge.connect([f = std::get<std::function<void(std::uint64_t, std::uint64_t, const std::string &)>>(fn_callback)]
+                                        (uint64_t from, uint64_t to, const std::string &t, const SignalInfo &) { f(from, to, t); });
                 } catch (std::exception &e) {
                     std::cout << "Delete Edge Callback must be (int, int, str)\n "  << std::endl;
                     throw e;
@@ -275,8 +389,8 @@ PYBIND11_MODULE(pydsr, m) {
                 break;
             case DELETE_NODE:
                 try {
-                    QObject::connect(G, &DSR::DSRGraph::del_node_signal,
-                                     std::get<std::function<void(std::uint64_t)>>(fn_callback));
+                    cb.del_node.connect([f = std::get<std::function<void(std::uint64_t)>>(fn_callback)]
+                                        (uint64_t id, const SignalInfo &) { f(id); });
                 } catch (std::exception &e) {
                     std::cout << "Delete Node Callback must be (int)\n "  << std::endl;
                     throw e;
@@ -287,6 +401,59 @@ PYBIND11_MODULE(pydsr, m) {
         }
     });
 
+    py::class_<SignalQueueConnection>(sig, "queue", R""""(
+    Queued delivery of the signals. The graph threads only push events into a bounded lock-free queue and
+    never wait for Python. Drain it from your own loop:
+
+        q = signals.queue(g)
+        while q.wait(100):
+            for ev in q.drain(): ...
+
+    or from asyncio with loop.add_reader(q.fileno(), lambda: handle(q.drain())).
+
+    Each event is a tuple with the signal_type followed by the arguments of the callback of that signal.
+    Repeated updates of a node or edge that are still in the queue are coalesced, and events that do not
+    fit are dropped. Both are counted.
+    )"""")
+            .def(py::init([](DSRGraph *G, std::size_t capacity, bool coalesce, const std::vector<signal_type> &types) {
+                std::vector<DSR::python::EventType> t;
+                for (auto type : types) t.emplace_back(static_cast<DSR::python::EventType>(type));
+                return std::make_unique<SignalQueueConnection>(G, capacity, coalesce, t);
+            }), "graph"_a, "capacity"_a = 4096, "coalesce"_a = true,
+                "types"_a = std::vector<signal_type>{UPDATE_NODE, UPDATE_NODE_ATTR, UPDATE_EDGE, UPDATE_EDGE_ATTR, DELETE_EDGE, DELETE_NODE},
+                py::keep_alive<1, 2>())
+            .def("drain", [](SignalQueueConnection &self, std::size_t max_events) {
+                auto events = self.queue->drain(max_events);
+                py::list out(events.size());
+                for (std::size_t i = 0; i < events.size(); i++)
+                {
+                    auto &ev = events[i];
+                    const auto type = static_cast<signal_type>(ev.type);
+                    switch (type)
+                    {
+                        case UPDATE_NODE: out[i] = py::make_tuple(type, ev.from, ev.name); break;
+                        case UPDATE_NODE_ATTR: out[i] = py::make_tuple(type, ev.from, ev.attrs); break;
+                        case UPDATE_EDGE:
+                        case DELETE_EDGE: out[i] = py::make_tuple(type, ev.from, ev.to, ev.name); break;
+                        case UPDATE_EDGE_ATTR: out[i] = py::make_tuple(type, ev.from, ev.to, ev.name, ev.attrs); break;
+                        case DELETE_NODE: out[i] = py::make_tuple(type, ev.from); break;
+                    }
+                }
+                return out;
+            }, "max_events"_a = 0, "Pop up to max_events events (0 for all) as a list of tuples.")
+            .def("wait", [](SignalQueueConnection &self, int timeout_ms) {
+                return self.queue->wait(timeout_ms);
+            }, "timeout_ms"_a = -1, py::call_guard<py::gil_scoped_release>(),
+               "Wait for events with the GIL released. Returns False on timeout.")
+            .def("fileno", [](SignalQueueConnection &self) { return self.queue->fileno(); },
+                 "File descriptor that becomes readable when there are events, for selectors and asyncio.")
+            .def("close", &SignalQueueConnection::disconnect, "Disconnect the queue from the graph.")
+            .def("__len__", [](SignalQueueConnection &self) { return self.queue->size(); })
+            .def_property_readonly("capacity", [](SignalQueueConnection &self) { return self.queue->capacity(); })
+            .def_property_readonly("pushed", [](SignalQueueConnection &self) { return self.queue->pushed(); })
+            .def_property_readonly("dropped", [](SignalQueueConnection &self) { return self.queue->dropped(); })
+            .def_property_readonly("coalesced", [](SignalQueueConnection &self) { return self.queue->coalesced(); });
+
     //DSR Attribute class
     py::class_<Attribute>(m, "Attribute")
             .def(py::init([&](attribute_type const& v, uint64_t t, uint32_t agent_id){
@@ -365,10 +532,7 @@ PYBIND11_MODULE(pydsr, m) {
                                           break;
                                       case 3:
                                           if (val.index() == ATT_ENUM::NPYF) {
-                                              auto tmp = std::get<py::array_t<float>>(val);
-                                              const auto size = tmp.size();
-                                              py::buffer_info x = tmp.request();
-                                              self.float_vec(std::vector<float>{static_cast<float *>(x.ptr), static_cast<float *>(x.ptr) + size});
+                                              self.float_vec(array_to_vector(std::get<py::array_t<float>>(val)));
                                           }
                                           else self.float_vec(std::get<std::vector<float>>(val));
                                           break;
@@ -377,10 +541,7 @@ PYBIND11_MODULE(pydsr, m) {
                                           break;
                                       case 5:
                                           if (val.index() == ATT_ENUM::NPYU8) {
-                                              auto tmp = std::get<py::array_t<uint8_t>>(val);
-                                              const auto size = tmp.size();
-                                              py::buffer_info x = tmp.request();
-                                              self.byte_vec(std::vector<uint8_t>{static_cast<uint8_t *>(x.ptr), static_cast<uint8_t *>(x.ptr) + size});
+                                              self.byte_vec(array_to_vector(std::get<py::array_t<uint8_t>>(val)));
                                           }
                                           else self.byte_vec(std::get<std::vector<uint8_t>>(val));
                                           break;
@@ -396,10 +557,7 @@ PYBIND11_MODULE(pydsr, m) {
                                           break;
                                       case 9:
                                           if (val.index() == ATT_ENUM::NPYU64) {
-                                              auto tmp = std::get<py::array_t<uint64_t>>(val);
-                                              const auto size = tmp.size();
-                                              py::buffer_info x = tmp.request();
-                                              self.u64_vec(std::vector<uint64_t>{static_cast<uint64_t *>(x.ptr), static_cast<uint64_t *>(x.ptr) + size});
+                                              self.u64_vec(array_to_vector(std::get<py::array_t<uint64_t>>(val)));
                                           } else if (val.index() == ATT_ENUM::VECU8_PY) {
                                               auto tmp = std::get<std::vector<uint8_t>>(val);
                                               self.u64_vec(std::vector<uint64_t>{tmp.begin(), tmp.end()});
@@ -602,47 +760,114 @@ PYBIND11_MODULE(pydsr, m) {
 
             .def("get_node", [](DSRGraph &self, uint64_t id) -> std::optional<Node> {
                 return self.get_node(id);
-            }, "id"_a, "return the node with the id passed as parameter. Returns None if the node does not exist.")
+            }, "id"_a, py::call_guard<py::gil_scoped_release>(), "return the node with the id passed as parameter. Returns None if the node does not exist.")
             .def("get_node", [](DSRGraph &self, const std::string &name) -> std::optional<Node> {
                 return self.get_node(name);
-            }, "name"_a, "return the node with the name passed as parameter. Returns None if the node does not exist.")
-            .def("delete_node", static_cast<bool (DSRGraph::*)(uint64_t)>(&DSRGraph::delete_node), "id"_a,
+            }, "name"_a, py::call_guard<py::gil_scoped_release>(), "return the node with the name passed as parameter. Returns None if the node does not exist.")
+            .def("get_attrib_array", [](DSRGraph &self, uint64_t id, const std::string &name) -> py::object {
+                std::optional<Node> n;
+                {
+                    py::gil_scoped_release release;
+                    n = self.get_node(id);
+                }
+                if (not n.has_value()) return py::none();
+                // The snapshot of the node owns the storage of the array.
+                auto *node = new Node(std::move(n.value()));
+                py::capsule owner(node, [](void *p) { delete static_cast<Node *>(p); });
+                auto it = node->attrs().find(name);
+                if (it == node->attrs().end()) return py::none();
+                const auto &att = it->second;
+                switch (att.selected())
+                {
+                    case 3: return readonly_array(att.float_vec().data(), att.float_vec().size(), owner);
+                    case 5: return readonly_array(att.byte_vec().data(), att.byte_vec().size(), owner);
+                    case 9: return readonly_array(att.u64_vec().data(), att.u64_vec().size(), owner);
+                    default: throw pybind11::type_error("Attribute " + name + " is not a vector");
+                }
+            }, "id"_a, "name"_a, "return a read only numpy array over a vector attribute of the node without copying it. "
+                                 "The array keeps its own snapshot of the node. Returns None if the node or the attribute do not exist.")
+            .def("delete_node", static_cast<bool (DSRGraph::*)(uint64_t)>(&DSRGraph::delete_node), "id"_a, py::call_guard<py::gil_scoped_release>(),
                  "delete the node with the given id. Returns a bool with the result o the operation.")
             .def("delete_node",
-                 static_cast<bool (DSRGraph::*)(const std::basic_string<char> &)>(&DSRGraph::delete_node), "name"_a,
+                 static_cast<bool (DSRGraph::*)(const std::basic_string<char> &)>(&DSRGraph::delete_node), "name"_a, py::call_guard<py::gil_scoped_release>(),
                  "delete the node with the given name. Returns a bool with the result o the operation.")
             .def("insert_node", [](DSRGraph &g, Node &n) -> std::optional<uint64_t> {
                      return g.insert_node(n);
-                 }, "node"_a,
+                 }, "node"_a, py::call_guard<py::gil_scoped_release>(),
                  "Insert in the graph the new node passed as parameter. Returns the id of the node or None if the Node alredy exist in the map.")
-            .def("update_node", &DSRGraph::update_node<DSR::Node&>, "node"_a, "Update the node in the graph. Returns a bool.")
+            .def("update_node", &DSRGraph::update_node<DSR::Node&>, "node"_a, py::call_guard<py::gil_scoped_release>(), "Update the node in the graph. Returns a bool.")
             .def("get_edge", [](DSRGraph &self, const std::string &from, const std::string &to,
                                 const std::string &key) -> std::optional<Edge> {
                      return self.get_edge(from, to, key);
-                 }, "from"_a, "to"_a, "type"_a,
+                 }, "from"_a, "to"_a, "type"_a, py::call_guard<py::gil_scoped_release>(),
                  "Return the edge with the parameters from, to, and type passed as parameter. If the edge does not exist it return None")
             .def("get_edge",
                  [](DSRGraph &self, uint64_t from, uint64_t to, const std::string &key) -> std::optional<Edge> {
                      return self.get_edge(from, to, key);
-                 }, "from"_a, "to"_a, "type"_a,
+                 }, "from"_a, "to"_a, "type"_a, py::call_guard<py::gil_scoped_release>(),
                  "Return the edge with the parameters from, to, and type passed as parameter.  If the edge does not exist it return None")
-            .def("insert_or_assign_edge", &DSRGraph::insert_or_assign_edge<DSR::Edge&>, "edge"_a,
+            .def("insert_or_assign_edge", &DSRGraph::insert_or_assign_edge<DSR::Edge&>, "edge"_a, py::call_guard<py::gil_scoped_release>(),
                  "Insert or updates and edge. returns a bool")
             .def("delete_edge", static_cast<bool (DSRGraph::*)(uint64_t, uint64_t,
                                                                const std::basic_string<char> &)>(&DSRGraph::delete_edge),
-                 "from"_a, "to"_a, "type"_a, "Removes the edge and returns a bool")
+                 "from"_a, "to"_a, "type"_a, py::call_guard<py::gil_scoped_release>(), "Removes the edge and returns a bool")
             .def("delete_edge",
                  static_cast<bool (DSRGraph::*)(const std::basic_string<char> &, const std::basic_string<char> &,
                                                 const std::basic_string<char> &)>(&DSRGraph::delete_edge), "from"_a,
-                 "to"_a, "type"_a, "Removes the edge and returns a bool")
-
-            .def("get_node_root", &DSRGraph::get_node_root, "Return the root node.")
-            .def("get_nodes_by_type", &DSRGraph::get_nodes_by_type, "type"_a, "Return all the nodes with a given type.")
-            .def("get_name_from_id", &DSRGraph::get_name_from_id, "id"_a, "Return the name of a node given its id")
-            .def("get_id_from_name", &DSRGraph::get_id_from_name, "name"_a, "Return the id from a node given its name")
-            .def("get_edges_by_type", &DSRGraph::get_edges_by_type, "type"_a, "Return all the edges with a given type.")
-            .def("get_edges_to_id", &DSRGraph::get_edges_to_id, "id"_a, "Return all the edges that point to the node")
-            .def("write_to_json_file", &DSRGraph::write_to_json_file, "file"_a, "skip_atts"_a=std::vector<std::string>{}, "Return all the edges that point to the node");
+                 "to"_a, "type"_a, py::call_guard<py::gil_scoped_release>(), "Removes the edge and returns a bool")
+
+            .def("get_node_root", &DSRGraph::get_node_root, py::call_guard<py::gil_scoped_release>(), "Return the root node.")
+            .def("get_nodes_by_type", &DSRGraph::get_nodes_by_type, "type"_a, py::call_guard<py::gil_scoped_release>(), "Return all the nodes with a given type.")
+            .def("get_name_from_id", &DSRGraph::get_name_from_id, "id"_a, py::call_guard<py::gil_scoped_release>(), "Return the name of a node given its id")
+            .def("get_id_from_name", &DSRGraph::get_id_from_name, "name"_a, py::call_guard<py::gil_scoped_release>(), "Return the id from a node given its name")
+            .def("get_edges_by_type", &DSRGraph::get_edges_by_type, "type"_a, py::call_guard<py::gil_scoped_release>(), "Return all the edges with a given type.")
+            .def("get_edges_to_id", &DSRGraph::get_edges_to_id, "id"_a, py::call_guard<py::gil_scoped_release>(), "Return all the edges that point to the node")
+            .def("write_to_json_file", &DSRGraph::write_to_json_file, "file"_a, "skip_atts"_a=std::vector<std::string>{}, py::call_guard<py::gil_scoped_release>(), "Write the graph to a json file")
+            .def("get_nodes", &DSRGraph::get_nodes, "ids"_a, py::call_guard<py::gil_scoped_release>(),
+                 "Return the nodes with the given ids, None for the ones that do not exist. The graph is locked once for all of them.")
+            .def("get_attribs", &DSRGraph::get_attribs, "ids"_a, "names"_a, py::call_guard<py::gil_scoped_release>(),
+                 "Return a list per id with the attributes in names, None where the node or the attribute do not exist.")
+            .def("update_nodes", [](DSRGraph &self, const py::list &nodes) {
+                std::vector<Node *> ptrs;
+                ptrs.reserve(nodes.size());
+                for (auto n : nodes) ptrs.emplace_back(n.cast<Node *>());
+                py::gil_scoped_release release;
+                std::vector<bool> res;
+                res.reserve(ptrs.size());
+                for (auto *n : ptrs) res.emplace_back(self.update_node(*n));
+                return res;
+            }, "nodes"_a, "Update a list of nodes releasing the GIL once. Returns a list of bools.")
+            .def("wait_for_node", [](DSRGraph &self, const std::string &type) {
+                return async_wait<Node>([&](auto cb) { self.get_wait_api().on_node(type, std::move(cb)); });
+            }, "type"_a, "Awaitable for the running asyncio loop that completes with a node of the given type as soon as "
+                         "one exists, or None if the graph is destroyed first. Use asyncio.wait_for for a timeout.")
+            .def("wait_for_edge", [](DSRGraph &self, uint64_t from, uint64_t to, const std::string &type) {
+                return async_wait<Edge>([&](auto cb) { self.get_wait_api().on_edge(from, to, type, std::move(cb)); });
+            }, "from"_a, "to"_a, "type"_a, "Awaitable that completes with the edge as soon as it exists.")
+            .def("wait_for_attr", [](DSRGraph &self, uint64_t id, const std::string &name, const py::function &pred) {
+                auto p = std::make_shared<GilObject>(pred);
+                auto check = [&self, id, name, p]() -> std::optional<Attribute> {
+                    auto n = self.get_node(id);
+                    if (not n.has_value()) return {};
+                    auto it = n->attrs().find(name);
+                    if (it == n->attrs().end()) return {};
+                    py::gil_scoped_acquire gil;
+                    try
+                    {
+                        if (p->obj(py::cast(it->second).attr("value")).cast<bool>()) return it->second;
+                    }
+                    catch (py::error_already_set &e) { e.discard_as_unraisable(p->obj); }
+                    return {};
+                };
+                auto on_event = [check, name](const DSR::WaitAPI::Event &ev) -> std::optional<Attribute> {
+                    if (ev.attrs != nullptr and std::find(ev.attrs->begin(), ev.attrs->end(), name) == ev.attrs->end()) return {};
+                    return check();
+                };
+                return async_wait<Attribute>([&](auto cb) {
+                    self.get_wait_api().on<Attribute>(DSR::WaitAPI::Kind::NODE_ID, DSR::WaitAPI::node_key(id), check, on_event, std::move(cb));
+                });
+            }, "id"_a, "name"_a, "pred"_a, "Awaitable that completes with the attribute when pred(value) is true. pred runs "
+                                           "on the thread that applied the change, keep it short.");
     //DSR RT_API class
     py::class_<RT_API>(m, "rt_api")
             .def(py::init([](DSRGraph &g) -> std::unique_ptr<RT_API> {
@@ -653,7 +878,7 @@ PYBIND11_MODULE(pydsr, m) {
                                                 const std::vector<float> &rotation_euler
             ) {
                 self.insert_or_assign_edge_RT(n, to, translation, rotation_euler);
-            }, "node"_a, "to"_a, "trans"_a, "rot_euler"_a)
+            }, "node"_a, "to"_a, "trans"_a, "rot_euler"_a, py::call_guard<py::gil_scoped_release>())
             .def_static("get_edge_RT", &RT_API::get_edge_RT, "node"_a, "to"_a)
             .def("get_RT_pose_from_parent", [](RT_API &self, Node &e) -> std::optional<Eigen::Matrix<double, 4, 4>> {
                 auto tmp = self.get_RT_pose_from_parent(e);
@@ -666,7 +891,7 @@ PYBIND11_MODULE(pydsr, m) {
                 } else {
                     return std::nullopt;
                 }
-            }, "node"_a)
+            }, "node"_a, py::call_guard<py::gil_scoped_release>())
             .def("get_edge_RT_as_rtmat", [](RT_API &self, Edge &e, std::uint64_t t) -> std::optional<Eigen::Matrix<double, 4, 4>> {
                 auto tmp = self.get_edge_RT_as_rtmat(e, t);
                 if (tmp.has_value()) {
@@ -678,11 +903,11 @@ PYBIND11_MODULE(pydsr, m) {
                 } else {
                     return std::nullopt;
                 }
-            }, "edge"_a, "timestamp"_a=0)
+            }, "edge"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
             .def("get_translation", static_cast<std::optional<Eigen::Vector3d> (RT_API::*)(std::uint64_t,
                                                                                            std::uint64_t,
                                                                                            std::uint64_t timestamp)>(&RT_API::get_translation),
-                 "node_id"_a, "to"_a, "timestamp"_a=0);
+                 "node_id"_a, "to"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>());
 
     py::class_<InnerEigenAPI>(m, "inner_api")
             .def(py::init([](DSRGraph &g) -> std::unique_ptr<InnerEigenAPI> {
@@ -691,22 +916,22 @@ PYBIND11_MODULE(pydsr, m) {
             .def("transform", static_cast<std::optional<Eigen::Vector3d> (InnerEigenAPI::*)(const std::string &,
                                                                                             const std::string &,
                                                                                             std::uint64_t timestamp)>(&InnerEigenAPI::transform),
-                 "orig"_a, "dest"_a, "timestamp"_a=0)
+                 "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
             .def("transform", static_cast<std::optional<Eigen::Vector3d> (InnerEigenAPI::*)(const std::string &,
                                                                                             const Mat::Vector3d &,
                                                                                             const std::string &,
                                                                                             std::uint64_t timestamp)>(&InnerEigenAPI::transform),
-                 "orig"_a, "vector"_a, "dest"_a, "timestamp"_a=0)
+                 "orig"_a, "vector"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
 
             .def("transform_axis", static_cast<std::optional<Mat::Vector6d> (InnerEigenAPI::*)(const std::string &,
                                                                                                const std::string &,
                                                                                                std::uint64_t timestamp)>(&InnerEigenAPI::transform_axis),
-                 "orig"_a, "dest"_a, "timestamp"_a=0)
+                 "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
             .def("transform_axis",
                  static_cast<std::optional<Mat::Vector6d> (InnerEigenAPI::*)(const std::string &, const Mat::Vector6d &,
                                                                              const std::string &,
                                                                              std::uint64_t timestamp)>(&InnerEigenAPI::transform_axis),
-                 "orig"_a, "vector"_a, "dest"_a, "timestamp"_a=0)
+                 "orig"_a, "vector"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
 
 
             .def("get_transformation_matrix",
@@ -722,11 +947,98 @@ PYBIND11_MODULE(pydsr, m) {
                      } else {
                          return std::nullopt;
                      }
-                 }, "orig"_a, "dest"_a, "timestamp"_a=0)
-            .def("get_rotation_matrix", &InnerEigenAPI::get_rotation_matrix, "orig"_a, "dest"_a, "timestamp"_a=0)
-            .def("get_translation_vector", &InnerEigenAPI::get_translation_vector, "orig"_a, "dest"_a, "timestamp"_a=0)
-            .def("get_euler_xyz_angles", &InnerEigenAPI::get_euler_xyz_angles, "orig"_a, "dest"_a, "timestamp"_a=0);
-
+                 }, "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
+            .def("get_rotation_matrix", &InnerEigenAPI::get_rotation_matrix, "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
+            .def("get_translation_vector", &InnerEigenAPI::get_translation_vector, "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
+            .def("get_euler_xyz_angles", &InnerEigenAPI::get_euler_xyz_angles, "orig"_a, "dest"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
+            .def("transform", static_cast<std::optional<Mat::Matrix3Xd> (InnerEigenAPI::*)(const std::string &,
+                                                                                           const Mat::Matrix3Xd &,
+                                                                                           const std::string &,
+                                                                                           std::uint64_t timestamp)>(&InnerEigenAPI::transform),
+                 "dest"_a, "points"_a, "orig"_a, "timestamp"_a=0, py::call_guard<py::gil_scoped_release>())
+            .def("get_poses", &InnerEigenAPI::get_poses, "dest"_a, "nodes"_a, "timestamp"_a=0,
+                 py::call_guard<py::gil_scoped_release>())
+            .def("get_world_poses", &InnerEigenAPI::get_world_poses, "type"_a, "timestamp"_a=0,
+                 py::call_guard<py::gil_scoped_release>());
+
+    py::enum_<PixelFormat>(m, "PixelFormat")
+            .value("GRAY8", PixelFormat::GRAY8)
+            .value("RGB8", PixelFormat::RGB8)
+            .value("DEPTH32F", PixelFormat::DEPTH32F);
+
+    // The view owns a copy of the image taken under one read lock, Python objects are released by the GC at any
+    // time and from any thread so they never hold the lock of G. numpy.asarray(view) shares that copy.
+    py::class_<ImageView>(m, "image_view", py::buffer_protocol())
+            .def_static("rgb", [](DSRGraph *G, uint64_t id) -> std::optional<ImageView> {
+                            auto view = ImageView::rgb(G, id);
+                            if (not view.has_value()) return {};
+                            return view->copy();
+                        }, "graph"_a, "id"_a, py::call_guard<py::gil_scoped_release>(),
+                        "Copy of cam_rgb in the node id. None if the image or its size attributes are missing")
+            .def_static("depth", [](DSRGraph *G, uint64_t id) -> std::optional<ImageView> {
+                            auto view = ImageView::depth(G, id);
+                            if (not view.has_value()) return {};
+                            return view->copy();
+                        }, "graph"_a, "id"_a, py::call_guard<py::gil_scoped_release>(),
+                        "Copy of cam_depth in the node id. None if the image or its size attributes are missing")
+            .def_property_readonly("width", &ImageView::width)
+            .def_property_readonly("height", &ImageView::height)
+            .def_property_readonly("stride", &ImageView::stride)
+            .def_property_readonly("format", &ImageView::format)
+            .def_property_readonly("timestamp", &ImageView::timestamp)
+            .def_buffer([](ImageView &self) -> py::buffer_info {
+                auto *ptr = const_cast<uint8_t *>(self.bytes().data());
+                const auto h = static_cast<py::ssize_t>(self.height());
+                const auto w = static_cast<py::ssize_t>(self.width());
+                const auto stride = static_cast<py::ssize_t>(self.stride());
+                switch (self.format())
+                {
+                    case PixelFormat::DEPTH32F:
+                        return py::buffer_info(ptr, sizeof(float), py::format_descriptor<float>::format(), 2,
+                                               {h, w}, {stride, static_cast<py::ssize_t>(sizeof(float))}, true);
+                    case PixelFormat::RGB8:
+                        return py::buffer_info(ptr, 1, py::format_descriptor<uint8_t>::format(), 3,
+                                               {h, w, py::ssize_t{3}}, {stride, py::ssize_t{3}, py::ssize_t{1}}, true);
+                    default:
+                        return py::buffer_info(ptr, 1, py::format_descriptor<uint8_t>::format(), 2,
+                                               {h, w}, {stride, py::ssize_t{1}}, true);
+                }
+            });
+
+    // query.name("world").out("RT", 8).of_type("plant").ids(g). Each call runs the query under one read lock of G and
+    // returns the results as a list, Python never holds the lock of a QueryResult. The predicates of where() run
+    // under that lock, they must not call the graph. Queries with predicates keep the GIL for the whole run,
+    // otherwise every call would wait for the GIL while G is locked and stall its writers.
+    auto run_query = [](const Query &q, auto &&f) {
+        if (q.has_predicates()) return f();
+        py::gil_scoped_release release;
+        return f();
+    };
+    py::class_<Query>(m, "query")
+            .def_static("node", &Query::node, "id"_a)
+            .def_static("name", &Query::name, "name"_a)
+            .def_static("type", &Query::type, "type"_a)
+            .def_static("all", &Query::all)
+            .def("out", &Query::out, "edge_type"_a = "", "max_depth"_a = 1, "min_depth"_a = 1,
+                 py::return_value_policy::reference_internal)
+            .def("in_", &Query::in, "edge_type"_a = "", "max_depth"_a = 1, "min_depth"_a = 1,
+                 py::return_value_policy::reference_internal)
+            .def("of_type", &Query::of_type, "type"_a, py::return_value_policy::reference_internal)
+            .def("has", &Query::has, "att_name"_a, py::return_value_policy::reference_internal)
+            .def("where", static_cast<Query &(Query::*)(const std::string &, std::function<bool(const Attribute &)>)>(&Query::where),
+                 "att_name"_a, "pred"_a, py::return_value_policy::reference_internal)
+            .def("ids", [run_query](const Query &self, DSRGraph *G, std::size_t limit) {
+                     return run_query(self, [&] { return self.run(G).ids(limit); });
+                 }, "graph"_a, "limit"_a = std::numeric_limits<std::size_t>::max())
+            .def("nodes", [run_query](const Query &self, DSRGraph *G, std::size_t limit) {
+                     return run_query(self, [&] { return self.run(G).nodes(limit); });
+                 }, "graph"_a, "limit"_a = std::numeric_limits<std::size_t>::max())
+            .def("first", [run_query](const Query &self, DSRGraph *G) {
+                     return run_query(self, [&] { return self.run(G).first(); });
+                 }, "graph"_a)
+            .def("count", [run_query](const Query &self, DSRGraph *G) {
+                     return run_query(self, [&] { return self.run(G).count(); });
+                 }, "graph"_a);
 
     bind_ghistory(m);
     /*
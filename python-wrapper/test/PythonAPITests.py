@@ -1,7 +1,7 @@
 import unittest
 import subprocess
 
-import sys, time, os
+import sys, time, os, threading
 from pydsr import *
 
 
@@ -272,6 +272,43 @@ class TestDSRGraph(unittest.TestCase):
         self.assertEqual(len(edges), 0)
 
 
+    def test_get_attrib_array(self):
+        import numpy as np
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        world = g.get_node("root")
+        world.attrs["points"] = Attribute(np.arange(10, dtype=np.float32)[::2], 12)
+        self.assertTrue(g.update_node(world))
+        array = g.get_attrib_array(world.id, "points")
+        self.assertEqual(list(array), [0, 2, 4, 6, 8])
+        self.assertFalse(array.flags.writeable)
+        self.assertIsNone(g.get_attrib_array(world.id, "missing"))
+        with self.assertRaises(TypeError):
+            g.get_attrib_array(world.id, "color")
+
+    def test_get_nodes(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        root = g.get_node("root")
+        nodes = g.get_nodes([root.id, 123456789])
+        self.assertEqual(len(nodes), 2)
+        self.assertEqual(nodes[0].name, "root")
+        self.assertIsNone(nodes[1])
+
+    def test_get_attribs(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        root = g.get_node("root")
+        attribs = g.get_attribs([root.id, 123456789], ["color", "missing"])
+        self.assertEqual(attribs[0][0].value, root.attrs["color"].value)
+        self.assertIsNone(attribs[0][1])
+        self.assertEqual(attribs[1], [None, None])
+
+    def test_update_nodes(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        nodes = g.get_nodes_by_type("plane")
+        for n in nodes:
+            n.attrs["color"].value = "red"
+        self.assertEqual(g.update_nodes(nodes), [True] * len(nodes))
+        self.assertTrue(all(a[0].value == "red" for a in g.get_attribs([n.id for n in nodes], ["color"])))
+
     def test_insert_node(self):
 
         g = DSRGraph(int(0), "Prueba", 12, os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json") )
@@ -391,6 +428,204 @@ class TestInnerAPI(unittest.TestCase):
         angles = inner.get_euler_xyz_angles("root", "laser", 0)
         self.assertIsNotNone(angles)
 
+    def test_transform_points(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        inner = inner_api(g)
+        points = inner.transform("root", [[1.1, 0.0], [3.3, 0.0], [6.6, 0.0]], "laser", 0)
+        self.assertEqual(points.shape, (3, 2))
+        origin = inner.transform("root", "laser", 0)
+        self.assertAlmostEqual(points[0][1], origin[0], places=4)
+
+    def test_get_poses(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        inner = inner_api(g)
+        poses = inner.get_poses("root", [g.get_id_from_name("laser"), g.get_id_from_name("root")], 0)
+        self.assertEqual(poses.shape, (6, 2))
+
+    def test_get_world_poses(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        inner = inner_api(g)
+        ids, poses = inner.get_world_poses("plane", 0)
+        self.assertEqual(poses.shape, (6, len(ids)))
+        self.assertTrue(len(ids) > 0)
+
+
+class TestImageView(unittest.TestCase):
+
+    def test_rgb_view(self):
+        import numpy as np
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        camera = g.get_node("viriato_head_camera_sensor")
+        self.assertIsNone(image_view.rgb(g, camera.id))    # empty image
+        image = np.zeros((480, 640, 3), dtype=np.uint8)
+        image[1, 2] = [10, 20, 30]
+        camera.attrs["cam_rgb"] = Attribute(image.flatten(), 12)
+        self.assertTrue(g.update_node(camera))
+
+        view = image_view.rgb(g, camera.id)
+        self.assertIsNotNone(view)
+        self.assertEqual((view.width, view.height, view.stride), (640, 480, 640 * 3))
+        self.assertEqual(view.format, PixelFormat.RGB8)
+        array = np.asarray(view)
+        self.assertEqual(array.shape, (480, 640, 3))
+        self.assertFalse(array.flags.writeable)
+        self.assertEqual(list(array[1, 2]), [10, 20, 30])
+        # the view is a copy, G can be written while it is alive
+        camera.attrs["cam_rgb"] = Attribute(np.zeros((480, 640, 3), dtype=np.uint8).flatten(), 12)
+        self.assertTrue(g.update_node(camera))
+        self.assertEqual(list(array[1, 2]), [10, 20, 30])
+        del array, view
+
+    def test_depth_view(self):
+        import numpy as np
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        camera = g.get_node("viriato_head_camera_sensor")
+        depth = np.full((480, 640), 2.5, dtype=np.float32)
+        camera.attrs["cam_depth"] = Attribute(depth.view(np.uint8).flatten(), 12)
+        self.assertTrue(g.update_node(camera))
+
+        view = image_view.depth(g, camera.id)
+        array = np.asarray(view)
+        self.assertEqual(array.dtype, np.float32)
+        self.assertEqual(array.shape, (480, 640))
+        self.assertAlmostEqual(float(array[100, 100]), 2.5)
+        del array, view
+
+
+class TestQuery(unittest.TestCase):
+
+    def test_rt_descendants(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        planes = sorted(n.id for n in g.get_nodes_by_type("plane"))
+        self.assertTrue(len(planes) > 0)
+        self.assertEqual(sorted(query.name("root").out("RT", 20).of_type("plane").ids(g)), planes)
+        self.assertEqual(sorted(query.type("plane").ids(g)), planes)
+        self.assertEqual(len(query.type("plane").ids(g, 2)), 2)
+
+    def test_filters(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        root = g.get_node("root")
+        self.assertEqual(query.all().where("level", lambda a: a.value == 0).ids(g), [root.id])
+        self.assertEqual(query.node(root.id).in_("RT").count(g), 0)
+        self.assertIsNone(query.name("not_a_node").first(g))
+        # the results are copies, G is not locked after the call
+        nodes = query.all().nodes(g, 2)
+        self.assertEqual(len(nodes), 2)
+        self.assertTrue(g.update_node(root))
+
+    def test_predicates_keep_the_gil(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        # A busy thread would take the GIL on every call of the predicate if the query released it.
+        interval = sys.getswitchinterval()
+        sys.setswitchinterval(0.02)
+        stop = threading.Event()
+        busy = threading.Thread(target=lambda: [None for _ in iter(stop.is_set, True)])
+        busy.start()
+        try:
+            start = time.monotonic()
+            calls = len(query.all().where("level", lambda a: True).ids(g))
+            elapsed = time.monotonic() - start
+        finally:
+            stop.set()
+            busy.join()
+            sys.setswitchinterval(interval)
+        self.assertTrue(calls > 10)
+        self.assertLess(elapsed, calls * 0.02 / 2)
+
+
+class TestSignalQueue(unittest.TestCase):
+
+    def test_queued_updates_are_coalesced(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        q = signals.queue(g, 16, True, [signals.UPDATE_NODE, signals.DELETE_NODE])
+        world = g.get_node("root")
+        for color in ["red", "green", "blue"]:
+            world.attrs["color"].value = color
+            self.assertTrue(g.update_node(world))
+        self.assertTrue(q.wait(1000))
+        events = q.drain()
+        self.assertEqual(events, [(signals.UPDATE_NODE, world.id, "root")])
+        self.assertEqual(q.coalesced, 2)
+        self.assertEqual(q.dropped, 0)
+        self.assertFalse(q.wait(0))
+        q.close()
+
+    def test_full_queue_drops(self):
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        q = signals.queue(g, 2, False, [signals.UPDATE_NODE])
+        world = g.get_node("root")
+        for i in range(4):
+            world.attrs["color"].value = "color" + str(i)
+            self.assertTrue(g.update_node(world))
+        self.assertEqual(len(q.drain()), 2)
+        self.assertEqual(q.dropped, 2)
+
+    def test_asyncio(self):
+        import asyncio
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        q = signals.queue(g)
+
+        async def first_event():
+            loop = asyncio.get_running_loop()
+            ready = asyncio.Event()
+            loop.add_reader(q.fileno(), ready.set)
+            world = g.get_node("root")
+            world.attrs["color"].value = "red"
+            g.update_node(world)
+            await asyncio.wait_for(ready.wait(), 1)
+            loop.remove_reader(q.fileno())
+            return q.drain()
+
+        events = asyncio.run(first_event())
+        self.assertTrue(len(events) > 0)
+
+
+class TestWaitFor(unittest.TestCase):
+
+    def test_wait_for_attr(self):
+        import asyncio
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        world = g.get_node("root")
+
+        async def wait_blue():
+            waiting = g.wait_for_attr(world.id, "color", lambda v: v == "blue")
+            for color in ["red", "green", "blue"]:
+                self.assertFalse(waiting.done())
+                world.attrs["color"].value = color
+                g.update_node(world)
+            return await asyncio.wait_for(waiting, 1)
+
+        att = asyncio.run(wait_blue())
+        self.assertEqual(att.value, "blue")
+
+    def test_wait_for_node_and_edge(self):
+        import asyncio
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+        root = g.get_node("root")
+
+        async def wait_insert():
+            waiting = g.wait_for_node("testtype")
+            node = Node(12, "testtype", "waited")
+            node_id = g.insert_node(node)
+            n = await asyncio.wait_for(waiting, 1)
+            self.assertEqual(n.id, node_id)
+            waiting = g.wait_for_edge(root.id, node_id, "in")
+            g.insert_or_assign_edge(Edge(node_id, root.id, "in", 12))
+            return await asyncio.wait_for(waiting, 1)
+
+        edge = asyncio.run(wait_insert())
+        self.assertEqual(edge.type, "in")
+
+    def test_timeout(self):
+        import asyncio
+        g = DSRGraph(int(0), "Prueba", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+
+        async def wait_missing():
+            await asyncio.wait_for(g.wait_for_node("never_inserted"), 0.05)
+
+        with self.assertRaises(asyncio.TimeoutError):
+            asyncio.run(wait_missing())
+
 
 class Singleton(type):
     _instances = {}
@@ -0,0 +1,67 @@
+# Benchmarks of vector attributes between numpy and pydsr.
+# Run with: pytest test_attribute_arrays_bench.py (needs pytest-benchmark)
+import os
+
+import numpy as np
+import pytest
+from pydsr import *
+
+pytest.importorskip("pytest_benchmark")
+
+ETC_DIR = "../etc/"
+BYTES = 1 << 20
+FLOATS = 300_000
+
+
+@pytest.fixture(scope="module")
+def graph():
+    g = DSRGraph(int(0), "Bench", int(12), os.path.join(ETC_DIR, "autonomyLab_objects.simscene.json"), True)
+    node = g.get_node("root")
+    node.attrs["cam_image"] = Attribute(np.random.randint(0, 255, BYTES, dtype=np.uint8), 12)
+    node.attrs["points"] = Attribute(np.random.rand(FLOATS).astype(np.float32), 12)
+    assert g.update_node(node)
+    return g, node.id
+
+
+def test_get_attrib_array_is_a_readonly_view(graph):
+    g, id = graph
+    array = g.get_attrib_array(id, "points")
+    assert array.dtype == np.float32
+    assert array.shape == (FLOATS,)
+    assert not array.flags.writeable
+    assert not array.flags.owndata
+    assert g.get_attrib_array(id, "missing") is None
+
+
+def test_bench_get_attrib_array_bytes(benchmark, graph):
+    g, id = graph
+    array = benchmark(g.get_attrib_array, id, "cam_image")
+    assert array.size == BYTES
+
+
+def test_bench_get_attrib_array_floats(benchmark, graph):
+    g, id = graph
+    array = benchmark(g.get_attrib_array, id, "points")
+    assert array.size == FLOATS
+
+
+def test_bench_get_node_value_floats(benchmark, graph):
+    g, id = graph
+    array = benchmark(lambda: g.get_node(id).attrs["points"].value)
+    assert array.size == FLOATS
+
+
+def test_bench_set_value_from_numpy_bytes(benchmark, graph):
+    g, id = graph
+    node = g.get_node(id)
+    data = np.random.randint(0, 255, BYTES, dtype=np.uint8)
+    benchmark(setattr, node.attrs["cam_image"], "value", data)
+    assert node.attrs["cam_image"].value[10] == data[10]
+
+
+def test_bench_set_value_from_strided_numpy_floats(benchmark, graph):
+    g, id = graph
+    node = g.get_node(id)
+    data = np.random.rand(2 * FLOATS).astype(np.float32)[::2]
+    benchmark(setattr, node.attrs["points"], "value", data)
+    assert node.attrs["points"].value[10] == data[10]
@@ -0,0 +1,71 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_person(DSRGraph &G, float distance, uint64_t parent)
+{
+    auto n = Node::create<person_node_type>(random_string());
+    G.add_or_modify_attrib_local<distance_to_robot_att>(n, distance);
+    G.add_or_modify_attrib_local<parent_att>(n, parent);
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    return id.value();
+}
+
+
+TEST_CASE("Secondary attribute indices performance", "[BENCHMARK][INDEX]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    constexpr int N = 50000;
+    std::vector<uint64_t> parents;
+    for (int i = 0; i < N; i++)
+    {
+        const uint64_t parent = parents.empty() or i % 10 == 0 ? root->id() : parents[rand() % parents.size()];
+        parents.emplace_back(insert_person(G, static_cast<float>(rand() % 10000), parent));
+    }
+    const uint64_t some_parent = parents[N / 2];
+
+    BENCHMARK("get_nodes_by_type + scan, distance < 2000") {
+        std::vector<uint64_t> ids;
+        for (const auto &n : G.get_nodes_by_type("person"))
+            if (auto d = G.get_attrib_by_name<distance_to_robot_att>(n); d.has_value() and d.value() < 2000.f)
+                ids.emplace_back(n.id());
+        return ids;
+    };
+    BENCHMARK("query_nodes without index, distance < 2000") {
+        return G.query_nodes(distance_to_robot_str, AttrPredicate::lt(2000.f), "person");
+    };
+    BENCHMARK("query_nodes without index, parent == X") {
+        return G.query_nodes(parent_str, AttrPredicate::eq(some_parent));
+    };
+
+    BENCHMARK("create ordered index") {
+        G.drop_attr_index(distance_to_robot_str);
+        return G.create_attr_index(distance_to_robot_str, IndexKind::ORDERED);
+    };
+    REQUIRE(G.create_attr_index(parent_str, IndexKind::HASH));
+
+    BENCHMARK("ordered index, distance < 2000") {
+        return G.query_nodes(distance_to_robot_str, AttrPredicate::lt(2000.f), "person");
+    };
+    BENCHMARK("hash index, parent == X") {
+        return G.query_nodes(parent_str, AttrPredicate::eq(some_parent));
+    };
+
+    auto n = G.get_node(parents[N / 3]);
+    REQUIRE(n.has_value());
+    float d = 0.f;
+    BENCHMARK("update_node with two indices") {
+        G.add_or_modify_attrib_local<distance_to_robot_att>(n.value(), d += 1.f);
+        return G.update_node(n.value());
+    };
+}
@@ -0,0 +1,20 @@
+# Runs every benchmark of dsr_bench and stores the results in OUTPUT_DIR/dsr_bench-<commit>.json.
+# Run by the dsr_bench_json target, so the commit is the one checked out when the target is built:
+#   cmake -DDSR_BENCH=<dsr_bench> -DSOURCE_DIR=<repo> -DOUTPUT_DIR=<dir> -P bench_json.cmake
+
+execute_process(COMMAND git rev-parse --short HEAD
+                WORKING_DIRECTORY ${SOURCE_DIR}
+                OUTPUT_VARIABLE DSR_BENCH_COMMIT
+                OUTPUT_STRIP_TRAILING_WHITESPACE
+                ERROR_QUIET)
+if(NOT DSR_BENCH_COMMIT)
+    set(DSR_BENCH_COMMIT local)
+endif()
+
+execute_process(COMMAND ${DSR_BENCH} "[BENCHMARK]" --rng-seed 1
+                        --reporter JSON::out=${OUTPUT_DIR}/dsr_bench-${DSR_BENCH_COMMIT}.json
+                        --reporter console
+                RESULT_VARIABLE DSR_BENCH_RESULT)
+if(NOT DSR_BENCH_RESULT EQUAL 0)
+    message(FATAL_ERROR "dsr_bench failed: ${DSR_BENCH_RESULT}")
+endif()
@@ -0,0 +1,102 @@
+#include "dsr/core/crdt/delta_crdt.h"
+#include "dsr/core/types/translator.h"
+#include "dsr/core/topics/IDLGraphPubSubTypes.hpp"
+#include "../utils.h"
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+// Node with the attributes of a typical object: a few scalars, a pose and a small vector.
+static Node make_node(uint32_t agent)
+{
+    auto n = Node::create<testtype_node_type>("bench_node");
+    n.id(1000);
+    n.agent_id(agent);
+    n.attrs()[std::string(level_str)] = Attribute(int32_t{2}, 0, agent);
+    n.attrs()[std::string(parent_str)] = Attribute(uint64_t{100}, 0, agent);
+    n.attrs()[std::string(pos_x_str)] = Attribute(10.f, 0, agent);
+    n.attrs()[std::string(pos_y_str)] = Attribute(20.f, 0, agent);
+    n.attrs()[std::string(color_str)] = Attribute(std::string("red"), 0, agent);
+    n.attrs()[std::string(rt_translation_str)] = Attribute(std::vector<float>{1.f, 2.f, 3.f}, 0, agent);
+    n.attrs()[std::string(cam_rgb_str)] = Attribute(std::vector<uint8_t>(64 * 48 * 3, 127), 0, agent);
+    return n;
+}
+
+
+TEST_CASE("CRDT and translation micro benchmarks", "[BENCHMARK][CRDT]") {
+
+    constexpr uint32_t agent = 7;
+    const auto crdt_node = user_node_to_crdt(make_node(agent));
+    const Attribute att(3.f, 0, agent);
+
+    BENCHMARK_ADVANCED("mvreg<Attribute>::write")(Catch::Benchmark::Chronometer meter) {
+        std::vector<mvreg<CRDTAttribute>> regs(meter.runs());
+        for (auto &r : regs) { r.id = agent; r.write(att); }
+        meter.measure([&](int i) { return regs[i].write(att); });
+    };
+
+    BENCHMARK_ADVANCED("mvreg<Attribute>::join")(Catch::Benchmark::Chronometer meter) {
+        mvreg<CRDTAttribute> src;
+        src.id = agent + 1;
+        auto delta = src.write(att);
+        std::vector<mvreg<CRDTAttribute>> regs(meter.runs());
+        std::vector<mvreg<CRDTAttribute>> deltas(meter.runs(), delta);
+        for (auto &r : regs) { r.id = agent; r.write(Attribute(1.f, 0, agent)); }
+        meter.measure([&](int i) { regs[i].join(std::move(deltas[i])); return regs[i].dk.ds.size(); });
+    };
+
+    BENCHMARK_ADVANCED("mvreg<CRDTNode>::write")(Catch::Benchmark::Chronometer meter) {
+        std::vector<mvreg<CRDTNode>> regs(meter.runs());
+        for (auto &r : regs) { r.id = agent; r.write(crdt_node); }
+        meter.measure([&](int i) { return regs[i].write(crdt_node); });
+    };
+
+    BENCHMARK_ADVANCED("dot_context::compact with 64 pending dots")(Catch::Benchmark::Chronometer meter) {
+        // Dots received out of order that can be folded into the compact context.
+        dot_context proto;
+        proto.cc = {{agent, 0}, {agent + 1, 10}};
+        for (int i = 64; i >= 1; i--) proto.dc.emplace(agent, i);
+        std::vector<dot_context> ctxs(meter.runs(), proto);
+        meter.measure([&](int i) { ctxs[i].compact(); return ctxs[i].cc.size(); });
+    };
+
+    mvreg<CRDTNode> reg;
+    reg.id = agent;
+    auto delta = reg.write(crdt_node);
+
+    BENCHMARK("CRDTNode_to_IDL") {
+        return CRDTNode_to_IDL(agent, crdt_node.id(), delta);
+    };
+
+    BENCHMARK_ADVANCED("IDLNode_to_CRDT")(Catch::Benchmark::Chronometer meter) {
+        std::vector<IDL::MvregNode> idls(meter.runs(), CRDTNode_to_IDL(agent, crdt_node.id(), delta));
+        meter.measure([&](int i) { return IDLNode_to_CRDT(std::move(idls[i])); });
+    };
+
+    BENCHMARK("user_node_to_crdt") {
+        return user_node_to_crdt(make_node(agent));
+    };
+
+    // CDR encoding of the delta as it is written by DSRPublisher.
+    MvregNodePubSubType type;
+    auto idl = CRDTNode_to_IDL(agent, crdt_node.id(), delta);
+    const auto size = type.calculate_serialized_size(&idl, eprosima::fastdds::dds::DEFAULT_DATA_REPRESENTATION);
+    eprosima::fastdds::rtps::SerializedPayload_t payload(size);
+
+    BENCHMARK("CDR encode MvregNode (" + std::to_string(size) + " bytes)") {
+        payload.length = 0;
+        return type.serialize(&idl, payload, eprosima::fastdds::dds::DEFAULT_DATA_REPRESENTATION);
+    };
+
+    REQUIRE(type.serialize(&idl, payload, eprosima::fastdds::dds::DEFAULT_DATA_REPRESENTATION));
+    BENCHMARK("CDR decode MvregNode") {
+        IDL::MvregNode out;
+        payload.pos = 0;
+        type.deserialize(payload, &out);
+        return out.id();
+    };
+}
@@ -0,0 +1,105 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/core/rtps/loopback_transport.h"
+#include "../utils.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+using namespace std::chrono_literals;
+
+
+// Latency and throughput of the updates of the first agent until every other agent has applied them.
+static void benchmark_propagation(std::vector<std::unique_ptr<DSRGraph>> &graphs, const std::string &label)
+{
+    const auto agents = graphs.size();
+    auto &G = *graphs.front();
+
+    auto id = G.insert_node(Node::create<testtype_node_type>(random_string()));
+    REQUIRE(id.has_value());
+
+    // Last level seen by each agent.
+    std::vector<std::atomic<int>> seen(agents);
+    std::vector<QMetaObject::Connection> connections;
+    for (std::size_t a = 1; a < agents; a++)
+    {
+        auto *g = graphs[a].get();
+        connections.emplace_back(QObject::connect(g, &DSRGraph::update_node_attr_signal, g,
+                         [g, &seen, a, node = id.value()](uint64_t n, const std::vector<std::string> &) {
+                             if (n != node) return;
+                             if (auto level = g->get_attrib_by_name<level_att>(n); level.has_value())
+                                 seen[a].store(level.value(), std::memory_order_release);
+                         }, Qt::DirectConnection));
+    }
+
+    // Spins until every agent has seen the level, a lost delta fails the benchmark instead of hanging it.
+    auto wait_all = [&](int level) {
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        for (std::size_t a = 1; a < agents; a++)
+            while (seen[a].load(std::memory_order_acquire) < level)
+            {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                std::this_thread::yield();
+            }
+        return true;
+    };
+
+    int level = 0;
+    auto node = G.get_node(id.value());
+    REQUIRE(node.has_value());
+    auto publish = [&]() {
+        G.add_or_modify_attrib_local<level_att>(node.value(), ++level);
+        G.update_node(node.value());
+    };
+    publish();
+    REQUIRE(wait_all(level));
+
+    const auto receivers = std::to_string(agents - 1) + " agents, " + label;
+    BENCHMARK("Latency of one update to " + receivers) {
+        publish();
+        REQUIRE(wait_all(level));
+    };
+
+    BENCHMARK("Throughput, 1000 updates to " + receivers) {
+        for (int k = 0; k < 1000; k++) publish();
+        REQUIRE(wait_all(level));
+    };
+
+    for (auto &c : connections) QObject::disconnect(c);
+}
+
+
+TEST_CASE("Delta propagation between agents", "[BENCHMARK][SYNCHRONIZATION]") {
+
+    for (int agents : {2, 4})
+    {
+        // All the agents run in this process and talk through Fast DDS.
+        auto filename = make_empty_config_file();
+        const auto first_id = rand() % 1000 * 10;
+        std::vector<std::unique_ptr<DSRGraph>> graphs;
+        graphs.emplace_back(std::make_unique<DSRGraph>(random_string(10), first_id, filename));
+        for (int a = 1; a < agents; a++)
+            graphs.emplace_back(std::make_unique<DSRGraph>(random_string(10), first_id + a));
+        std::this_thread::sleep_for(200ms);
+        benchmark_propagation(graphs, "DDS");
+    }
+}
+
+TEST_CASE("Delta propagation between agents over the loopback transport", "[BENCHMARK][SYNCHRONIZATION][LOOPBACK]") {
+
+    for (int agents : {2, 4, 16})
+    {
+        // The CRDT and apply path without the network.
+        auto domain = LoopbackDomain::create();
+        std::vector<std::unique_ptr<DSRGraph>> graphs;
+        graphs.emplace_back(std::make_unique<DSRGraph>(random_string(10), 1, make_empty_config_file(), domain->connect()));
+        for (int a = 1; a < agents; a++)
+            graphs.emplace_back(std::make_unique<DSRGraph>(random_string(10), a + 1, "", domain->connect()));
+        benchmark_propagation(graphs, "loopback");
+    }
+}
@@ -0,0 +1,46 @@
+#include "dsr/api/dsr_depth_utils.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR::depth;
+
+
+TEST_CASE("Depth kernels performance", "[BENCHMARK][API]") {
+
+    for (auto [width, height] : {std::pair{640, 480}, std::pair{1280, 720}})
+    {
+        std::mt19937 mt(width);
+        std::uniform_real_distribution<float> unif_dist(0.2f, 8.f);
+        std::vector<float> depth(width * height);
+        for (auto &d : depth) d = unif_dist(mt);
+        for (std::size_t i = 0; i < depth.size(); i += 17) depth[i] = 0.f;
+        std::vector<uint8_t> gray(width * height);
+        std::vector<float> out(width * height * 3);
+        const std::string res = std::to_string(width) + "x" + std::to_string(height);
+
+        BENCHMARK("Auto ranged gray " + res) {
+            depth_to_gray(depth.data(), width, height, 1, depth_range(depth.data(), width, height), gray.data(), width);
+            return gray[0];
+        };
+        BENCHMARK("Median decimation 2x2 " + res) {
+            decimate_median(depth.data(), width, height, 2, out.data());
+            return out[0];
+        };
+        BENCHMARK("Median decimation 4x4 " + res) {
+            decimate_median(depth.data(), width, height, 4, out.data());
+            return out[0];
+        };
+        BENCHMARK("ROI stats centre half " + res) {
+            return roi_stats(depth.data(), width, height, width / 4, height / 4, 3 * width / 4, 3 * height / 4);
+        };
+        BENCHMARK("Normals " + res) {
+            normals(depth.data(), width, height, 600.f, 600.f, width / 2.f, height / 2.f, out.data());
+            return out[0];
+        };
+    }
+}
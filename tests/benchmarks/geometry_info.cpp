@@ -0,0 +1,80 @@
+#include "dsr/api/dsr_geometry_queries_api.h"
+#include <Qt3DCore/QEntity>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+
+// Mesh of 300 vertices spread in a 1m box at (x, y, 0), about the size of a furniture model.
+static std::vector<std::tuple<float, float, float>> make_mesh(std::mt19937 &mt, float x, float y)
+{
+    std::uniform_real_distribution<float> unif_dist(0.f, 1.f);
+    std::vector<std::tuple<float, float, float>> positions(300);
+    for (auto &[px, py, pz] : positions)
+    {
+        px = x + unif_dist(mt); py = y + unif_dist(mt); pz = unif_dist(mt);
+    }
+    return positions;
+}
+
+
+// Registration of the meshes of a 5000 object scene, alone and with 4 threads querying the index
+// while it is loaded.
+TEST_CASE("Geometry loads and queries", "[BENCHMARK][GEOMETRY]") {
+
+    constexpr int objects = 5000;
+    std::mt19937 mt(objects);
+    std::vector<std::vector<std::tuple<float, float, float>>> meshes;
+    std::vector<std::unique_ptr<Qt3DCore::QEntity>> entities;
+    for (int i = 0; i < objects; i++)
+    {
+        meshes.emplace_back(make_mesh(mt, 2.f * (i % 100), 2.f * (i / 100)));
+        entities.emplace_back(std::make_unique<Qt3DCore::QEntity>());
+        entities.back()->setObjectName(QString::fromStdString("object_" + std::to_string(i)));
+    }
+
+    auto load = [&](GeomInfo &info) {
+        for (int i = 0; i < objects; i++)
+            info.addQtGeom(entities[i].get(), std::vector(meshes[i]), {0, 1, 2});
+        return info.size();
+    };
+
+    // GeomInfo is a singleton that lives while someone holds it, each run loads a new one.
+    BENCHMARK("Load 5000 meshes of 300 vertices") {
+        auto info = TempSingleton<GeomInfo>::get();
+        return load(*info);
+    };
+
+    BENCHMARK("Load 5000 meshes of 300 vertices with 4 readers") {
+        auto info = TempSingleton<GeomInfo>::get();
+        geometry_queries_api api;
+        std::atomic<bool> loading{true};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; r++)
+            readers.emplace_back([&, r] {
+                float x = r;
+                while (loading.load()) api.nearest({x = std::fmod(x + 7.f, 200.f), 10.f, 0.5f}, 5);
+            });
+        auto n = load(*info);
+        loading.store(false);
+        for (auto &t : readers) t.join();
+        return n;
+    };
+
+    auto info = TempSingleton<GeomInfo>::get();
+    load(*info);
+    geometry_queries_api api;
+    BENCHMARK("5 nearest of 5000 geometries") {
+        return api.nearest({100.f, 100.f, 0.5f}, 5);
+    };
+    BENCHMARK("Status against one geometry") {
+        return api.status({100.5f, 100.5f, 0.5f}, "object_2550");
+    };
+}
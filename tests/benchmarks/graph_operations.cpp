@@ -0,0 +1,134 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_at(DSRGraph &G, RT_API &rt, uint64_t parent, float x, float y, float z)
+{
+    auto n = Node::create<testtype_node_type>(random_string());
+    G.add_or_modify_attrib_local<level_att>(n, 1);
+    G.add_or_modify_attrib_local<pos_x_att>(n, x);
+    G.add_or_modify_attrib_local<pos_y_att>(n, y);
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    auto p = G.get_node(parent);
+    REQUIRE(p.has_value());
+    rt.insert_or_assign_edge_RT(p.value(), id.value(), {x, y, z}, {0.f, 0.f, 0.3f});
+    return id.value();
+}
+
+
+TEST_CASE("Graph API micro benchmarks on 1k nodes", "[BENCHMARK][GRAPH]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    // Ten chains of 100 nodes below the root.
+    std::vector<uint64_t> ids;
+    std::vector<std::string> names;
+    for (int c = 0; c < 10; c++)
+    {
+        uint64_t parent = root->id();
+        for (int i = 0; i < 100; i++)
+        {
+            parent = insert_at(G, *rt, parent, 10.f * c, 1.f, 0.f);
+            ids.emplace_back(parent);
+            names.emplace_back(G.get_name_from_id(parent).value());
+        }
+    }
+    const auto n = ids.size();
+    std::size_t i = 0;
+
+    BENCHMARK("get_node(id)") {
+        return G.get_node(ids[i++ % n]);
+    };
+
+    BENCHMARK("get_node(name)") {
+        return G.get_node(names[i++ % n]);
+    };
+
+    auto node = G.get_node(ids.front());
+    REQUIRE(node.has_value());
+    BENCHMARK("get_attrib_by_name<pos_x>(node)") {
+        return G.get_attrib_by_name<pos_x_att>(node.value());
+    };
+
+    BENCHMARK("get_attrib_by_name<pos_x>(id)") {
+        return G.get_attrib_by_name<pos_x_att>(ids[i++ % n]);
+    };
+
+    int level = 0;
+    BENCHMARK("update_node, one attribute") {
+        G.add_or_modify_attrib_local<level_att>(node.value(), ++level);
+        return G.update_node(node.value());
+    };
+
+    // Fourth level of a chain to the root, and between the deepest nodes of two chains.
+    auto inner = G.get_inner_eigen_api();
+    const auto &shallow = names[3];
+    const auto &deep_a = names[99];
+    const auto &deep_b = names[199];
+    const auto &world = root->name();
+
+    BENCHMARK("InnerEigenAPI::transform, depth 4") {
+        return inner->transform(world, shallow);
+    };
+
+    BENCHMARK("InnerEigenAPI::transform, between depth 100 nodes") {
+        return inner->transform(deep_a, deep_b);
+    };
+}
+
+TEST_CASE("Node insertion bursts", "[BENCHMARK][GRAPH]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+
+    // More nodes than ids in one 10 ms period of the generator.
+    constexpr int burst = 5000;
+    auto make_batch = [] {
+        std::vector<Node> batch;
+        batch.reserve(burst);
+        for (int i = 0; i < burst; i++)
+            batch.emplace_back(Node::create<testtype_node_type>(""));
+        return batch;
+    };
+    auto remove = [&G](const std::vector<uint64_t> &ids) {
+        for (auto id : ids) G.delete_node(id);
+    };
+
+    BENCHMARK("Generate 5000 ids") {
+        id_generator generator(1);
+        uint64_t last = 0;
+        for (int i = 0; i < burst; i++) last = generator.generate();
+        return last;
+    };
+
+    BENCHMARK_ADVANCED("insert_node x 5000")(Catch::Benchmark::Chronometer meter) {
+        auto batch = make_batch();
+        std::vector<uint64_t> ids;
+        ids.reserve(burst);
+        meter.measure([&] {
+            for (auto &n : batch) ids.emplace_back(G.insert_node(n).value_or(0));
+        });
+        remove(ids);
+    };
+
+    BENCHMARK_ADVANCED("insert_nodes of 5000")(Catch::Benchmark::Chronometer meter) {
+        auto batch = make_batch();
+        std::vector<uint64_t> ids;
+        meter.measure([&] {
+            auto r = G.insert_nodes(batch);
+            ids.insert(ids.end(), r.begin(), r.end());
+        });
+        remove(ids);
+    };
+}
@@ -0,0 +1,112 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_query.h"
+#include "../utils.h"
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+template <typename Type>
+static uint64_t insert_child(DSRGraph &G, RT_API &rt, uint64_t parent)
+{
+    auto n = Node::create<Type>(random_string());
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    auto p = G.get_node(parent);
+    REQUIRE(p.has_value());
+    rt.insert_or_assign_edge_RT(p.value(), id.value(), {0.f, 0.f, 0.f}, {0.f, 0.f, 0.f});
+    return id.value();
+}
+
+
+// Queries against the same traversal written with the public API of the graph, which copies every node
+// and edge it reads. 20 rooms with 10 tables of 5 objects each and one robot: 1221 nodes.
+TEST_CASE("Graph queries against hand-written traversals", "[BENCHMARK][QUERY]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    constexpr int ROOMS = 20, TABLES = 10, OBJECTS = 5;
+    for (int r = 0; r < ROOMS; r++)
+    {
+        auto room = insert_child<room_node_type>(G, *rt, root->id());
+        if (r == ROOMS / 2)
+        {
+            auto robot = insert_child<robot_node_type>(G, *rt, room);
+            REQUIRE(G.insert_or_assign_edge(Edge::create<in_edge_type>(robot, room)));
+        }
+        for (int t = 0; t < TABLES; t++)
+        {
+            auto table = insert_child<object_node_type>(G, *rt, room);
+            REQUIRE(G.insert_or_assign_edge(Edge::create<in_edge_type>(table, room)));
+            for (int o = 0; o < OBJECTS; o++)
+            {
+                auto object = insert_child<plant_node_type>(G, *rt, table);
+                REQUIRE(G.insert_or_assign_edge(Edge::create<in_edge_type>(object, room)));
+            }
+        }
+    }
+    const uint64_t start = root->id();
+
+    auto rt_descendants = [&]() {
+        std::vector<uint64_t> ret;
+        std::unordered_set<uint64_t> visited{start};
+        std::deque<std::pair<uint64_t, int>> frontier{{start, 0}};
+        while (not frontier.empty())
+        {
+            auto [id, depth] = frontier.front();
+            frontier.pop_front();
+            if (depth >= 8) continue;
+            auto edges = G.get_edges(id);
+            if (not edges.has_value()) continue;
+            for (const auto &[key, edge] : edges.value())
+            {
+                if (key.second != "RT" or not visited.insert(key.first).second) continue;
+                frontier.emplace_back(key.first, depth + 1);
+                if (auto n = G.get_node(key.first); n.has_value() and n->type() == "plant") ret.emplace_back(key.first);
+            }
+        }
+        return ret;
+    };
+    REQUIRE(rt_descendants().size() == ROOMS * TABLES * OBJECTS);
+    REQUIRE(Query::node(start).out("RT", 8).of_type("plant").run(&G).count() == ROOMS * TABLES * OBJECTS);
+
+    BENCHMARK("RT descendants of a type, hand-written") {
+        return rt_descendants();
+    };
+    BENCHMARK("RT descendants of a type, query") {
+        return Query::node(start).out("RT", 8).of_type("plant").run(&G).ids();
+    };
+
+    auto same_room = [&]() {
+        std::vector<uint64_t> ret;
+        std::unordered_set<uint64_t> seen;
+        for (const auto &robot : G.get_nodes_by_type("robot"))
+            for (const auto &in : DSRGraph::get_node_edges_by_type(robot, "in"))
+                for (const auto &e : G.get_edges_to_id(in.to()))
+                    if (e.type() == "in" and seen.insert(e.from()).second)
+                        if (auto n = G.get_node(e.from()); n.has_value() and n->type() == "object") ret.emplace_back(e.from());
+        return ret;
+    };
+    REQUIRE(same_room().size() == TABLES);
+    REQUIRE(Query::type("robot").out("in").in("in").of_type("object").run(&G).count() == TABLES);
+
+    BENCHMARK("Objects in the same room as the robot, hand-written") {
+        return same_room();
+    };
+    BENCHMARK("Objects in the same room as the robot, query") {
+        return Query::type("robot").out("in").in("in").of_type("object").run(&G).ids();
+    };
+
+    BENCHMARK("First plant, query") {
+        return Query::node(start).out("RT", 8).of_type("plant").run(&G).first();
+    };
+}
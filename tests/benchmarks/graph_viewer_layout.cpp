@@ -0,0 +1,46 @@
+#include "dsr/gui/viewers/graph_viewer/force_layout.h"
+#include <cmath>
+#include <random>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static ForceLayoutState make_random_tree_layout(std::size_t n)
+{
+    std::mt19937 mt(n);
+    std::uniform_real_distribution<float> unif_dist(-300, 300);
+    ForceLayoutState state;
+    state.positions.resize(2 * n);
+    for (auto &p : state.positions) p = unif_dist(mt);
+    for (uint32_t i = 1; i < n; i++)
+        state.edges.emplace_back(i, std::uniform_int_distribution<uint32_t>(0, i - 1)(mt));
+    return state;
+}
+
+
+TEST_CASE("Barnes-Hut force layout steps", "[BENCHMARK][GUI]") {
+
+    SECTION("Layout step on 1k/5k/10k nodes") {
+        for (std::size_t n : {1000, 5000, 10000})
+        {
+            auto state = make_random_tree_layout(n);
+            ForceLayout layout;
+            BENCHMARK("Layout step " + std::to_string(n) + " nodes") {
+                return layout.step(state);
+            };
+        }
+
+        BENCHMARK_ADVANCED("Layout step 10000 nodes in worker thread")(Catch::Benchmark::Chronometer meter) {
+            ForceLayoutWorker worker;
+            auto state = make_random_tree_layout(10000);
+            meter.measure([&] {
+                worker.submit(ForceLayoutState(state));
+                while (true)
+                    if (auto r = worker.take_result(); r.has_value()) return r->second;
+            });
+        };
+    }
+}
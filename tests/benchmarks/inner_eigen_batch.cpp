@@ -0,0 +1,59 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_at(DSRGraph &G, RT_API &rt, uint64_t parent, float x, float y, float z, float rz = 0.f)
+{
+    auto n = Node::create<testtype_node_type>(random_string());
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    auto p = G.get_node(parent);
+    REQUIRE(p.has_value());
+    rt.insert_or_assign_edge_RT(p.value(), id.value(), {x, y, z}, {0.f, 0.f, rz});
+    return id.value();
+}
+
+
+TEST_CASE("Batched InnerEigenAPI transforms on 1k nodes", "[BENCHMARK][INNER EIGEN]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    auto robot = insert_at(G, *rt, root->id(), 1000.f, 0.f, 0.f, 0.5f);
+    auto robot_name = G.get_name_from_id(robot).value();
+    std::vector<uint64_t> ids;
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; i++)
+    {
+        // Objects hanging from a few intermediate frames, as the tables and shelves of a room.
+        auto parent = i % 10 == 0 or ids.empty() ? root->id() : ids[i - i % 10];
+        ids.emplace_back(insert_at(G, *rt, parent, rand() % 2000, rand() % 2000, 0.f));
+        names.emplace_back(G.get_name_from_id(ids.back()).value());
+    }
+
+    // A new API each time so the looped calls don't hit the cache, as when the poses change every frame.
+    BENCHMARK("1000 looped transform calls") {
+        auto inner = G.get_inner_eigen_api();
+        Mat::Vector3d acc = Mat::Vector3d::Zero();
+        for (const auto &name : names)
+            acc += inner->transform(robot_name, name).value_or(Mat::Vector3d::Zero());
+        return acc;
+    };
+    BENCHMARK("get_poses of 1000 nodes") {
+        auto inner = G.get_inner_eigen_api();
+        return inner->get_poses(robot_name, ids);
+    };
+    BENCHMARK("get_world_poses of 1000 nodes") {
+        auto inner = G.get_inner_eigen_api();
+        return inner->get_world_poses(std::string(testtype_node_type::attr_name));
+    };
+}
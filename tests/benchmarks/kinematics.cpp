@@ -0,0 +1,75 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_kinematics_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_link(DSRGraph &G, RT_API &rt, uint64_t parent, float x, float y, float z, float rz = 0.f)
+{
+    auto n = Node::create<testtype_node_type>(random_string());
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    auto p = G.get_node(parent);
+    REQUIRE(p.has_value());
+    rt.insert_or_assign_edge_RT(p.value(), id.value(), {x, y, z}, {0.f, 0.f, rz});
+    return id.value();
+}
+
+
+TEST_CASE("Forward kinematics on a humanoid", "[BENCHMARK][KINEMATICS]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    // Base, torso, head (3), two arms (7) with five fingers (3), two legs (6): 77 links.
+    std::vector<uint64_t> leaves;
+    auto base = insert_link(G, *rt, root->id(), 1000.f, 0.f, 0.f);
+    auto torso = insert_link(G, *rt, base, 0.f, 0.f, 800.f);
+    auto chain = [&](uint64_t from, int n, float dz) {
+        for (int i = 0; i < n; i++) from = insert_link(G, *rt, from, 0.f, 0.f, dz, 0.1f);
+        return from;
+    };
+    leaves.emplace_back(chain(torso, 3, 100.f));
+    for (int side = 0; side < 2; side++)
+    {
+        auto wrist = chain(torso, 7, 50.f);
+        for (int f = 0; f < 5; f++) leaves.emplace_back(chain(wrist, 3, 20.f));
+        leaves.emplace_back(chain(base, 6, -120.f));
+    }
+    std::vector<std::string> leaf_names;
+    for (auto id : leaves) leaf_names.emplace_back(G.get_name_from_id(id).value());
+
+    auto fk = G.get_kinematics_api();
+    auto root_n = G.get_node_root();
+    float x = 0.f;
+
+    BENCHMARK("Move the base and read every leaf (KinematicsAPI)") {
+        rt->insert_or_assign_edge_RT(root_n.value(), base, {x++, 0.f, 0.f}, {0.f, 0.f, 0.f});
+        Mat::Vector3d acc = Mat::Vector3d::Zero();
+        for (auto id : leaves) acc += fk->world_pose(id)->translation();
+        return acc;
+    };
+    BENCHMARK("Move the base and read every leaf (InnerEigenAPI)") {
+        rt->insert_or_assign_edge_RT(root_n.value(), base, {x++, 0.f, 0.f}, {0.f, 0.f, 0.f});
+        auto fresh = G.get_inner_eigen_api();
+        Mat::Vector3d acc = Mat::Vector3d::Zero();
+        for (const auto &name : leaf_names) acc += fresh->transform("root", name).value_or(Mat::Vector3d::Zero());
+        return acc;
+    };
+    BENCHMARK("Read every leaf, clean cache") {
+        Mat::Vector3d acc = Mat::Vector3d::Zero();
+        for (auto id : leaves) acc += fk->world_pose(id)->translation();
+        return acc;
+    };
+    BENCHMARK("Relative pose hand to head, clean cache") {
+        return fk->relative_pose(leaves[0], leaves[1]);
+    };
+}
@@ -0,0 +1,123 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/gui/viewers/qt3d_viewer/mesh_loader.h"
+#include "../utils.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+// Grid of n x n vertices and its triangles, about the size of the furniture models of a room.
+static void write_obj(const std::filesystem::path &file, int n, float offset)
+{
+    std::ofstream out(file);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            out << "v " << i + offset << " " << j << " 0\n";
+    for (int i = 0; i + 1 < n; i++)
+        for (int j = 0; j + 1 < n; j++)
+        {
+            const int a = i * n + j + 1;
+            out << "f " << a << " " << a + 1 << " " << a + n << "\n";
+        }
+}
+
+// Time to first frame of the Qt3D viewer, without the rendering: what runs in the GUI thread before
+// the scene is shown, and how long the loader takes to resolve every mesh behind it.
+TEST_CASE("Qt3D viewer mesh loading of a 1k mesh world", "[BENCHMARK][GUI]") {
+
+    auto dir = std::filesystem::temp_directory_path() / ("dsr_meshes_" + random_string(6));
+    std::filesystem::create_directories(dir);
+    // 20 models, plus a copy of each under another name, as when a model is duplicated per room.
+    std::vector<std::string> models;
+    for (int m = 0; m < 20; m++)
+    {
+        write_obj(dir / ("model_" + std::to_string(m) + ".obj"), 40, m);
+        std::filesystem::copy_file(dir / ("model_" + std::to_string(m) + ".obj"), dir / ("copy_" + std::to_string(m) + ".obj"));
+        models.emplace_back((dir / ("model_" + std::to_string(m) + ".obj")).string());
+        models.emplace_back((dir / ("copy_" + std::to_string(m) + ".3ds")).string());
+    }
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    std::vector<std::pair<uint64_t, std::string>> nodes;
+    for (int i = 0; i < 1000; i++)
+    {
+        auto n = Node::create<mesh_node_type>(random_string());
+        G.add_or_modify_attrib_local<path_att>(n, models[i % models.size()]);
+        auto id = G.insert_node(n);
+        REQUIRE(id.has_value());
+        rt->insert_or_assign_edge_RT(root.value(), id.value(), {float(rand() % 5000), float(rand() % 5000), 0.f}, {0.f, 0.f, 0.f});
+        nodes.emplace_back(id.value(), models[i % models.size()]);
+    }
+    std::vector<uint64_t> ids;
+    for (const auto &[id, path] : nodes) ids.emplace_back(id);
+    const std::vector<uint64_t> first_batch(ids.begin(), ids.begin() + 64);
+
+    auto drain = [](MeshLoader &loader) {
+        std::vector<MeshSource> sources;
+        while (not loader.idle())
+        {
+            auto r = loader.take_ready();
+            sources.insert(sources.end(), std::make_move_iterator(r.begin()), std::make_move_iterator(r.end()));
+            std::this_thread::yield();
+        }
+        return sources;
+    };
+
+    SECTION("Files with the same contents share the content key") {
+        MeshLoader loader;
+        for (const auto &[id, path] : nodes) loader.request(id, path);
+        auto sources = drain(loader);
+        REQUIRE(sources.size() == nodes.size());
+        std::set<uint64_t> keys;
+        for (const auto &s : sources)
+        {
+            REQUIRE(s.content_key != 0);
+            keys.insert(s.content_key);
+        }
+        REQUIRE(keys.size() == 20);
+        REQUIRE(loader.stats().files_read == 40);
+        REQUIRE(loader.stats().shared == nodes.size() - 20);
+    }
+
+    SECTION("Time to first frame") {
+        // Before: every transform and mesh path was resolved before showing the scene.
+        BENCHMARK("Synchronous resolution of 1000 meshes") {
+            auto inner = G.get_inner_eigen_api();
+            std::size_t found = 0;
+            for (const auto &[id, path] : nodes)
+            {
+                auto mat = inner->get_transformation_matrix("root", G.get_name_from_id(id).value());
+                std::error_code ec;
+                auto canonical = std::filesystem::canonical(MeshLoader::obj_path(path), ec);
+                found += mat.has_value() and not ec;
+            }
+            return found;
+        };
+        // After: the first batch of entities is created and the meshes are left to the loader.
+        BENCHMARK("First batch of 64 and 1000 mesh requests") {
+            auto inner = G.get_inner_eigen_api();
+            MeshLoader loader;
+            for (const auto &[id, path] : nodes) loader.request(id, path);
+            return inner->get_poses("root", first_batch);
+        };
+        BENCHMARK("All 1000 meshes resolved by the loader") {
+            MeshLoader loader;
+            for (const auto &[id, path] : nodes) loader.request(id, path);
+            return drain(loader).size();
+        };
+    }
+
+    std::filesystem::remove_all(dir);
+}
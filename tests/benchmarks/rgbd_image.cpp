@@ -0,0 +1,43 @@
+#include "dsr/gui/viewers/graph_viewer/rgbd_image_utils.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR::image;
+
+
+TEST_CASE("RGBD widget image conversion timings", "[BENCHMARK][GUI]") {
+
+    constexpr int width = 1280, height = 720;
+    std::mt19937 mt(width);
+    std::uniform_real_distribution<float> unif_dist(0.2f, 8.f);
+    std::vector<float> depth(width * height);
+    for (auto &d : depth) d = unif_dist(mt);
+    std::vector<uint8_t> rgb(width * height * 3, 127);
+    std::vector<uint8_t> out(width * height * 3);
+
+    SECTION("Conversion of a 1280x720 frame") {
+        const int step = downsample_step(width, 640);
+        REQUIRE(step == 2);
+        auto range = depth_range(depth.data(), width, height);
+
+        BENCHMARK("Depth range 1280x720") {
+            return depth_range(depth.data(), width, height);
+        };
+        BENCHMARK("Depth to gray 1280x720") {
+            depth_to_gray(depth.data(), width, height, 1, range, out.data(), width);
+            return out[0];
+        };
+        BENCHMARK("Depth to gray 1280x720 -> 640x360") {
+            depth_to_gray(depth.data(), width, height, step, range, out.data(), width / step);
+            return out[0];
+        };
+        BENCHMARK("RGB 1280x720 -> 640x360") {
+            downsample_rgb(rgb.data(), width, height, step, out.data(), width / step * 3);
+            return out[0];
+        };
+    }
+}
@@ -0,0 +1,127 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_signal_bus.h"
+#include "../utils.h"
+#include <QCoreApplication>
+#include <atomic>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+// Cost of delivering the graph signals to 4 subscribers, 1000 signals per run. The callbacks of
+// G.callbacks() against the Qt signals of G, with the same arguments an update_node_attr carries.
+TEST_CASE("Graph signal dispatch", "[BENCHMARK][SIGNALS]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto &cb = G.callbacks();
+
+    constexpr int SUBSCRIBERS = 4;
+    constexpr int SIGNALS = 1000;
+    const std::vector<std::string> names{"level", "parent"};
+    const SignalInfo info{G.get_agent_id()};
+    std::atomic<uint64_t> received{0};
+
+    {
+        Connections connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.add(cb.update_node_attr, [&](uint64_t id, const std::vector<std::string> &, const SignalInfo &) {
+                received.fetch_add(id, std::memory_order_relaxed);
+            });
+        BENCHMARK("Callbacks, direct") {
+            for (uint64_t k = 0; k < SIGNALS; k++) cb.update_node_attr.publish(k, names, info);
+            return received.load();
+        };
+    }
+
+    {
+        QueuedExecutor executor;
+        Connections connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.add(cb.update_node_attr, executor, [&](uint64_t id, const std::vector<std::string> &, const SignalInfo &) {
+                received.fetch_add(id, std::memory_order_relaxed);
+            });
+        BENCHMARK("Callbacks, queued") {
+            for (uint64_t k = 0; k < SIGNALS; k++) cb.update_node_attr.publish(k, names, info);
+            return executor.run_pending();
+        };
+    }
+
+    {
+        std::vector<QMetaObject::Connection> connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.emplace_back(QObject::connect(&G, &DSRGraph::update_node_attr_signal, &G,
+                             [&](uint64_t id, const std::vector<std::string> &) { received.fetch_add(id, std::memory_order_relaxed); },
+                             Qt::DirectConnection));
+        BENCHMARK("Qt signals, direct") {
+            for (uint64_t k = 0; k < SIGNALS; k++) emit G.update_node_attr_signal(k, names, info);
+            return received.load();
+        };
+        for (auto &c : connections) QObject::disconnect(c);
+    }
+
+    {
+        QObject context;
+        std::vector<QMetaObject::Connection> connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.emplace_back(QObject::connect(&G, &DSRGraph::update_node_attr_signal, &context,
+                             [&](uint64_t id, const std::vector<std::string> &) { received.fetch_add(id, std::memory_order_relaxed); },
+                             Qt::QueuedConnection));
+        BENCHMARK("Qt signals, queued") {
+            for (uint64_t k = 0; k < SIGNALS; k++) emit G.update_node_attr_signal(k, names, info);
+            QCoreApplication::sendPostedEvents(&context);
+            return received.load();
+        };
+        for (auto &c : connections) QObject::disconnect(c);
+    }
+}
+
+// An update of one attribute of a node with a 640x480 RGB image, seen by 4 subscribers that need the
+// new value. With the names they read it back from G, with update_node_attr_values it comes in the event.
+TEST_CASE("Attribute change notifications", "[BENCHMARK][SIGNALS]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto &cb = G.callbacks();
+
+    constexpr int SUBSCRIBERS = 4;
+    auto node = Node::create<testtype_node_type>(random_string());
+    const std::vector<uint8_t> rgb(640 * 480 * 3, 1);
+    G.add_or_modify_attrib_local<cam_rgb_att>(node, rgb);
+    auto id = G.insert_node(node);
+    REQUIRE(id.has_value());
+    auto n = G.get_node(id.value());
+    REQUIRE(n.has_value());
+    int level = 0;
+    std::atomic<int64_t> seen{0};
+
+    {
+        Connections connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.add(cb.update_node_attr, [&](uint64_t id, const std::vector<std::string> &, const SignalInfo &) {
+                if (auto v = G.get_node(id); v.has_value())
+                    seen.fetch_add(G.get_attrib_by_name<level_att>(v.value()).value_or(0), std::memory_order_relaxed);
+            });
+        BENCHMARK("Names, get_node in the callbacks") {
+            G.add_or_modify_attrib_local<level_att>(n.value(), ++level);
+            return G.update_node(n.value());
+        };
+    }
+
+    {
+        Connections connections;
+        for (int i = 0; i < SUBSCRIBERS; i++)
+            connections.add(cb.update_node_attr_values, [&](uint64_t, const AttrValues &values, const SignalInfo &) {
+                for (const auto &c : *values)
+                    if (c.name == level_att::attr_name and c.value.has_value())
+                        seen.fetch_add(c.value->dec(), std::memory_order_relaxed);
+            });
+        BENCHMARK("Values in the event") {
+            G.add_or_modify_attrib_local<level_att>(n.value(), ++level);
+            return G.update_node(n.value());
+        };
+    }
+}
@@ -0,0 +1,47 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_spatial_index_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_at(DSRGraph &G, RT_API &rt, Node &parent, float x, float y, float z)
+{
+    auto n = Node::create<testtype_node_type>(random_string());
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    rt.insert_or_assign_edge_RT(parent, id.value(), {x, y, z}, {0.f, 0.f, 0.f});
+    return id.value();
+}
+
+
+TEST_CASE("Spatial index queries on 10k nodes", "[BENCHMARK][SPATIAL INDEX]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+    for (int i = 0; i < 10000; i++)
+        insert_at(G, *rt, root.value(), rand() % 20000 - 10000, rand() % 20000 - 10000, 0.f);
+
+    auto index = G.get_spatial_index_api();
+    REQUIRE(index->size() == 10001);
+
+    BENCHMARK("10-nearest") {
+        return index->nearest(Mat::Vector3d(0, 0, 0), 10);
+    };
+    BENCHMARK("10-nearest by type") {
+        return index->nearest(Mat::Vector3d(0, 0, 0), 10, std::string(testtype_node_type::attr_name));
+    };
+    BENCHMARK("Radius 1000") {
+        return index->radius(Mat::Vector3d(0, 0, 0), 1000);
+    };
+    BENCHMARK("Box 2000x2000") {
+        return index->box_query(Mat::Vector3d(-1000, -1000, -1), Mat::Vector3d(1000, 1000, 1));
+    };
+}
@@ -0,0 +1,59 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_wait_api.h"
+#include "../utils.h"
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+using namespace DSR;
+using namespace std::chrono_literals;
+
+
+static DetachedTask await_level_flag(DSRGraph *G, uint64_t id, int level, std::atomic<bool> *done)
+{
+    co_await G->wait_for_attr<level_att>(id, [level](int v) { return v == level; });
+    done->store(true, std::memory_order_release);
+}
+
+
+TEST_CASE("Awaitable wake-up latency", "[BENCHMARK][WAIT]") {
+
+    auto filename = make_empty_config_file();
+    auto id1 = rand() % 1000;
+    DSRGraph G(random_string(10), id1, filename);
+    DSRGraph G2(random_string(11), id1 + 1);
+    std::this_thread::sleep_for(200ms);
+
+    auto id = G.insert_node(Node::create<testtype_node_type>(random_string()));
+    REQUIRE(id.has_value());
+    auto n = G.get_node(id.value());
+    G.add_or_modify_attrib_local<level_att>(n.value(), 0);
+    REQUIRE(G.update_node(n.value()));
+    for (int i = 0; i < 100 and not G2.get_node(id.value()).has_value(); i++)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(G2.get_node(id.value()).has_value());
+
+    int level = 0;
+    // Update written in G and the coroutine resumed in the same agent.
+    BENCHMARK("Local update to resume") {
+        std::atomic<bool> done{false};
+        await_level_flag(&G, id.value(), ++level, &done);
+        G.add_or_modify_attrib_local<level_att>(n.value(), level);
+        G.update_node(n.value());
+        return done.load();
+    };
+
+    // Update written in G, published, joined by G2 and resumed there.
+    BENCHMARK("Remote update to resume") {
+        std::atomic<bool> done{false};
+        await_level_flag(&G2, id.value(), ++level, &done);
+        G.add_or_modify_attrib_local<level_att>(n.value(), level);
+        G.update_node(n.value());
+        while (not done.load(std::memory_order_acquire)) std::this_thread::yield();
+        return true;
+    };
+}
@@ -0,0 +1,75 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+static uint64_t insert_person(DSRGraph &G, float distance, uint64_t parent)
+{
+    auto n = Node::create<person_node_type>(random_string());
+    G.add_or_modify_attrib_local<distance_to_robot_att>(n, distance);
+    G.add_or_modify_attrib_local<parent_att>(n, parent);
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+    return id.value();
+}
+
+
+TEST_CASE("Secondary attribute indices", "[GRAPH][INDEX]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    auto near = insert_person(G, 1500.f, root->id());
+    auto far = insert_person(G, 4000.f, root->id());
+    auto child = insert_person(G, 500.f, near);
+
+    // The same queries with and without indices.
+    auto check_queries = [&]() {
+        REQUIRE(sorted(G.query_nodes(distance_to_robot_str, AttrPredicate::lt(2000.f), "person")) == sorted({near, child}));
+        REQUIRE(G.query_nodes(distance_to_robot_str, AttrPredicate::range(1000.f, 2000.f)) == std::vector<uint64_t>{near});
+        REQUIRE(G.query_nodes(distance_to_robot_str, AttrPredicate::ge(4000)) == std::vector<uint64_t>{far});
+        REQUIRE(sorted(G.query_nodes(parent_str, AttrPredicate::eq(root->id()))) == sorted({near, far}));
+        REQUIRE(G.query_nodes(parent_str, AttrPredicate::eq(near), "person") == std::vector<uint64_t>{child});
+        REQUIRE(G.query_nodes(parent_str, AttrPredicate::eq(near), "testtype").empty());
+    };
+
+    SECTION("Scans without an index") {
+        check_queries();
+    }
+
+    SECTION("Indices built over the existing nodes") {
+        REQUIRE(G.create_attr_index(distance_to_robot_str, IndexKind::ORDERED));
+        REQUIRE(G.create_attr_index(parent_str, IndexKind::HASH));
+        REQUIRE_FALSE(G.create_attr_index(parent_str, IndexKind::HASH));
+        check_queries();
+        // A hash index can not answer a range, the query falls back to a scan.
+        REQUIRE(G.query_nodes(parent_str, AttrPredicate::gt(uint64_t{0})).size() == 3);
+    }
+
+    SECTION("Indices follow inserts, updates and deletes") {
+        REQUIRE(G.create_attr_index(distance_to_robot_str, IndexKind::ORDERED));
+        REQUIRE(G.create_attr_index(parent_str, IndexKind::HASH));
+
+        auto n = G.get_node(far);
+        G.add_or_modify_attrib_local<distance_to_robot_att>(n.value(), 100.f);
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(sorted(G.query_nodes(distance_to_robot_str, AttrPredicate::lt(2000.f))) == sorted({near, far, child}));
+
+        REQUIRE(G.remove_attrib_local<distance_to_robot_att>(n.value()));
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(sorted(G.query_nodes(distance_to_robot_str, AttrPredicate::lt(2000.f))) == sorted({near, child}));
+
+        auto other = insert_person(G, 10.f, near);
+        REQUIRE(sorted(G.query_nodes(parent_str, AttrPredicate::eq(near))) == sorted({child, other}));
+        REQUIRE(G.delete_node(child));
+        REQUIRE(G.query_nodes(parent_str, AttrPredicate::eq(near)) == std::vector<uint64_t>{other});
+
+        REQUIRE(G.drop_attr_index(parent_str));
+        REQUIRE(G.query_nodes(parent_str, AttrPredicate::eq(near)) == std::vector<uint64_t>{other});
+    }
+}
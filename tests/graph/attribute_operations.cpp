@@ -448,3 +448,94 @@ TEST_CASE("Native types in attributes", "[ATTRIBUTES]") {
     
     }
 }
+
+TEST_CASE("Attribute and type name ids", "[ATTRIBUTES]") {
+
+    SECTION("Registered names get their id at compile time") {
+        static_assert(int__att::attr_id == name_id("int_"));
+        static_assert(testtype_node_type::type_id == name_id("testtype"));
+        static_assert(RT_edge_type::type_id == name_id("RT"));
+        REQUIRE(attribute_types::name_of(int__att::attr_id) == "int_");
+
+        static_assert(name_id("runtime_att_232789") == name_id("runtime_att_429192"));
+        REQUIRE(attribute_types::check_type("runtime_att_232789", 1));
+        REQUIRE_FALSE(attribute_types::check_type("runtime_att_429192", 1));
+        REQUIRE_FALSE(attribute_types::check_type("runtime_att_429192", 1));
+        REQUIRE(attribute_types::name_of(name_id("runtime_att_429192")) == "runtime_att_232789");
+    }
+
+    SECTION("Names defined at runtime keep their type") {
+        const auto name = random_string(12);
+        {
+            // The registry keeps its own copy of the name.
+            std::string tmp = name;
+            REQUIRE(attribute_types::check_type(tmp, std::vector<float>{}));
+        }
+        REQUIRE(attribute_types::name_of(name_id(name)) == name);
+        REQUIRE(attribute_types::check_type(name, std::vector<float>{}));
+        REQUIRE_FALSE(attribute_types::check_type(name, 1));
+        REQUIRE_FALSE(attribute_types::check_type(name, std::any(1)));
+    }
+
+    SECTION("Types are checked by id and name") {
+        REQUIRE(node_types::check_type("testtype"));
+        REQUIRE_FALSE(node_types::check_type(random_string(20)));
+        REQUIRE(edge_types::check_type("RT"));
+    }
+
+    SECTION("A runtime name with the id of a registered one is rejected") {
+        static_assert(name_id("xxasien6") == int__att::attr_id);
+        REQUIRE_FALSE(attribute_types::check_type("xxasien6", 1));
+        REQUIRE(attribute_types::check_type("int_", 1));
+        REQUIRE(attribute_types::name_of(int__att::attr_id) == "int_");
+
+        static_assert(name_id("runtime_att_232789") == name_id("runtime_att_429192"));
+        REQUIRE(attribute_types::check_type("runtime_att_232789", 1));
+        REQUIRE_FALSE(attribute_types::check_type("runtime_att_429192", 1));
+        REQUIRE_FALSE(attribute_types::check_type("runtime_att_429192", 1));
+        REQUIRE(attribute_types::name_of(name_id("runtime_att_429192")) == "runtime_att_232789");
+    }
+
+    SECTION("Nodes of types with the same id are kept apart") {
+        static_assert(name_id("xabouz2s") == testtype_node_type::type_id);
+        auto filename = make_edge_config_file();
+        DSRGraph G(random_string(10), rand() % 1200, filename);
+
+        auto before = G.get_nodes_by_type("testtype").size();
+        auto n = Node::create<testtype_node_type>(random_string());
+        n.type() = "xabouz2s";  // as received from an agent with that type
+        auto id = G.insert_node(n);
+        REQUIRE(id.has_value());
+
+        REQUIRE(G.get_nodes_by_type("testtype").size() == before);
+        REQUIRE(G.get_nodes_by_type<testtype_node_type>().size() == before);
+        REQUIRE(G.get_nodes_by_types({"testtype"}).size() == before);
+        auto other = G.get_nodes_by_type("xabouz2s");
+        REQUIRE(other.size() == 1);
+        REQUIRE(other[0].id() == id.value());
+        REQUIRE(G.get_edges_by_type<RT_edge_type>().size() == G.get_edges_by_type("RT").size());
+    }
+
+    SECTION("Deleting an edge keeps the edges of types with the same id") {
+        static_assert(name_id("runtime_att_232789") == name_id("runtime_att_429192"));
+        auto filename = make_edge_config_file();
+        DSRGraph G(random_string(10), rand() % 1200, filename);
+
+        auto from = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        auto to = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        REQUIRE((from.has_value() and to.has_value()));
+        for (const auto *type : {"runtime_att_232789", "runtime_att_429192"})
+        {
+            auto e = Edge::create<RT_edge_type>(from.value(), to.value());
+            e.type() = type;  // as received from an agent with that type
+            REQUIRE(G.insert_or_assign_edge(e));
+        }
+
+        REQUIRE(G.delete_edge(from.value(), to.value(), "runtime_att_232789"));
+        REQUIRE(G.get_edges_by_type("runtime_att_232789").empty());
+        REQUIRE(G.get_edges_by_type("runtime_att_429192").size() == 1);
+
+        REQUIRE(G.delete_node(from.value()));
+        REQUIRE(G.get_edges_by_type("runtime_att_429192").empty());
+    }
+}
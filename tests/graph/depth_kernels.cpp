@@ -0,0 +1,75 @@
+#include "dsr/api/dsr_depth_utils.h"
+#include <cmath>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_approx.hpp"
+
+using namespace DSR::depth;
+
+
+TEST_CASE("Depth kernels", "[API][DEPTH]") {
+
+    constexpr int width = 8, height = 6;
+    std::vector<float> depth(width * height, 2.f);
+    depth[0] = NAN;
+    depth[1] = 0.f;
+    depth[9] = INFINITY;
+
+    SECTION("ROI statistics skip invalid pixels") {
+        depth[2] = 1.f;
+        auto stats = roi_stats(depth.data(), width, height, 0, 0, 4, 4);
+        REQUIRE(stats.has_value());
+        REQUIRE(stats->valid == 13);
+        REQUIRE(stats->min == 1.f);
+        REQUIRE(stats->median == 2.f);
+        REQUIRE(stats->mean == Catch::Approx(25.f / 13));
+        REQUIRE_FALSE(roi_stats(depth.data(), width, height, 0, 0, 2, 1).has_value());
+        REQUIRE_FALSE(roi_stats(depth.data(), width, height, 4, 4, 2, 2).has_value());
+    }
+
+    SECTION("Gray conversion writes invalid pixels as 0") {
+        depth[2] = 1.f;
+        depth[3] = 3.f;
+        depth[2 * width + 2] = INFINITY;
+        auto range = depth_range(depth.data(), width, height, 1);
+        REQUIRE(range.min == 1.f);
+        REQUIRE(range.max == 3.f);
+
+        std::vector<uint8_t> out(width * height, 1);
+        depth_to_gray(depth.data(), width, height, 1, range, out.data(), width);
+        REQUIRE(out[0] == 0);       // NaN
+        REQUIRE(out[1] == 0);
+        REQUIRE(out[2] == 0);
+        REQUIRE(out[3] == 255);
+        REQUIRE(out[4] == 127);
+        REQUIRE(out[9] == 0);       // inf
+
+        depth_to_gray(depth.data(), width, height, 2, range, out.data(), width / 2);
+        REQUIRE(out[0] == 0);
+        REQUIRE(out[1] == 0);
+        REQUIRE(out[2] == 127);
+        REQUIRE(out[width / 2 + 1] == 0);   // inf
+    }
+
+    SECTION("Block median decimation") {
+        depth[8] = 3.f;
+        std::vector<float> out((width / 2) * (height / 2));
+        decimate_median(depth.data(), width, height, 2, out.data());
+        REQUIRE(out[0] == 3.f);     // NaN, 0 and inf are masked
+        REQUIRE(out[1] == 2.f);
+        decimate_median(depth.data(), width, height, 3, out.data());
+        REQUIRE(out[0] == 2.f);
+    }
+
+    SECTION("Normals of a fronto parallel plane point to the camera") {
+        std::vector<float> out(width * height * 3);
+        normals(depth.data(), width, height, 100.f, 100.f, width / 2.f, height / 2.f, out.data());
+        const std::size_t p = 3 * (3 * width + 4);
+        REQUIRE(out[p] == Catch::Approx(0.f).margin(1e-5));
+        REQUIRE(out[p + 1] == Catch::Approx(-1.f));
+        REQUIRE(out[p + 2] == Catch::Approx(0.f).margin(1e-5));
+        // the pixel above is 0
+        REQUIRE(out[3 * (width + 1) + 1] == 0.f);
+    }
+}
@@ -0,0 +1,73 @@
+#include "dsr/api/dsr_geometry_queries_api.h"
+#include <Qt3DCore/QEntity>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+// Unit cube with its min corner at (x, 0, 0).
+static void add_cube(GeomInfo &info, Qt3DCore::QEntity *e, float x)
+{
+    std::vector<std::tuple<float, float, float>> positions;
+    for (int i = 0; i < 8; i++)
+        positions.emplace_back(x + (i & 1), (i >> 1) & 1, (i >> 2) & 1);
+    info.addQtGeom(e, std::move(positions), {0, 1, 2, 1, 3, 2});
+}
+
+
+TEST_CASE("Concurrent geometry loads and queries", "[API][GEOMETRY]") {
+
+    constexpr int writers = 4, per_writer = 250, readers = 4;
+    auto info = TempSingleton<GeomInfo>::get();
+    geometry_queries_api api;
+
+    std::vector<std::unique_ptr<Qt3DCore::QEntity>> entities;
+    for (int i = 0; i < writers * per_writer; i++)
+    {
+        entities.emplace_back(std::make_unique<Qt3DCore::QEntity>());
+        entities.back()->setObjectName(QString::fromStdString("cube_" + std::to_string(i)));
+    }
+
+    std::atomic<bool> loading{true};
+    std::atomic<int> inconsistent{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++)
+        threads.emplace_back([&, r] {
+            int i = r;
+            while (loading.load())
+            {
+                // Everything a query returns is fully registered.
+                for (const auto &[name, dist] : api.nearest({10.f * i, 0.5f, 0.5f}, 3))
+                    if (api.get_geom_mesh(name) == nullptr or api.get_geom_bbox_vertices(name).size() != 8)
+                        inconsistent++;
+                auto mesh = api.get_geom_mesh("cube_" + std::to_string(i));
+                if (mesh != nullptr and mesh->vertices().size() != 8) inconsistent++;
+                i = (i + readers) % (writers * per_writer);
+            }
+        });
+    std::vector<std::thread> loaders;
+    for (int w = 0; w < writers; w++)
+        loaders.emplace_back([&, w] {
+            for (int i = w * per_writer; i < (w + 1) * per_writer; i++)
+                add_cube(*info, entities[i].get(), 10.f * i);
+        });
+    for (auto &t : loaders) t.join();
+    loading.store(false);
+    for (auto &t : threads) t.join();
+
+    REQUIRE(inconsistent.load() == 0);
+    REQUIRE(info->size() == writers * per_writer);
+    for (int i = 0; i < writers * per_writer; i += 37)
+    {
+        auto nearest = api.nearest({10.f * i + 0.5f, 0.5f, 0.5f}, 1);
+        REQUIRE(nearest.size() == 1);
+        REQUIRE(nearest.front().first == "cube_" + std::to_string(i));
+        REQUIRE(nearest.front().second == 0.f);
+        REQUIRE(api.status({10.f * i + 0.5f, 0.5f, 0.5f}, "cube_" + std::to_string(i)).front() == State::within);
+    }
+    REQUIRE(api.get_geom_mesh("not_a_geometry") == nullptr);
+    REQUIRE(api.status({0.f, 0.f, 0.f}, "not_a_geometry").empty());
+}
@@ -0,0 +1,100 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_query.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+template <typename Type>
+static Node with_level(DSRGraph &G, int level)
+{
+    auto n = Node::create<Type>(random_string());
+    G.add_or_modify_attrib_local<level_att>(n, level);
+    return n;
+}
+
+static void insert_in(DSRGraph &G, uint64_t from, uint64_t to)
+{
+    REQUIRE(G.insert_or_assign_edge(Edge::create<in_edge_type>(from, to)));
+}
+
+
+TEST_CASE("Graph queries", "[GRAPH][QUERY]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    // root -> kitchen -> robot, table -> cup ; root -> hall -> plant. Things point to their room with "in".
+    auto kitchen = insert_rt_child(G, *rt, root->id(), with_level<room_node_type>(G, 1));
+    auto hall = insert_rt_child(G, *rt, root->id(), with_level<room_node_type>(G, 1));
+    auto robot = insert_rt_child(G, *rt, kitchen, with_level<robot_node_type>(G, 2));
+    auto table = insert_rt_child(G, *rt, kitchen, with_level<object_node_type>(G, 2));
+    auto cup = insert_rt_child(G, *rt, table, with_level<object_node_type>(G, 3));
+    auto plant = insert_rt_child(G, *rt, hall, with_level<object_node_type>(G, 2));
+    for (auto id : {robot, table, cup}) insert_in(G, id, kitchen);
+    insert_in(G, plant, hall);
+
+    SECTION("RT descendants of a type") {
+        auto r = Query::node(root->id()).out("RT", 8).of_type("object").run(&G);
+        REQUIRE(r.locked());
+        REQUIRE(sorted(r.ids()) == sorted({table, cup, plant}));
+        r.release();
+        REQUIRE_FALSE(r.locked());
+
+        REQUIRE(sorted(Query::node(kitchen).out("RT", 1).run(&G).ids()) == sorted({robot, table}));
+        REQUIRE(sorted(Query::node(root->id()).out("RT", 2, 2).run(&G).ids()) == sorted({robot, table, plant}));
+    }
+
+    SECTION("Objects in the same room as the robot") {
+        auto objects = Query::type("robot").out("in").in("in").of_type("object").run(&G).ids();
+        REQUIRE(sorted(objects) == sorted({table, cup}));
+    }
+
+    SECTION("Ancestors through incoming edges") {
+        auto ancestors = Query::node(cup).in("RT", 10).run(&G).ids();
+        REQUIRE(sorted(ancestors) == sorted({table, kitchen, root->id()}));
+        REQUIRE(sorted(Query::node(cup).in("RT", 10, 0).run(&G).ids()) == sorted({cup, table, kitchen, root->id()}));
+    }
+
+    SECTION("Attribute filters") {
+        auto deep = Query::all().where<level_att>([](int level) { return level >= 2; }).run(&G).ids();
+        REQUIRE(sorted(deep) == sorted({robot, table, cup, plant}));
+        REQUIRE(Query::all().has("level").run(&G).count() == G.size());
+        REQUIRE(Query::type("room").where("level", [](const Attribute &a) { return a.dec() == 3; }).run(&G).count() == 0);
+        REQUIRE(Query::all().where<level_att>([](int) { return true; }).has_predicates());
+        REQUIRE_FALSE(Query::all().has("level").out("RT").has_predicates());
+    }
+
+    SECTION("Results are produced lazily") {
+        auto r = Query::all().run(&G);
+        REQUIRE(r.first().has_value());
+        REQUIRE(r.ids(2).size() == 2);
+        const auto total = G.size();
+        REQUIRE(r.count() == total - 3);
+        REQUIRE_FALSE(r.next().has_value());
+    }
+
+    SECTION("Nodes are copied only for nodes()") {
+        auto nodes = Query::name(G.get_name_from_id(kitchen).value()).out("RT").of_type("robot").run(&G).nodes();
+        REQUIRE(nodes.size() == 1);
+        REQUIRE(nodes.front().id() == robot);
+    }
+
+    SECTION("Unknown start nodes give no results") {
+        REQUIRE(Query::node(0).out().run(&G).count() == 0);
+        REQUIRE(Query::name(random_string()).run(&G).count() == 0);
+        REQUIRE(Query::type("person").run(&G).count() == 0);
+    }
+
+    SECTION("The graph can be written after the result is released") {
+        auto r = Query::all().run(&G);
+        r.release();
+        REQUIRE(G.insert_node(Node::create<testtype_node_type>(random_string())).has_value());
+    }
+}
@@ -0,0 +1,77 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "dsr/core/id_generator.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("Id generation", "[NODE][ID]") {
+
+    id_generator generator(42);
+
+    SECTION("Ids carry the agent id and grow") {
+        uint64_t prev = 0;
+        for (int i = 0; i < 10000; i++)
+        {
+            auto id = generator.generate();
+            REQUIRE(id > prev);
+            REQUIRE(std::get<2>(id_generator::parse(id)) == 42);
+            prev = id;
+        }
+    }
+
+    SECTION("More ids than the counter holds in one period don't repeat") {
+        // 5 periods worth of ids, generated well under 50 ms.
+        auto ids = generator.generate_n(5 << counter_size);
+        REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+        REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+        auto next = generator.generate();
+        REQUIRE(next > ids.back());
+    }
+
+    SECTION("Large batches don't run ahead of the clock") {
+        // 200 periods worth of ids, twice the lead the generator allows.
+        auto ids = generator.generate_n(200 << counter_size);
+        const auto now = std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now());
+        const uint64_t period = now.time_since_epoch().count() / 10000000 - 1609459200000000000 / 10000000;
+        REQUIRE(ids.size() == 200 << counter_size);
+        REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+        REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+        REQUIRE(std::get<0>(id_generator::parse(ids.back())) <= period + 100);
+    }
+
+    SECTION("Concurrent generation") {
+        constexpr int threads = 8, per_thread = 20000;
+        std::vector<std::vector<uint64_t>> generated(threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < per_thread; i++)
+                {
+                    if (i % 10 == 0)
+                    {
+                        auto batch = generator.generate_n(10);
+                        generated[t].insert(generated[t].end(), batch.begin(), batch.end());
+                    }
+                    else
+                        generated[t].emplace_back(generator.generate());
+                }
+            });
+        for (auto &w : workers) w.join();
+
+        std::vector<uint64_t> all;
+        for (const auto &g : generated)
+        {
+            REQUIRE(std::is_sorted(g.begin(), g.end()));
+            all.insert(all.end(), g.begin(), g.end());
+        }
+        std::sort(all.begin(), all.end());
+        REQUIRE(std::adjacent_find(all.begin(), all.end()) == all.end());
+    }
+
+    SECTION("Invalid agent id") {
+        REQUIRE_THROWS(id_generator(1 << agent_id_size));
+    }
+}
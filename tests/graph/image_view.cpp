@@ -0,0 +1,92 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_image_view.h"
+#include "../utils.h"
+#include <cstring>
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+TEST_CASE("Camera image views", "[CAMERA]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+
+    constexpr int width = 4, height = 3;
+    auto n = Node::create<rgbd_node_type>(random_string());
+    G.add_or_modify_attrib_local<cam_rgb_width_att>(n, width);
+    G.add_or_modify_attrib_local<cam_rgb_height_att>(n, height);
+    G.add_or_modify_attrib_local<cam_rgb_depth_att>(n, 3);
+    G.add_or_modify_attrib_local<cam_rgb_focalx_att>(n, 100);
+    G.add_or_modify_attrib_local<cam_rgb_focaly_att>(n, 100);
+    G.add_or_modify_attrib_local<cam_depth_width_att>(n, width);
+    G.add_or_modify_attrib_local<cam_depth_height_att>(n, height);
+    std::vector<uint8_t> rgb(width * height * 3);
+    rgb[3 * (width + 1)] = 200;
+    std::vector<float> depth(width * height, 2.f);
+    depth[0] = 0.f;
+    std::vector<uint8_t> depth_bytes(depth.size() * sizeof(float));
+    std::memcpy(depth_bytes.data(), depth.data(), depth_bytes.size());
+    G.add_or_modify_attrib_local<cam_rgb_att>(n, rgb);
+    G.add_or_modify_attrib_local<cam_depth_att>(n, depth_bytes);
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+
+    SECTION("Views read the stored buffers") {
+        auto view = ImageView::rgb(&G, id.value());
+        REQUIRE(view.has_value());
+        REQUIRE(view->locked());
+        REQUIRE(view->format() == PixelFormat::RGB8);
+        REQUIRE(view->stride() == width * 3);
+        REQUIRE(view->pixels<uint8_t>()[3 * (width + 1)] == 200);
+        REQUIRE(view->pixels<float>().empty());
+        view->release();
+        REQUIRE_FALSE(view->locked());
+
+        auto d = ImageView::depth(&G, id.value());
+        REQUIRE(d.has_value());
+        REQUIRE(d->format() == PixelFormat::DEPTH32F);
+        REQUIRE(d->pixels<float>().size() == width * height);
+        REQUIRE(d->pixels<float>()[1] == 2.f);
+    }
+
+    SECTION("Copies do not lock the graph") {
+        auto view = ImageView::rgb(&G, id.value());
+        REQUIRE(view.has_value());
+        auto copy = view->copy();
+        view.reset();
+        REQUIRE_FALSE(copy.locked());
+        REQUIRE(copy.width() == width);
+        REQUIRE(copy.format() == PixelFormat::RGB8);
+
+        auto node = G.get_node(id.value());
+        REQUIRE(node.has_value());
+        G.add_or_modify_attrib_local<cam_rgb_att>(node.value(), std::vector<uint8_t>(width * height * 3, 7));
+        REQUIRE(G.update_node(node.value()));
+        REQUIRE(copy.pixels<uint8_t>()[3 * (width + 1)] == 200);
+        REQUIRE(ImageView::rgb(&G, id.value())->pixels<uint8_t>()[3 * (width + 1)] == 7);
+    }
+
+    SECTION("Invalid sizes give no view") {
+        auto node = G.get_node(id.value());
+        REQUIRE(node.has_value());
+        G.add_or_modify_attrib_local<cam_depth_width_att>(node.value(), width * 2);
+        REQUIRE(G.update_node(node.value()));
+        REQUIRE_FALSE(ImageView::depth(&G, id.value()).has_value());
+        REQUIRE_FALSE(ImageView::rgb(&G, id.value() + 1).has_value());
+    }
+
+    SECTION("Camera kernels read through the view") {
+        auto node = G.get_node(id.value());
+        auto camera = G.get_camera_api(node.value());
+        auto stats = camera->get_roi_depth_stats(Eigen::AlignedBox<float, 2>(Eigen::Vector2f(0, 0), Eigen::Vector2f(width, height)));
+        REQUIRE(stats.has_value());
+        REQUIRE(stats->valid == width * height - 1);
+        auto gray = camera->get_depth_as_gray_image();
+        REQUIRE(gray.has_value());
+        REQUIRE(gray->size() == width * height);
+        REQUIRE(gray->at(0) == 0);
+    }
+}
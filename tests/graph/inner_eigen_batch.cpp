@@ -0,0 +1,61 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+
+TEST_CASE("Batched InnerEigenAPI transforms", "[INNER EIGEN]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    auto robot = insert_rt_child(G, *rt, root->id(), {1000.f, 0.f, 0.f}, {0.f, 0.f, static_cast<float>(M_PI_2)});
+    auto camera = insert_rt_child(G, *rt, robot, {0.f, 0.f, 500.f});
+    auto object = insert_rt_child(G, *rt, root->id(), {0.f, 2000.f, 0.f});
+    auto robot_name = G.get_name_from_id(robot).value();
+    auto camera_name = G.get_name_from_id(camera).value();
+    auto object_name = G.get_name_from_id(object).value();
+
+    auto inner = G.get_inner_eigen_api();
+
+    SECTION("Points are transformed as with the single point call") {
+        Mat::Matrix3Xd points(3, 3);
+        points << 0, 100, -50,
+                  0, 200,  10,
+                  0,   0,  30;
+        auto batch = inner->transform(camera_name, points, object_name);
+        REQUIRE(batch.has_value());
+        for (int i = 0; i < points.cols(); i++)
+        {
+            auto single = inner->transform(camera_name, Mat::Vector3d(points.col(i)), object_name);
+            REQUIRE(single.has_value());
+            REQUIRE(batch->col(i).isApprox(single.value()));
+        }
+    }
+
+    SECTION("Poses of several nodes in one frame") {
+        auto poses = inner->get_poses(robot_name, {camera, object, 123456789});
+        REQUIRE(poses.has_value());
+        REQUIRE(poses->col(0).head(3).isApprox(Mat::Vector3d(0, 0, 500)));
+        REQUIRE(poses->col(1).head(3).isApprox(inner->transform(robot_name, object_name).value()));
+        REQUIRE(std::isnan((*poses)(0, 2)));
+    }
+
+    SECTION("World poses of a node type") {
+        auto [ids, poses] = inner->get_world_poses(std::string(testtype_node_type::attr_name));
+        REQUIRE(ids.size() == 3);
+        REQUIRE(poses.cols() == 3);
+        for (std::size_t i = 0; i < ids.size(); i++)
+        {
+            auto name = G.get_name_from_id(ids[i]).value();
+            REQUIRE(poses.col(i).head(3).isApprox(inner->transform("root", name).value()));
+        }
+    }
+}
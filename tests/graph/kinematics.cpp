@@ -0,0 +1,79 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_kinematics_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+
+TEST_CASE("Forward kinematics cache", "[KINEMATICS]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    auto base = insert_rt_child(G, *rt, root->id(), {1000.f, 0.f, 0.f}, {0.f, 0.f, static_cast<float>(M_PI_2)});
+    auto arm = insert_rt_child(G, *rt, base, {100.f, 0.f, 0.f});
+    auto hand = insert_rt_child(G, *rt, arm, {0.f, 0.f, 300.f});
+
+    auto fk = G.get_kinematics_api();
+    REQUIRE(fk->size() == 4);
+
+    SECTION("World poses are composed along the RT tree") {
+        auto w = fk->world_pose(hand);
+        REQUIRE(w.has_value());
+        REQUIRE(w->translation().isApprox(Mat::Vector3d(1000, 100, 300)));
+        REQUIRE(fk->world_pose(root->id())->isApprox(Eigen::Isometry3d::Identity()));
+        REQUIRE(fk->parent(hand) == arm);
+    }
+
+    SECTION("Relative poses match InnerEigenAPI") {
+        auto inner = G.get_inner_eigen_api();
+        auto rel = fk->relative_pose(base, hand);
+        REQUIRE(rel.has_value());
+        auto expected = inner->get_transformation_matrix(G.get_name_from_id(base).value(), G.get_name_from_id(hand).value());
+        REQUIRE(expected.has_value());
+        REQUIRE(rel->matrix().isApprox(expected->matrix()));
+    }
+
+    SECTION("Updating an RT edge moves the whole subtree") {
+        auto root_n = G.get_node_root();
+        rt->insert_or_assign_edge_RT(root_n.value(), base, {0.f, 0.f, 0.f}, {0.f, 0.f, 0.f});
+        auto w = fk->world_pose(hand);
+        REQUIRE(w.has_value());
+        REQUIRE(w->translation().isApprox(Mat::Vector3d(100, 0, 300)));
+        REQUIRE(fk->local_pose(hand)->translation().isApprox(Mat::Vector3d(0, 0, 300)));
+    }
+
+    SECTION("Deleting an RT edge disconnects the subtree") {
+        REQUIRE(G.delete_edge(base, arm, "RT"));
+        REQUIRE_FALSE(fk->world_pose(hand).has_value());
+        REQUIRE(fk->world_pose(base).has_value());
+
+        auto base_n = G.get_node(base);
+        rt->insert_or_assign_edge_RT(base_n.value(), arm, {100.f, 0.f, 0.f}, {0.f, 0.f, 0.f});
+        REQUIRE(fk->world_pose(hand).has_value());
+    }
+
+    SECTION("Deleting a node removes it from the cache") {
+        REQUIRE(G.delete_node(hand));
+        REQUIRE_FALSE(fk->world_pose(hand).has_value());
+        REQUIRE(fk->size() == 3);
+    }
+
+    SECTION("The slots of deleted nodes are reused") {
+        REQUIRE(G.delete_node(arm));
+        REQUIRE_FALSE(fk->world_pose(hand).has_value());
+        auto tool = insert_rt_child(G, *rt, hand, {0.f, 0.f, 10.f});
+        REQUIRE_FALSE(fk->world_pose(tool).has_value());
+        auto leg = insert_rt_child(G, *rt, base, {0.f, 0.f, -500.f});
+        auto w = fk->world_pose(leg);
+        REQUIRE(w.has_value());
+        REQUIRE(w->translation().isApprox(Mat::Vector3d(1000, 0, -500)));
+    }
+}
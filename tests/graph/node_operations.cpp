@@ -42,6 +42,28 @@ TEST_CASE("Graph node operations", "[NODE]") {
         REQUIRE(n_name.has_value());
     }
 
+    SECTION("Insert a batch of nodes") {
+        std::vector<Node> batch;
+        auto node_name = random_string();
+        batch.emplace_back(Node::create<testtype_node_type>(node_name));
+        for (int i = 0; i < 99; i++)
+            batch.emplace_back(Node::create<testtype_node_type>(""));
+        // The name is taken, the node is renamed as in insert_node.
+        batch.emplace_back(Node::create<testtype_node_type>(node_name));
+
+        auto ids = G.insert_nodes(batch);
+        REQUIRE(ids.size() == batch.size());
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            REQUIRE(batch[i].id() == ids[i]);
+            auto n = G.get_node(ids[i]);
+            REQUIRE(n.has_value());
+            REQUIRE(n->name() == batch[i].name());
+        }
+        REQUIRE(G.get_node(node_name)->id() == ids.front());
+        REQUIRE(batch.back().name() != node_name);
+    }
+
     SECTION("Create a node with an invalid type") {
         Node n;
         REQUIRE_THROWS(n.type(random_string(100)));
@@ -0,0 +1,86 @@
+#include "dsr/api/dsr_api.h"
+#include "../utils.h"
+#include <optional>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+TEST_CASE("RT edges with pose history", "[RT]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    rt->HISTORY_SIZE = 4;
+
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+    auto n = Node::create<testtype_node_type>(random_string());
+    auto id = G.insert_node(n);
+    REQUIRE(id.has_value());
+
+    // Six samples in a ring of four: slots 0 and 1 are overwritten and the head ends in slot 1.
+    for (int i = 0; i < 6; i++)
+    {
+        rt->insert_or_assign_edge_RT(root.value(), id.value(), {i * 100.f, 0.f, 0.f}, {0.f, 0.f, i * 0.1f});
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    auto edge = G.get_edge(root->id(), id.value(), "RT");
+    REQUIRE(edge.has_value());
+
+    SECTION("One attribute per slot and the last pose in rt_translation") {
+        REQUIRE(G.get_attrib_by_name<rt_head_index_att>(edge.value()) == 1);
+        REQUIRE(G.get_attrib_by_name<rt_history_size_att>(edge.value()) == 4);
+        auto t = G.get_attrib_by_name<rt_translation_att>(edge.value());
+        REQUIRE(t.has_value());
+        REQUIRE(t->get() == std::vector<float>{500.f, 0.f, 0.f});
+        for (uint32_t slot = 0; slot < 4; slot++)
+            REQUIRE(edge->attrs().contains(RT_API::history_slot_name(slot)));
+        REQUIRE_FALSE(edge->attrs().contains(RT_API::history_slot_name(4)));
+        REQUIRE_FALSE(edge->attrs().contains("rt_timestamps"));
+    }
+
+    SECTION("Timestamp 0 returns the last pose") {
+        auto m = rt->get_edge_RT_as_rtmat(edge.value());
+        REQUIRE(m.has_value());
+        REQUIRE(m->translation().isApprox(Mat::Vector3d(500, 0, 0)));
+    }
+
+    SECTION("Poses are interpolated between the closest samples") {
+        auto ms = [&](uint32_t slot) { return edge->attrs().at(RT_API::history_slot_name(slot)).timestamp() / 1000000; };
+        // Slots 2 and 3 hold the third and fourth samples.
+        auto m = rt->get_edge_RT_as_rtmat(edge.value(), (ms(2) + ms(3)) / 2);
+        REQUIRE(m.has_value());
+        REQUIRE(m->translation().x() > 200.0);
+        REQUIRE(m->translation().x() < 300.0);
+        auto angle = Eigen::AngleAxisd(m->rotation()).angle();
+        REQUIRE(angle > 0.2);
+        REQUIRE(angle < 0.3);
+
+        auto t = rt->get_translation(root->id(), id.value(), ms(2) - 1000);
+        REQUIRE(t.has_value());
+        REQUIRE(t->isApprox(Mat::Vector3d(200, 0, 0)));
+    }
+
+    SECTION("The history isn't used until every delta of an append has arrived") {
+        auto ms = [&](uint32_t slot) { return edge->attrs().at(RT_API::history_slot_name(slot)).timestamp() / 1000000; };
+        const uint64_t between = (ms(2) + ms(3)) / 2;
+        const uint64_t last = edge->attrs().at("rt_translation").timestamp();
+
+        // rt_head_index joined before its slot, which still holds the sample of the previous lap.
+        auto head_first = edge.value();
+        head_first.attrs().at("rt_head_index") = Attribute(2, last + 1000000, 0);
+        auto m = rt->get_edge_RT_as_rtmat(head_first, between);
+        REQUIRE(m.has_value());
+        REQUIRE(m->translation().isApprox(Mat::Vector3d(500, 0, 0)));
+
+        // The slot joined before rt_head_index and the current pose, it is newer than the head.
+        auto slot_first = edge.value();
+        slot_first.attrs().at(RT_API::history_slot_name(2)) = Attribute(std::array<float, 6>{600.f, 0.f, 0.f, 0.f, 0.f, 0.6f}, last + 1000000, 0);
+        m = rt->get_edge_RT_as_rtmat(slot_first, between);
+        REQUIRE(m.has_value());
+        REQUIRE(m->translation().isApprox(Mat::Vector3d(500, 0, 0)));
+    }
+}
@@ -0,0 +1,65 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_spatial_index_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+
+TEST_CASE("Spatial index over RT poses", "[SPATIAL INDEX]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto rt = G.get_rt_api();
+    auto root = G.get_node_root();
+    REQUIRE(root.has_value());
+
+    auto near = insert_rt_child(G, *rt, root->id(), {100.f, 0.f, 0.f});
+    auto far = insert_rt_child(G, *rt, root->id(), {5000.f, 0.f, 0.f});
+    auto child = insert_rt_child(G, *rt, far, {0.f, 100.f, 0.f});
+
+    auto index = G.get_spatial_index_api();
+
+    SECTION("World poses are composed along the RT tree") {
+        auto p = index->get_world_position(child);
+        REQUIRE(p.has_value());
+        REQUIRE(p->isApprox(Mat::Vector3d(5000, 100, 0)));
+    }
+
+    SECTION("Nearest, radius and box queries") {
+        auto k = index->nearest(Mat::Vector3d(0, 0, 0), 1, std::string(testtype_node_type::attr_name));
+        REQUIRE(k.size() == 1);
+        REQUIRE(k[0].id == near);
+
+        auto r = index->radius(Mat::Vector3d(5000, 0, 0), 150, std::string(testtype_node_type::attr_name));
+        REQUIRE(r.size() == 2);
+        REQUIRE(r[0].id == far);
+        REQUIRE(r[1].id == child);
+
+        auto b = index->box_query(Mat::Vector3d(-10, -10, -10), Mat::Vector3d(200, 10, 10));
+        REQUIRE(b.size() == 1);
+        REQUIRE(b[0].id == near);
+    }
+
+    SECTION("Moving an RT edge updates the whole subtree") {
+        auto root_n = G.get_node_root();
+        rt->insert_or_assign_edge_RT(root_n.value(), far, {0.f, 0.f, 0.f}, {0.f, 0.f, 0.f});
+        index->add_or_assign_edge_slot(root_n->id(), far, "RT");
+        auto p = index->get_world_position(child);
+        REQUIRE(p.has_value());
+        REQUIRE(p->isApprox(Mat::Vector3d(0, 100, 0)));
+        auto k = index->nearest(Mat::Vector3d(0, 100, 0), 1);
+        REQUIRE(k[0].id == child);
+    }
+
+    SECTION("Deleting a node removes it from the index") {
+        REQUIRE(G.delete_node(child));
+        index->del_node_slot(child);
+        REQUIRE(not index->get_world_position(child).has_value());
+        auto r = index->radius(Mat::Vector3d(5000, 100, 0), 10);
+        REQUIRE(r.empty());
+    }
+}
@@ -0,0 +1,92 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_wait_api.h"
+#include "../utils.h"
+#include <optional>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+static DetachedTask await_node(DSRGraph *G, std::string type, std::optional<Node> *out, bool *resumed)
+{
+    *out = co_await G->wait_for_node(type);
+    *resumed = true;
+}
+
+static DetachedTask await_edge(DSRGraph *G, uint64_t from, uint64_t to, std::optional<Edge> *out)
+{
+    *out = co_await G->wait_for_edge(from, to, "in");
+}
+
+static DetachedTask await_level(DSRGraph *G, uint64_t id, int level, std::optional<int> *out)
+{
+    *out = co_await G->wait_for_attr<level_att>(id, [level](int v) { return v >= level; });
+}
+
+TEST_CASE("Awaitable graph conditions", "[GRAPH][WAIT]") {
+
+    auto filename = make_empty_config_file();
+    DSRGraph G(random_string(10), rand() % 1200, filename);
+
+    SECTION("wait_for_node resumes when a node of the type is inserted") {
+        std::optional<Node> got;
+        bool resumed = false;
+        await_node(&G, "testtype", &got, &resumed);
+        REQUIRE_FALSE(resumed);
+        REQUIRE(G.get_wait_api().pending() == 1);
+
+        auto id = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        REQUIRE(id.has_value());
+        REQUIRE(resumed);
+        REQUIRE(got.has_value());
+        REQUIRE(got->id() == id.value());
+        REQUIRE(G.get_wait_api().pending() == 0);
+
+        // The condition already holds, so the coroutine does not suspend.
+        resumed = false;
+        await_node(&G, "testtype", &got, &resumed);
+        REQUIRE(resumed);
+    }
+
+    SECTION("wait_for_edge resumes when the edge is inserted") {
+        auto a = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        auto b = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        REQUIRE((a.has_value() and b.has_value()));
+        std::optional<Edge> got;
+        await_edge(&G, a.value(), b.value(), &got);
+        REQUIRE_FALSE(got.has_value());
+        REQUIRE(G.insert_or_assign_edge(Edge::create<in_edge_type>(a.value(), b.value())));
+        REQUIRE(got.has_value());
+        REQUIRE(got->to() == b.value());
+    }
+
+    SECTION("wait_for_attr resumes only when the predicate holds") {
+        auto id = G.insert_node(Node::create<testtype_node_type>(random_string()));
+        REQUIRE(id.has_value());
+        std::optional<int> got;
+        await_level(&G, id.value(), 3, &got);
+        for (int i = 0; i < 5; i++)
+        {
+            auto n = G.get_node(id.value());
+            G.add_or_modify_attrib_local<level_att>(n.value(), i);
+            REQUIRE(G.update_node(n.value()));
+            if (i < 3) REQUIRE_FALSE(got.has_value());
+        }
+        REQUIRE(got == 3);
+    }
+
+    SECTION("Pending waiters are resumed with an empty value when the WaitAPI is destroyed") {
+        auto api = std::make_unique<WaitAPI>(&G);
+        std::optional<Node> got = Node::create<testtype_node_type>("dummy");
+        bool resumed = false;
+        [](WaitAPI *w, std::optional<Node> *out, bool *r) -> DetachedTask {
+            *out = co_await w->wait_for_node("never_inserted");
+            *r = true;
+        }(api.get(), &got, &resumed);
+        REQUIRE_FALSE(resumed);
+        api.reset();
+        REQUIRE(resumed);
+        REQUIRE_FALSE(got.has_value());
+    }
+}
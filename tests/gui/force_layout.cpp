@@ -0,0 +1,87 @@
+#include "dsr/gui/viewers/graph_viewer/force_layout.h"
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR;
+
+
+static ForceLayoutState make_random_tree_layout(std::size_t n)
+{
+    std::mt19937 mt(n);
+    std::uniform_real_distribution<float> unif_dist(-300, 300);
+    ForceLayoutState state;
+    state.positions.resize(2 * n);
+    for (auto &p : state.positions) p = unif_dist(mt);
+    for (uint32_t i = 1; i < n; i++)
+        state.edges.emplace_back(i, std::uniform_int_distribution<uint32_t>(0, i - 1)(mt));
+    return state;
+}
+
+
+TEST_CASE("Barnes-Hut force layout", "[GUI][LAYOUT]") {
+
+    SECTION("Barnes-Hut approximation stays close to the exact sum") {
+        auto approx = make_random_tree_layout(500);
+        auto exact = approx;
+        exact.params.theta = 0.f;
+        ForceLayout layout;
+        layout.step(approx);
+        layout.step(exact);
+        double max_error = 0;
+        for (std::size_t i = 0; i < approx.positions.size(); i++)
+            max_error = std::max<double>(max_error, std::abs(approx.positions[i] - exact.positions[i]));
+        REQUIRE(max_error < 5.0);
+    }
+
+    SECTION("A tree converges without overlapping nodes") {
+        constexpr std::size_t n = 100;
+        auto state = make_random_tree_layout(n);
+        ForceLayout layout;
+        int steps = 0;
+        while (layout.step(state) and steps < 2000) steps++;
+        REQUIRE(steps < 2000);
+
+        float min_distance = std::numeric_limits<float>::max();
+        for (std::size_t i = 0; i < n; i++)
+            for (std::size_t j = i + 1; j < n; j++)
+                min_distance = std::min(min_distance, std::hypot(state.positions[2*i] - state.positions[2*j],
+                                                                 state.positions[2*i+1] - state.positions[2*j+1]));
+        REQUIRE(min_distance > 20.f);   // GraphNode::DEFAULT_DIAMETER
+    }
+
+    SECTION("Positions are clamped to the scene rect") {
+        auto state = make_random_tree_layout(50);
+        state.params.left = state.params.top = -100.f;
+        state.params.right = state.params.bottom = 100.f;
+        ForceLayout layout;
+        for (int i = 0; i < 10; i++) layout.step(state);
+        for (auto p : state.positions)
+            REQUIRE((p >= -90.f and p <= 90.f));
+    }
+
+    SECTION("Pinned nodes do not move") {
+        auto state = make_random_tree_layout(100);
+        state.pinned.assign(state.size(), 1);
+        auto before = state.positions;
+        ForceLayout layout;
+        REQUIRE(!layout.step(state));
+        REQUIRE(before == state.positions);
+    }
+
+    SECTION("The worker thread computes the same step") {
+        auto state = make_random_tree_layout(200);
+        ForceLayoutWorker worker;
+        worker.submit(ForceLayoutState(state));
+        ForceLayout layout;
+        const bool moved = layout.step(state);
+        std::optional<std::pair<ForceLayoutState, bool>> result;
+        while (not (result = worker.take_result()).has_value()) std::this_thread::yield();
+        REQUIRE(result->second == moved);
+        REQUIRE(result->first.positions == state.positions);
+    }
+}
@@ -0,0 +1,52 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/gui/viewers/graph_update_dispatcher.h"
+#include "../utils.h"
+#include <map>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+
+TEST_CASE("GUI update dispatcher coalesces graph signals", "[GRAPH][SIGNALS][GUI]") {
+
+    auto filename = make_empty_config_file();
+    DSR::DSRGraph G(random_string(10), rand() % 1200, filename);
+    DSR::GraphUpdateDispatcher dispatcher(&G);
+
+    std::map<uint64_t, int> updates;
+    std::vector<uint64_t> deleted;
+    QObject::connect(&dispatcher, &DSR::GraphUpdateDispatcher::update_node_signal, [&](uint64_t id, const std::string &) { updates[id]++; });
+    QObject::connect(&dispatcher, &DSR::GraphUpdateDispatcher::del_node_signal, [&](uint64_t id) { deleted.push_back(id); });
+
+    auto node = DSR::Node::create<testtype_node_type>(random_string());
+    auto id = G.insert_node(node);
+    REQUIRE(id.has_value());
+    dispatcher.flush();
+    updates.clear();
+
+    SECTION("Several updates of the same node are delivered once") {
+        auto n = G.get_node(id.value());
+        REQUIRE(n.has_value());
+        for (int i = 0; i < 10; i++)
+        {
+            G.add_or_modify_attrib_local<level_att>(n.value(), i);
+            REQUIRE(G.update_node(n.value()));
+        }
+        dispatcher.flush();
+        REQUIRE(updates[id.value()] == 1);
+        REQUIRE(dispatcher.stats().merged >= 9);
+        REQUIRE(dispatcher.pending() == 0);
+    }
+
+    SECTION("Deleting a node discards its pending updates") {
+        auto n = G.get_node(id.value());
+        REQUIRE(n.has_value());
+        G.add_or_modify_attrib_local<level_att>(n.value(), 1);
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(G.delete_node(id.value()));
+        dispatcher.flush();
+        REQUIRE(updates.count(id.value()) == 0);
+        REQUIRE(deleted == std::vector<uint64_t>{id.value()});
+        REQUIRE(dispatcher.stats().dropped >= 1);
+    }
+}
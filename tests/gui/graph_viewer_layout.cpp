@@ -0,0 +1,72 @@
+#include "dsr/api/dsr_api.h"
+#include "dsr/gui/viewers/graph_viewer/graph_node.h"
+#include "dsr/gui/viewers/graph_viewer/graph_viewer.h"
+#include "../utils.h"
+#include <chrono>
+#include <map>
+#include <thread>
+#include <QApplication>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace std::chrono_literals;
+
+
+// Runs the steps of the layout timer without waiting for it.
+class LayoutStepViewer : public DSR::GraphViewer
+{
+public:
+    using DSR::GraphViewer::GraphViewer;
+    void step() { timerEvent(nullptr); }
+};
+
+static QApplication &gui_application()
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    static int argc = 1;
+    static char name[] = "tests";
+    static char *argv[] = {name, nullptr};
+    static QApplication app(argc, argv);
+    return app;
+}
+
+static std::map<uint64_t, QPointF> node_positions(const DSR::GraphViewer &viewer)
+{
+    std::map<uint64_t, QPointF> positions;
+    for (const auto &[id, node] : viewer.getGMap()) positions.emplace(id, node->pos());
+    return positions;
+}
+
+
+TEST_CASE("Threaded graph viewer layout", "[GUI][LAYOUT]") {
+
+    gui_application();
+    auto filename = make_empty_config_file();
+    auto G = std::make_shared<DSR::DSRGraph>(random_string(10), rand() % 1200, filename);
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 20; i++)
+    {
+        auto id = G->insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        REQUIRE(id.has_value());
+        ids.push_back(id.value());
+    }
+
+    // The viewer owns itself, like the ones created by DSRViewer.
+    auto *viewer = new LayoutStepViewer(G);
+    viewer->set_threaded_layout(true);
+
+    SECTION("A step computed before a node is deleted is discarded") {
+        viewer->step();     // the worker gets a snapshot with every node
+        viewer->del_node_SLOT(ids.front());
+        REQUIRE(viewer->getGMap().size() == ids.size());   // root and the rest of the nodes
+        std::this_thread::sleep_for(500ms);
+
+        const auto before = node_positions(*viewer);
+        viewer->step();     // takes the stale result, it must not touch the deleted node
+        REQUIRE(node_positions(*viewer) == before);
+
+        std::this_thread::sleep_for(500ms);
+        viewer->step();     // the step for the current scene is applied
+        REQUIRE(node_positions(*viewer) != before);
+    }
+}
@@ -0,0 +1,52 @@
+#include "dsr/gui/viewers/graph_viewer/rgbd_image_utils.h"
+#include <cmath>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+using namespace DSR::image;
+
+
+TEST_CASE("RGBD widget image conversion", "[GUI][IMAGE]") {
+
+    SECTION("Downsampling step") {
+        REQUIRE(downsample_step(640, 640) == 1);
+        REQUIRE(downsample_step(1280, 640) == 2);
+        REQUIRE(downsample_step(1281, 640) == 3);
+        REQUIRE(downsample_step(1280, 0) == 1);
+    }
+
+    SECTION("Invalid depth values are written as 0") {
+        std::vector<float> depth = {0.f, NAN, 1.f, 3.f, INFINITY, 2.f, -1.f, 3.f};
+        auto range = depth_range(depth.data(), 4, 2, 1);
+        REQUIRE(range.min == 1.f);
+        REQUIRE(range.max == 3.f);
+
+        std::vector<uint8_t> out(8, 1);
+        depth_to_gray(depth.data(), 4, 2, 1, range, out.data(), 4);
+        REQUIRE(out == std::vector<uint8_t>{0, 0, 0, 255, 0, 127, 0, 255});
+    }
+
+    SECTION("Depth is decimated into a padded output") {
+        std::vector<float> depth = {1.f, 0.f, 3.f, 0.f,
+                                    0.f, 0.f, 0.f, 0.f};
+        std::vector<uint8_t> out(2 * 4, 1);    // one row of 2 pixels in a stride of 4
+        depth_to_gray(depth.data(), 4, 2, 2, {1.f, 3.f}, out.data(), 4);
+        REQUIRE(out[0] == 0);
+        REQUIRE(out[1] == 255);
+        REQUIRE(out[2] == 1);   // padding is not written
+    }
+
+    SECTION("RGB downsampling keeps one pixel out of step") {
+        constexpr int width = 4, height = 2;
+        std::vector<uint8_t> rgb(width * height * 3);
+        for (std::size_t i = 0; i < rgb.size(); i++) rgb[i] = static_cast<uint8_t>(i);
+
+        std::vector<uint8_t> out(width * height * 3);
+        downsample_rgb(rgb.data(), width, height, 1, out.data(), width * 3);
+        REQUIRE(out == rgb);
+
+        downsample_rgb(rgb.data(), width, height, 2, out.data(), 6);
+        REQUIRE(std::vector<uint8_t>(out.begin(), out.begin() + 6) == std::vector<uint8_t>{0, 1, 2, 6, 7, 8});
+    }
+}
@@ -0,0 +1,444 @@
+//
+// Multi-agent convergence stress harness.
+//
+// Starts N replicas of the graph in this process, connected through the loopback transport or through
+// Fast DDS on localhost, and has every agent write a mix of operations at a fixed rate. While it runs it
+// compares the digests of the replicas and samples the backlog of deltas waiting for their node or edge.
+// At the end it reports the propagation latency of each kind of operation and how long the replicas take
+// to converge once the writers stop.
+//
+//   dsr_stress --agents=16 --seconds=20 --rate=200 --mix=3,5,1,1 --transport=loopback
+//
+
+#include "dsr/api/dsr_api.h"
+#include "dsr/core/rtps/loopback_transport.h"
+#include "../utils.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace DSR;
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    enum Op { INSERT, UPDATE, RT, DELETE, OP_COUNT };
+    constexpr std::array<const char *, OP_COUNT> op_names {"insert_node", "update_node", "insert_or_assign_edge_RT", "delete_node"};
+    constexpr std::size_t MAX_AGENTS = 64;                 // receivers are tracked in a 64 bit mask
+    constexpr std::size_t MAX_TRACKED = 1u << 24;          // sequence numbers travel as the x of RT translations
+
+    struct Options
+    {
+        std::size_t agents = 10;
+        double seconds = 10.0;
+        double rate = 100.0;                               // operations per second of each agent
+        std::array<int, OP_COUNT> mix {3, 5, 1, 1};
+        int report_ms = 1000;
+        bool dds = false;
+        unsigned seed = 1;
+    };
+
+    bool parse_options(int argc, char *argv[], Options &o)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view arg(argv[i]);
+            auto value = [&](std::string_view key) -> std::optional<std::string_view> {
+                if (arg.starts_with(key) and arg.size() > key.size() and arg[key.size()] == '=') return arg.substr(key.size() + 1);
+                return {};
+            };
+            auto number = [](std::string_view s, auto &out) {
+                return std::from_chars(s.data(), s.data() + s.size(), out).ec == std::errc();
+            };
+
+            bool ok = true;
+            if (auto v = value("--agents")) ok = number(*v, o.agents) and o.agents >= 2 and o.agents <= MAX_AGENTS;
+            else if (auto v = value("--seconds")) ok = number(*v, o.seconds) and o.seconds > 0;
+            else if (auto v = value("--rate")) ok = number(*v, o.rate) and o.rate > 0;
+            else if (auto v = value("--report-ms")) ok = number(*v, o.report_ms) and o.report_ms > 0;
+            else if (auto v = value("--seed")) ok = number(*v, o.seed);
+            else if (auto v = value("--transport")) { ok = *v == "loopback" or *v == "dds"; o.dds = *v == "dds"; }
+            else if (auto v = value("--mix"))
+            {
+                std::string_view rest = *v;
+                for (int k = 0; k < OP_COUNT and ok; k++)
+                {
+                    auto comma = rest.find(',');
+                    ok = number(rest.substr(0, comma), o.mix[k]) and o.mix[k] >= 0 and (k == OP_COUNT - 1) == (comma == std::string_view::npos);
+                    if (comma != std::string_view::npos) rest.remove_prefix(comma + 1);
+                }
+                ok = ok and o.mix[INSERT] > 0;
+            }
+            else ok = false;
+
+            if (not ok)
+            {
+                std::cerr << "Usage: " << argv[0] << " [--agents=2.." << MAX_AGENTS << "] [--seconds=S] [--rate=ops/s per agent]\n"
+                          << "       [--mix=insert,update,rt,delete] [--report-ms=MS] [--transport=loopback|dds] [--seed=N]\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //
+    // Send time of each operation and the replicas that have applied it. The sequence number of an
+    // operation travels in the graph: obj_id of the node for inserts and updates, x of the translation
+    // for RT edges. Deletes are looked up by node id.
+    //
+    class Tracker
+    {
+    public:
+        explicit Tracker(std::size_t capacity, std::size_t agents_)
+            : entries(std::min(capacity, MAX_TRACKED)), agents(agents_) {}
+
+        // 0 when the operation is not tracked.
+        uint32_t begin(Op op, std::size_t writer)
+        {
+            auto seq = next.fetch_add(1, std::memory_order_relaxed);
+            if (seq >= entries.size()) return 0;
+            auto &e = entries[seq];
+            e.op = op;
+            e.writer = writer;
+            e.sent_ns.store(now_ns(), std::memory_order_release);
+            issued[op].fetch_add(1, std::memory_order_relaxed);
+            return seq;
+        }
+
+        void failed(Op op) { failures[op].fetch_add(1, std::memory_order_relaxed); }
+
+        void arrived(int64_t seq, std::size_t receiver)
+        {
+            if (seq <= 0 or static_cast<std::size_t>(seq) >= entries.size()) return;
+            auto &e = entries[seq];
+            const auto sent = e.sent_ns.load(std::memory_order_acquire);
+            if (sent == 0 or e.writer == receiver) return;
+            const uint64_t bit = uint64_t{1} << receiver;
+            const auto before = e.seen.fetch_or(bit, std::memory_order_acq_rel);
+            if (before & bit) return;
+
+            const double ms = static_cast<double>(now_ns() - sent) / 1e6;
+            std::unique_lock lck(mtx);
+            latencies[e.op].emplace_back(ms);
+            if (std::popcount(before | bit) == static_cast<int>(agents - 1)) complete[e.op]++;
+        }
+
+        void report() const
+        {
+            std::unique_lock lck(mtx);
+            std::printf("\n%-26s %8s %8s %10s %9s %9s %9s %9s\n", "operation", "issued", "failed", "complete",
+                        "p50 ms", "p90 ms", "p99 ms", "max ms");
+            for (int op = 0; op < OP_COUNT; op++)
+            {
+                auto l = latencies[op];
+                std::sort(l.begin(), l.end());
+                auto pct = [&](double p) { return l.empty() ? 0.0 : l[std::min(l.size() - 1, static_cast<std::size_t>(p * l.size()))]; };
+                std::printf("%-26s %8lu %8lu %10lu %9.2f %9.2f %9.2f %9.2f\n", op_names[op],
+                            static_cast<unsigned long>(issued[op].load()), static_cast<unsigned long>(failures[op].load()),
+                            static_cast<unsigned long>(complete[op]), pct(0.5), pct(0.9), pct(0.99), l.empty() ? 0.0 : l.back());
+            }
+            std::printf("(latency of each operation to each other replica, complete = applied by all of them)\n");
+        }
+
+        static int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        struct Entry
+        {
+            std::atomic<int64_t> sent_ns{0};
+            std::atomic<uint64_t> seen{0};
+            Op op = INSERT;
+            std::size_t writer = 0;
+        };
+
+        std::vector<Entry> entries;
+        std::size_t agents;
+        std::atomic<uint32_t> next{1};
+        std::array<std::atomic<uint64_t>, OP_COUNT> issued{};
+        std::array<std::atomic<uint64_t>, OP_COUNT> failures{};
+
+        mutable std::mutex mtx;
+        std::array<std::vector<double>, OP_COUNT> latencies;
+        std::array<uint64_t, OP_COUNT> complete{};
+    };
+
+    void hash_combine(uint64_t &seed, uint64_t v)
+    {
+        seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    uint64_t hash_value(const ValType &v)
+    {
+        uint64_t h = v.index();
+        std::visit([&](const auto &x) {
+            using T = std::decay_t<decltype(x)>;
+            if constexpr (std::is_same_v<T, std::string>) hash_combine(h, std::hash<std::string>{}(x));
+            else if constexpr (std::is_arithmetic_v<T>) hash_combine(h, std::hash<T>{}(x));
+            else for (const auto &e : x)
+            {
+                if constexpr (std::is_arithmetic_v<std::decay_t<decltype(e)>>) hash_combine(h, std::hash<std::decay_t<decltype(e)>>{}(e));
+                else for (auto c : e) hash_combine(h, std::hash<std::decay_t<decltype(c)>>{}(c));
+            }
+        }, v);
+        return h;
+    }
+
+    // Digest of the values of the replica, equal digests mean converged replicas.
+    uint64_t digest(DSRGraph &G)
+    {
+        uint64_t h = 0;
+        for (const auto &[id, node] : G.getCopy())
+        {
+            hash_combine(h, id);
+            hash_combine(h, std::hash<std::string>{}(node.type()));
+            hash_combine(h, std::hash<std::string>{}(node.name()));
+            for (const auto &[name, att] : node.attrs())
+            {
+                hash_combine(h, std::hash<std::string>{}(name));
+                hash_combine(h, hash_value(att.value()));
+            }
+            for (const auto &[key, edge] : node.fano())
+            {
+                hash_combine(h, key.first);
+                hash_combine(h, std::hash<std::string>{}(key.second));
+                for (const auto &[name, att] : edge.attrs())
+                {
+                    hash_combine(h, std::hash<std::string>{}(name));
+                    hash_combine(h, hash_value(att.value()));
+                }
+            }
+        }
+        return h;
+    }
+
+    std::size_t distinct_digests(std::vector<std::unique_ptr<DSRGraph>> &graphs)
+    {
+        std::unordered_set<uint64_t> d;
+        for (auto &g : graphs) d.insert(digest(*g));
+        return d.size();
+    }
+
+    void connect_receiver(DSRGraph *g, std::size_t index, Tracker &tracker,
+                          std::mutex &deletes_mtx, std::unordered_map<uint64_t, uint32_t> &deletes)
+    {
+        QObject::connect(g, &DSRGraph::update_node_signal, g, [=, &tracker](uint64_t id, const std::string &type, SignalInfo) {
+            if (type != "testtype") return;
+            if (auto seq = g->get_attrib_by_name<obj_id_att>(id); seq.has_value()) tracker.arrived(seq.value(), index);
+        }, Qt::DirectConnection);
+        QObject::connect(g, &DSRGraph::update_edge_signal, g, [=, &tracker](uint64_t from, uint64_t to, const std::string &type, SignalInfo) {
+            if (type != "RT") return;
+            auto edge = g->get_edge(from, to, "RT");
+            if (not edge.has_value()) return;
+            if (auto t = g->get_attrib_by_name<rt_translation_att>(edge.value()); t.has_value() and not t->get().empty())
+                tracker.arrived(static_cast<int64_t>(t->get()[0]), index);
+        }, Qt::DirectConnection);
+        QObject::connect(g, &DSRGraph::del_node_signal, g, [=, &tracker, &deletes_mtx, &deletes](uint64_t id, SignalInfo) {
+            uint32_t seq = 0;
+            {
+                std::unique_lock lck(deletes_mtx);
+                if (auto it = deletes.find(id); it != deletes.end()) seq = it->second;
+            }
+            tracker.arrived(seq, index);
+        }, Qt::DirectConnection);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    Options opt;
+    if (not parse_options(argc, argv, opt)) return 1;
+    srand(opt.seed);
+
+    // Replicas
+    std::shared_ptr<LoopbackDomain> domain;
+    std::vector<std::unique_ptr<DSRGraph>> graphs;
+    const auto config = make_empty_config_file();
+    const uint32_t first_id = opt.dds ? static_cast<uint32_t>(rand() % 1000 * 100) : 1;
+    if (not opt.dds) domain = LoopbackDomain::create();
+    for (std::size_t a = 0; a < opt.agents; a++)
+    {
+        const auto name = "stress_agent_" + std::to_string(a);
+        const auto &file = a == 0 ? config : std::string();
+        if (opt.dds) graphs.emplace_back(std::make_unique<DSRGraph>(name, first_id + a, file));
+        else graphs.emplace_back(std::make_unique<DSRGraph>(name, first_id + a, file, domain->connect()));
+    }
+    if (opt.dds) std::this_thread::sleep_for(500ms);
+    std::printf("%zu replicas over %s, %.0f ops/s per agent for %.1f s, mix insert:update:rt:delete = %d:%d:%d:%d\n",
+                opt.agents, opt.dds ? "Fast DDS (localhost)" : "the loopback transport", opt.rate, opt.seconds,
+                opt.mix[INSERT], opt.mix[UPDATE], opt.mix[RT], opt.mix[DELETE]);
+
+    Tracker tracker(static_cast<std::size_t>(opt.agents * opt.rate * opt.seconds * 1.2) + 1024, opt.agents);
+    std::mutex deletes_mtx;
+    std::unordered_map<uint64_t, uint32_t> deletes;
+    for (std::size_t a = 0; a < opt.agents; a++)
+        connect_receiver(graphs[a].get(), a, tracker, deletes_mtx, deletes);
+
+    // Nodes of every agent, updates also touch the nodes of the others.
+    std::mutex known_mtx;
+    std::vector<uint64_t> known;
+
+    // Writers
+    std::atomic<bool> running{true};
+    std::vector<std::thread> writers;
+    for (std::size_t a = 0; a < opt.agents; a++)
+    {
+        writers.emplace_back([&, a]() {
+            auto &G = *graphs[a];
+            auto rt = G.get_rt_api();
+            std::mt19937 rng(opt.seed * 7919 + a);
+            std::discrete_distribution<int> pick_op(opt.mix.begin(), opt.mix.end());
+            std::uniform_real_distribution<float> coord(-5000.f, 5000.f);
+            std::vector<uint64_t> own;
+            uint64_t inserted = 0;
+
+            const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / opt.rate));
+            auto next_tick = Clock::now();
+            while (running.load(std::memory_order_relaxed))
+            {
+                next_tick += period;
+                std::this_thread::sleep_until(next_tick);
+
+                auto op = static_cast<Op>(pick_op(rng));
+                if (own.empty()) op = INSERT;
+                auto any_node = [&]() {
+                    std::unique_lock lck(known_mtx);
+                    return known[std::uniform_int_distribution<std::size_t>(0, known.size() - 1)(rng)];
+                };
+                auto own_node = [&]() { return std::uniform_int_distribution<std::size_t>(0, own.size() - 1)(rng); };
+
+                const auto seq = tracker.begin(op, a);
+                bool ok = false;
+                switch (op)
+                {
+                    case INSERT:
+                    {
+                        auto n = Node::create<testtype_node_type>("stress_" + std::to_string(a) + "_" + std::to_string(inserted++));
+                        G.add_or_modify_attrib_local<obj_id_att>(n, static_cast<int>(seq));
+                        G.add_or_modify_attrib_local<pos_x_att>(n, coord(rng));
+                        G.add_or_modify_attrib_local<pos_y_att>(n, coord(rng));
+                        if (auto id = G.insert_node(n); id.has_value())
+                        {
+                            own.emplace_back(id.value());
+                            std::unique_lock lck(known_mtx);
+                            known.emplace_back(id.value());
+                            ok = true;
+                        }
+                        break;
+                    }
+                    case UPDATE:
+                        if (auto n = G.get_node(any_node()); n.has_value())
+                        {
+                            G.add_or_modify_attrib_local<obj_id_att>(n.value(), static_cast<int>(seq));
+                            G.add_or_modify_attrib_local<pos_x_att>(n.value(), coord(rng));
+                            ok = G.update_node(n.value());
+                        }
+                        break;
+                    case RT:
+                        if (auto root = G.get_node_root(); root.has_value())
+                        {
+                            rt->insert_or_assign_edge_RT(root.value(), own[own_node()], {static_cast<float>(seq), coord(rng), 0.f}, {0.f, 0.f, 0.5f});
+                            ok = true;
+                        }
+                        break;
+                    case DELETE:
+                    {
+                        const auto i = own_node();
+                        {
+                            std::unique_lock lck(deletes_mtx);
+                            deletes[own[i]] = seq;
+                        }
+                        ok = G.delete_node(own[i]);
+                        own[i] = own.back();
+                        own.pop_back();
+                        break;
+                    }
+                    default: break;
+                }
+                if (not ok) tracker.failed(op);
+            }
+        });
+    }
+
+    // Monitor
+    DSRGraph::DeltaBacklog max_backlog;
+    auto sample_backlog = [&]() {
+        for (auto &g : graphs)
+        {
+            auto b = g->delta_backlog();
+            max_backlog.node_attrs = std::max(max_backlog.node_attrs, b.node_attrs);
+            max_backlog.edges_from = std::max(max_backlog.edges_from, b.edges_from);
+            max_backlog.edges_to = std::max(max_backlog.edges_to, b.edges_to);
+            max_backlog.edge_attrs = std::max(max_backlog.edge_attrs, b.edge_attrs);
+        }
+    };
+
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt.seconds));
+    auto next_report = start + std::chrono::milliseconds(opt.report_ms);
+    while (Clock::now() < end)
+    {
+        std::this_thread::sleep_for(50ms);
+        sample_backlog();
+        if (Clock::now() >= next_report)
+        {
+            next_report += std::chrono::milliseconds(opt.report_ms);
+            std::size_t min_size = SIZE_MAX, max_size = 0;
+            for (auto &g : graphs)
+            {
+                min_size = std::min(min_size, g->size());
+                max_size = std::max(max_size, g->size());
+            }
+            std::printf("t=%6.1fs  nodes %zu..%zu  distinct digests %zu  max backlog node_attrs=%zu edges_from=%zu edges_to=%zu edge_attrs=%zu\n",
+                        std::chrono::duration<double>(Clock::now() - start).count(), min_size, max_size,
+                        distinct_digests(graphs), max_backlog.node_attrs, max_backlog.edges_from,
+                        max_backlog.edges_to, max_backlog.edge_attrs);
+            std::fflush(stdout);
+        }
+    }
+    running = false;
+    for (auto &w : writers) w.join();
+
+    // Convergence once the writers stop.
+    const auto stop = Clock::now();
+    bool converged = false;
+    while (Clock::now() - stop < 30s)
+    {
+        sample_backlog();
+        if (distinct_digests(graphs) == 1)
+        {
+            converged = true;
+            break;
+        }
+        std::this_thread::sleep_for(20ms);
+    }
+    const auto convergence = std::chrono::duration<double, std::milli>(Clock::now() - stop).count();
+    const auto elapsed = std::chrono::duration<double>(stop - start).count();
+
+    tracker.report();
+    if (converged) std::printf("\nTime to convergence after the last write: %.1f ms\n", convergence);
+    else std::printf("\nReplicas did not converge %.0f ms after the last write\n", convergence);
+    std::printf("Max unprocessed deltas: node_attrs=%zu edges_from=%zu edges_to=%zu edge_attrs=%zu\n",
+                max_backlog.node_attrs, max_backlog.edges_from, max_backlog.edges_to, max_backlog.edge_attrs);
+    std::printf("Nodes in the first replica: %zu, run time %.1f s\n", graphs.front()->size(), elapsed);
+
+    graphs.clear();
+    return converged ? 0 : 2;
+}
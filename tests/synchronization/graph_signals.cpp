@@ -1,6 +1,8 @@
 
 #include "dsr/api/dsr_api.h"
+#include "dsr/api/dsr_signal_bus.h"
 #include "../utils.h"
+#include <algorithm>
 #include <thread>
 
 #include "catch2/catch_test_macros.hpp"
@@ -9,4 +11,147 @@
 TEST_CASE("Connect and receive the graph from other agent", "[GRAPH][SIGNALS]"){
 
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("Graph callbacks", "[GRAPH][SIGNALS]") {
+
+    auto filename = make_empty_config_file();
+    DSR::DSRGraph G(random_string(10), rand() % 1200, filename);
+    auto &cb = G.callbacks();
+
+    SECTION("Direct callbacks run before the operation returns") {
+        std::vector<uint64_t> updated, deleted;
+        std::vector<std::string> attrs;
+        DSR::Connections connections;
+        connections.add(cb.update_node, [&](uint64_t id, const std::string &, const DSR::SignalInfo &info) {
+            REQUIRE(info.agent_id == G.get_agent_id());
+            updated.push_back(id);
+        });
+        connections.add(cb.update_node_attr, [&](uint64_t, const std::vector<std::string> &names, const DSR::SignalInfo &) { attrs = names; });
+        connections.add(cb.del_node, [&](uint64_t id, const DSR::SignalInfo &) { deleted.push_back(id); });
+
+        auto id = G.insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        REQUIRE(id.has_value());
+        REQUIRE(updated == std::vector<uint64_t>{id.value()});
+
+        auto n = G.get_node(id.value());
+        G.add_or_modify_attrib_local<level_att>(n.value(), 3);
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(std::find(attrs.begin(), attrs.end(), "level") != attrs.end());
+
+        REQUIRE(G.delete_node(id.value()));
+        REQUIRE(deleted == std::vector<uint64_t>{id.value()});
+
+        connections.clear();
+        REQUIRE(cb.update_node.empty());
+        REQUIRE(G.insert_node(DSR::Node::create<testtype_node_type>(random_string())).has_value());
+        REQUIRE(updated.size() == 2);
+    }
+
+    SECTION("Attribute values are delivered with the update") {
+        std::vector<DSR::AttrValues> node_values, edge_values;
+        DSR::Connections connections;
+        connections.add(cb.update_node_attr_values, [&](uint64_t, const DSR::AttrValues &values, const DSR::SignalInfo &) { node_values.push_back(values); });
+        connections.add(cb.update_edge_attr_values, [&](uint64_t, uint64_t, const std::string &, const DSR::AttrValues &values, const DSR::SignalInfo &) { edge_values.push_back(values); });
+
+        auto id = G.insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        REQUIRE(id.has_value());
+        auto n = G.get_node(id.value());
+        G.add_or_modify_attrib_local<level_att>(n.value(), 7);
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(node_values.size() == 1);
+        auto level = std::find_if(node_values[0]->begin(), node_values[0]->end(), [](auto &c) { return c.name == "level"; });
+        REQUIRE(level != node_values[0]->end());
+        REQUIRE(level->value.has_value());
+        REQUIRE(level->value->dec() == 7);
+
+        REQUIRE(G.remove_attrib_local<level_att>(n.value()));
+        REQUIRE(G.update_node(n.value()));
+        REQUIRE(node_values.size() == 2);
+        level = std::find_if(node_values[1]->begin(), node_values[1]->end(), [](auto &c) { return c.name == "level"; });
+        REQUIRE(level != node_values[1]->end());
+        REQUIRE_FALSE(level->value.has_value());
+
+        auto to = G.insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        auto e = DSR::Edge::create<in_edge_type>(id.value(), to.value());
+        REQUIRE(G.insert_or_assign_edge(e));
+        G.add_or_modify_attrib_local<level_att>(e, 2);
+        REQUIRE(G.insert_or_assign_edge(e));
+        REQUIRE(edge_values.size() == 1);
+        level = std::find_if(edge_values[0]->begin(), edge_values[0]->end(), [](auto &c) { return c.name == "level"; });
+        REQUIRE(level != edge_values[0]->end());
+        REQUIRE(level->value->dec() == 2);
+    }
+
+    SECTION("Queued callbacks run in the thread of the executor") {
+        DSR::QueuedExecutor executor;
+        std::vector<std::pair<uint64_t, std::string>> edges;
+        auto c = cb.update_edge.connect(executor, [&](uint64_t from, uint64_t to, const std::string &type, const DSR::SignalInfo &) {
+            edges.emplace_back(to, type);
+        });
+
+        auto from = G.insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        auto to = G.insert_node(DSR::Node::create<testtype_node_type>(random_string()));
+        REQUIRE((from.has_value() and to.has_value()));
+        REQUIRE(G.insert_or_assign_edge(DSR::Edge::create<in_edge_type>(from.value(), to.value())));
+        REQUIRE(edges.empty());
+        REQUIRE(executor.size() >= 1);
+
+        executor.run_pending();
+        REQUIRE(edges == std::vector<std::pair<uint64_t, std::string>>{{to.value(), "in"}});
+
+        REQUIRE(cb.update_edge.disconnect(c));
+        REQUIRE_FALSE(cb.update_edge.disconnect(c));
+    }
+}
+
+TEST_CASE("Replaced callback lists are freed", "[SIGNALS]") {
+
+    DSR::Signal<uint64_t> signal;
+
+    SECTION("Lists are freed right away without publishers") {
+        std::vector<DSR::CallbackId> ids;
+        for (int i = 0; i < 1000; i++) ids.push_back(signal.connect([](uint64_t) {}));
+        for (auto id : ids) REQUIRE(signal.disconnect(id));
+        REQUIRE(signal.retired_lists() == 0);
+        REQUIRE(signal.empty());
+    }
+
+    SECTION("A running callback holds back only the lists replaced meanwhile") {
+        std::vector<DSR::CallbackId> ids;
+        std::size_t held = 0;
+        auto c = signal.connect([&](uint64_t) {
+            for (int i = 0; i < 10; i++) ids.push_back(signal.connect([](uint64_t) {}));
+            held = signal.retired_lists();
+        });
+        signal.publish(1);
+        REQUIRE(held == 10);
+        REQUIRE(signal.retired_lists() == 10);
+
+        REQUIRE(signal.disconnect(c));
+        REQUIRE(signal.retired_lists() == 0);
+        for (auto id : ids) REQUIRE(signal.disconnect(id));
+        REQUIRE(signal.retired_lists() == 0);
+    }
+
+    SECTION("Connecting while other threads publish") {
+        std::atomic<bool> stop = false;
+        std::atomic<uint64_t> calls = 0;
+        std::vector<std::thread> publishers;
+        for (int t = 0; t < 4; t++)
+            publishers.emplace_back([&] {
+                while (not stop.load()) signal.publish(1);
+            });
+        for (int i = 0; i < 2000; i++)
+        {
+            auto id = signal.connect([&](uint64_t v) { calls.fetch_add(v); });
+            REQUIRE(signal.disconnect(id));
+        }
+        stop.store(true);
+        for (auto &t : publishers) t.join();
+
+        // The publishers are done, so the next change frees everything replaced before it.
+        REQUIRE(signal.disconnect(signal.connect([](uint64_t) {})));
+        REQUIRE(signal.retired_lists() == 0);
+    }
+}
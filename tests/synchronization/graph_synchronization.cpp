@@ -6,7 +6,9 @@
 
 
 #include "dsr/api/dsr_api.h"
+#include "dsr/core/rtps/loopback_transport.h"
 #include "../utils.h"
+#include <algorithm>
 #include <thread>
 
 #include "catch2/catch_test_macros.hpp"
@@ -27,4 +29,43 @@ TEST_CASE("Connect and receive the graph from other agent", "[SYNCHRONIZATION][G
     std::this_thread::sleep_for(200ms);
     REQUIRE(G2.size() == G.size());
     
-}
\ No newline at end of file
+}
+
+TEST_CASE("Agents connected through the loopback transport", "[SYNCHRONIZATION][GRAPH][LOOPBACK]"){
+
+    auto domain = LoopbackDomain::create();
+    DSRGraph G(random_string(10), 1, make_empty_config_file(), domain->connect());
+    std::vector<std::unique_ptr<DSRGraph>> replicas;
+    for (uint32_t id = 2; id <= 8; id++)
+        replicas.emplace_back(std::make_unique<DSRGraph>(random_string(10), id, "", domain->connect()));
+    REQUIRE(domain->size() == 8);
+
+    // The full graph is joined before the constructor returns.
+    for (auto &r : replicas)
+        REQUIRE(r->size() == G.size());
+
+    auto eventually = [](auto &&condition) {
+        const auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (not condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    };
+
+    auto id = G.insert_node(Node::create<testtype_node_type>(random_string()));
+    REQUIRE(id.has_value());
+    REQUIRE(eventually([&] {
+        return std::ranges::all_of(replicas, [&](auto &r) { return r->get_node(id.value()).has_value(); });
+    }));
+
+    auto &last = *replicas.back();
+    auto n = last.get_node(id.value());
+    last.add_or_modify_attrib_local<level_att>(n.value(), 7);
+    REQUIRE(last.update_node(n.value()));
+    REQUIRE(eventually([&] { return G.get_attrib_by_name<level_att>(id.value()) == 7; }));
+
+    replicas.pop_back();
+    REQUIRE(domain->size() == 7);
+}
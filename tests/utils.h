@@ -1,9 +1,11 @@
 
 #include <dsr/api/dsr_api.h>
+#include <algorithm>
 #include <fstream>
 #include <span>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 
 
 
@@ -89,6 +91,30 @@ inline auto make_empty_config_file() -> std::string {
 }
 
 
+// Inserts node under parent with an RT edge. A failed insertion throws, which fails the test.
+inline auto insert_rt_child(DSR::DSRGraph &G, DSR::RT_API &rt, uint64_t parent, DSR::Node node,
+                            std::vector<float> translation = {0.f, 0.f, 0.f},
+                            std::vector<float> rotation = {0.f, 0.f, 0.f}) -> uint64_t {
+    auto id = G.insert_node(node).value();
+    auto p = G.get_node(parent).value();
+    rt.insert_or_assign_edge_RT(p, id, std::move(translation), std::move(rotation));
+    return id;
+}
+
+template <typename Type = testtype_node_type>
+inline auto insert_rt_child(DSR::DSRGraph &G, DSR::RT_API &rt, uint64_t parent,
+                            std::vector<float> translation = {0.f, 0.f, 0.f},
+                            std::vector<float> rotation = {0.f, 0.f, 0.f}) -> uint64_t {
+    return insert_rt_child(G, rt, parent, DSR::Node::create<Type>(random_string()),
+                           std::move(translation), std::move(rotation));
+}
+
+inline auto sorted(std::vector<uint64_t> v) -> std::vector<uint64_t> {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+
 inline auto make_edge_config_file() -> std::string {
 
     auto filename = temp_filename();